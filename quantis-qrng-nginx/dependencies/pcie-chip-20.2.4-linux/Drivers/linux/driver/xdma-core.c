@@ -79,6 +79,30 @@ MODULE_PARM_DESC(
 	garbage_to_read_rng,
 	"the number of bytes read after device initialization mode RNG to make sure there is no garbage left in the fifo, use 0 to disable this feature");
 
+static unsigned int rx_ring_blocks = 256;
+module_param(rx_ring_blocks, uint, 0644);
+MODULE_PARM_DESC(
+	rx_ring_blocks,
+	"number of 4 KiB blocks of the C2H rx ring, allocated when the device is first opened, between 2 and 16384, default is 256");
+
+static unsigned int rx_initial_credits = 128;
+module_param(rx_initial_credits, uint, 0644);
+MODULE_PARM_DESC(
+	rx_initial_credits,
+	"number of rx ring blocks the C2H engine may fill ahead of the readers with the credit feature, at most rx_ring_blocks, default is 128");
+
+static unsigned int enable_hwrng;
+module_param(enable_hwrng, uint, S_IRUGO);
+MODULE_PARM_DESC(
+	enable_hwrng,
+	"Set 1 to feed the kernel hwrng framework (/dev/hwrng and the kernel CRNG) from the first C2H stream of each card, default is 0");
+
+static unsigned short hwrng_quality;
+module_param(hwrng_quality, ushort, S_IRUGO);
+MODULE_PARM_DESC(
+	hwrng_quality,
+	"estimated bits of entropy per 1024 bits read from the hwrng, 0 leaves the kernel default, default is 0");
+
 /* SECTION: Module global variables */
 
 static struct class *g_xdma_class; /* sys filesystem */
@@ -211,28 +235,47 @@ static ssize_t transfer_data(struct xdma_engine *engine,
 static ssize_t char_sgdma_read_write(struct file *file, char __user *buf,
 				     size_t count, loff_t *pos, int dir_to_dev);
 static int transfer_monitor_cyclic(struct xdma_engine *engine,
-				   struct xdma_transfer *transfer);
-static int copy_cyclic_to_user(struct xdma_dev *lro, struct xdma_engine *engine,
-			       size_t pkt_length, int head, char __user *buf,
-			       size_t size);
-static int complete_cyclic(struct xdma_dev *lro, struct xdma_engine *engine,
-			   char __user *buf, size_t size);
+				   struct xdma_transfer *transfer,
+				   bool nonblock);
+static int copy_cyclic(struct cyclic_dest *dest, struct xdma_engine *engine,
+		       u32 first, u32 count, size_t size);
+static int cyclic_return_credits(struct xdma_engine *engine, u32 first,
+				 u32 count);
+static int cyclic_drop_garbage(struct xdma_dev *lro,
+			       struct xdma_engine *engine, bool nonblock);
+static int cyclic_skip_garbage(struct xdma_char *lro_char, bool nonblock);
+static int read_mutex_lock(struct xdma_file *xfile, bool nonblock);
+static bool engine_is_cyclic(struct xdma_engine *engine);
+static int complete_cyclic(struct cyclic_dest *dest,
+			   struct xdma_engine *engine, size_t size);
+static int read_cyclic(struct cyclic_dest *dest, struct xdma_engine *engine,
+		       size_t size, bool nonblock);
 static ssize_t char_sgdma_read_cyclic(struct file *file, char __user *buf,
 				      size_t size);
 static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 			     unsigned long arg);
+static int char_sgdma_mmap(struct file *file, struct vm_area_struct *vma);
+static __poll_t char_sgdma_poll(struct file *file, poll_table *wait);
 static ssize_t char_sgdma_write(struct file *file, const char __user *buf,
 				size_t count, loff_t *pos);
 static ssize_t char_sgdma_read(struct file *file, char __user *buf,
 			       size_t count, loff_t *pos);
 static ssize_t char_xdma_read(struct file *file, char __user *buf, size_t count,
 			      loff_t *pos);
+static size_t rx_buffer_size(const struct qrandom_ring *ring);
+static size_t rx_result_buffer_size(const struct qrandom_ring *ring);
 static int cyclic_transfer_setup(struct xdma_engine *engine);
+static void xdma_file_init(struct xdma_file *xfile,
+			   struct xdma_char *lro_char);
+static int char_get(struct xdma_char *lro_char);
+static int char_put(struct xdma_char *lro_char);
 static int char_sgdma_open(struct inode *inode, struct file *file);
 static int cyclic_shutdown_polled(struct xdma_engine *engine);
 static int cyclic_shutdown_interrupt(struct xdma_engine *engine);
 static int cyclic_transfer_teardown(struct xdma_engine *engine);
 static int char_sgdma_close(struct inode *inode, struct file *file);
+static void xdma_hwrng_register(struct xdma_dev *lro);
+static void xdma_hwrng_unregister(struct xdma_dev *lro);
 static int msi_msix_capable(struct pci_dev *dev, int type);
 static struct xdma_dev *alloc_dev_instance(struct pci_dev *pdev);
 static int probe_scan_for_msi(struct xdma_dev *lro, struct pci_dev *pdev);
@@ -261,6 +304,9 @@ static int destroy_sg_char(struct xdma_char *lro_char);
 static int gen_dev_major(struct xdma_char *lro_char);
 static int gen_dev_minor(struct xdma_engine *engine, int event_id);
 static int config_kobject(struct xdma_char *lro_char, enum chardev_type type);
+static bool char_has_rx_ring(struct xdma_char *lro_char);
+static int create_rx_ring_files(struct device *dev);
+static void remove_rx_ring_files(struct device *dev);
 static int create_dev(struct xdma_char *lro_char, enum chardev_type type);
 static struct xdma_char *create_sg_char(struct xdma_dev *lro, int bar,
 					struct xdma_engine *engine,
@@ -283,6 +329,8 @@ static const struct file_operations sg_fops = {
 	.read = char_sgdma_read,
 	.write = char_sgdma_write,
 	.unlocked_ioctl = char_sgdma_ioctl,
+	.mmap = char_sgdma_mmap,
+	.poll = char_sgdma_poll,
 	.llseek = char_sgdma_llseek,
 };
 
@@ -304,6 +352,12 @@ static inline u64 build_u64(u64 hi, u64 lo)
 	return ((hi & 0xFFFFFFFULL) << 32) | (lo & 0xFFFFFFFFULL);
 }
 
+/* character device an open file refers to */
+static inline struct xdma_char *file_char(struct file *file)
+{
+	return ((struct xdma_file *)file->private_data)->lro_char;
+}
+
 #if XDMA_STATUS_DUMPS
 static void interrupt_status(struct xdma_dev *lro)
 {
@@ -776,42 +830,57 @@ static void engine_transfer_dequeue(struct xdma_engine *engine)
 static int engine_ring_process(struct xdma_engine *engine)
 {
 	struct xdma_result *result;
-	int start;
+	struct qrandom_ring *ring;
+	u32 tail;
 	int eop_count = 0;
 
 	BUG_ON(!engine);
 	result = (struct xdma_result *)engine->rx_result_buffer_virt;
 	BUG_ON(!result);
-
-	/* where we start receiving in the ring buffer */
-	start = engine->rx_tail;
+	ring = &engine->rx_ring;
 
 	/* iterate through all newly received RX result descriptors */
-	while (result[engine->rx_tail].status && !engine->rx_overrun) {
-		/* EOP bit set in result? */
-		if (result[engine->rx_tail].status & RX_STATUS_EOP) {
-			eop_count++;
-		}
-		dbg_tfr("result[engine->rx_tail=%3d].status = 0x%08x\n",
-			engine->rx_tail, (int)result[engine->rx_tail].status);
-		dbg_tfr("result[engine->rx_tail=%3d].length = %d\n",
-			engine->rx_tail, (int)result[engine->rx_tail].length);
-
-		/* increment tail pointer */
-
-		engine->rx_tail = (engine->rx_tail + 1) % RX_BUF_PAGES;
-
-		/* overrun? */
-		if (engine->rx_tail == engine->rx_head) {
+	while (result[ring->tail].status) {
+		tail = ring->tail;
+		dbg_tfr("result[tail=%3u].status = 0x%08x\n", tail,
+			(int)result[tail].status);
+		dbg_tfr("result[tail=%3u].length = %d\n", tail,
+			(int)result[tail].length);
+
+		/* increment tail pointer, unless the readers were overrun */
+		if (!qrandom_ring_produce(ring)) {
 			dbg_tfr("engine_service_cyclic(): overrun\n");
-			/* flag to user space that overrun has occurred */
-			engine->rx_overrun = 1;
+			break;
 		}
+
+		/* EOP bit set in result? */
+		if (result[tail].status & RX_STATUS_EOP)
+			eop_count++;
 	}
 
 	return eop_count;
 }
 
+/*
+ * Poll mode only: wakes the pollers of the rx ring, so that poll() processes
+ * the result array again. Armed by char_sgdma_poll() while the ring is empty.
+ */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 15, 0)
+static void engine_poll_timer(struct timer_list *timer)
+{
+	struct xdma_engine *engine =
+		container_of(timer, struct xdma_engine, rx_poll_timer);
+#else
+static void engine_poll_timer(unsigned long data)
+{
+	struct xdma_engine *engine = (struct xdma_engine *)data;
+#endif
+	struct xdma_transfer *transfer = READ_ONCE(engine->rx_transfer_cyclic);
+
+	if (transfer)
+		wake_up_interruptible(&transfer->wq);
+}
+
 static int engine_service_cyclic_polled(struct xdma_engine *engine)
 {
 	int eop_count = 0;
@@ -869,16 +938,12 @@ static int engine_service_cyclic_interrupt(struct xdma_engine *engine)
 	 * the RX buffer
 	 */
 	if (enable_credit_mp) {
-		if (eop_count > 0) {
-			//engine->eop_found = 1;
-		}
 		wake_up_interruptible(&engine->rx_transfer_cyclic->wq);
 	} else {
 		if (eop_count > 0) {
 			/* awake task on transfer's wait queue */
 			dbg_tfr("wake_up_interruptible() due to %d EOP's\n",
 				eop_count);
-			engine->eop_found = 1;
 			wake_up_interruptible(&engine->rx_transfer_cyclic->wq);
 		}
 	}
@@ -2369,6 +2434,13 @@ static struct xdma_engine *engine_create(struct xdma_dev *lro, int offset,
 
 	/* initialize spinlock */
 	spin_lock_init(&engine->lock);
+	/* initialize the rx ring poll timer */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 15, 0)
+	timer_setup(&engine->rx_poll_timer, engine_poll_timer, 0);
+#else
+	setup_timer(&engine->rx_poll_timer, engine_poll_timer,
+		    (unsigned long)engine);
+#endif
 	/* initialize transfer_list */
 	INIT_LIST_HEAD(&engine->transfer_list);
 	/* parent */
@@ -2785,7 +2857,7 @@ static loff_t char_sgdma_llseek(struct file *file, loff_t off, int whence)
 {
 	loff_t newpos = 0;
 	struct xdma_dev *lro;
-	struct xdma_char *lro_char = (struct xdma_char *)file->private_data;
+	struct xdma_char *lro_char = file_char(file);
 	BUG_ON(!lro_char);
 	BUG_ON(lro_char->magic != MAGIC_CHAR);
 	lro = lro_char->lro;
@@ -2967,7 +3039,7 @@ static ssize_t char_sgdma_read_write(struct file *file, char __user *buf,
 	struct xdma_engine *engine;
 
 	/* fetch device specific data stored earlier during open */
-	lro_char = (struct xdma_char *)file->private_data;
+	lro_char = file_char(file);
 	BUG_ON(!lro_char);
 	BUG_ON(lro_char->magic != MAGIC_CHAR);
 
@@ -3016,17 +3088,29 @@ static ssize_t char_sgdma_read_write(struct file *file, char __user *buf,
 	return res;
 }
 
+/*
+ * Waits until the rx ring has ready blocks. With @nonblock, returns -EAGAIN
+ * instead of waiting; in poll mode the result array is checked once first.
+ */
 static int transfer_monitor_cyclic(struct xdma_engine *engine,
-				   struct xdma_transfer *transfer)
+				   struct xdma_transfer *transfer,
+				   bool nonblock)
 {
-	struct xdma_result *result;
 	int rc = 0;
 
 	BUG_ON(!engine);
 	BUG_ON(!transfer);
 
-	result = (struct xdma_result *)engine->rx_result_buffer_virt;
-	BUG_ON(!result);
+	if (nonblock) {
+		if (poll_mode) {
+			spin_lock(&engine->lock);
+			engine_ring_process(engine);
+			spin_unlock(&engine->lock);
+		}
+		if (qrandom_ring_available(&engine->rx_ring) == 0)
+			return -EAGAIN;
+		return 0;
+	}
 
 	do {
 		if (poll_mode) {
@@ -3037,162 +3121,149 @@ static int transfer_monitor_cyclic(struct xdma_engine *engine,
 				break;
 			}
 		} else {
-			if (enable_credit_mp) {
-				rc = wait_event_interruptible(
-					transfer->wq,
-					(engine->rx_head != engine->rx_tail ||
-					 engine->rx_overrun));
-			} else {
-				rc = wait_event_interruptible(
-					transfer->wq, engine->eop_found);
-			}
+			rc = wait_event_interruptible(
+				transfer->wq,
+				qrandom_ring_available(&engine->rx_ring) > 0);
 			if (rc) {
 				dbg_tfr("wait_event_interruptible()=%d\n", rc);
 				break;
 			}
 		}
-	} while (result[engine->rx_head].status == 0);
+	} while (qrandom_ring_available(&engine->rx_ring) == 0);
 
 	return rc;
 }
 
-static int copy_cyclic_to_user(struct xdma_dev *lro, struct xdma_engine *engine,
-			       size_t nb_result, int head, char __user *buf,
-			       size_t size)
+static int cyclic_copy_user(void *ctx, size_t offset, const char *data,
+			    size_t len)
+{
+	struct cyclic_dest *dest = ctx;
+
+	if (copy_to_user(&dest->user[offset], data, len)) {
+		dbg_tfr("copy_to_user failed\n");
+		return -EFAULT;
+	}
+	return 0;
+}
+
+static int cyclic_copy_kernel(void *ctx, size_t offset, const char *data,
+			      size_t len)
+{
+	struct cyclic_dest *dest = ctx;
+
+	memcpy(&dest->kernel[offset], data, len);
+	return 0;
+}
+
+#if USE_FIFO
+/* keep what does not fit for the next read */
+static void cyclic_keep(void *ctx, const char *data, size_t len)
+{
+	struct cyclic_dest *dest = ctx;
+
+	kfifo_in(&dest->xfile->remaining_bytes, data, len);
+}
+#else
+#define cyclic_keep NULL
+#endif
+
+static int copy_cyclic(struct cyclic_dest *dest, struct xdma_engine *engine,
+		       u32 first, u32 count, size_t size)
 {
 	struct xdma_result *result;
-	char *rx_buffer;
-	int rc, copy;
-	size_t user_buffer_index = 0;
-	size_t copied = 0;
-	size_t i;
 
 	BUG_ON(!engine);
-	BUG_ON(!buf);
+	BUG_ON(!dest->user && !dest->kernel);
 
 	result = (struct xdma_result *)engine->rx_result_buffer_virt;
 	BUG_ON(!result);
 
-	dbg_tfr("nb_result = %zu, size = %zu\n", nb_result, size);
-
-	rx_buffer = engine->rx_buffer;
-
-	for (i = 0; i < nb_result; i++) {
-		size_t len = result[head].length;
-		size_t remaining_in_user_buf = size - user_buffer_index;
-		copy = remaining_in_user_buf > len ? len :
-						     remaining_in_user_buf;
+	dbg_tfr("count = %u, size = %zu\n", count, size);
 
-		dbg_tfr("head = %u, len = %zu\n", head, len);
+	return qrandom_ring_copy(&engine->rx_ring, result, engine->rx_buffer,
+				 first, count, size,
+				 dest->user ? cyclic_copy_user :
+					      cyclic_copy_kernel,
+				 cyclic_keep, dest);
+}
 
-		if (copy > 0) {
-			rc = copy_to_user(&buf[engine->user_buffer_index],
-					  &rx_buffer[head * RX_BUF_BLOCK],
-					  copy);
+/*
+ * Releases @count claimed blocks from @first and gives the engine a credit
+ * for each block it can fill again.
+ */
+static int cyclic_return_credits(struct xdma_engine *engine, u32 first,
+				 u32 count)
+{
+	int credits;
 
-			if (rc) {
-				dbg_tfr("copy_to_user failed\n");
-				return rc;
-			}
-			copied += copy;
-#if USE_FIFO
-			if (copy < len) {
-				kfifo_in(&lro->remaining_bytes,
-					 &rx_buffer[head * RX_BUF_BLOCK + copy],
-					 len - copy);
-			}
-#endif
-		}
-#if USE_FIFO
-		else {
-			kfifo_in(&lro->remaining_bytes,
-				 &rx_buffer[head * RX_BUF_BLOCK], len);
-		}
-#endif
-		result[head].length = 0;
+	spin_lock(&engine->lock);
+	credits = qrandom_ring_release(&engine->rx_ring, first, count);
+	spin_unlock(&engine->lock);
 
-		user_buffer_index += copy;
-		head = (head + 1) % RX_BUF_PAGES;
-	}
+	if (credits > 0)
+		iowrite32(credits, &engine->sgdma_regs->credits);
 
-	return copied;
+	return credits;
 }
 
-static int complete_cyclic(struct xdma_dev *lro, struct xdma_engine *engine,
-			   char __user *buf, size_t size)
+/*
+ * Claims the ready blocks needed to fill @size bytes and copies them to the
+ * destination, the bytes which do not fit are kept for the next read.
+ *
+ * Only the claim and the release hold the engine lock, so readers of other
+ * files copy their blocks at the same time. Returns 0 if another reader
+ * took the ready blocks first.
+ */
+static int complete_cyclic(struct cyclic_dest *dest,
+			   struct xdma_engine *engine, size_t size)
 {
 	struct xdma_result *result;
-	int fault = 0;
-	int eop = 0;
-	int head;
-	int rc = 0;
-	int num_credit = 0;
+	struct qrandom_ring *ring;
+	u32 first;
+	u32 count;
+	int fault;
+	int rc;
 
 	BUG_ON(!engine);
 	result = (struct xdma_result *)engine->rx_result_buffer_virt;
 	BUG_ON(!result);
+	ring = &engine->rx_ring;
 
 	spin_lock(&engine->lock);
+	count = qrandom_ring_claim(
+		ring, result,
+		min_t(size_t, DIV_ROUND_UP(size, ring->block_size), ring->blocks),
+		&first, &fault);
+	spin_unlock(&engine->lock);
 
-	/* where the host currently is in the ring buffer */
-	head = engine->rx_head;
-
-	/* iterate over newly received results */
-	//while (result[engine->rx_head].status) {
-	while (engine->rx_head != engine->rx_tail || engine->rx_overrun) {
-		WARN_ON(result[engine->rx_head].status == 0);
-		dbg_tfr("result[engine->rx_head=%3d].status = 0x%08x\n",
-			engine->rx_head, (int)result[engine->rx_head].status);
-
-		dbg_tfr("result[engine->rx_head=%3d].length = %d\n",
-			engine->rx_head, (int)result[engine->rx_head].length);
-
-		if ((result[engine->rx_head].status >> 16) != C2H_WB) {
-			dbg_tfr("engine->rx_head has no result magic\n");
-			fault = 1;
-		} else if (result[engine->rx_head].length > RX_BUF_BLOCK) {
-			dbg_tfr("engine->rx_head length > %d\n", RX_BUF_BLOCK);
-			fault = 1;
-		} else if (result[engine->rx_head].length == 0) {
-			dbg_tfr("engine->rx_head length is zero\n");
-			fault = 1;
-			/* valid result */
-		} else {
-			num_credit++;
-			/* seen eop? */
-			if (result[engine->rx_head].status & RX_STATUS_EOP) {
-				eop = 1;
-				engine->eop_found = 1;
-			}
+	rc = copy_cyclic(dest, engine, first, count, size);
 
-			dbg_tfr("num_credit=%d (%s)\n", num_credit,
-				eop ? "with EOP" : "no EOP yet");
-		}
-		/* clear result */
-		result[engine->rx_head].status = 0;
-		/* proceed head pointer so we make progress, even when fault */
-		engine->rx_head = (engine->rx_head + 1) % RX_BUF_PAGES;
+	/* the blocks are released even when the copy failed */
+	cyclic_return_credits(engine, first, count);
 
-		/* stop processing if a fault/eop was detected */
-		if (fault || eop) {
-			break;
-		}
+	if (fault) {
+		printk("[complete_cyclic] fault in result ring\n");
+		if (rc == 0)
+			rc = -EIO;
 	}
 
-	spin_unlock(&engine->lock);
+	return rc;
+}
 
-	if (fault) {
-		printk("[complete_cyclic] fault!!!!  rc = -EIO!!!! \n");
-		rc = -EIO;
-	} else {
-		rc = copy_cyclic_to_user(lro, engine, num_credit, head, buf,
-					 size);
-		engine->rx_overrun = 0;
-		/* if copy is successful, release credits */
-		if (rc > 0) {
-			iowrite32(num_credit, &engine->sgdma_regs->credits);
-		}
-	}
+/* waits for ready blocks until @size bytes, or less, reached @dest */
+static int read_cyclic(struct cyclic_dest *dest, struct xdma_engine *engine,
+		       size_t size, bool nonblock)
+{
+	int rc;
+
+	/* another reader may take the ready blocks first */
+	do {
+		rc = transfer_monitor_cyclic(engine, engine->rx_transfer_cyclic,
+					     nonblock);
+		if (rc)
+			return rc;
+		rc = complete_cyclic(dest, engine, size);
+	} while (rc == 0);
 
 	return rc;
 }
@@ -3201,14 +3272,17 @@ static ssize_t char_sgdma_read_cyclic(struct file *file, char __user *buf,
 				      size_t size)
 {
 	int rc = 0;
-	int rc_len = 0;
 	struct xdma_char *lro_char;
 	struct xdma_dev *lro;
 	struct xdma_engine *engine;
 	struct xdma_transfer *transfer;
+	struct cyclic_dest dest = {
+		.xfile = file->private_data,
+		.user = buf,
+	};
 
 	/* fetch device specific data stored earlier during open */
-	lro_char = (struct xdma_char *)file->private_data;
+	lro_char = file_char(file);
 	BUG_ON(!lro_char);
 	BUG_ON(lro_char->magic != MAGIC_CHAR);
 
@@ -3225,20 +3299,236 @@ static ssize_t char_sgdma_read_cyclic(struct file *file, char __user *buf,
 	BUG_ON(!transfer);
 
 	dbg_tfr("char_sgdma_read_cyclic()");
-	engine->user_buffer_index = 0;
 
-	do {
-		rc = transfer_monitor_cyclic(engine, transfer);
+	rc = read_cyclic(&dest, engine, size, file->f_flags & O_NONBLOCK);
+
+	dbg_tfr("returning %d\n", rc);
+	return rc;
+}
+
+/*
+ * Drops the garbage the engine produces after the card initialization or a
+ * reset, as char_xdma_throw_garbage() does for read() but without copying
+ * it. The bytes dropped so far are kept in the device, so a nonblocking
+ * reader which gets -EAGAIN carries on where it stopped.
+ */
+static int cyclic_drop_garbage(struct xdma_dev *lro, struct xdma_engine *engine,
+			       bool nonblock)
+{
+	struct xdma_result *result;
+	size_t garbage;
+	u32 first;
+	u32 count;
+	u32 length;
+	int fault;
+	int rc;
+
+	result = (struct xdma_result *)engine->rx_result_buffer_virt;
+	BUG_ON(!result);
+
+	if (lro->current_qrng_mode == QUANTIS_QRNG_MODE_SAMPLE)
+		garbage = garbage_to_read_sample;
+	else
+		garbage = garbage_to_read_rng;
+
+	while (lro->garbage_dropped < garbage) {
+		rc = transfer_monitor_cyclic(engine, engine->rx_transfer_cyclic,
+					     nonblock);
 		if (rc)
 			return rc;
-		rc_len += complete_cyclic(lro, engine, buf, size);
-	} while (!engine->eop_found);
 
-	if (enable_credit_mp) {
-		engine->eop_found = 0;
+		spin_lock(&engine->lock);
+		count = qrandom_ring_claim(&engine->rx_ring, result,
+					   engine->rx_ring.blocks, &first,
+					   &fault);
+		length = qrandom_ring_span_length(&engine->rx_ring, result,
+						  first, count);
+		spin_unlock(&engine->lock);
+
+		cyclic_return_credits(engine, first, count);
+		lro->garbage_dropped += length;
 	}
-	dbg_tfr("returning %d\n", rc_len);
-	return rc_len;
+
+	lro->no_garbage_to_read = true;
+
+	return 0;
+}
+
+/*
+ * Drops the garbage once, before the first read from the ring. The device
+ * mutex only serializes the readers while they wait for that.
+ */
+static int cyclic_skip_garbage(struct xdma_char *lro_char, bool nonblock)
+{
+	struct xdma_dev *lro = lro_char->lro;
+	int rc = 0;
+
+	if (READ_ONCE(lro->no_garbage_to_read))
+		return 0;
+
+	if (nonblock) {
+		if (!mutex_trylock(&(lro_char->device_mutex)))
+			return -EAGAIN;
+	} else if (mutex_lock_interruptible(&(lro_char->device_mutex))) {
+		return -ERESTARTSYS;
+	}
+	if (!lro->no_garbage_to_read)
+		rc = cyclic_drop_garbage(lro, lro_char->engine, nonblock);
+	mutex_unlock(&(lro_char->device_mutex));
+
+	return rc;
+}
+
+/* a nonblocking reader does not wait for another reader of the file */
+static int read_mutex_lock(struct xdma_file *xfile, bool nonblock)
+{
+	if (nonblock)
+		return mutex_trylock(&xfile->read_mutex) ? 0 : -EAGAIN;
+	if (mutex_lock_interruptible(&xfile->read_mutex))
+		return -ERESTARTSYS;
+	return 0;
+}
+
+#if USE_FIFO
+/*
+ * Drops the bytes the fifo kept from before a board reset. Called by the
+ * reader of the fifo, under the read mutex (or the device mutex for other
+ * engines), which the reset does not wait for.
+ */
+static void fifo_reset_pending(struct xdma_file *xfile)
+{
+	if (READ_ONCE(xfile->fifo_reset)) {
+		WRITE_ONCE(xfile->fifo_reset, false);
+		kfifo_reset(&xfile->remaining_bytes);
+	}
+}
+#endif
+
+/* AXI-ST C2H engine reading into the rx ring */
+static bool engine_is_cyclic(struct xdma_engine *engine)
+{
+	return !engine->dir_to_dev && engine->rx_buffer &&
+	       engine->rx_transfer_cyclic;
+}
+
+/*
+ * Zero-copy readers map the rx ring and its result array, which only works
+ * if the engine does not overwrite the blocks they acquired.
+ */
+static bool ring_mapping_supported(struct xdma_engine *engine)
+{
+	return enable_credit_mp && engine_is_cyclic(engine);
+}
+
+/* mmap offset of the result array, right after the rx ring */
+static unsigned long ring_result_offset(struct xdma_engine *engine)
+{
+	return PAGE_ALIGN((unsigned long)engine->rx_ring.blocks *
+			  engine->rx_ring.block_size);
+}
+
+static long ring_info_ioctl(struct xdma_engine *engine,
+			    struct quantis_ring_info __user *arg)
+{
+	struct quantis_ring_info info;
+
+	if (!ring_mapping_supported(engine))
+		return -EOPNOTSUPP;
+
+	info.blocks = engine->rx_ring.blocks;
+	info.block_size = engine->rx_ring.block_size;
+	info.result_offset = ring_result_offset(engine);
+	info.result_size = sizeof(struct xdma_result);
+
+	return copy_to_user(arg, &info, sizeof(info)) ? -EFAULT : 0;
+}
+
+/*
+ * Waits for completed blocks and hands at most span.count of them to the
+ * file. The payload of each block is read from the mapped rx ring, its
+ * length from the mapped result array.
+ */
+static long ring_acquire_ioctl(struct xdma_file *xfile,
+			       struct quantis_ring_span __user *arg,
+			       bool nonblock)
+{
+	struct xdma_engine *engine = xfile->lro_char->engine;
+	struct xdma_result *result;
+	struct quantis_ring_span span;
+	u32 first;
+	u32 count;
+	int fault;
+	int rc;
+
+	if (!ring_mapping_supported(engine))
+		return -EOPNOTSUPP;
+	if (copy_from_user(&span, arg, sizeof(span)))
+		return -EFAULT;
+	if (span.count == 0)
+		return -EINVAL;
+	/* the blocks acquired before must be released first */
+	if (xfile->ring_count > 0)
+		return -EBUSY;
+
+	result = (struct xdma_result *)engine->rx_result_buffer_virt;
+
+	/* another reader may take the ready blocks first */
+	do {
+		rc = transfer_monitor_cyclic(engine,
+					     engine->rx_transfer_cyclic,
+					     nonblock);
+		if (rc)
+			return rc;
+
+		spin_lock(&engine->lock);
+		count = qrandom_ring_claim(&engine->rx_ring, result,
+					   min_t(u32, span.count,
+						 engine->rx_ring.blocks),
+					   &first, &fault);
+		spin_unlock(&engine->lock);
+	} while (count == 0);
+	span.first = first;
+	span.count = count;
+
+	/* a faulty block is handed out too, its length reads as zero */
+	if (fault)
+		dbg_tfr("fault in result ring\n");
+
+	xfile->ring_first = span.first;
+	xfile->ring_count = span.count;
+
+	return copy_to_user(arg, &span, sizeof(span)) ? -EFAULT : 0;
+}
+
+/* releases the first @count blocks acquired by the file */
+static int ring_release(struct xdma_file *xfile, u32 count)
+{
+	struct xdma_engine *engine = xfile->lro_char->engine;
+	int rc;
+
+	if (count > xfile->ring_count)
+		return -EINVAL;
+
+	rc = cyclic_return_credits(engine, xfile->ring_first, count);
+	if (rc < 0)
+		return rc;
+
+	xfile->ring_first =
+		qrandom_ring_next(&engine->rx_ring, xfile->ring_first, count);
+	xfile->ring_count -= count;
+
+	return 0;
+}
+
+static long ring_release_ioctl(struct xdma_file *xfile,
+			       unsigned int __user *arg)
+{
+	unsigned int count;
+
+	if (get_user(count, arg))
+		return -EFAULT;
+
+	return ring_release(xfile, count);
 }
 
 static long modules_status_ioctl(struct xilinx_fpga_regs __iomem *user_regs,
@@ -3299,6 +3589,8 @@ static long get_modules_mask_ioctl(struct xilinx_fpga_regs __iomem *user_regs,
 static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 			     unsigned long arg)
 {
+	struct xdma_file *xfile = file->private_data;
+	bool nonblock = file->f_flags & O_NONBLOCK;
 	struct xdma_char *lro_char;
 	struct xdma_dev *lro;
 	struct xdma_engine *engine;
@@ -3307,7 +3599,7 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 	uint32_t mode_from_user;
 
 	/* fetch device specific data stored earlier during open */
-	lro_char = (struct xdma_char *)file->private_data;
+	lro_char = file_char(file);
 	BUG_ON(!lro_char);
 	BUG_ON(lro_char->magic != MAGIC_CHAR);
 
@@ -3319,6 +3611,34 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 
 	user_regs = lro->bar[lro->user_bar_idx];
 
+	/* the rx ring is shared with the readers, not the device settings */
+	switch (cmd) {
+	case QUANTIS_IOCTL_GET_RING_INFO:
+		return ring_info_ioctl(engine,
+				       (struct quantis_ring_info __user *)arg);
+	case QUANTIS_IOCTL_RING_ACQUIRE:
+		if (!ring_mapping_supported(engine))
+			return -EOPNOTSUPP;
+		/* takes the device mutex, which nests outside the read mutex */
+		rc = cyclic_skip_garbage(lro_char, nonblock);
+		if (rc)
+			return rc;
+		rc = read_mutex_lock(xfile, nonblock);
+		if (rc)
+			return rc;
+		rc = ring_acquire_ioctl(xfile,
+					(struct quantis_ring_span __user *)arg,
+					nonblock);
+		mutex_unlock(&xfile->read_mutex);
+		return rc;
+	case QUANTIS_IOCTL_RING_RELEASE:
+		if (mutex_lock_interruptible(&xfile->read_mutex))
+			return -ERESTARTSYS;
+		rc = ring_release_ioctl(xfile, (unsigned int __user *)arg);
+		mutex_unlock(&xfile->read_mutex);
+		return rc;
+	}
+
 	if (mutex_lock_interruptible(&(lro_char->device_mutex))) {
 		return -ERESTARTSYS;
 	}
@@ -3341,8 +3661,10 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 		rc = Q400RegInit(user_regs, lro->qrng_mode, lro->qrng_num);
 		lro->current_qrng_mode = lro->qrng_mode;
 		lro->no_garbage_to_read = false;
+		lro->garbage_dropped = 0;
 #if USE_FIFO
-		kfifo_reset(&lro->remaining_bytes);
+		/* a reader may wait for the stalled card with the read mutex */
+		WRITE_ONCE(xfile->fifo_reset, true);
 #endif
 		break;
 	case QUANTIS_IOCTL_GET_MODULES_STATUS:
@@ -3378,33 +3700,156 @@ static long char_sgdma_ioctl(struct file *file, unsigned int cmd,
 	return rc;
 }
 
-/* sg_write() -- Write to the device
+/* char_sgdma_mmap() - Map the rx ring or its result array read-only
  *
- * @buf userspace buffer
- * @count number of bytes in the userspace buffer
- * @pos byte-address in device
+ * The rx ring is mapped at offset 0, the result array at the offset given by
+ * QUANTIS_IOCTL_GET_RING_INFO. The content of a block is only stable while
+ * it is acquired with QUANTIS_IOCTL_RING_ACQUIRE.
+ *
+ * The ring holds the bytes of every reader, only a file opened with O_EXCL
+ * maps it, see qrandom_ring_may_map(). The mapping keeps the file, and so
+ * the device, exclusive until it is unmapped.
  */
-static ssize_t char_sgdma_write(struct file *file, const char __user *buf,
-				size_t count, loff_t *pos)
+static int char_sgdma_mmap(struct file *file, struct vm_area_struct *vma)
 {
-	ssize_t rc;
+	struct xdma_file *xfile = file->private_data;
+	struct xdma_char *lro_char = file_char(file);
 	struct xdma_dev *lro;
-	struct xdma_char *lro_char = (struct xdma_char *)file->private_data;
+	struct xdma_engine *engine;
+	int rc;
+	unsigned long offset = vma->vm_pgoff << PAGE_SHIFT;
+	unsigned long size = vma->vm_end - vma->vm_start;
+	unsigned long start = vma->vm_start;
+	char *pos;
+
 	BUG_ON(!lro_char);
 	BUG_ON(lro_char->magic != MAGIC_CHAR);
 	lro = lro_char->lro;
 	BUG_ON(!lro);
 	BUG_ON(lro->magic != MAGIC_DEVICE);
+	engine = lro_char->engine;
+	BUG_ON(!engine);
 
-	if (mutex_lock_interruptible(&(lro_char->device_mutex))) {
-		return -ERESTARTSYS;
+	if (!ring_mapping_supported(engine))
+		return -ENODEV;
+
+	mutex_lock(&(lro_char->device_mutex));
+	rc = qrandom_ring_may_map(xfile->exclusive, lro_char->users,
+				  lro->hwrng != NULL);
+	mutex_unlock(&(lro_char->device_mutex));
+	if (rc)
+		return rc;
+
+	/* the engine owns both buffers, userspace only looks */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 3, 0)
+	vma->vm_flags &= ~VM_MAYWRITE;
+#else
+	vm_flags_clear(vma, VM_MAYWRITE);
+#endif
+
+	if (offset == ring_result_offset(engine)) {
+		if (size > PAGE_ALIGN(rx_result_buffer_size(&engine->rx_ring)))
+			return -EINVAL;
+		/* offset of the mapping within the coherent buffer */
+		vma->vm_pgoff = 0;
+		return dma_mmap_coherent(&lro->pci_dev->dev, vma,
+					 engine->rx_result_buffer_virt,
+					 engine->rx_result_buffer_bus, size);
 	}
 
-	rc = char_sgdma_read_write(file, (char __user *)buf, count, pos, 1);
+	if (offset + size > ring_result_offset(engine))
+		return -EINVAL;
 
-	mutex_unlock(&(lro_char->device_mutex));
+	/* rvmalloc()ed pages are reserved, map them one by one */
+	pos = (char *)engine->rx_buffer + offset;
+	while (size > 0) {
+		if (remap_pfn_range(vma, start, vmalloc_to_pfn(pos), PAGE_SIZE,
+				    vma->vm_page_prot))
+			return -EAGAIN;
+		start += PAGE_SIZE;
+		pos += PAGE_SIZE;
+		size -= PAGE_SIZE;
+	}
 
-	return rc;
+	return 0;
+}
+
+/*
+ * The AXI-ST C2H file is readable while the rx ring has ready blocks or the
+ * fifo of the file holds bytes. The interrupt handler wakes the pollers on
+ * the wait queue of the cyclic transfer. Other engines transfer on demand
+ * and never wait for data.
+ */
+static __poll_t char_sgdma_poll(struct file *file, poll_table *wait)
+{
+	struct xdma_file *xfile = file->private_data;
+	struct xdma_engine *engine;
+	__poll_t mask = 0;
+
+	engine = xfile->lro_char->engine;
+	BUG_ON(!engine);
+	BUG_ON(engine->magic != MAGIC_ENGINE);
+
+	if (!engine_is_cyclic(engine)) {
+		if (engine->dir_to_dev)
+			return EPOLLOUT | EPOLLWRNORM;
+		return EPOLLIN | EPOLLRDNORM;
+	}
+
+	poll_wait(file, &engine->rx_transfer_cyclic->wq, wait);
+
+	/* in poll mode, nothing services the engine but its readers */
+	if (poll_mode) {
+		spin_lock(&engine->lock);
+		engine_ring_process(engine);
+		spin_unlock(&engine->lock);
+	}
+
+	if (qrandom_ring_available(&engine->rx_ring) > 0)
+		mask |= EPOLLIN | EPOLLRDNORM;
+#if USE_FIFO
+	if (!kfifo_is_empty(&xfile->remaining_bytes) &&
+	    !READ_ONCE(xfile->fifo_reset))
+		mask |= EPOLLIN | EPOLLRDNORM;
+#endif
+
+	/* and no interrupt wakes the queue: check the ring again shortly */
+	if (poll_mode && mask == 0)
+		mod_timer(&engine->rx_poll_timer,
+			  jiffies + msecs_to_jiffies(RX_POLL_INTERVAL_MS));
+
+	return mask;
+}
+
+/* sg_write() -- Write to the device
+ *
+ * @buf userspace buffer
+ * @count number of bytes in the userspace buffer
+ * @pos byte-address in device
+ */
+static ssize_t char_sgdma_write(struct file *file, const char __user *buf,
+				size_t count, loff_t *pos)
+{
+	ssize_t rc;
+	struct xdma_dev *lro;
+	struct xdma_char *lro_char = file_char(file);
+	BUG_ON(!lro_char);
+	BUG_ON(lro_char->magic != MAGIC_CHAR);
+	lro = lro_char->lro;
+	BUG_ON(!lro);
+	BUG_ON(lro->magic != MAGIC_DEVICE);
+
+	if (mutex_lock_interruptible(&(lro_char->device_mutex))) {
+		return -ERESTARTSYS;
+	}
+
+	rc = char_sgdma_read_write(file, (char __user *)buf, count, pos, 1);
+
+	mutex_unlock(&(lro_char->device_mutex));
+
+	return rc;
 }
 /* char_xdma_throw_garbage() - read and throw away bytes from the card
  *
@@ -3456,12 +3901,34 @@ static ssize_t char_sgdma_read(struct file *file, char __user *buf,
 	ssize_t ret_sz;
 
 	struct xdma_dev *lro;
-	struct xdma_char *lro_char = (struct xdma_char *)file->private_data;
+	struct xdma_file *xfile = file->private_data;
+	struct xdma_char *lro_char = file_char(file);
 	BUG_ON(!lro_char);
 	BUG_ON(lro_char->magic != MAGIC_CHAR);
 	lro = lro_char->lro;
 	BUG_ON(!lro);
 	BUG_ON(lro->magic != MAGIC_DEVICE);
+	BUG_ON(!lro_char->engine);
+
+	/*
+	 * AXI-ST C2H: readers of different files only share the rx ring,
+	 * the device mutex is not held while they wait and copy.
+	 */
+	if (engine_is_cyclic(lro_char->engine)) {
+		bool nonblock = file->f_flags & O_NONBLOCK;
+
+		ret_sz = cyclic_skip_garbage(lro_char, nonblock);
+		if (ret_sz)
+			return ret_sz;
+
+		ret_sz = read_mutex_lock(xfile, nonblock);
+		if (ret_sz)
+			return ret_sz;
+		ret_sz = char_xdma_read(file, buf, count, pos);
+		mutex_unlock(&xfile->read_mutex);
+
+		return ret_sz;
+	}
 
 	if (mutex_lock_interruptible(&(lro_char->device_mutex))) {
 		return -ERESTARTSYS;
@@ -3509,13 +3976,14 @@ static ssize_t char_xdma_read(struct file *file, char __user *buf, size_t count,
 			      loff_t *pos)
 {
 	int rc_len;
+	struct xdma_file *xfile = file->private_data;
 	struct xdma_char *lro_char;
 	struct xdma_dev *lro;
 	struct xdma_engine *engine;
 	unsigned int fifo_copied = 0;
 
 	/* fetch device specific data stored earlier during open */
-	lro_char = (struct xdma_char *)file->private_data;
+	lro_char = file_char(file);
 	BUG_ON(!lro_char);
 	BUG_ON(lro_char->magic != MAGIC_CHAR);
 
@@ -3529,16 +3997,20 @@ static ssize_t char_xdma_read(struct file *file, char __user *buf, size_t count,
 	BUG_ON(engine->magic != MAGIC_ENGINE);
 
 #if USE_FIFO
-	rc_len = kfifo_to_user(&lro->remaining_bytes, buf, count, &fifo_copied);
+	fifo_reset_pending(xfile);
+	rc_len = kfifo_to_user(&xfile->remaining_bytes, buf, count,
+			       &fifo_copied);
 	if (rc_len < 0) {
 		return rc_len;
 	}
 #endif
 	if (count - fifo_copied > 0) {
-		if (!engine->dir_to_dev && engine->rx_buffer &&
-		    engine->rx_transfer_cyclic) {
+		if (engine_is_cyclic(engine)) {
 			rc_len = char_sgdma_read_cyclic(file, buf + fifo_copied,
 							count - fifo_copied);
+			/* a nonblocking read returns what the fifo held */
+			if (rc_len == -EAGAIN && fifo_copied > 0)
+				rc_len = 0;
 
 		} else {
 			rc_len = char_sgdma_read_write(file, buf + fifo_copied,
@@ -3552,110 +4024,177 @@ static ssize_t char_xdma_read(struct file *file, char __user *buf, size_t count,
 	return rc_len;
 }
 
+/* bytes of the rx ring and of its result array */
+static size_t rx_buffer_size(const struct qrandom_ring *ring)
+{
+	return (size_t)ring->blocks * ring->block_size;
+}
+
+static size_t rx_result_buffer_size(const struct qrandom_ring *ring)
+{
+	return (size_t)ring->blocks * sizeof(struct xdma_result);
+}
+
+/*
+ * Called on the first open, under the device mutex. The buffers are
+ * allocated, and may sleep, before the engine lock is taken: nothing
+ * services the ring until the cyclic transfer is queued.
+ */
 static int cyclic_transfer_setup(struct xdma_engine *engine)
 {
 	int rc;
 	struct xdma_dev *lro;
+	struct qrandom_ring ring;
+	struct xdma_transfer *transfer;
+	void *rx_buffer;
+	u8 *rx_result_buffer_virt;
+	dma_addr_t rx_result_buffer_bus;
+	u8 *rx_ring_done;
+	u32 blocks;
+	u32 credits;
 	u32 w = XDMA_DESC_EOP | XDMA_DESC_COMPLETED;
 
 	BUG_ON(!engine);
 	lro = engine->lro;
 	BUG_ON(!lro);
 
-	spin_lock(&engine->lock);
+	/* the parameters are writable in sysfs, read each of them once */
+	blocks = READ_ONCE(rx_ring_blocks);
+	if (blocks < 2 || blocks > RX_RING_MAX_BLOCKS) {
+		printk("rx_ring_blocks must be between 2 and %u\n",
+		       RX_RING_MAX_BLOCKS);
+		return -EINVAL;
+	}
+	credits = clamp_t(u32, READ_ONCE(rx_initial_credits), 1, blocks);
 
-	if (engine->rx_buffer) {
+	if (READ_ONCE(engine->rx_buffer)) {
 		dbg_tfr("Channel already open, cannot open twice\n");
-		spin_unlock(&engine->lock);
 		return -EBUSY;
 	}
 
-	engine->rx_tail = 0;
-	engine->rx_head = 0;
-	engine->rx_overrun = 0;
-	engine->eop_found = 0;
-	engine->user_buffer_index = 0;
-
-	engine->rx_buffer = rvmalloc(RX_BUF_SIZE);
-	if (engine->rx_buffer == NULL) {
-		dbg_tfr("rvmalloc(%d) failed\n", RX_BUF_SIZE);
-		spin_unlock(&engine->lock);
+	rx_ring_done = kcalloc(blocks, sizeof(u8), GFP_KERNEL);
+	if (rx_ring_done == NULL)
 		return -ENOMEM;
+	qrandom_ring_init(&ring, blocks, RX_BUF_BLOCK, rx_ring_done);
+
+	rx_buffer = rvmalloc(rx_buffer_size(&ring));
+	if (rx_buffer == NULL) {
+		dbg_tfr("rvmalloc(%zu) failed\n", rx_buffer_size(&ring));
+		rc = -ENOMEM;
+		goto fail_buffer;
 	}
 
-	dbg_init("engine->rx_buffer = %p\n", engine->rx_buffer);
-	engine->rx_transfer_cyclic =
-		transfer_create(lro, engine->rx_buffer, RX_BUF_SIZE, 0,
-				engine->dir_to_dev, 0, 1, 0);
-	if (engine->rx_buffer == NULL) {
-		dbg_tfr("transfer_create(%d) failed\n", RX_BUF_SIZE);
+	dbg_init("rx_buffer = %p\n", rx_buffer);
+	transfer = transfer_create(lro, rx_buffer, rx_buffer_size(&ring), 0,
+				   engine->dir_to_dev, 0, 1, 0);
+	if (transfer == NULL) {
+		dbg_tfr("transfer_create(%zu) failed\n", rx_buffer_size(&ring));
 		rc = -EINVAL;
 		goto fail_transfer;
 	}
 
-	// TODO: add conditional compilation
-	/*
-	engine->rx_result_buffer_virt =
-		pci_alloc_consistent(lro->pci_dev, RX_RESULT_BUF_SIZE,
-				     &engine->rx_result_buffer_bus);
-
-	if (engine->rx_result_buffer_virt == NULL) {
-		dbg_tfr("pci_alloc_consistent(%d) failed\n", RX_BUF_SIZE);
-		rc = -ENOMEM;
-		goto fail_result_buffer;
-	}*/
-
-	engine->rx_result_buffer_virt =
-		dma_alloc_coherent(&lro->pci_dev->dev, RX_RESULT_BUF_SIZE,
-				&engine->rx_result_buffer_bus, GFP_KERNEL);
-
-	if (engine->rx_result_buffer_virt == NULL) {
-		dbg_tfr("dma_alloc_coherent(%d) failed\n", RX_BUF_SIZE);
+	rx_result_buffer_virt =
+		dma_alloc_coherent(&lro->pci_dev->dev,
+				   rx_result_buffer_size(&ring),
+				   &rx_result_buffer_bus, GFP_KERNEL);
+	if (rx_result_buffer_virt == NULL) {
+		dbg_tfr("dma_alloc_coherent(%zu) failed\n",
+			rx_result_buffer_size(&ring));
 		rc = -ENOMEM;
 		goto fail_result_buffer;
 	}
 
-
-
-	dbg_init("engine->rx_result_buffer_virt = %p\n",
-		 engine->rx_result_buffer_virt);
-	dbg_init("engine->rx_result_buffer_bus = 0x%016llx\n",
-		 engine->rx_result_buffer_bus);
+	dbg_init("rx_result_buffer_virt = %p\n", rx_result_buffer_virt);
+	dbg_init("rx_result_buffer_bus = 0x%016llx\n",
+		 (u64)rx_result_buffer_bus);
 	/* replace source addresses with result write-back addresses */
-	transfer_set_result_addresses(engine->rx_transfer_cyclic,
-				      engine->rx_result_buffer_bus);
+	transfer_set_result_addresses(transfer, rx_result_buffer_bus);
 	/* set control of all descriptors */
-	transfer_set_all_control(engine->rx_transfer_cyclic, w);
+	transfer_set_all_control(transfer, w);
 	/* make this a cyclic transfer */
-	xdma_transfer_cyclic(engine->rx_transfer_cyclic);
-	transfer_dump(engine->rx_transfer_cyclic);
+	xdma_transfer_cyclic(transfer);
+	transfer_dump(transfer);
 
+	spin_lock(&engine->lock);
+	/* the statistics of the previous opens are kept */
+	ring.high_water = engine->rx_ring.high_water;
+	ring.overruns = engine->rx_ring.overruns;
+	ring.served = engine->rx_ring.served;
+	engine->rx_ring = ring;
+	engine->rx_buffer = rx_buffer;
+	engine->rx_transfer_cyclic = transfer;
+	engine->rx_result_buffer_virt = rx_result_buffer_virt;
+	engine->rx_result_buffer_bus = rx_result_buffer_bus;
 	spin_unlock(&engine->lock);
 
 	/* write initial credits */
-	if (enable_credit_mp) {
-		//iowrite32(RX_BUF_PAGES,&engine->sgdma_regs->credits);
-		iowrite32(128, &engine->sgdma_regs->credits);
-	}
+	if (enable_credit_mp)
+		iowrite32(credits, &engine->sgdma_regs->credits);
 
 	/* start cyclic transfer */
-	if (engine->rx_transfer_cyclic)
-		transfer_queue(engine, engine->rx_transfer_cyclic);
+	transfer_queue(engine, engine->rx_transfer_cyclic);
 
 	return 0;
 
 	/* unwind on errors */
 fail_result_buffer:
-	transfer_destroy(engine->lro, engine->rx_transfer_cyclic);
-	engine->rx_transfer_cyclic = NULL;
+	transfer_destroy(lro, transfer);
 fail_transfer:
-	rvfree(engine->rx_buffer, RX_BUF_SIZE);
-	engine->rx_buffer = NULL;
-	spin_unlock(&engine->lock);
+	rvfree(rx_buffer, rx_buffer_size(&ring));
+fail_buffer:
+	kfree(rx_ring_done);
+	return rc;
+}
+
+static void xdma_file_init(struct xdma_file *xfile, struct xdma_char *lro_char)
+{
+	xfile->lro_char = lro_char;
+	mutex_init(&xfile->read_mutex);
+#if USE_FIFO
+	INIT_KFIFO(xfile->remaining_bytes);
+#endif
+}
+
+/*
+ * A new user of the device, an open file or the hwrng. The first user of
+ * an AXI ST C2H device sets up the rx ring. Called with the device mutex.
+ */
+static int char_get(struct xdma_char *lro_char)
+{
+	struct xdma_engine *engine = lro_char->engine;
+	int rc = 0;
+
+	BUG_ON(!engine);
+	BUG_ON(engine->magic != MAGIC_ENGINE);
+
+	lro_char->users += 1;
+
+	/* AXI ST C2H? Set up RX ring buffer on host with a cyclic transfer */
+	if (lro_char->users == 1 && engine->streaming && !engine->dir_to_dev)
+		rc = cyclic_transfer_setup(engine);
+
+	if (rc)
+		lro_char->users -= 1;
 
 	return rc;
 }
 
+/* the last user tears the rx ring down, called with the device mutex */
+static int char_put(struct xdma_char *lro_char)
+{
+	struct xdma_engine *engine = lro_char->engine;
+
+	BUG_ON(!engine);
+	BUG_ON(engine->magic != MAGIC_ENGINE);
+
+	lro_char->users -= 1;
+
+	if (lro_char->users == 0 && engine->streaming && !engine->dir_to_dev)
+		return cyclic_transfer_teardown(engine);
+
+	return 0;
+}
+
 /*
  * Called when the device goes from unused to used.
  */
@@ -3664,7 +4203,7 @@ static int char_sgdma_open(struct inode *inode, struct file *file)
 	int rc = 0;
 	struct xdma_dev *lro;
 	struct xdma_char *lro_char;
-	struct xdma_engine *engine;
+	struct xdma_file *xfile;
 
 	/* pointer to containing structure of the character device inode */
 	lro_char = container_of(inode->i_cdev, struct xdma_char, cdev);
@@ -3673,24 +4212,33 @@ static int char_sgdma_open(struct inode *inode, struct file *file)
 	lro = lro_char->lro;
 	BUG_ON(!lro);
 
+	xfile = kzalloc(sizeof(*xfile), GFP_KERNEL);
+	if (!xfile)
+		return -ENOMEM;
+	xdma_file_init(xfile, lro_char);
+
 	if (mutex_lock_interruptible(&(lro_char->device_mutex))) {
+		kfree(xfile);
 		return -ERESTARTSYS;
 	}
 
 	/* create a reference to our char device in the opened file */
-	file->private_data = lro_char;
-
-	engine = lro_char->engine;
-	BUG_ON(!engine);
-	BUG_ON(engine->magic != MAGIC_ENGINE);
+	file->private_data = xfile;
 
 	dbg_tfr("char_sgdma_open(0x%p, 0x%p)\n", inode, file);
 
-	lro_char->users += 1;
-
-	/* AXI ST C2H? Set up RX ring buffer on host with a cyclic transfer */
-	if (lro_char->users == 1 && engine->streaming && !engine->dir_to_dev)
-		rc = cyclic_transfer_setup(engine);
+	/* O_EXCL asks for the device alone, to map the rx ring */
+	xfile->exclusive = (file->f_flags & O_EXCL) != 0;
+	rc = qrandom_ring_may_open(lro_char->exclusive, lro_char->users,
+				   lro->hwrng != NULL, xfile->exclusive);
+	if (!rc)
+		rc = char_get(lro_char);
+	if (rc) {
+		file->private_data = NULL;
+		kfree(xfile);
+	} else if (xfile->exclusive) {
+		lro_char->exclusive = true;
+	}
 
 	mutex_unlock(&(lro_char->device_mutex));
 
@@ -3751,6 +4299,9 @@ static int cyclic_transfer_teardown(struct xdma_engine *engine)
 	int rc;
 	struct xdma_dev *lro;
 	struct xdma_transfer *transfer;
+	void *rx_buffer;
+	u8 *rx_result_buffer_virt;
+	u8 *rx_ring_done;
 
 	BUG_ON(!engine);
 	lro = engine->lro;
@@ -3777,39 +4328,33 @@ static int cyclic_transfer_teardown(struct xdma_engine *engine)
 	else
 		rc = cyclic_shutdown_interrupt(engine);
 
-	/* obtain spin lock to atomically remove resources */
-	spin_lock(&engine->lock);
+	/* no file is left to poll, a pending wake up uses the transfer */
+	timer_delete_sync(&engine->rx_poll_timer);
 
-	if (engine->rx_transfer_cyclic) {
-		transfer_destroy(engine->lro, engine->rx_transfer_cyclic);
-		engine->rx_transfer_cyclic = NULL;
-	}
-	if (engine->rx_buffer) {
-		rvfree(engine->rx_buffer, RX_BUF_SIZE);
-		engine->rx_buffer = NULL;
-	}
-
-	// TODO: add conditional compilation
-	/*
-	if (engine->rx_result_buffer_virt) {
+	/* detach the resources atomically, then free them without the lock */
+	spin_lock(&engine->lock);
+	transfer = engine->rx_transfer_cyclic;
+	rx_buffer = engine->rx_buffer;
+	rx_result_buffer_virt = engine->rx_result_buffer_virt;
+	rx_ring_done = engine->rx_ring.done;
+	engine->rx_transfer_cyclic = NULL;
+	engine->rx_buffer = NULL;
+	engine->rx_result_buffer_virt = NULL;
+	engine->rx_ring.done = NULL;
+	spin_unlock(&engine->lock);
 
-		pci_free_consistent(lro->pci_dev, RX_RESULT_BUF_SIZE,
-				    engine->rx_result_buffer_virt,
-				    engine->rx_result_buffer_bus);
-		engine->rx_result_buffer_virt = NULL;
-	}*/
-	if (engine->rx_result_buffer_virt) {
+	if (transfer)
+		transfer_destroy(lro, transfer);
+	rvfree(rx_buffer, rx_buffer_size(&engine->rx_ring));
+	kfree(rx_ring_done);
+	if (rx_result_buffer_virt) {
 		/* free contiguous list */
-		dma_free_coherent(&lro->pci_dev->dev, RX_RESULT_BUF_SIZE,
-					engine->rx_result_buffer_virt,
-					engine->rx_result_buffer_bus);
-		engine->rx_result_buffer_virt = NULL;
+		dma_free_coherent(&lro->pci_dev->dev,
+				  rx_result_buffer_size(&engine->rx_ring),
+				  rx_result_buffer_virt,
+				  engine->rx_result_buffer_bus);
 	}
 
-
-
-	spin_unlock(&engine->lock);
-
 	return rc;
 }
 
@@ -3819,8 +4364,8 @@ static int cyclic_transfer_teardown(struct xdma_engine *engine)
 static int char_sgdma_close(struct inode *inode, struct file *file)
 {
 	struct xdma_dev *lro;
-	struct xdma_char *lro_char = (struct xdma_char *)file->private_data;
-	struct xdma_engine *engine;
+	struct xdma_file *xfile = file->private_data;
+	struct xdma_char *lro_char = file_char(file);
 	int rc = 0;
 
 	BUG_ON(!lro_char);
@@ -3830,27 +4375,171 @@ static int char_sgdma_close(struct inode *inode, struct file *file)
 	BUG_ON(!lro);
 	BUG_ON(lro->magic != MAGIC_DEVICE);
 
-	if (mutex_lock_interruptible(&(lro_char->device_mutex))) {
-		return -ERESTARTSYS;
-	}
+	/* release() is not restarted, the file must be let go of */
+	mutex_lock(&(lro_char->device_mutex));
 
-	lro_char->users -= 1;
+	dbg_tfr("char_sgdma_close(0x%p, 0x%p)\n", inode, file);
 
-	/* fetch device specific data stored earlier during open */
-	engine = lro_char->engine;
-	BUG_ON(!engine);
-	BUG_ON(engine->magic != MAGIC_ENGINE);
+	/* give back the blocks a zero-copy reader did not release */
+	if (xfile->ring_count > 0)
+		ring_release(xfile, xfile->ring_count);
 
-	dbg_tfr("char_sgdma_close(0x%p, 0x%p)\n", inode, file);
+	if (xfile->exclusive)
+		lro_char->exclusive = false;
+	rc = char_put(lro_char);
 
-	if (lro_char->users == 0 && engine->streaming && !engine->dir_to_dev)
-		rc = cyclic_transfer_teardown(engine);
+	mutex_unlock(&(lro_char->device_mutex));
+	kfree(xfile);
+
+	return rc;
+}
+
+#if IS_ENABLED(CONFIG_HW_RANDOM)
+/* longest wait of a blocking hwrng read, the hwrng core retries later */
+#define XDMA_HWRNG_WAIT (HZ / 10)
+
+static struct xdma_hwrng *to_xdma_hwrng(struct hwrng *rng)
+{
+	return container_of(rng, struct xdma_hwrng, rng);
+}
 
+/* the hwrng is a user of the C2H device while it is the current rng */
+static int xdma_hwrng_init(struct hwrng *rng)
+{
+	struct xdma_char *lro_char = to_xdma_hwrng(rng)->xfile.lro_char;
+	int rc;
+
+	/* no bytes for the kernel while a file may map the ring */
+	mutex_lock(&(lro_char->device_mutex));
+	rc = lro_char->exclusive ? -EBUSY : char_get(lro_char);
 	mutex_unlock(&(lro_char->device_mutex));
 
 	return rc;
 }
 
+static void xdma_hwrng_cleanup(struct hwrng *rng)
+{
+	struct xdma_hwrng *hwrng = to_xdma_hwrng(rng);
+	struct xdma_char *lro_char = hwrng->xfile.lro_char;
+
+	mutex_lock(&(lro_char->device_mutex));
+	char_put(lro_char);
+	mutex_unlock(&(lro_char->device_mutex));
+#if USE_FIFO
+	kfifo_reset(&hwrng->xfile.remaining_bytes);
+#endif
+}
+
+/*
+ * Serves the bytes the fifo of the hwrng kept, then the rx ring, like a
+ * read() of an open file. The ring is never waited for without a bound:
+ * hwrng_unregister() waits for a blocking read of the hwrng core to end,
+ * which must not depend on the engine producing. Returns 0 when nothing is
+ * ready, the hwrng core tries again later.
+ */
+static int xdma_hwrng_read(struct hwrng *rng, void *data, size_t max,
+			   bool wait)
+{
+	struct xdma_hwrng *hwrng = to_xdma_hwrng(rng);
+	struct xdma_file *xfile = &hwrng->xfile;
+	struct xdma_char *lro_char = xfile->lro_char;
+	struct xdma_engine *engine = lro_char->engine;
+	struct cyclic_dest dest = {
+		.xfile = xfile,
+	};
+	size_t copied = 0;
+	int rc;
+
+	if (wait && !poll_mode)
+		wait_event_interruptible_timeout(
+			engine->rx_transfer_cyclic->wq,
+			qrandom_ring_available(&engine->rx_ring) > 0,
+			XDMA_HWRNG_WAIT);
+
+	rc = cyclic_skip_garbage(lro_char, true);
+	if (rc)
+		return rc == -EAGAIN ? 0 : rc;
+
+	mutex_lock(&xfile->read_mutex);
+#if USE_FIFO
+	copied = kfifo_out(&xfile->remaining_bytes, (char *)data, max);
+#endif
+	if (copied < max) {
+		dest.kernel = (char *)data + copied;
+		rc = read_cyclic(&dest, engine, max - copied, true);
+		if (rc > 0)
+			copied += rc;
+	}
+	mutex_unlock(&xfile->read_mutex);
+
+	/* the bytes already taken are returned before an error */
+	if (copied)
+		return copied;
+	return rc == -EAGAIN ? 0 : rc;
+}
+
+/*
+ * Registers the first C2H stream of the card with the hwrng framework if
+ * enable_hwrng is set. The card works without it, so a failure is only
+ * reported.
+ */
+static void xdma_hwrng_register(struct xdma_dev *lro)
+{
+	struct xdma_char *lro_char = lro->sgdma_char_dev[0][1];
+	struct xdma_hwrng *hwrng;
+	int rc;
+
+	if (!enable_hwrng)
+		return;
+	if (!lro_char || !lro_char->engine->streaming) {
+		printk("quantis%d: no C2H stream to feed the hwrng\n",
+		       lro->instance + device_file_first_index);
+		return;
+	}
+
+	hwrng = kzalloc(sizeof(*hwrng), GFP_KERNEL);
+	if (!hwrng)
+		return;
+	xdma_file_init(&hwrng->xfile, lro_char);
+	snprintf(hwrng->name, sizeof(hwrng->name), "quantis%d",
+		 lro->instance + device_file_first_index);
+	hwrng->rng.name = hwrng->name;
+	hwrng->rng.init = xdma_hwrng_init;
+	hwrng->rng.cleanup = xdma_hwrng_cleanup;
+	hwrng->rng.read = xdma_hwrng_read;
+	hwrng->rng.quality = hwrng_quality;
+
+	rc = hwrng_register(&hwrng->rng);
+	if (rc) {
+		printk("quantis%d: hwrng_register() = %d\n",
+		       lro->instance + device_file_first_index, rc);
+		kfree(hwrng);
+		return;
+	}
+	lro->hwrng = hwrng;
+}
+
+static void xdma_hwrng_unregister(struct xdma_dev *lro)
+{
+	if (!lro->hwrng)
+		return;
+
+	hwrng_unregister(&lro->hwrng->rng);
+	kfree(lro->hwrng);
+	lro->hwrng = NULL;
+}
+#else
+static void xdma_hwrng_register(struct xdma_dev *lro)
+{
+	if (enable_hwrng)
+		printk("enable_hwrng needs a kernel with CONFIG_HW_RANDOM\n");
+}
+
+static void xdma_hwrng_unregister(struct xdma_dev *lro)
+{
+}
+#endif
+
 /*
  * RTO - code to detect if MSI/MSI-X capability exists is derived
  * from linux/pci/msi.c - pci_msi_check_device
@@ -3899,9 +4588,6 @@ static struct xdma_dev *alloc_dev_instance(struct pci_dev *pdev)
 		dbg_init("Could not kzalloc(xdma_dev).\n");
 		return NULL;
 	}
-#if USE_FIFO
-	INIT_KFIFO(lro->remaining_bytes);
-#endif
 	lro->magic = MAGIC_DEVICE;
 	lro->config_bar_idx = -1;
 	lro->user_bar_idx = -1;
@@ -4595,6 +5281,9 @@ static int probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	/* Flush writes */
 	read_interrupts(lro);
 
+	/* needs the engine interrupts to read the C2H stream */
+	xdma_hwrng_register(lro);
+
 	if (rc == 0)
 		return 0;
 
@@ -4647,6 +5336,8 @@ static void remove(struct pci_dev *pdev)
 		       (unsigned long)lro->pci_dev, (unsigned long)pdev);
 	}
 
+	xdma_hwrng_unregister(lro);
+
 	channel_interrupts_disable(lro, ~0);
 	user_interrupts_disable(lro, ~0);
 	read_interrupts(lro);
@@ -4682,8 +5373,11 @@ static int destroy_sg_char(struct xdma_char *lro_char)
 	BUG_ON(!lro_char->lro);
 	BUG_ON(!g_xdma_class);
 
-	if (lro_char->sys_device)
+	if (lro_char->sys_device) {
+		if (char_has_rx_ring(lro_char))
+			remove_rx_ring_files(lro_char->sys_device);
 		device_destroy(g_xdma_class, lro_char->cdevno);
+	}
 
 	cdev_del(&lro_char->cdev);
 	unregister_chrdev_region(lro_char->cdevno, 1);
@@ -4757,6 +5451,84 @@ static int config_kobject(struct xdma_char *lro_char, enum chardev_type type)
 	return rc;
 }
 
+/*
+ * Statistics of the rx ring in sysfs, next to the C2H device files. They
+ * cover every open of the device since the driver was loaded, see
+ * cyclic_transfer_setup().
+ */
+static bool char_has_rx_ring(struct xdma_char *lro_char)
+{
+	return lro_char->engine && !lro_char->engine->dir_to_dev;
+}
+
+static struct qrandom_ring rx_ring_snapshot(struct device *dev)
+{
+	struct xdma_char *lro_char = dev_get_drvdata(dev);
+	struct xdma_engine *engine = lro_char->engine;
+	struct qrandom_ring ring;
+
+	spin_lock(&engine->lock);
+	ring = engine->rx_ring;
+	spin_unlock(&engine->lock);
+
+	return ring;
+}
+
+static ssize_t rx_ring_high_water_show(struct device *dev,
+				       struct device_attribute *attr,
+				       char *buf)
+{
+	return sprintf(buf, "%u\n", rx_ring_snapshot(dev).high_water);
+}
+
+static ssize_t rx_ring_overruns_show(struct device *dev,
+				     struct device_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", rx_ring_snapshot(dev).overruns);
+}
+
+static ssize_t rx_bytes_served_show(struct device *dev,
+				    struct device_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long)rx_ring_snapshot(dev).served);
+}
+
+static DEVICE_ATTR(rx_ring_high_water, S_IRUGO, rx_ring_high_water_show,
+		   NULL);
+static DEVICE_ATTR(rx_ring_overruns, S_IRUGO, rx_ring_overruns_show, NULL);
+static DEVICE_ATTR(rx_bytes_served, S_IRUGO, rx_bytes_served_show, NULL);
+
+static int create_rx_ring_files(struct device *dev)
+{
+	int rc;
+
+	rc = device_create_file(dev, &dev_attr_rx_ring_high_water);
+	if (rc)
+		return rc;
+	rc = device_create_file(dev, &dev_attr_rx_ring_overruns);
+	if (rc)
+		goto fail_overruns;
+	rc = device_create_file(dev, &dev_attr_rx_bytes_served);
+	if (rc)
+		goto fail_served;
+
+	return 0;
+
+fail_served:
+	device_remove_file(dev, &dev_attr_rx_ring_overruns);
+fail_overruns:
+	device_remove_file(dev, &dev_attr_rx_ring_high_water);
+	return rc;
+}
+
+static void remove_rx_ring_files(struct device *dev)
+{
+	device_remove_file(dev, &dev_attr_rx_bytes_served);
+	device_remove_file(dev, &dev_attr_rx_ring_overruns);
+	device_remove_file(dev, &dev_attr_rx_ring_high_water);
+}
+
 static int create_dev(struct xdma_char *lro_char, enum chardev_type type)
 {
 	struct xdma_dev *lro;
@@ -4772,12 +5544,21 @@ static int create_dev(struct xdma_char *lro_char, enum chardev_type type)
 
 	lro_char->sys_device =
 		device_create(g_xdma_class, &lro->pci_dev->dev,
-			      lro_char->cdevno, NULL, devnode_names[type],
+			      lro_char->cdevno, lro_char, devnode_names[type],
 			      lro->instance + device_file_first_index,
 			      engine ? engine->channel : 0);
 	if (!lro_char->sys_device) {
 		dbg_init("device_create(%s) failed\n", devnode_names[type]);
-		rc = -1;
+		return -1;
+	}
+
+	if (char_has_rx_ring(lro_char)) {
+		rc = create_rx_ring_files(lro_char->sys_device);
+		if (rc) {
+			dbg_init("create_rx_ring_files() = %d\n", rc);
+			device_destroy(g_xdma_class, lro_char->cdevno);
+			lro_char->sys_device = NULL;
+		}
 	}
 
 	return rc;
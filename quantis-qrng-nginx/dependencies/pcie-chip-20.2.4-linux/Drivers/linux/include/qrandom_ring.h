@@ -0,0 +1,325 @@
+/*
+ * Book keeping of the C2H cyclic rx ring
+ *
+ * The C2H engine fills the rx ring one block at a time and writes a
+ * struct xdma_result for each block. With the credit feature enabled,
+ * the engine only fills a block once the host gave it a credit for it.
+ *
+ * A block is in one of three states:
+ *   ready   - completed by the engine, from head to tail
+ *   claimed - handed out to a reader, from released to head
+ *   free    - owned by the engine, from tail to released
+ *
+ * Readers claim blocks at the head and release them in any order, the
+ * blocks at the released end go back to the engine once they are done.
+ *
+ * The statistics at the end of struct qrandom_ring are kept when the ring
+ * is initialized again, so they cover every use of the engine until
+ * qrandom_ring_reset_stats().
+ *
+ * Nothing here touches the hardware or sleeps, the caller holds the engine
+ * lock. This header does not depend on the rest of the driver so the ring
+ * simulator (see sim/qrandom_ring_sim.c) builds it in userspace.
+ */
+
+#ifndef QRANDOM_RING_H
+#define QRANDOM_RING_H
+
+#ifdef __KERNEL__
+#include <linux/errno.h>
+#include <linux/string.h>
+#include <linux/types.h>
+#else
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+#define __packed __attribute__((packed))
+#endif
+
+#define RX_STATUS_EOP (1)
+
+/* magic in the upper 16 bits of a valid result status */
+#define C2H_WB 0x52B4UL
+
+/* 32 bytes (four 32-bit words) or 64 bytes (eight 32-bit words) */
+struct xdma_result {
+	u32 status;
+	u32 length;
+	u32 reserved_1[6]; /* padding */
+} __packed;
+
+struct qrandom_ring {
+	u32 blocks; /* number of blocks in the ring */
+	u32 block_size; /* bytes per block */
+	u32 tail; /* next block completed by the engine */
+	u32 head; /* next block handed out to a reader */
+	u32 released; /* oldest claimed block */
+	u32 ready; /* number of blocks from head to tail */
+	u32 claimed; /* number of blocks from released to head */
+	int overrun; /* flag if the engine wrote a claimed block */
+	u8 *done; /* one flag per block, set when its reader released it */
+
+	/* statistics */
+	u32 high_water; /* most blocks ready at once */
+	u32 overruns; /* times the engine caught up with the readers */
+	u64 served; /* payload bytes handed out to readers */
+};
+
+static inline u32 qrandom_ring_next(const struct qrandom_ring *ring, u32 block,
+				    u32 n)
+{
+	return (block + n) % ring->blocks;
+}
+
+/* @done holds @blocks flags, it is owned by the caller */
+static inline void qrandom_ring_init(struct qrandom_ring *ring, u32 blocks,
+				     u32 block_size, u8 *done)
+{
+	ring->blocks = blocks;
+	ring->block_size = block_size;
+	ring->tail = 0;
+	ring->head = 0;
+	ring->released = 0;
+	ring->ready = 0;
+	ring->claimed = 0;
+	ring->overrun = 0;
+	ring->done = done;
+	memset(done, 0, blocks);
+}
+
+static inline void qrandom_ring_reset_stats(struct qrandom_ring *ring)
+{
+	ring->high_water = 0;
+	ring->overruns = 0;
+	ring->served = 0;
+}
+
+/* number of blocks a reader can claim */
+static inline u32 qrandom_ring_available(const struct qrandom_ring *ring)
+{
+	return ring->ready;
+}
+
+/*
+ * Accounts the block at the tail as completed by the engine.
+ *
+ * Returns 0 when every block is already ready or claimed. The block at the
+ * tail is then the oldest claimed one, if any, whose result was cleared by
+ * the claim: the engine wrote a block a reader still owns, which it only
+ * does without credit control.
+ */
+static inline int qrandom_ring_produce(struct qrandom_ring *ring)
+{
+	if (ring->ready + ring->claimed == ring->blocks) {
+		if (ring->claimed > 0 && !ring->overrun) {
+			ring->overrun = 1;
+			ring->overruns++;
+		}
+		return 0;
+	}
+
+	ring->tail = qrandom_ring_next(ring, ring->tail, 1);
+	ring->ready++;
+	if (ring->ready > ring->high_water)
+		ring->high_water = ring->ready;
+
+	return 1;
+}
+
+/* payload length of a completed block, -EIO if its result is not valid */
+static inline int qrandom_ring_result_length(const struct qrandom_ring *ring,
+					     const struct xdma_result *result)
+{
+	if ((result->status >> 16) != C2H_WB)
+		return -EIO;
+	if (result->length == 0 || result->length > ring->block_size)
+		return -EIO;
+
+	return result->length;
+}
+
+/*
+ * Hands out up to @max ready blocks, the first one is stored in @first.
+ *
+ * The status of each claimed result is cleared so that the engine writing
+ * the block again is noticed. A block with an invalid result ends the claim:
+ * its length is set to zero and @fault is set. It is claimed nonetheless so
+ * that the head makes progress, and must be released like the others.
+ */
+static inline u32 qrandom_ring_claim(struct qrandom_ring *ring,
+				     struct xdma_result *results, u32 max,
+				     u32 *first, int *fault)
+{
+	u32 count = 0;
+
+	*first = ring->head;
+	*fault = 0;
+
+	while (count < max && ring->ready > 0) {
+		struct xdma_result *result = &results[ring->head];
+
+		if (qrandom_ring_result_length(ring, result) < 0) {
+			result->length = 0;
+			*fault = 1;
+		}
+		result->status = 0;
+		ring->served += result->length;
+
+		ring->head = qrandom_ring_next(ring, ring->head, 1);
+		ring->ready--;
+		ring->claimed++;
+		count++;
+
+		if (*fault)
+			break;
+	}
+
+	return count;
+}
+
+/* payload bytes of @count claimed blocks from @first */
+static inline u32 qrandom_ring_span_length(const struct qrandom_ring *ring,
+					   const struct xdma_result *results,
+					   u32 first, u32 count)
+{
+	u32 length = 0;
+	u32 i;
+
+	for (i = 0; i < count; i++)
+		length += results[qrandom_ring_next(ring, first, i)].length;
+
+	return length;
+}
+
+/*
+ * Hands the payload of @count claimed blocks from @first, which the ring
+ * stores in @buffer, to a reader: the first @size bytes go to @copy, at
+ * @offset of its destination, and the rest of the last block to @keep, if
+ * any, for the next read.
+ *
+ * Returns the number of bytes given to @copy, or the error @copy returned.
+ */
+static inline long qrandom_ring_copy(const struct qrandom_ring *ring,
+				     const struct xdma_result *results,
+				     const char *buffer, u32 first, u32 count,
+				     size_t size,
+				     int (*copy)(void *ctx, size_t offset,
+						 const char *data, size_t len),
+				     void (*keep)(void *ctx, const char *data,
+						  size_t len),
+				     void *ctx)
+{
+	size_t copied = 0;
+	u32 block = first;
+	u32 i;
+	int rc;
+
+	for (i = 0; i < count; i++) {
+		size_t len = results[block].length;
+		size_t part = len < size - copied ? len : size - copied;
+		const char *data = &buffer[(size_t)block * ring->block_size];
+
+		if (part > 0) {
+			rc = copy(ctx, copied, data, part);
+			if (rc)
+				return rc;
+		}
+		copied += part;
+		if (part < len && keep)
+			keep(ctx, data + part, len - part);
+
+		block = qrandom_ring_next(ring, block, 1);
+	}
+
+	return copied;
+}
+
+/* true if @block is between released and head and was not released yet */
+static inline int qrandom_ring_is_claimed(const struct qrandom_ring *ring,
+					  u32 block)
+{
+	u32 offset = (block + ring->blocks - ring->released) % ring->blocks;
+
+	return block < ring->blocks && offset < ring->claimed &&
+	       !ring->done[block];
+}
+
+/*
+ * Releases @count blocks claimed from @first.
+ *
+ * Returns the number of blocks given back to the engine, i.e. the credits to
+ * write, which is zero while an older claim is still pending. Returns -EINVAL
+ * and changes nothing if one of the blocks is not claimed.
+ */
+static inline int qrandom_ring_release(struct qrandom_ring *ring, u32 first,
+				       u32 count)
+{
+	u32 block;
+	u32 i;
+	int credits = 0;
+
+	if (count > ring->claimed)
+		return -EINVAL;
+
+	for (i = 0, block = first; i < count;
+	     i++, block = qrandom_ring_next(ring, block, 1)) {
+		if (!qrandom_ring_is_claimed(ring, block))
+			return -EINVAL;
+	}
+
+	for (i = 0, block = first; i < count;
+	     i++, block = qrandom_ring_next(ring, block, 1))
+		ring->done[block] = 1;
+
+	while (ring->claimed > 0 && ring->done[ring->released]) {
+		ring->done[ring->released] = 0;
+		ring->released = qrandom_ring_next(ring, ring->released, 1);
+		ring->claimed--;
+		credits++;
+	}
+
+	if (credits > 0)
+		ring->overrun = 0;
+
+	return credits;
+}
+
+/*
+ * Access rules of the device files sharing the ring
+ *
+ * A mapping of the ring shows the bytes of every reader, and those the
+ * hwrng feeds to the kernel. Only a file opened with O_EXCL may map it:
+ * such an open fails while the device has another user or a registered
+ * hwrng, and no other user gets the device while it is open.
+ *
+ * Returns 0 or -EBUSY for an open, @exclusive if it asks for O_EXCL,
+ * while the device has @users users, @held an exclusive one.
+ */
+static inline int qrandom_ring_may_open(int held, unsigned long users,
+					int hwrng, int exclusive)
+{
+	if (held)
+		return -EBUSY;
+	if (exclusive && (users > 0 || hwrng))
+		return -EBUSY;
+	return 0;
+}
+
+/*
+ * Returns 0 or -EPERM for a mapping of the ring by a file, @exclusive if
+ * it was opened with O_EXCL, while the device has @users users.
+ */
+static inline int qrandom_ring_may_map(int exclusive, unsigned long users,
+				       int hwrng)
+{
+	if (!exclusive || users != 1 || hwrng)
+		return -EPERM;
+	return 0;
+}
+
+#endif /* QRANDOM_RING_H */
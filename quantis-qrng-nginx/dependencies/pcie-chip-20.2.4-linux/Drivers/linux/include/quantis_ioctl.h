@@ -54,3 +54,26 @@
 /* Get the mode that is currently used */
 #define QUANTIS_IOCTL_GET_CURRENT_QRNG_MODE                                    \
 	_IOR(QUANTIS_IOC_MAGIC, 15, unsigned int)
+
+/* Layout of the rx ring mapped with mmap */
+struct quantis_ring_info {
+	unsigned int blocks; /* number of blocks in the ring */
+	unsigned int block_size; /* bytes per block, mapped at offset 0 */
+	unsigned int result_offset; /* mmap offset of the result array */
+	unsigned int result_size; /* bytes per result, one per block */
+};
+
+/* Blocks of the rx ring */
+struct quantis_ring_span {
+	unsigned int first; /* first block */
+	unsigned int count; /* number of blocks, may wrap around the ring */
+};
+
+/* Get the layout of the rx ring */
+#define QUANTIS_IOCTL_GET_RING_INFO                                            \
+	_IOR(QUANTIS_IOC_MAGIC, 16, struct quantis_ring_info)
+/* Wait for completed blocks and acquire at most count of them */
+#define QUANTIS_IOCTL_RING_ACQUIRE                                             \
+	_IOWR(QUANTIS_IOC_MAGIC, 17, struct quantis_ring_span)
+/* Release the first blocks acquired and return their credits */
+#define QUANTIS_IOCTL_RING_RELEASE _IOW(QUANTIS_IOC_MAGIC, 18, unsigned int)
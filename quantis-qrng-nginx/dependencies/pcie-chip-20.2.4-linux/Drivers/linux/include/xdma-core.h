@@ -6,6 +6,7 @@
 #include <linux/dma-mapping.h>
 #include <linux/fb.h>
 #include <linux/fs.h>
+#include <linux/hw_random.h>
 #include <linux/init.h>
 #include <linux/interrupt.h>
 #include <linux/io.h>
@@ -21,12 +22,15 @@
 #include <linux/sched.h>
 #include <linux/slab.h>
 #include <linux/splice.h>
+#include <linux/timer.h>
 #include <linux/types.h>
 #include <linux/uio.h>
 #include <linux/version.h>
 #include <linux/vmalloc.h>
 #include <linux/workqueue.h>
 
+#include "qrandom_ring.h"
+
 // Driver
 
 /* Switch debug printing on/off */
@@ -59,6 +63,20 @@
 #define USE_FIFO 0
 #endif
 
+/* poll() masks became __poll_t in 4.16 */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(4, 16, 0)
+typedef unsigned int __poll_t;
+#define EPOLLIN POLLIN
+#define EPOLLRDNORM POLLRDNORM
+#define EPOLLOUT POLLOUT
+#define EPOLLWRNORM POLLWRNORM
+#endif
+
+/* del_timer_sync() became timer_delete_sync() in 6.2 */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 2, 0)
+#define timer_delete_sync del_timer_sync
+#endif
+
 /* SECTION: Preprocessor macros/constants */
 
 #define PCIE_VENDOR_ID 0x1e89
@@ -82,7 +100,6 @@
  */
 #define XDMA_ENG_IRQ_NUM (1)
 #define MAX_EXTRA_ADJ (15)
-#define RX_STATUS_EOP (1)
 
 /* Target internal components on XDMA control BAR */
 #define XDMA_OFS_INT_CTRL (0x2000UL)
@@ -139,9 +156,10 @@
 #define K_MAX_RD_SIZE 2048 //kernel area max size to read.
 #define RX_BUF_BLOCK 4096
 #define RX_DBUF_BLOCK 3520 //4096-128(ptail)-440(hash)-8
-#define RX_BUF_PAGES 256
-#define RX_BUF_SIZE (RX_BUF_PAGES * RX_BUF_BLOCK)
-#define RX_RESULT_BUF_SIZE (RX_BUF_PAGES * sizeof(struct xdma_result))
+/* the rx ring has one block, and one descriptor, per page */
+#define RX_RING_MAX_BLOCKS 16384
+/* in poll mode, interval at which poll() rechecks an empty rx ring */
+#define RX_POLL_INTERVAL_MS 1
 
 #define REMAINING_BYTES_FIFO_SIZE 4096
 
@@ -163,8 +181,6 @@
 
 #define DESC_MAGIC 0xAD4B0000UL
 
-#define C2H_WB 0x52B4UL
-
 #define MAX_NUM_ENGINES (XDMA_CHANNEL_NUM_MAX * 2)
 #define H2C_CHANNEL_OFFSET 0x1000
 #define SGDMA_OFFSET_FROM_CHANNEL 0x4000
@@ -386,13 +402,6 @@ struct xdma_desc {
 	__le32 next_hi; /* next desc address (high 32-bit) */
 } __packed;
 
-/* 32 bytes (four 32-bit words) or 64 bytes (eight 32-bit words) */
-struct xdma_result {
-	u32 status;
-	u32 length;
-	u32 reserved_1[6]; /* padding */
-} __packed;
-
 /* Structure for polled mode descriptor writeback */
 struct xdma_poll_wb {
 	u32 completed_desc_count;
@@ -461,11 +470,9 @@ struct xdma_engine {
 	/* Transfer list management */
 	struct list_head transfer_list; /* queue of transfers */
 	struct sg_mapping_t *sgm; /* user space scatter gather mapper */
-	int rx_tail; /* follows the HW */
-	int rx_head; /* where the SW reads from */
-	int rx_overrun; /* flag if overrun occured */
 
 	/* Members applicable to AXI-ST C2H (cyclic) transfers */
+	struct qrandom_ring rx_ring; /* rx ring indices and credits */
 	void *rx_buffer; /* Kernel buffer for transfers */
 	struct xdma_transfer *rx_transfer_cyclic; /* Transfer list */
 	u8 *rx_result_buffer_virt; /* virt addr for transfer */
@@ -474,6 +481,7 @@ struct xdma_engine {
 	/* Members associated with polled mode support */
 	u8 *poll_mode_addr_virt; /* virt addr for descriptor writeback */
 	dma_addr_t poll_mode_bus; /* bus addr for descriptor writeback */
+	struct timer_list rx_poll_timer; /* wakes the pollers of the rx ring */
 
 	/* Members associated with interrupt mode support */
 	wait_queue_head_t shutdown_wq; /* wait queue for shutdown sync */
@@ -486,8 +494,6 @@ struct xdma_engine {
 	/* Members associated with performance test support */
 	struct xdma_performance_ioctl *xdma_perf; /* perf test control */
 	wait_queue_head_t xdma_perf_wq; /* Perf test sync */
-	u8 eop_found; /* used only for cyclic(rx:c2h) */
-	u32 user_buffer_index;
 };
 
 /*
@@ -505,6 +511,39 @@ struct xdma_char {
 	struct device *sys_device; /* sysfs device */
 	struct mutex device_mutex;
 	unsigned long users; /* number of times the device is open at this time */
+	bool exclusive; /* open with O_EXCL, no other user gets the device */
+};
+
+/*
+ * Book keeping of an open file of a SG DMA character device. Readers of
+ * different files only share the rx ring, see complete_cyclic().
+ */
+struct xdma_file {
+	struct xdma_char *lro_char; /* character device the file was opened on */
+	struct mutex read_mutex; /* serializes the readers of this file, nests inside device_mutex */
+	u32 ring_first; /* first rx ring block acquired through the ioctl */
+	u32 ring_count; /* number of rx ring blocks still acquired */
+	bool exclusive; /* opened with O_EXCL, may map the rx ring */
+#if USE_FIFO
+	bool fifo_reset; /* set by a board reset, next read empties the fifo */
+	DECLARE_KFIFO(
+		remaining_bytes, char,
+		REMAINING_BYTES_FIFO_SIZE); /* if we didn't use all the bytes we received, they are stored here for the next call */
+#endif
+};
+
+/* destination of a read from the rx ring, see complete_cyclic() */
+struct cyclic_dest {
+	struct xdma_file *xfile; /* keeps the bytes which do not fit */
+	char __user *user; /* user buffer, or NULL */
+	char *kernel; /* kernel buffer if there is no user buffer */
+};
+
+/* kernel hwrng fed by the C2H stream of a card, see xdma_hwrng_read() */
+struct xdma_hwrng {
+	struct hwrng rng;
+	struct xdma_file xfile; /* read context of the hwrng, like an open file */
+	char name[32]; /* rng.name */
 };
 
 struct xdma_irq {
@@ -552,14 +591,11 @@ struct xdma_dev {
 	struct xdma_engine *engine[XDMA_CHANNEL_NUM_MAX][2]; /* instances */
 
 	bool no_garbage_to_read; /* false if we need to read to remove garbage before sending the values to userspace */
+	size_t garbage_dropped; /* garbage bytes already removed since the last reset */
+	struct xdma_hwrng *hwrng; /* registered with the hwrng framework, if any */
 	unsigned int qrng_mode;
 	unsigned int current_qrng_mode;
 	unsigned int qrng_num;
-#if USE_FIFO
-	DECLARE_KFIFO(
-		remaining_bytes, char,
-		REMAINING_BYTES_FIFO_SIZE); /* if we didn't use all the bytes we received, they are stored here for the next call */
-#endif
 };
 
 #endif /* XDMA_CORE_H */
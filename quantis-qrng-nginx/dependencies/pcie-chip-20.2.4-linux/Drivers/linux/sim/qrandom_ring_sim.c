@@ -0,0 +1,730 @@
+/*
+ * Userspace simulation of the C2H cyclic rx ring
+ *
+ * Runs the ring book keeping of include/qrandom_ring.h, as used by
+ * xdma-core.c, against a simulated C2H engine: the engine fills one block
+ * per credit, writes its result and numbers every byte it produces, so the
+ * readers can check that nothing is lost, duplicated or reordered.
+ *
+ * The concurrent test runs the engine and several readers in their own
+ * threads, with a mutex standing for the engine spinlock: readers only hold
+ * it to claim and release blocks, and copy them without it, as
+ * complete_cyclic() does.
+ *
+ * The reads through the fifo test qrandom_ring_copy() as the driver uses it
+ * for read() and for the hwrng.
+ *
+ * The access test checks who may open the device and map the ring.
+ *
+ * Build and run with "make check".
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "qrandom_ring.h"
+
+#define SIM_BLOCKS 256
+#define SIM_BLOCK_SIZE 4096
+#define SIM_INITIAL_CREDITS 128
+
+struct sim_engine {
+	struct qrandom_ring ring;
+	struct xdma_result results[SIM_BLOCKS];
+	unsigned char data[SIM_BLOCKS * SIM_BLOCK_SIZE];
+	unsigned char done[SIM_BLOCKS];
+	u32 position; /* next block the engine writes */
+	u32 credits; /* blocks the engine may write */
+	int credit_control; /* without it, the engine ignores credits */
+	unsigned long produced; /* bytes written so far */
+	unsigned int seed;
+};
+
+static int failures;
+
+static void check(int condition, const char *what)
+{
+	if (!condition) {
+		printf("  FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+/* a ring of @blocks blocks, cyclic_transfer_setup() */
+static void sim_setup(struct sim_engine *sim, u32 blocks, u32 credits,
+		      int credit_control)
+{
+	qrandom_ring_init(&sim->ring, blocks, SIM_BLOCK_SIZE, sim->done);
+	qrandom_ring_reset_stats(&sim->ring);
+	memset(sim->results, 0, sizeof(sim->results));
+	sim->position = 0;
+	sim->credits = credits;
+	sim->credit_control = credit_control;
+	sim->produced = 0;
+	sim->seed = 1;
+}
+
+static void sim_init(struct sim_engine *sim, int credit_control)
+{
+	sim_setup(sim, SIM_BLOCKS, SIM_INITIAL_CREDITS, credit_control);
+}
+
+/* the engine writes @count blocks, as far as its credits go */
+static void sim_engine_write(struct sim_engine *sim, u32 count)
+{
+	while (count-- > 0) {
+		struct xdma_result *result = &sim->results[sim->position];
+		unsigned char *block = &sim->data[sim->position * SIM_BLOCK_SIZE];
+		u32 length = 1 + rand_r(&sim->seed) % SIM_BLOCK_SIZE;
+		u32 i;
+
+		if (sim->credit_control) {
+			if (sim->credits == 0)
+				return;
+			sim->credits--;
+		}
+
+		for (i = 0; i < length; i++)
+			block[i] = (unsigned char)(sim->produced++ % 251);
+		result->length = length;
+		result->status = (C2H_WB << 16) | RX_STATUS_EOP;
+
+		sim->position = qrandom_ring_next(&sim->ring, sim->position, 1);
+	}
+}
+
+/* engine_ring_process() */
+static void sim_service(struct sim_engine *sim)
+{
+	while (sim->results[sim->ring.tail].status &&
+	       qrandom_ring_produce(&sim->ring))
+		;
+}
+
+static void sim_release(struct sim_engine *sim, u32 first, u32 count)
+{
+	int credits = qrandom_ring_release(&sim->ring, first, count);
+
+	check(credits >= 0, "release of claimed blocks");
+	if (credits > 0)
+		sim->credits += credits;
+}
+
+/* checks the numbering of the bytes of a span, returns the bytes read */
+static unsigned long sim_read(struct sim_engine *sim, u32 first, u32 count,
+			      unsigned long expected)
+{
+	unsigned long start = expected;
+	u32 i;
+
+	for (i = 0; i < count; i++) {
+		u32 block = qrandom_ring_next(&sim->ring, first, i);
+		const unsigned char *data = &sim->data[block * SIM_BLOCK_SIZE];
+		u32 length = sim->results[block].length;
+		u32 j;
+
+		for (j = 0; j < length; j++, expected++) {
+			if (data[j] != (unsigned char)(expected % 251)) {
+				check(0, "data read in order");
+				return expected - start;
+			}
+		}
+	}
+
+	return expected - start;
+}
+
+/* one reader claims, reads and releases spans of random sizes */
+static void test_sequential(struct sim_engine *sim)
+{
+	unsigned long read = 0;
+	unsigned int seed = 7;
+	int round;
+
+	printf("sequential reader\n");
+	sim_init(sim, 1);
+
+	for (round = 0; round < 100000; round++) {
+		u32 first;
+		u32 count;
+		int fault;
+
+		sim_engine_write(sim, 1 + rand_r(&seed) % 16);
+		sim_service(sim);
+
+		count = qrandom_ring_claim(&sim->ring, sim->results,
+					   1 + rand_r(&seed) % 8, &first,
+					   &fault);
+		check(!fault, "no fault");
+		check(qrandom_ring_span_length(&sim->ring, sim->results, first,
+					       count) ==
+			      sim_read(sim, first, count, read),
+		      "span length");
+		read += qrandom_ring_span_length(&sim->ring, sim->results,
+						 first, count);
+		sim_release(sim, first, count);
+	}
+
+	check(!sim->ring.overrun, "no overrun with credit control");
+	check(sim->ring.ready + sim->ring.claimed + sim->credits ==
+		      SIM_INITIAL_CREDITS,
+	      "credits are conserved");
+	printf("  %lu bytes read, %lu produced\n", read, sim->produced);
+}
+
+/* blocks released out of order go back to the engine in order */
+static void test_out_of_order(struct sim_engine *sim)
+{
+	u32 first[3];
+	u32 count[3];
+	u32 released;
+	int fault;
+	int i;
+
+	printf("out of order release\n");
+	sim_init(sim, 1);
+	sim_engine_write(sim, 12);
+	sim_service(sim);
+
+	for (i = 0; i < 3; i++)
+		count[i] = qrandom_ring_claim(&sim->ring, sim->results, 4,
+					      &first[i], &fault);
+	check(count[0] == 4 && count[1] == 4 && count[2] == 4, "claims");
+	check(qrandom_ring_available(&sim->ring) == 0, "nothing left");
+
+	released = sim->ring.released;
+	check(qrandom_ring_release(&sim->ring, first[2], count[2]) == 0,
+	      "no credit while older blocks are claimed");
+	check(qrandom_ring_release(&sim->ring, first[1], count[1]) == 0,
+	      "still no credit");
+	check(sim->ring.released == released, "released end did not move");
+	check(qrandom_ring_release(&sim->ring, first[0], count[0]) == 12,
+	      "all credits once the oldest claim is released");
+	check(sim->ring.claimed == 0, "nothing claimed");
+
+	printf("  ok\n");
+}
+
+/* a bad release changes nothing */
+static void test_invalid_release(struct sim_engine *sim)
+{
+	u32 first;
+	u32 count;
+	int fault;
+
+	printf("invalid release\n");
+	sim_init(sim, 1);
+	sim_engine_write(sim, 4);
+	sim_service(sim);
+
+	count = qrandom_ring_claim(&sim->ring, sim->results, 2, &first,
+				   &fault);
+	check(qrandom_ring_release(&sim->ring, first + 2, 1) == -EINVAL,
+	      "release of a ready block");
+	check(qrandom_ring_release(&sim->ring, first, 3) == -EINVAL,
+	      "release past the claim");
+	check(qrandom_ring_release(&sim->ring, first + 1, 1) == 0,
+	      "release of the second block");
+	check(qrandom_ring_release(&sim->ring, first + 1, 1) == -EINVAL,
+	      "second release of a block");
+	check(qrandom_ring_release(&sim->ring, SIM_BLOCKS, 1) == -EINVAL,
+	      "release out of the ring");
+	check(qrandom_ring_release(&sim->ring, first, 1) == (int)count,
+	      "release of the first block");
+
+	printf("  ok\n");
+}
+
+/* a block without a valid result ends the claim */
+static void test_fault(struct sim_engine *sim)
+{
+	u32 first;
+	u32 count;
+	int fault;
+
+	printf("faulty result\n");
+	sim_init(sim, 1);
+	sim_engine_write(sim, 4);
+	sim->results[2].status = RX_STATUS_EOP;
+	sim_service(sim);
+
+	count = qrandom_ring_claim(&sim->ring, sim->results, 4, &first,
+				   &fault);
+	check(fault && count == 3, "claim ends on the faulty block");
+	check(sim->results[2].length == 0, "faulty block is empty");
+	sim_read(sim, first, count, 0);
+	sim_release(sim, first, count);
+
+	count = qrandom_ring_claim(&sim->ring, sim->results, 4, &first,
+				   &fault);
+	check(!fault && count == 1, "next claim is fine");
+	sim_release(sim, first, count);
+
+	printf("  ok\n");
+}
+
+/* without credit control the engine catches up with the readers */
+static void test_overrun(struct sim_engine *sim)
+{
+	u32 first;
+	u32 count;
+	int fault;
+
+	printf("overrun without credit control\n");
+	sim_init(sim, 0);
+	sim_engine_write(sim, SIM_BLOCKS);
+	sim_service(sim);
+	check(!sim->ring.overrun, "a full ring is no overrun");
+	check(qrandom_ring_available(&sim->ring) == SIM_BLOCKS, "ring full");
+
+	count = qrandom_ring_claim(&sim->ring, sim->results, 1, &first,
+				   &fault);
+
+	/* the engine writes the claimed block again */
+	sim_engine_write(sim, 1);
+	sim_service(sim);
+	check(sim->ring.overrun, "overrun detected");
+	check(qrandom_ring_available(&sim->ring) == SIM_BLOCKS - 1,
+	      "tail stopped");
+
+	/* the engine keeps writing, it is still the same overrun */
+	sim_engine_write(sim, 1);
+	sim_service(sim);
+	check(sim->ring.overruns == 1, "one overrun counted");
+
+	sim_release(sim, first, count);
+	check(!sim->ring.overrun, "overrun cleared by the release");
+	sim_service(sim);
+	check(qrandom_ring_available(&sim->ring) == SIM_BLOCKS,
+	      "tail moves again");
+
+	printf("  ok\n");
+}
+
+/* the statistics follow the readers and survive a new ring */
+static void test_stats(struct sim_engine *sim)
+{
+	unsigned long served = 0;
+	u32 first;
+	u32 count;
+	int fault;
+	int i;
+
+	printf("statistics\n");
+	sim_init(sim, 1);
+
+	sim_engine_write(sim, 10);
+	sim_service(sim);
+	check(sim->ring.high_water == 10, "high water");
+
+	for (i = 0; i < 3; i++) {
+		count = qrandom_ring_claim(&sim->ring, sim->results, 4, &first,
+					   &fault);
+		served += qrandom_ring_span_length(&sim->ring, sim->results,
+						   first, count);
+		sim_release(sim, first, count);
+	}
+	check(sim->ring.served == served && served == sim->produced,
+	      "bytes served");
+
+	sim_engine_write(sim, 3);
+	sim_service(sim);
+	check(sim->ring.high_water == 10, "high water kept");
+
+	qrandom_ring_init(&sim->ring, SIM_BLOCKS, SIM_BLOCK_SIZE, sim->done);
+	check(sim->ring.high_water == 10 && sim->ring.served == served,
+	      "statistics kept by a new ring");
+	qrandom_ring_reset_stats(&sim->ring);
+	check(sim->ring.high_water == 0 && sim->ring.served == 0,
+	      "statistics reset");
+
+	printf("  ok\n");
+}
+
+/* rings of other depths and initial credits, as set by the module */
+static void test_depths(struct sim_engine *sim)
+{
+	static const u32 depths[][2] = {
+		{ 2, 1 }, { 2, 2 }, { 17, 5 }, { 64, 64 }, { SIM_BLOCKS, 1 },
+	};
+	unsigned int seed = 11;
+	unsigned int d;
+
+	printf("ring depths\n");
+
+	for (d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+		u32 blocks = depths[d][0];
+		u32 credits = depths[d][1];
+		unsigned long read = 0;
+		int round;
+
+		sim_setup(sim, blocks, credits, 1);
+
+		for (round = 0; round < 10000; round++) {
+			u32 first;
+			u32 count;
+			int fault;
+
+			sim_engine_write(sim, 1 + rand_r(&seed) % blocks);
+			sim_service(sim);
+			check(sim->ring.ready + sim->ring.claimed <= credits,
+			      "engine bounded by its credits");
+
+			count = qrandom_ring_claim(&sim->ring, sim->results,
+						   1 + rand_r(&seed) % blocks,
+						   &first, &fault);
+			read += sim_read(sim, first, count, read);
+			sim_release(sim, first, count);
+		}
+
+		check(!sim->ring.overrun, "no overrun");
+		check(sim->ring.high_water <= credits, "high water");
+		check(read == sim->ring.served, "bytes served");
+		printf("  %u blocks, %u credits: %lu bytes read, high water %u\n",
+		       blocks, credits, read, sim->ring.high_water);
+	}
+}
+
+/* a reader with the fifo of an open file or of the hwrng */
+struct sim_reader {
+	unsigned char fifo[SIM_BLOCK_SIZE]; /* REMAINING_BYTES_FIFO_SIZE */
+	size_t kept;
+	unsigned char *buf;
+	int fail; /* copy_to_user() fails */
+};
+
+static int sim_copy(void *ctx, size_t offset, const char *data, size_t len)
+{
+	struct sim_reader *reader = ctx;
+
+	if (reader->fail)
+		return -EFAULT;
+	memcpy(&reader->buf[offset], data, len);
+	return 0;
+}
+
+static void sim_keep(void *ctx, const char *data, size_t len)
+{
+	struct sim_reader *reader = ctx;
+
+	check(reader->kept + len <= sizeof(reader->fifo), "fifo overflow");
+	memcpy(&reader->fifo[reader->kept], data, len);
+	reader->kept += len;
+}
+
+/*
+ * xdma_hwrng_read() or char_xdma_read(): the fifo first, then the blocks
+ * needed for the rest, returns the bytes read
+ */
+static size_t sim_reader_read(struct sim_engine *sim,
+			      struct sim_reader *reader, unsigned char *buf,
+			      size_t max)
+{
+	size_t copied = reader->kept < max ? reader->kept : max;
+	u32 first;
+	u32 count;
+	int fault;
+	long rc;
+
+	memcpy(buf, reader->fifo, copied);
+	memmove(reader->fifo, &reader->fifo[copied], reader->kept - copied);
+	reader->kept -= copied;
+	if (copied == max)
+		return copied;
+
+	count = qrandom_ring_claim(&sim->ring, sim->results,
+				   (max - copied + SIM_BLOCK_SIZE - 1) /
+					   SIM_BLOCK_SIZE,
+				   &first, &fault);
+	reader->buf = buf + copied;
+	rc = qrandom_ring_copy(&sim->ring, sim->results,
+			       (const char *)sim->data, first, count,
+			       max - copied, sim_copy, sim_keep, reader);
+	sim_release(sim, first, count);
+	check(rc >= 0, "copy");
+
+	return copied + (rc > 0 ? rc : 0);
+}
+
+/* reads of any size go through the fifo without losing a byte */
+static void test_copy(struct sim_engine *sim)
+{
+	struct sim_reader reader;
+	unsigned char buf[3 * SIM_BLOCK_SIZE];
+	unsigned long expected = 0;
+	unsigned int seed = 13;
+	u32 first;
+	u32 count;
+	int fault;
+	int round;
+
+	printf("reads through the fifo\n");
+	sim_init(sim, 1);
+	memset(&reader, 0, sizeof(reader));
+
+	for (round = 0; round < 200000; round++) {
+		/* hwrng reads are small, read() calls any size */
+		size_t max = round % 2 ? 1 + rand_r(&seed) % 64 :
+					 1 + rand_r(&seed) % sizeof(buf);
+		size_t got;
+		size_t i;
+
+		sim_engine_write(sim, 1 + rand_r(&seed) % 4);
+		sim_service(sim);
+
+		got = sim_reader_read(sim, &reader, buf, max);
+		check(got <= max, "read within the buffer");
+		for (i = 0; i < got; i++, expected++) {
+			if (buf[i] != (unsigned char)(expected % 251)) {
+				check(0, "bytes in order across the fifo");
+				return;
+			}
+		}
+	}
+	check(expected + reader.kept + qrandom_ring_span_length(
+		      &sim->ring, sim->results, sim->ring.head,
+		      sim->ring.ready) == sim->produced,
+	      "every byte read, kept or ready");
+
+	/* a failed copy is reported and keeps nothing */
+	reader.fail = 1;
+	reader.kept = 0;
+	sim_engine_write(sim, 1);
+	sim_service(sim);
+	count = qrandom_ring_claim(&sim->ring, sim->results, 1, &first,
+				   &fault);
+	reader.buf = buf;
+	check(qrandom_ring_copy(&sim->ring, sim->results,
+				(const char *)sim->data, first, count, 1,
+				sim_copy, sim_keep, &reader) == -EFAULT,
+	      "copy error returned");
+	check(reader.kept == 0, "nothing kept after an error");
+	sim_release(sim, first, count);
+
+	printf("  %lu bytes read\n", expected);
+}
+
+#define CONCURRENT_READERS 8
+#define CONCURRENT_BLOCKS 400000
+
+/* the engine numbers the blocks it writes, every byte holds the number */
+struct concurrent_sim {
+	struct sim_engine *sim;
+	pthread_mutex_t lock; /* engine->lock */
+	u32 serial[SIM_BLOCKS]; /* number of the block last written there */
+	unsigned char *seen; /* times each numbered block was read */
+	unsigned long consumed; /* blocks read so far */
+	int corrupted; /* a block changed while a reader owned it */
+};
+
+static unsigned char block_pattern(u32 serial, u32 i)
+{
+	return (unsigned char)(serial * 31 + i);
+}
+
+static void *concurrent_engine(void *arg)
+{
+	struct concurrent_sim *cs = arg;
+	struct sim_engine *sim = cs->sim;
+	u32 serial = 0;
+
+	while (serial < CONCURRENT_BLOCKS) {
+		u32 position = sim->position;
+		unsigned char *block = &sim->data[position * SIM_BLOCK_SIZE];
+		u32 i;
+
+		/* the engine owns its credits, the readers add to them */
+		if (__atomic_load_n(&sim->credits, __ATOMIC_ACQUIRE) == 0) {
+			sched_yield();
+			continue;
+		}
+		__atomic_fetch_sub(&sim->credits, 1, __ATOMIC_ACQ_REL);
+
+		/* DMA of the block then writeback of its result */
+		for (i = 0; i < SIM_BLOCK_SIZE; i++)
+			block[i] = block_pattern(serial, i);
+		cs->serial[position] = serial;
+		sim->results[position].length = SIM_BLOCK_SIZE;
+		__atomic_store_n(&sim->results[position].status,
+				 (C2H_WB << 16) | RX_STATUS_EOP,
+				 __ATOMIC_RELEASE);
+		sim->position = (position + 1) % SIM_BLOCKS;
+		serial++;
+
+		/* engine_service_cyclic() */
+		pthread_mutex_lock(&cs->lock);
+		sim_service(sim);
+		pthread_mutex_unlock(&cs->lock);
+	}
+
+	return NULL;
+}
+
+static void *concurrent_reader(void *arg)
+{
+	struct concurrent_sim *cs = arg;
+	struct sim_engine *sim = cs->sim;
+	unsigned char copy[4 * SIM_BLOCK_SIZE];
+	unsigned int seed = (unsigned int)(size_t)&copy;
+
+	for (;;) {
+		u32 first;
+		u32 count;
+		int fault;
+		int credits;
+		u32 i;
+
+		pthread_mutex_lock(&cs->lock);
+		if (cs->consumed == CONCURRENT_BLOCKS) {
+			pthread_mutex_unlock(&cs->lock);
+			break;
+		}
+		count = qrandom_ring_claim(&sim->ring, sim->results,
+					   1 + rand_r(&seed) % 4, &first,
+					   &fault);
+		cs->consumed += count;
+		pthread_mutex_unlock(&cs->lock);
+
+		if (count == 0) {
+			sched_yield();
+			continue;
+		}
+		if (fault)
+			cs->corrupted = 1;
+
+		/* copy_cyclic_to_user(), without the lock */
+		for (i = 0; i < count; i++) {
+			u32 block = qrandom_ring_next(&sim->ring, first, i);
+			memcpy(&copy[i * SIM_BLOCK_SIZE],
+			       &sim->data[block * SIM_BLOCK_SIZE],
+			       SIM_BLOCK_SIZE);
+		}
+		for (i = 0; i < count; i++) {
+			u32 block = qrandom_ring_next(&sim->ring, first, i);
+			u32 serial = cs->serial[block];
+			u32 j;
+
+			for (j = 0; j < SIM_BLOCK_SIZE; j++) {
+				if (copy[i * SIM_BLOCK_SIZE + j] !=
+				    block_pattern(serial, j)) {
+					cs->corrupted = 1;
+					break;
+				}
+			}
+			__atomic_fetch_add(&cs->seen[serial], 1,
+					   __ATOMIC_RELAXED);
+		}
+
+		pthread_mutex_lock(&cs->lock);
+		credits = qrandom_ring_release(&sim->ring, first, count);
+		pthread_mutex_unlock(&cs->lock);
+
+		if (credits < 0)
+			cs->corrupted = 1;
+		else
+			__atomic_fetch_add(&sim->credits, credits,
+					   __ATOMIC_ACQ_REL);
+	}
+
+	return NULL;
+}
+
+/* readers copying at the same time never see a block being overwritten */
+static void test_concurrent(struct sim_engine *sim)
+{
+	struct concurrent_sim cs;
+	pthread_t engine;
+	pthread_t readers[CONCURRENT_READERS];
+	unsigned long once = 0;
+	int i;
+
+	printf("%d concurrent readers\n", CONCURRENT_READERS);
+	sim_init(sim, 1);
+
+	memset(&cs, 0, sizeof(cs));
+	cs.sim = sim;
+	pthread_mutex_init(&cs.lock, NULL);
+	cs.seen = calloc(CONCURRENT_BLOCKS, 1);
+	if (cs.seen == NULL) {
+		check(0, "memory");
+		return;
+	}
+
+	pthread_create(&engine, NULL, concurrent_engine, &cs);
+	for (i = 0; i < CONCURRENT_READERS; i++)
+		pthread_create(&readers[i], NULL, concurrent_reader, &cs);
+	pthread_join(engine, NULL);
+	for (i = 0; i < CONCURRENT_READERS; i++)
+		pthread_join(readers[i], NULL);
+
+	for (i = 0; i < CONCURRENT_BLOCKS; i++)
+		once += cs.seen[i] == 1;
+
+	check(!cs.corrupted, "blocks are intact while claimed");
+	check(once == CONCURRENT_BLOCKS, "each block read once");
+	check(sim->ring.claimed == 0 && sim->ring.ready == 0, "ring drained");
+	check(sim->credits == SIM_INITIAL_CREDITS, "credits are conserved");
+	printf("  %lu blocks read once\n", once);
+
+	free(cs.seen);
+	pthread_mutex_destroy(&cs.lock);
+}
+
+/* only a sole user which opened with O_EXCL maps the ring */
+static void test_access(void)
+{
+	printf("access\n");
+
+	check(qrandom_ring_may_open(0, 0, 0, 0) == 0, "first open");
+	check(qrandom_ring_may_open(0, 2, 0, 0) == 0, "shared open");
+	check(qrandom_ring_may_open(0, 0, 0, 1) == 0, "exclusive open");
+	check(qrandom_ring_may_open(0, 1, 0, 1) == -EBUSY,
+	      "exclusive open of a device in use");
+	check(qrandom_ring_may_open(0, 0, 1, 1) == -EBUSY,
+	      "exclusive open with a hwrng");
+	check(qrandom_ring_may_open(1, 1, 0, 0) == -EBUSY,
+	      "open of an exclusive device");
+	check(qrandom_ring_may_open(1, 1, 0, 1) == -EBUSY,
+	      "exclusive open of an exclusive device");
+
+	check(qrandom_ring_may_map(1, 1, 0) == 0, "mapping of the sole user");
+	check(qrandom_ring_may_map(0, 1, 0) == -EPERM,
+	      "mapping without O_EXCL");
+	check(qrandom_ring_may_map(0, 3, 0) == -EPERM,
+	      "mapping of a shared device");
+	check(qrandom_ring_may_map(1, 2, 0) == -EPERM,
+	      "mapping with the hwrng as a user");
+	check(qrandom_ring_may_map(1, 1, 1) == -EPERM,
+	      "mapping with a registered hwrng");
+
+	printf("  ok\n");
+}
+
+int main(void)
+{
+	struct sim_engine *sim = malloc(sizeof(*sim));
+
+	if (sim == NULL)
+		return 1;
+
+	test_sequential(sim);
+	test_out_of_order(sim);
+	test_invalid_release(sim);
+	test_fault(sim);
+	test_overrun(sim);
+	test_stats(sim);
+	test_depths(sim);
+	test_copy(sim);
+	test_concurrent(sim);
+	test_access();
+
+	free(sim);
+
+	if (failures > 0) {
+		printf("%d check(s) failed\n", failures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}
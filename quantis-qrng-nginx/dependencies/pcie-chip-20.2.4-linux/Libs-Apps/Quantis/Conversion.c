@@ -57,19 +57,22 @@
 #endif
 
 #include "Conversion.h"
+#include "Conversion_Kernels.h"
 
+/* Same conversion as the array ones: dividing the whole word could round
+ * up to 1.0 */
 double ConvertToDouble_01(const char *buffer)
 {
-  uint64_t value;
-  memcpy(&value, buffer, sizeof(value));
-  return (double)value / ((double)0xFFFFFFFFFFFFFFFFull + 1.0);
+  double value;
+  ConversionKernelToDoubleArray_01(CONVERSION_KERNEL_SCALAR, &value, buffer, 1u);
+  return value;
 }
 
 float ConvertToFloat_01(const char *buffer)
 {
-  uint32_t value;
-  memcpy(&value, buffer, sizeof(value));
-  return (float)value / ((float)0xFFFFFFFFu + 1.0f);
+  float value;
+  ConversionKernelToFloatArray_01(CONVERSION_KERNEL_SCALAR, &value, buffer, 1u);
+  return value;
 }
 
 int ConvertToInt(const char *buffer)
@@ -86,6 +89,92 @@ short ConvertToShort(const char *buffer)
   return value;
 }
 
+void ConvertToDoubleArray_01(double *values, const char *buffer, size_t count)
+{
+  ConversionKernelToDoubleArray_01(ConversionKernelGetDefault(CONVERSION_OPERATION_DOUBLE), values, buffer, count);
+}
+
+void ConvertToFloatArray_01(float *values, const char *buffer, size_t count)
+{
+  ConversionKernelToFloatArray_01(ConversionKernelGetDefault(CONVERSION_OPERATION_FLOAT), values, buffer, count);
+}
+
+size_t ConvertToScaledIntArray(int *values, size_t count, int min, int max)
+{
+  const uint64_t range = (uint64_t)((int64_t)max - (int64_t)min) + 1u;
+  uint32_t threshold = 0;
+  int thresholdKnown = 0;
+  size_t kept = 0;
+  size_t i;
+
+  if (range > 0xFFFFFFFFull)
+  {
+    // full range, every random value is kept as is
+    return count;
+  }
+
+  for (i = 0; i < count; ++i)
+  {
+    uint64_t product = (uint64_t)(uint32_t)values[i] * range;
+
+    // the low part of the product is below 2^32 % range for the biased values only,
+    // the division is only needed when it is below range (rarely for small ranges)
+    if ((uint32_t)product < range)
+    {
+      if (!thresholdKnown)
+      {
+        threshold = (uint32_t)((0x100000000ull - range) % range);
+        thresholdKnown = 1;
+      }
+      if ((uint32_t)product < threshold)
+      {
+        continue;
+      }
+    }
+
+    values[kept++] = (int)((uint32_t)min + (uint32_t)(product >> 32));
+  }
+
+  return kept;
+}
+
+size_t ConvertToScaledShortArray(short *values, size_t count, short min, short max)
+{
+  const uint32_t range = (uint32_t)((int32_t)max - (int32_t)min) + 1u;
+  uint32_t threshold = 0;
+  int thresholdKnown = 0;
+  size_t kept = 0;
+  size_t i;
+
+  if (range > 0xFFFFu)
+  {
+    // full range, every random value is kept as is
+    return count;
+  }
+
+  for (i = 0; i < count; ++i)
+  {
+    uint32_t product = (uint32_t)(uint16_t)values[i] * range;
+
+    if ((product & 0xFFFFu) < range)
+    {
+      if (!thresholdKnown)
+      {
+        threshold = (0x10000u - range) % range;
+        thresholdKnown = 1;
+      }
+      if ((product & 0xFFFFu) < threshold)
+      {
+        continue;
+      }
+    }
+
+    values[kept++] = (short)((uint16_t)min + (uint16_t)(product >> 16));
+  }
+
+  return kept;
+}
+
 char ConvertHexaToByte(char c)
 {
   if ('0' <= c && c <= '9')
@@ -112,22 +201,10 @@ void ConvertByteToHexa(unsigned char h, char *c)
 
 void ConvertHexaToByteArray(unsigned char *data, const char *text, size_t length)
 {
-  size_t i = 0;
-
-  for (i = 0; i < length; ++i)
-  {
-    data[i] = (ConvertHexaToByte(text[i * 2]) << 4) + ConvertHexaToByte(text[(i * 2) + 1]);
-  }
+  ConversionKernelHexaToByteArray(ConversionKernelGetDefault(CONVERSION_OPERATION_HEXA), data, text, length);
 }
 
 void ConvertByteArrayToHexa(char *string, unsigned char *data, size_t length)
 {
-  size_t i = 0;
-
-  for (i = 0; i < length; ++i)
-  {
-    ConvertByteToHexa(data[i], string + (i * 2));
-    string[(i * 2) + 2] = '\0';
-  }
-  string[length * 2] = '\0';
+  ConversionKernelByteArrayToHexa(ConversionKernelGetDefault(CONVERSION_OPERATION_HEXA), string, data, length);
 }
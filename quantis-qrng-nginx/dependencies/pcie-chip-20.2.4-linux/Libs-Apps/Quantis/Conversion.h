@@ -97,6 +97,46 @@ extern "C"
    */
   DLL_EXPORT short ConvertToShort(const char *buffer);
 
+  /**
+   * Convert a buffer to an array of double values between 0.0 (inclusive) and 1.0 (exclusive).
+   * @param values the array to fill.
+   * @param buffer the buffer (at least count * sizeof(double) long) to convert. It may
+   * be the array to fill itself (conversion in place).
+   * @param count number of values to convert.
+   * @note the 53 most significant bits of each 64-bit word are used.
+   */
+  DLL_EXPORT void ConvertToDoubleArray_01(double *values, const char *buffer, size_t count);
+
+  /**
+   * Convert a buffer to an array of float values between 0.0 (inclusive) and 1.0 (exclusive).
+   * @param values the array to fill.
+   * @param buffer the buffer (at least count * sizeof(float) long) to convert. It may
+   * be the array to fill itself (conversion in place).
+   * @param count number of values to convert.
+   * @note the 24 most significant bits of each 32-bit word are used.
+   */
+  DLL_EXPORT void ConvertToFloatArray_01(float *values, const char *buffer, size_t count);
+
+  /**
+   * Convert in place an array of random int values to values between min and max (inclusive).
+   * Each random value is mapped with a multiply-shift (Lemire's nearly divisionless method),
+   * the few values which would bias the result are dropped. Kept values are moved to the
+   * beginning of the array.
+   * @param values the random values to convert.
+   * @param count number of values to convert.
+   * @param min the minimal value (not larger than max).
+   * @param max the maximal value.
+   * @return the number of kept values, the end of the array MUST be filled with new
+   * random values and converted again.
+   */
+  DLL_EXPORT size_t ConvertToScaledIntArray(int *values, size_t count, int min, int max);
+
+  /**
+   * Convert in place an array of random short values to values between min and max (inclusive).
+   * @see ConvertToScaledIntArray
+   */
+  DLL_EXPORT size_t ConvertToScaledShortArray(short *values, size_t count, short min, short max);
+
   /**
    * Convert a hexadecimal character to a byte.
    * @param c the character to convert.
@@ -116,6 +156,7 @@ extern "C"
    * @param data the byte buffer to fill.
    * @param text the hexadecimal string to convert.
    * @param length number of byte to convert.
+   * @note characters which are not lowercase hexadecimal digits are read as 0.
    */
   DLL_EXPORT void ConvertHexaToByteArray(unsigned char *data, const char *text, size_t length);
 
@@ -124,6 +165,7 @@ extern "C"
    * @param string the hexadecimal string to fill.
    * @param data the byte buffer to convert.
    * @param length number of byte to convert.
+   * @note the string MUST be at least 2 * length + 1 long.
    */
   DLL_EXPORT void ConvertByteArrayToHexa(char *string, unsigned char *data, size_t length);
 
@@ -0,0 +1,625 @@
+/*
+ * Conversion kernels
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include "msc_stdint.h"
+#else
+#include <stdint.h>
+#endif
+
+#include "Conversion.h"
+#include "Conversion_Kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CONVERSION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/* Bits of 1.0 */
+#define CONVERSION_DOUBLE_ONE 0x3FF0000000000000ull
+#define CONVERSION_FLOAT_ONE 0x3F800000u
+
+/* Bits of 2^-53 and 2^-24, the weight of the last random bit */
+#define CONVERSION_DOUBLE_LAST_BIT 0x3CA0000000000000ull
+#define CONVERSION_FLOAT_LAST_BIT 0x33800000u
+
+static const char conversionHexaDigits[] = "0123456789abcdef";
+
+/* ---------------------------- Scalar kernel ---------------------------- */
+
+static void ConversionScalarByteArrayToHexa(char *string, const unsigned char *data, size_t length)
+{
+  size_t i;
+
+  for (i = 0; i < length; ++i)
+  {
+    ConvertByteToHexa(data[i], string + (i * 2));
+  }
+  string[length * 2] = '\0';
+}
+
+static void ConversionScalarHexaToByteArray(unsigned char *data, const char *text, size_t length)
+{
+  size_t i;
+
+  for (i = 0; i < length; ++i)
+  {
+    data[i] = (ConvertHexaToByte(text[i * 2]) << 4) + ConvertHexaToByte(text[(i * 2) + 1]);
+  }
+}
+
+static void ConversionScalarToDoubleArray_01(double *values, const char *buffer, size_t count)
+{
+  size_t i;
+
+  // values and buffer may overlap, each word is loaded before being overwritten
+  for (i = 0; i < count; ++i)
+  {
+    uint64_t value;
+    memcpy(&value, buffer + (i * sizeof(value)), sizeof(value));
+    values[i] = (double)(value >> 11) * (1.0 / 9007199254740992.0); // 2^-53
+  }
+}
+
+static void ConversionScalarToFloatArray_01(float *values, const char *buffer, size_t count)
+{
+  size_t i;
+
+  // values and buffer may overlap, each word is loaded before being overwritten
+  for (i = 0; i < count; ++i)
+  {
+    uint32_t value;
+    memcpy(&value, buffer + (i * sizeof(value)), sizeof(value));
+    values[i] = (float)(value >> 8) * (1.0f / 16777216.0f); // 2^-24
+  }
+}
+
+/* --------------------------- Portable kernel --------------------------- */
+
+/**
+ * Returns the value of a hexadecimal digit, 0 when it is not one (like
+ * ConvertHexaToByte).
+ */
+static inline unsigned char ConversionHexaValue(char c)
+{
+  unsigned int digit = (unsigned int)(unsigned char)c - '0';
+  unsigned int letter = (unsigned int)(unsigned char)c - 'a';
+
+  return (unsigned char)((digit < 10u) ? digit : ((letter < 6u) ? letter + 10u : 0u));
+}
+
+static void ConversionPortableByteArrayToHexa(char *string, const unsigned char *data, size_t length)
+{
+  size_t i;
+
+  for (i = 0; i < length; ++i)
+  {
+    string[i * 2] = conversionHexaDigits[data[i] >> 4];
+    string[(i * 2) + 1] = conversionHexaDigits[data[i] & 0x0F];
+  }
+  string[length * 2] = '\0';
+}
+
+static void ConversionPortableHexaToByteArray(unsigned char *data, const char *text, size_t length)
+{
+  size_t i;
+
+  for (i = 0; i < length; ++i)
+  {
+    data[i] = (unsigned char)((ConversionHexaValue(text[i * 2]) << 4) | ConversionHexaValue(text[(i * 2) + 1]));
+  }
+}
+
+static void ConversionPortableToDoubleArray_01(double *values, const char *buffer, size_t count)
+{
+  const double lastBit = 1.0 / 9007199254740992.0; // 2^-53
+  size_t i;
+
+  for (i = 0; i < count; ++i)
+  {
+    uint64_t value;
+    uint64_t bits;
+    double result;
+    memcpy(&value, buffer + (i * sizeof(value)), sizeof(value));
+
+    // 52 random bits in [1.0, 2.0), both operations are exact
+    bits = (value >> 12) | CONVERSION_DOUBLE_ONE;
+    memcpy(&result, &bits, sizeof(result));
+    values[i] = (result - 1.0) + (double)((value >> 11) & 1u) * lastBit;
+  }
+}
+
+static void ConversionPortableToFloatArray_01(float *values, const char *buffer, size_t count)
+{
+  const float lastBit = 1.0f / 16777216.0f; // 2^-24
+  size_t i;
+
+  for (i = 0; i < count; ++i)
+  {
+    uint32_t value;
+    uint32_t bits;
+    float result;
+    memcpy(&value, buffer + (i * sizeof(value)), sizeof(value));
+
+    // 23 random bits in [1.0, 2.0), both operations are exact
+    bits = (value >> 9) | CONVERSION_FLOAT_ONE;
+    memcpy(&result, &bits, sizeof(result));
+    values[i] = (result - 1.0f) + (float)((value >> 8) & 1u) * lastBit;
+  }
+}
+
+#ifdef CONVERSION_X86_KERNELS
+
+/* ----------------------------- SSSE3 kernel ----------------------------- */
+
+__attribute__((target("ssse3"))) static void ConversionSsse3ByteArrayToHexa(char *string,
+                                                                             const unsigned char *data,
+                                                                             size_t length)
+{
+  const __m128i digits = _mm_loadu_si128((const __m128i *)conversionHexaDigits);
+  const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+  size_t i;
+
+  for (i = 0; i + 16u <= length; i += 16u)
+  {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)(data + i));
+    __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask));
+    __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibbleMask));
+
+    _mm_storeu_si128((__m128i *)(string + (i * 2)), _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128((__m128i *)(string + (i * 2) + 16), _mm_unpackhi_epi8(high, low));
+  }
+
+  ConversionPortableByteArrayToHexa(string + (i * 2), data + i, length - i);
+}
+
+/**
+ * Returns the values of 16 hexadecimal digits, 0 for the characters which
+ * are not digits.
+ */
+__attribute__((target("ssse3"))) static inline __m128i ConversionSsse3HexaValues(__m128i c)
+{
+  // characters above 0x7F are negative, hence not digits
+  __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+  __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+                                 _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), c));
+
+  return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                      _mm_and_si128(letter, _mm_sub_epi8(c, _mm_set1_epi8('a' - 10))));
+}
+
+__attribute__((target("ssse3"))) static void ConversionSsse3HexaToByteArray(unsigned char *data,
+                                                                             const char *text,
+                                                                             size_t length)
+{
+  // (high nibble * 16) + low nibble, for each pair of characters
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  size_t i;
+
+  for (i = 0; i + 16u <= length; i += 16u)
+  {
+    __m128i first = ConversionSsse3HexaValues(_mm_loadu_si128((const __m128i *)(text + (i * 2))));
+    __m128i second = ConversionSsse3HexaValues(_mm_loadu_si128((const __m128i *)(text + (i * 2) + 16)));
+
+    _mm_storeu_si128((__m128i *)(data + i),
+                     _mm_packus_epi16(_mm_maddubs_epi16(first, weights),
+                                      _mm_maddubs_epi16(second, weights)));
+  }
+
+  ConversionPortableHexaToByteArray(data + i, text + (i * 2), length - i);
+}
+
+__attribute__((target("ssse3"))) static void ConversionSsse3ToDoubleArray_01(double *values,
+                                                                              const char *buffer,
+                                                                              size_t count)
+{
+  const __m128i one = _mm_set1_epi64x((long long)CONVERSION_DOUBLE_ONE);
+  const __m128i lastBit = _mm_set1_epi64x((long long)CONVERSION_DOUBLE_LAST_BIT);
+  const __m128i bit11 = _mm_set1_epi64x(1ll << 11);
+  size_t i;
+
+  // the words are loaded before being overwritten by the values
+  for (i = 0; i + 2u <= count; i += 2u)
+  {
+    __m128i words = _mm_loadu_si128((const __m128i *)(buffer + (i * sizeof(uint64_t))));
+    __m128d result = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(words, 12), one)),
+                                _mm_set1_pd(1.0));
+    // 0 - bit is all ones when the bit is set
+    __m128i mask = _mm_sub_epi64(_mm_setzero_si128(), _mm_srli_epi64(_mm_and_si128(words, bit11), 11));
+
+    _mm_storeu_pd(values + i, _mm_add_pd(result, _mm_castsi128_pd(_mm_and_si128(mask, lastBit))));
+  }
+
+  ConversionPortableToDoubleArray_01(values + i, buffer + (i * sizeof(uint64_t)), count - i);
+}
+
+__attribute__((target("ssse3"))) static void ConversionSsse3ToFloatArray_01(float *values,
+                                                                             const char *buffer,
+                                                                             size_t count)
+{
+  const __m128i one = _mm_set1_epi32((int)CONVERSION_FLOAT_ONE);
+  const __m128i lastBit = _mm_set1_epi32((int)CONVERSION_FLOAT_LAST_BIT);
+  const __m128i bit8 = _mm_set1_epi32(1 << 8);
+  size_t i;
+
+  for (i = 0; i + 4u <= count; i += 4u)
+  {
+    __m128i words = _mm_loadu_si128((const __m128i *)(buffer + (i * sizeof(uint32_t))));
+    __m128 result = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(words, 9), one)),
+                               _mm_set1_ps(1.0f));
+    __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(words, bit8), bit8);
+
+    _mm_storeu_ps(values + i, _mm_add_ps(result, _mm_castsi128_ps(_mm_and_si128(mask, lastBit))));
+  }
+
+  ConversionPortableToFloatArray_01(values + i, buffer + (i * sizeof(uint32_t)), count - i);
+}
+
+/* ----------------------------- AVX2 kernel ----------------------------- */
+
+__attribute__((target("avx2"))) static void ConversionAvx2ByteArrayToHexa(char *string,
+                                                                           const unsigned char *data,
+                                                                           size_t length)
+{
+  const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)conversionHexaDigits));
+  const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+  size_t i;
+
+  for (i = 0; i + 32u <= length; i += 32u)
+  {
+    __m256i bytes = _mm256_loadu_si256((const __m256i *)(data + i));
+    __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask));
+    __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibbleMask));
+    // bytes 0-7 and 16-23, bytes 8-15 and 24-31 (unpack works within 128 bits lanes)
+    __m256i first = _mm256_unpacklo_epi8(high, low);
+    __m256i second = _mm256_unpackhi_epi8(high, low);
+
+    _mm256_storeu_si256((__m256i *)(string + (i * 2)), _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256((__m256i *)(string + (i * 2) + 32), _mm256_permute2x128_si256(first, second, 0x31));
+  }
+
+  ConversionSsse3ByteArrayToHexa(string + (i * 2), data + i, length - i);
+}
+
+/**
+ * @see ConversionSsse3HexaValues
+ */
+__attribute__((target("avx2"))) static inline __m256i ConversionAvx2HexaValues(__m256i c)
+{
+  __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                                   _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+  __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)),
+                                    _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), c));
+
+  return _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                         _mm256_and_si256(letter, _mm256_sub_epi8(c, _mm256_set1_epi8('a' - 10))));
+}
+
+__attribute__((target("avx2"))) static void ConversionAvx2HexaToByteArray(unsigned char *data,
+                                                                           const char *text,
+                                                                           size_t length)
+{
+  const __m256i weights = _mm256_set1_epi16(0x0110);
+  size_t i;
+
+  for (i = 0; i + 32u <= length; i += 32u)
+  {
+    __m256i first = ConversionAvx2HexaValues(_mm256_loadu_si256((const __m256i *)(text + (i * 2))));
+    __m256i second = ConversionAvx2HexaValues(_mm256_loadu_si256((const __m256i *)(text + (i * 2) + 32)));
+    // bytes 0-7, 16-23, 8-15 and 24-31 (pack works within 128 bits lanes)
+    __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights),
+                                        _mm256_maddubs_epi16(second, weights));
+
+    _mm256_storeu_si256((__m256i *)(data + i), _mm256_permute4x64_epi64(bytes, 0xD8));
+  }
+
+  ConversionSsse3HexaToByteArray(data + i, text + (i * 2), length - i);
+}
+
+__attribute__((target("avx2"))) static void ConversionAvx2ToDoubleArray_01(double *values,
+                                                                            const char *buffer,
+                                                                            size_t count)
+{
+  const __m256i one = _mm256_set1_epi64x((long long)CONVERSION_DOUBLE_ONE);
+  const __m256i lastBit = _mm256_set1_epi64x((long long)CONVERSION_DOUBLE_LAST_BIT);
+  const __m256i bit11 = _mm256_set1_epi64x(1ll << 11);
+  size_t i;
+
+  for (i = 0; i + 4u <= count; i += 4u)
+  {
+    __m256i words = _mm256_loadu_si256((const __m256i *)(buffer + (i * sizeof(uint64_t))));
+    __m256d result = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(words, 12), one)),
+                                   _mm256_set1_pd(1.0));
+    __m256i mask = _mm256_cmpeq_epi64(_mm256_and_si256(words, bit11), bit11);
+
+    _mm256_storeu_pd(values + i, _mm256_add_pd(result, _mm256_castsi256_pd(_mm256_and_si256(mask, lastBit))));
+  }
+
+  ConversionPortableToDoubleArray_01(values + i, buffer + (i * sizeof(uint64_t)), count - i);
+}
+
+__attribute__((target("avx2"))) static void ConversionAvx2ToFloatArray_01(float *values,
+                                                                           const char *buffer,
+                                                                           size_t count)
+{
+  const __m256i one = _mm256_set1_epi32((int)CONVERSION_FLOAT_ONE);
+  const __m256i lastBit = _mm256_set1_epi32((int)CONVERSION_FLOAT_LAST_BIT);
+  const __m256i bit8 = _mm256_set1_epi32(1 << 8);
+  size_t i;
+
+  for (i = 0; i + 8u <= count; i += 8u)
+  {
+    __m256i words = _mm256_loadu_si256((const __m256i *)(buffer + (i * sizeof(uint32_t))));
+    __m256 result = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(words, 9), one)),
+                                  _mm256_set1_ps(1.0f));
+    __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(words, bit8), bit8);
+
+    _mm256_storeu_ps(values + i, _mm256_add_ps(result, _mm256_castsi256_ps(_mm256_and_si256(mask, lastBit))));
+  }
+
+  ConversionPortableToFloatArray_01(values + i, buffer + (i * sizeof(uint32_t)), count - i);
+}
+
+#endif /* CONVERSION_X86_KERNELS */
+
+/* ------------------------------------------------------------------------ */
+
+int ConversionKernelIsSupported(ConversionKernel kernel)
+{
+  switch (kernel)
+  {
+  case CONVERSION_KERNEL_SCALAR:
+  case CONVERSION_KERNEL_PORTABLE:
+    return 1;
+
+#ifdef CONVERSION_X86_KERNELS
+  case CONVERSION_KERNEL_SSSE3:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") ? 1 : 0;
+
+  case CONVERSION_KERNEL_AVX2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+
+  default:
+    return 0;
+  }
+}
+
+const char *ConversionKernelGetName(ConversionKernel kernel)
+{
+  switch (kernel)
+  {
+  case CONVERSION_KERNEL_SCALAR:
+    return "scalar";
+
+  case CONVERSION_KERNEL_PORTABLE:
+    return "portable";
+
+  case CONVERSION_KERNEL_SSSE3:
+    return "ssse3";
+
+  case CONVERSION_KERNEL_AVX2:
+    return "avx2";
+
+  default:
+    return "unknown";
+  }
+}
+
+/*
+ * Kernels faster than the scalar one, per operation (1 << kernel). Only the
+ * SIMD kernels beat the scalar conversion to doubles, and none beats the
+ * scalar conversion to floats (QuantisConversionBench on x86-64, e.g. avx2
+ * 14706 MB/s vs scalar 18965 MB/s for floats, portable 3948 MB/s vs scalar
+ * 6516 MB/s for doubles).
+ */
+static const unsigned int conversionFasterKernels[CONVERSION_OPERATIONS_COUNT] = {
+    /* CONVERSION_OPERATION_HEXA */
+    (1u << CONVERSION_KERNEL_PORTABLE) | (1u << CONVERSION_KERNEL_SSSE3) | (1u << CONVERSION_KERNEL_AVX2),
+    /* CONVERSION_OPERATION_DOUBLE */
+    (1u << CONVERSION_KERNEL_SSSE3) | (1u << CONVERSION_KERNEL_AVX2),
+    /* CONVERSION_OPERATION_FLOAT */
+    0u};
+
+ConversionKernel ConversionKernelGetDefault(ConversionOperation operation)
+{
+  /* Selected once per operation, -1 until then */
+  static int defaultKernels[CONVERSION_OPERATIONS_COUNT] = {-1, -1, -1};
+  int kernel = __atomic_load_n(&defaultKernels[operation], __ATOMIC_ACQUIRE);
+
+  if (kernel < 0)
+  {
+    const char *name = getenv("QUANTIS_CONVERSION_KERNEL");
+
+    kernel = -1;
+    if (name != NULL)
+    {
+      int i;
+      for (i = 0; i < CONVERSION_KERNELS_COUNT; i++)
+      {
+        if ((strcmp(name, ConversionKernelGetName((ConversionKernel)i)) == 0) &&
+            ConversionKernelIsSupported((ConversionKernel)i))
+        {
+          kernel = i;
+        }
+      }
+    }
+
+    // fastest supported kernel beating the scalar one
+    if (kernel < 0)
+    {
+      kernel = CONVERSION_KERNELS_COUNT - 1;
+      while ((kernel > CONVERSION_KERNEL_SCALAR) &&
+             (((conversionFasterKernels[operation] & (1u << kernel)) == 0u) ||
+              !ConversionKernelIsSupported((ConversionKernel)kernel)))
+      {
+        kernel--;
+      }
+    }
+
+    __atomic_store_n(&defaultKernels[operation], kernel, __ATOMIC_RELEASE);
+  }
+
+  return (ConversionKernel)kernel;
+}
+
+void ConversionKernelByteArrayToHexa(ConversionKernel kernel,
+                                     char *string,
+                                     const unsigned char *data,
+                                     size_t length)
+{
+  switch (kernel)
+  {
+#ifdef CONVERSION_X86_KERNELS
+  case CONVERSION_KERNEL_AVX2:
+    ConversionAvx2ByteArrayToHexa(string, data, length);
+    break;
+
+  case CONVERSION_KERNEL_SSSE3:
+    ConversionSsse3ByteArrayToHexa(string, data, length);
+    break;
+#endif
+
+  case CONVERSION_KERNEL_PORTABLE:
+    ConversionPortableByteArrayToHexa(string, data, length);
+    break;
+
+  default:
+    ConversionScalarByteArrayToHexa(string, data, length);
+    break;
+  }
+}
+
+void ConversionKernelHexaToByteArray(ConversionKernel kernel,
+                                     unsigned char *data,
+                                     const char *text,
+                                     size_t length)
+{
+  switch (kernel)
+  {
+#ifdef CONVERSION_X86_KERNELS
+  case CONVERSION_KERNEL_AVX2:
+    ConversionAvx2HexaToByteArray(data, text, length);
+    break;
+
+  case CONVERSION_KERNEL_SSSE3:
+    ConversionSsse3HexaToByteArray(data, text, length);
+    break;
+#endif
+
+  case CONVERSION_KERNEL_PORTABLE:
+    ConversionPortableHexaToByteArray(data, text, length);
+    break;
+
+  default:
+    ConversionScalarHexaToByteArray(data, text, length);
+    break;
+  }
+}
+
+void ConversionKernelToDoubleArray_01(ConversionKernel kernel,
+                                      double *values,
+                                      const char *buffer,
+                                      size_t count)
+{
+  switch (kernel)
+  {
+#ifdef CONVERSION_X86_KERNELS
+  case CONVERSION_KERNEL_AVX2:
+    ConversionAvx2ToDoubleArray_01(values, buffer, count);
+    break;
+
+  case CONVERSION_KERNEL_SSSE3:
+    ConversionSsse3ToDoubleArray_01(values, buffer, count);
+    break;
+#endif
+
+  case CONVERSION_KERNEL_PORTABLE:
+    ConversionPortableToDoubleArray_01(values, buffer, count);
+    break;
+
+  default:
+    ConversionScalarToDoubleArray_01(values, buffer, count);
+    break;
+  }
+}
+
+void ConversionKernelToFloatArray_01(ConversionKernel kernel,
+                                     float *values,
+                                     const char *buffer,
+                                     size_t count)
+{
+  switch (kernel)
+  {
+#ifdef CONVERSION_X86_KERNELS
+  case CONVERSION_KERNEL_AVX2:
+    ConversionAvx2ToFloatArray_01(values, buffer, count);
+    break;
+
+  case CONVERSION_KERNEL_SSSE3:
+    ConversionSsse3ToFloatArray_01(values, buffer, count);
+    break;
+#endif
+
+  case CONVERSION_KERNEL_PORTABLE:
+    ConversionPortableToFloatArray_01(values, buffer, count);
+    break;
+
+  default:
+    ConversionScalarToFloatArray_01(values, buffer, count);
+    break;
+  }
+}
@@ -0,0 +1,173 @@
+/*
+ * Conversion kernels
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#ifndef QUANTIS_CONVERSION_KERNELS_H
+#define QUANTIS_CONVERSION_KERNELS_H
+
+/*
+ * Internal header: kernels of the bulk conversions of Conversion.c
+ * (hexadecimal encoding and decoding, random words to values between 0.0
+ * and 1.0).
+ *
+ * The double and float kernels build the value with the exponent bits
+ * trick: the random bits are put in the significand of a number between
+ * 1.0 and 2.0, then 1.0 is subtracted. The last bit is added afterwards, so
+ * that all kernels produce exactly the same output as the scalar one.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * List of conversion kernels.
+   */
+  typedef enum
+  {
+    /** Reference kernel: one nibble or one value at a time */
+    CONVERSION_KERNEL_SCALAR = 0,
+
+    /** Tables and exponent bits, plain C (vectorized by the compiler if possible) */
+    CONVERSION_KERNEL_PORTABLE = 1,
+
+    /** SSSE3 (16 bytes or 2 doubles at a time) */
+    CONVERSION_KERNEL_SSSE3 = 2,
+
+    /** AVX2 (32 bytes or 4 doubles at a time) */
+    CONVERSION_KERNEL_AVX2 = 3
+  } ConversionKernel;
+
+#define CONVERSION_KERNELS_COUNT 4
+
+  /**
+   * Conversions for which a default kernel is selected.
+   */
+  typedef enum
+  {
+    /** ConvertByteArrayToHexa and ConvertHexaToByteArray */
+    CONVERSION_OPERATION_HEXA = 0,
+
+    /** ConvertToDoubleArray_01 */
+    CONVERSION_OPERATION_DOUBLE = 1,
+
+    /** ConvertToFloatArray_01 */
+    CONVERSION_OPERATION_FLOAT = 2
+  } ConversionOperation;
+
+#define CONVERSION_OPERATIONS_COUNT 3
+
+  /**
+   * @return 1 when the kernel can run on this CPU, 0 otherwise.
+   */
+  int ConversionKernelIsSupported(ConversionKernel kernel);
+
+  /**
+   * Returns the kernel used by Conversion.c for an operation: the fastest
+   * supported kernel among those measured faster than the scalar one for
+   * this operation, the scalar kernel if there is none. The
+   * QUANTIS_CONVERSION_KERNEL environment variable may name another
+   * supported kernel ("scalar", "portable", "ssse3" or "avx2"), used for all
+   * the operations.
+   */
+  ConversionKernel ConversionKernelGetDefault(ConversionOperation operation);
+
+  /**
+   * @return the name of the kernel.
+   */
+  const char *ConversionKernelGetName(ConversionKernel kernel);
+
+  /**
+   * Converts a byte array to a hexadecimal string with the given kernel,
+   * which MUST be supported.
+   * @see ConvertByteArrayToHexa
+   */
+  void ConversionKernelByteArrayToHexa(ConversionKernel kernel,
+                                       char *string,
+                                       const unsigned char *data,
+                                       size_t length);
+
+  /**
+   * Converts a hexadecimal string to a byte array with the given kernel,
+   * which MUST be supported.
+   * @see ConvertHexaToByteArray
+   */
+  void ConversionKernelHexaToByteArray(ConversionKernel kernel,
+                                       unsigned char *data,
+                                       const char *text,
+                                       size_t length);
+
+  /**
+   * Converts a buffer to an array of double values with the given kernel,
+   * which MUST be supported.
+   * @see ConvertToDoubleArray_01
+   */
+  void ConversionKernelToDoubleArray_01(ConversionKernel kernel,
+                                        double *values,
+                                        const char *buffer,
+                                        size_t count);
+
+  /**
+   * Converts a buffer to an array of float values with the given kernel,
+   * which MUST be supported.
+   * @see ConvertToFloatArray_01
+   */
+  void ConversionKernelToFloatArray_01(ConversionKernel kernel,
+                                       float *values,
+                                       const char *buffer,
+                                       size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUANTIS_CONVERSION_KERNELS_H */
@@ -72,10 +72,26 @@ extern "C"
     QUANTIS_DEVICE_PCI = 1,
 
     /** Quantis USB */
-    QUANTIS_DEVICE_USB = 2
+    QUANTIS_DEVICE_USB = 2,
+
+    /**
+     * All the Quantis PCI and USB devices, read in parallel (device number 0).
+     * The devices may be selected with the QUANTIS_AGGREGATE_DEVICES
+     * environment variable, e.g. "pci:0,pci:1,usb:0".
+     */
+    QUANTIS_DEVICE_AGGREGATE = 4,
+
+    /**
+     * Quantis device shared by QuantisServer, over a Unix-domain or a TCP
+     * socket. The device number is the index of the address of the server
+     * in the QUANTIS_REMOTE_ADDRESS environment variable, a comma separated
+     * list of "unix:<path>" and "tcp:<host>:<port>" addresses. When it is
+     * not set, the server on /var/run/quantis.sock is device 0.
+     */
+    QUANTIS_DEVICE_REMOTE = 8
 
     /* Next Quantis device type
-    QUANTIS_DEVICE_XXX = 4 */
+    QUANTIS_DEVICE_XXX = 16 */
   } QuantisDeviceType;
 
   /**
@@ -119,6 +135,43 @@ extern "C"
     QUANTIS_ERROR_OTHER = -199
   } QuantisError;
 
+  /**
+   * Policy used to decide when the status of the modules is checked before
+   * reading random data. Checking the status costs an ioctl (PCI) or a
+   * control transfer (USB), which is significant for small reads.
+   */
+  DLL_EXPORT typedef enum {
+    /** Check the status before every read */
+    QUANTIS_STATUS_CHECK_EVERY_READ = 0,
+
+    /** Check the status once every <em>interval</em> bytes read */
+    QUANTIS_STATUS_CHECK_EVERY_BYTES = 1,
+
+    /** Check the status once every <em>interval</em> milliseconds (default) */
+    QUANTIS_STATUS_CHECK_EVERY_MS = 2,
+
+    /** Only check the status after a failed read (and on first read) */
+    QUANTIS_STATUS_CHECK_AFTER_ERROR = 3
+  } QuantisStatusCheckPolicy;
+
+  /** Default status check policy of a newly opened device */
+#define QUANTIS_STATUS_CHECK_DEFAULT_POLICY QUANTIS_STATUS_CHECK_EVERY_MS
+
+  /** Default interval (in milliseconds) of the default status check policy */
+#define QUANTIS_STATUS_CHECK_DEFAULT_INTERVAL 100
+
+  /**
+   * State of the status check policy of a device handle.
+   */
+  typedef struct QuantisStatusCheck
+  {
+    QuantisStatusCheckPolicy policy;
+    unsigned int interval;      /* bytes or milliseconds, depending on policy */
+    int pending;                /* a check is required before next read */
+    size_t bytesSinceCheck;     /* bytes read since last check */
+    unsigned long long lastCheck; /* time of last check (in milliseconds) */
+  } QuantisStatusCheck;
+
   /**
    * Structure representing an handle on a Quantis device. This is an opaque
    * type for which are only ever provided with a pointer, usually originating
@@ -137,6 +190,7 @@ extern "C"
     QuantisDeviceType deviceType;
     QuantisOperations *ops;
     void *privateData;
+    QuantisStatusCheck statusCheck;
   };
 
   /**
@@ -406,9 +460,28 @@ extern "C"
                                     void *buffer,
                                     size_t size);
 
+  /**
+   * Sets when the status of the modules is checked by QuantisReadHandled.
+   * By default, the status is checked every
+   * QUANTIS_STATUS_CHECK_DEFAULT_INTERVAL milliseconds. A failed read always
+   * triggers a check on next read, whatever the policy.
+   * @param deviceHandle a pointer to a handle the device
+   * @param policy the status check policy.
+   * @param interval the number of bytes (QUANTIS_STATUS_CHECK_EVERY_BYTES) or
+   * of milliseconds (QUANTIS_STATUS_CHECK_EVERY_MS) between two checks.
+   * Ignored by the other policies.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisSetStatusCheckPolicy(QuantisDeviceHandle *deviceHandle,
+                                             QuantisStatusCheckPolicy policy,
+                                             unsigned int interval);
+
   /**
    * Reads random data from the Quantis device.
-   * This function perform open read and close
+   * This function does not require the device to be opened: the first call
+   * opens it and the handle is kept in a process-wide cache, so that next
+   * calls (from any thread) perform the read only. The handle is closed when
+   * the read fails, and the device is opened again on next call.
    * @param deviceType specify the type of Quantis device.
    * @param deviceNumber the number of the Quantis device.
    * @param buffer a pointer to a destination buffer. This buffer MUST 
@@ -421,6 +494,24 @@ extern "C"
                              void *buffer,
                              size_t size);
 
+  /**
+   * Close all the device handles kept open by the functions taking a
+   * deviceType and a deviceNumber (see QuantisRead). The devices are opened
+   * again on demand.
+   * @note QuantisOpen automatically releases the cached handle of the device
+   * it opens.
+   */
+  DLL_EXPORT void QuantisCloseCachedHandles();
+
+  /**
+   * Forgets the number of devices, the driver versions and the serial
+   * numbers remembered by QuantisCount, QuantisGetDriverVersion and
+   * QuantisGetSerialNumber, so that they are read again on next call.
+   * @note On Linux, the library already notices devices being added or
+   * removed. Elsewhere, it reads them again after a second.
+   */
+  DLL_EXPORT void QuantisRescanDevices();
+
   /**
    * Reads a random double floating precision value between 0.0 (inclusive)
    * and 1.0 (exclusive) from the Quantis device.
@@ -502,6 +593,9 @@ extern "C"
   /**
    * Reads a random number from the Quantis device and scale it to be between
    * min and max (inclusive).
+   * The random data is taken from a small buffer kept with the cached handle
+   * of the device (see QuantisRead), so that the random numbers rejected to
+   * avoid a bias do not cost a device round-trip.
    * @param deviceType specify the type of Quantis device.
    * @param deviceNumber the number of the Quantis device.
    * @param value a pointer to a destination value.
@@ -518,6 +612,9 @@ extern "C"
   /**
    * Reads a random number from the Quantis device and scale it to be between
    * min and max (inclusive).
+   * The random data is taken from a small buffer kept with the cached handle
+   * of the device (see QuantisRead), so that the random numbers rejected to
+   * avoid a bias do not cost a device round-trip.
    * @param deviceType specify the type of Quantis device.
    * @param deviceNumber the number of the Quantis device.
    * @param value a pointer to a destination value.
@@ -531,6 +628,122 @@ extern "C"
                                         short min,
                                         short max);
 
+  /**
+   * Fills an array with random double floating precision values between 0.0
+   * (inclusive) and 1.0 (exclusive).
+   * The random data of all the values is read at once (by chunks of
+   * QUANTIS_MAX_READ_SIZE bytes) and converted in place.
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadDoubles_01(QuantisDeviceHandle *deviceHandle,
+                                       double *values,
+                                       size_t count);
+
+  /**
+   * Fills an array with random single floating precision values between 0.0
+   * (inclusive) and 1.0 (exclusive).
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadFloats_01(QuantisDeviceHandle *deviceHandle,
+                                      float *values,
+                                      size_t count);
+
+  /**
+   * Fills an array with random numbers.
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadInts(QuantisDeviceHandle *deviceHandle,
+                                 int *values,
+                                 size_t count);
+
+  /**
+   * Fills an array with random numbers.
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadShorts(QuantisDeviceHandle *deviceHandle,
+                                   short *values,
+                                   size_t count);
+
+  /**
+   * Fills an array with random numbers scaled to be between min (inclusive)
+   * and max (exclusive).
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadScaledDoubles(QuantisDeviceHandle *deviceHandle,
+                                          double *values,
+                                          size_t count,
+                                          double min,
+                                          double max);
+
+  /**
+   * Fills an array with random numbers scaled to be between min (inclusive)
+   * and max (exclusive).
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadScaledFloats(QuantisDeviceHandle *deviceHandle,
+                                         float *values,
+                                         size_t count,
+                                         float min,
+                                         float max);
+
+  /**
+   * Fills an array with random numbers scaled to be between min and max
+   * (inclusive).
+   * The values are computed with a multiply-shift, the few random values
+   * which would bias the result are replaced by a single read for the whole
+   * array.
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadScaledInts(QuantisDeviceHandle *deviceHandle,
+                                       int *values,
+                                       size_t count,
+                                       int min,
+                                       int max);
+
+  /**
+   * Fills an array with random numbers scaled to be between min and max
+   * (inclusive).
+   * @see QuantisReadScaledInts
+   * @param deviceHandle a pointer to a handle the device
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisReadScaledShorts(QuantisDeviceHandle *deviceHandle,
+                                         short *values,
+                                         size_t count,
+                                         short min,
+                                         short max);
+
   /**
    * Get a pointer to the error message string.
    *
@@ -53,17 +53,29 @@
 
 #include <string>
 #include <stdexcept>
+#ifdef CXX11_SUPPORTED
+#include <system_error>
+#endif
+#if __cplusplus >= 202002L
+#include <cstddef>
+#include <span>
+#endif
 
 #include "Quantis.h"
 
-#ifdef _WIN32
-// Visual C++ does not implement checked exceptions
-// Disables "C++ exception specification ignored except to indicate a function is not __declspec(nothrow)"
-#pragma warning(disable : 4290)
-#endif
-
 namespace idQ
 {
+#ifdef CXX11_SUPPORTED
+/**
+  * Error category of the QUANTIS_ERROR codes reported through std::error_code.
+  */
+DLL_EXPORT const std::error_category &quantis_category() noexcept;
+#endif
+
+/**
+  * A Quantis device opened by the object. Each object owns its own handle on
+  * the device: objects can be moved (C++11) but not copied.
+  */
 class DLL_EXPORT Quantis
 {
 public:
@@ -73,21 +85,50 @@ public:
        * @param deviceNumber the number of the Quantis device.
        * @throw runtime_error QUANTIS_ERROR code on failure
        */
-    Quantis(QuantisDeviceType deviceType, unsigned int deviceNumber) throw(std::runtime_error);
+    Quantis(QuantisDeviceType deviceType, unsigned int deviceNumber);
+
+#ifdef CXX11_SUPPORTED
+    /**
+       * Constuctor: Open the device without throwing.
+       * @param deviceType specify the type of Quantis device.
+       * @param deviceNumber the number of the Quantis device.
+       * @param ec set to the QUANTIS_ERROR code on failure, cleared on success.
+       * On failure, the object can only be assigned or destroyed.
+       */
+    Quantis(QuantisDeviceType deviceType, unsigned int deviceNumber, std::error_code &ec) noexcept;
+
+    /**
+       * Move constructor: takes the device of other, which can then only be
+       * assigned or destroyed.
+       */
+    Quantis(Quantis &&other) noexcept;
+
+    /**
+       * Move assignment: closes the device and takes the one of other.
+       */
+    Quantis &operator=(Quantis &&other) noexcept;
+
+    Quantis(const Quantis &) = delete;
+    Quantis &operator=(const Quantis &) = delete;
+#endif
 
     /**
        * Destructor: Close the device
        */
     ~Quantis();
 
+    /**
+       * Returns whether the object holds an open device.
+       */
+    bool IsOpen() const;
+
     /**
       * Resets the Quantis board.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       * @warning This function do not generally has to be called, since the board
       * is automatically reset.
       */
-    void BoardReset() const
-        throw(std::runtime_error);
+    void BoardReset() const;
 
     /**
       * Returns the number of specific Quantis type devices that have been detected
@@ -96,15 +137,14 @@ public:
       * @return the number of Quantis devices that have been detected on the system.
       * Returns 0 on error or when no card is installed.
       */
-    static int Count(QuantisDeviceType deviceType) throw(std::runtime_error);
+    static int Count(QuantisDeviceType deviceType);
 
     /**
       * Get the version of the board.
       * @return the version of the board
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    int GetBoardVersion() const
-        throw(std::runtime_error);
+    int GetBoardVersion() const;
 
     /**
       * Returns the version of the driver as a number composed by the 
@@ -112,8 +152,7 @@ public:
       * @return the version of the driver
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    float GetDriverVersion() const
-        throw(std::runtime_error);
+    float GetDriverVersion() const;
 
     /**
       * Returns the version of the driver as a number composed by the 
@@ -122,7 +161,7 @@ public:
       * @return the version of the driver
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    static float GetDriverVersion(QuantisDeviceType deviceType) throw(std::runtime_error);
+    static float GetDriverVersion(QuantisDeviceType deviceType);
 
     /**
       * Returns the library version as a number composed by the major
@@ -146,8 +185,7 @@ public:
       * @throw runtime_error QUANTIS_ERROR code on failure.
       * @see QuantisGetModulesMask
       */
-    int GetModulesCount() const
-        throw(std::runtime_error);
+    int GetModulesCount() const;
 
     /**
       * Returns a bitmask of the modules that have been detected on a Quantis
@@ -158,24 +196,21 @@ public:
       * @throw runtime_error QUANTIS_ERROR code on failure.
       * @see QuantisGetModulesStatus
       */
-    int GetModulesMask() const
-        throw(std::runtime_error);
+    int GetModulesMask() const;
 
     /**
       * Returns the data rate (in Bytes per second) provided by the Quantis device.
       * @return the data rate provided by the Quantis device
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    int GetModulesDataRate() const
-        throw(std::runtime_error);
+    int GetModulesDataRate() const;
 
     /**
       * Get the power status of the modules.
       * @return true if the modules are powered, false if the modules are not powered
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    bool GetModulesPower() const
-        throw(std::runtime_error);
+    bool GetModulesPower() const;
 
     /**
       * Returns the status of the modules on the device as a bitmask as defined 
@@ -185,8 +220,7 @@ public:
       * @throw runtime_error QUANTIS_ERROR code on failure.
       * @see QuantisGetModulesMask
       */
-    int GetModulesStatus() const
-        throw(std::runtime_error);
+    int GetModulesStatus() const;
 
     /**
       * Get a string representing the serial number string of the Quantis device.
@@ -202,8 +236,7 @@ public:
       * QuantisGetModulesMask) that must be disabled.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    void ModulesDisable(int modulesMask) const
-        throw(std::runtime_error);
+    void ModulesDisable(int modulesMask) const;
 
     /**
       * Enable one ore more modules.
@@ -211,8 +244,7 @@ public:
       * QuantisGetModulesMask) that must be enabled.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    void ModulesEnable(int modulesMask) const
-        throw(std::runtime_error);
+    void ModulesEnable(int modulesMask) const;
 
     /**
       * Reset one or more modules.
@@ -222,31 +254,27 @@ public:
       * @warning This function just call QuantisModulesDisable and then 
       * QuantisModulesEnable with the provided modulesMask.
       */
-    void ModulesReset(int modulesMask) const
-        throw(std::runtime_error);
+    void ModulesReset(int modulesMask) const;
 
     /**
       * Get the device Id on the PCI or USB bus.
       * @return the deviceId of the board
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    int GetBusDeviceId() const
-        throw(std::runtime_error);
+    int GetBusDeviceId() const;
 
     /**
       * Get the AIS-31 Startup tests request flag.
       * @return 1 if startup tests are requested, otherwise 0
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    int GetAis31StartupTestsRequestFlag() const
-        throw(std::runtime_error);
+    int GetAis31StartupTestsRequestFlag() const;
 
     /**
       * Clear the AIS-31 Startup tests request flag.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    void ClearAis31StartupTestsRequestFlag() const
-        throw(std::runtime_error);
+    void ClearAis31StartupTestsRequestFlag() const;
 
     /**
       * Reads random data from the Quantis device.
@@ -254,8 +282,7 @@ public:
       * @return a string holding the random data.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    std::string Read(size_t size) const
-        throw(std::runtime_error);
+    std::string Read(size_t size) const;
 
     /**
       * Reads random data from the Quantis device.
@@ -264,8 +291,41 @@ public:
       * @param size the number of bytes to read (not larger than QUANTIS_MAX_READ_SIZE).
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    void Read(void *buffer, size_t size) const
-        throw(std::runtime_error);
+    void Read(void *buffer, size_t size) const;
+
+#ifdef CXX11_SUPPORTED
+    /**
+      * Reads random data from the Quantis device without throwing.
+      * No memory is allocated: hot loops can refill the same buffer.
+      * @param buffer a pointer to a destination buffer. This buffer MUST 
+      * already be allocated. Its size must be at least <em>size</em> bytes.
+      * @param size the number of bytes to read (not larger than QUANTIS_MAX_READ_SIZE).
+      * @param ec set to the QUANTIS_ERROR code on failure, cleared on success.
+      */
+    void Read(void *buffer, size_t size, std::error_code &ec) const noexcept;
+#endif
+
+#if __cplusplus >= 202002L
+    /**
+      * Fills a buffer with random data from the Quantis device.
+      * @param buffer the buffer to fill (not larger than QUANTIS_MAX_READ_SIZE).
+      * @throw runtime_error QUANTIS_ERROR code on failure.
+      */
+    void Read(std::span<std::byte> buffer) const
+    {
+        Read(buffer.data(), buffer.size());
+    }
+
+    /**
+      * Fills a buffer with random data from the Quantis device without throwing.
+      * @param buffer the buffer to fill (not larger than QUANTIS_MAX_READ_SIZE).
+      * @param ec set to the QUANTIS_ERROR code on failure, cleared on success.
+      */
+    void Read(std::span<std::byte> buffer, std::error_code &ec) const noexcept
+    {
+        Read(buffer.data(), buffer.size(), ec);
+    }
+#endif
 
     /**
       * Reads a random double floating precision value between 0.0 (inclusive)
@@ -273,8 +333,7 @@ public:
       * @return a double random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    double ReadDouble() const
-        throw(std::runtime_error);
+    double ReadDouble() const;
 
     /**
       * Reads a random double from the Quantis device and scale it to be between 
@@ -284,8 +343,7 @@ public:
       * @return a double random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.       
       */
-    double ReadDouble(double min, double max) const
-        throw(std::runtime_error);
+    double ReadDouble(double min, double max) const;
 
     /**
       * Reads a random float floating precision value between 0.0 (inclusive)
@@ -293,8 +351,7 @@ public:
       * @return a float random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    float ReadFloat() const
-        throw(std::runtime_error);
+    float ReadFloat() const;
 
     /**
       * Reads a random float from the Quantis device and scale it to be between 
@@ -304,16 +361,14 @@ public:
       * @return a float random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.       
       */
-    float ReadFloat(float min, float max) const
-        throw(std::runtime_error);
+    float ReadFloat(float min, float max) const;
 
     /**
       * Reads a random integer precision value from the Quantis device.
       * @return a int random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    int ReadInt() const
-        throw(std::runtime_error);
+    int ReadInt() const;
 
     /**
       * Reads a random integer from the Quantis device and scale it to be between 
@@ -323,16 +378,14 @@ public:
       * @return a int random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.       
       */
-    int ReadInt(int min, int max) const
-        throw(std::runtime_error);
+    int ReadInt(int min, int max) const;
 
     /**
       * Reads a random short integer precision value from the Quantis device.
       * @return a short int random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.
       */
-    short ReadShort() const
-        throw(std::runtime_error);
+    short ReadShort() const;
 
     /**
       * Reads a random short integer from the Quantis device and scale it to be between 
@@ -342,12 +395,48 @@ public:
       * @return a short int random number.
       * @throw runtime_error QUANTIS_ERROR code on failure.       
       */
-    short ReadShort(short min, short max) const
-        throw(std::runtime_error);
+    short ReadShort(short min, short max) const;
+
+#ifdef CXX11_SUPPORTED
+    /**
+      * Variants of the ReadXXX methods which do not throw: on failure, ec is
+      * set to the QUANTIS_ERROR code and 0 is returned.
+      */
+    double ReadDouble(std::error_code &ec) const noexcept;
+    double ReadDouble(double min, double max, std::error_code &ec) const noexcept;
+    float ReadFloat(std::error_code &ec) const noexcept;
+    float ReadFloat(float min, float max, std::error_code &ec) const noexcept;
+    int ReadInt(std::error_code &ec) const noexcept;
+    int ReadInt(int min, int max, std::error_code &ec) const noexcept;
+    short ReadShort(std::error_code &ec) const noexcept;
+    short ReadShort(short min, short max, std::error_code &ec) const noexcept;
+#endif
 
 private:
+#ifndef CXX11_SUPPORTED
+    /**
+      * Copies are not allowed (the handle on the device is owned by the object).
+      */
+    Quantis(const Quantis &);
+    Quantis &operator=(const Quantis &);
+#endif
+
+    /**
+      * Reads random data from the Quantis device.
+      * @return QUANTIS_SUCCESS or a QUANTIS_ERROR code on failure.
+      */
+    int ReadInternal(void *buffer, size_t size) const;
+
+    /**
+      * Reads random data from the Quantis device and converts it to scaled values.
+      * @return QUANTIS_SUCCESS or a QUANTIS_ERROR code on failure.
+      */
+    int ReadScaledInt(int &value, int min, int max) const;
+    int ReadScaledShort(short &value, short min, short max) const;
+
     QuantisDeviceType _deviceType;
     unsigned int _deviceNumber;
+    QuantisDeviceHandle *_deviceHandle;
 };
 } // namespace idQ
 
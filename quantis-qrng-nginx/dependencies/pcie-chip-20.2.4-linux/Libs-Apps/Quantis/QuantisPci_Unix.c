@@ -62,10 +62,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
-#include <dirent.h>      // for CountFiles
-#include <sys/syscall.h> // for CountFiles
+#include <dirent.h> // for CountFiles
 
 #include "Quantis.h"
 #include "Quantis_Internal.h"
@@ -78,7 +78,8 @@
 
 #include "quantis_pci.h"
 
-#define BUF_SIZE 4096 // for CountFiles
+/* Version of the loaded driver module */
+#define QUANTIS_PCI_MODULE_VERSION_FILE "/sys/module/quantis_chip_pcie/version"
 
 /**
  * QuantisPrivateData for Quantis PCI on Unix systems
@@ -87,51 +88,41 @@ typedef struct QuantisPrivateData
 {
   int fd; /* File descriptor */
   char serialNumber[QUANTIS_IOCTL_GET_SERIAL_MAX_LENGTH];
-} QuantisPrivateData;
 
-typedef struct LinuxDirectory
-{
-  long d_ino;
-  off_t d_off;
-  unsigned short d_reclen;
-  char d_name[];
-} LinuxDirectory;
+  /* Rx ring mapped by QuantisPciMapRing, NULL when reading with read() */
+  const unsigned char *ring;
+  const unsigned char *results;
+  struct quantis_ring_info ringInfo;
+  /* Blocks acquired from the ring and position of the next byte to read */
+  unsigned int acquiredFirst;
+  unsigned int acquiredCount;
+  unsigned int acquiredIndex;
+  unsigned int blockOffset;
+} QuantisPrivateData;
 
 int CountFiles(char *Dir,char *Prefix){
-  // Count the number of devices with filename starting with prefix
-  
-  int DirHandle=0,NumBytes=0,Pos=0,NumofQRNGDevs=0;
-  char Buffer[BUF_SIZE];
-  struct LinuxDirectory *DirEntry=NULL;
+  // Count the number of devices with filename starting with prefix.
+  // Called by the device registry (see Quantis_C.c) when devices may
+  // have changed, not on each QuantisCount.
+
+  DIR *DirHandle=NULL;
+  struct dirent *DirEntry=NULL;
+  int NumofQRNGDevs=0;
   size_t PrefixLength=strlen(Prefix);
-  
-  DirHandle = open(Dir, O_RDONLY | O_DIRECTORY);
-  if (DirHandle == -1) {
+
+  DirHandle = opendir(Dir);
+  if (DirHandle == NULL) {
     // if the /dev/ directory doesn't exist then we can't access any devices
     // so return no devices.
     return 0;
   }
-  
-  while (1) {
-    NumBytes = syscall(SYS_getdents, DirHandle, Buffer, BUF_SIZE);
-    if (NumBytes == -1) {
-      // cannot system call so no devices read
-      return 0;
-    }
-    if (NumBytes == 0) {
-      break;
-    }
-    
-    for (Pos = 0; Pos < NumBytes;Pos+=DirEntry->d_reclen) {
-      DirEntry = (struct LinuxDirectory *) (Buffer + Pos);
-      if(!strncmp(DirEntry->d_name,Prefix,PrefixLength)){
-	// Note we could check the d_type if we wanted here
-	// Increase counter
-	NumofQRNGDevs++;
-      }
+
+  while ((DirEntry = readdir(DirHandle)) != NULL) {
+    if(!strncmp(DirEntry->d_name,Prefix,PrefixLength)){
+      NumofQRNGDevs++;
     }
   }
-  close(DirHandle);  
+  closedir(DirHandle);
   return NumofQRNGDevs;
 }
 
@@ -141,6 +132,152 @@ int CountPciDevs(){
 }
 
 
+/**
+ * Returns whether the device is opened alone to read its rx ring in place,
+ * as set by the QUANTIS_PCI_EXCLUSIVE environment variable. The mapping
+ * shows the bytes of every reader, so the driver only allows it to a file
+ * opened with O_EXCL, which no other process may then open.
+ */
+static int QuantisPciIsExclusive()
+{
+  const char *value = getenv("QUANTIS_PCI_EXCLUSIVE");
+
+  return (value != NULL) && (strcmp(value, "1") == 0);
+}
+
+/**
+ * Maps the rx ring of the device, the driver then hands out blocks of the ring
+ * which are read in place instead of being copied by read().
+ * Leaves privateData->ring NULL if the driver does not support it.
+ */
+static void QuantisPciMapRing(QuantisPrivateData *privateData)
+{
+  struct quantis_ring_info *info = &privateData->ringInfo;
+  void *ring;
+  void *results;
+
+  privateData->ring = NULL;
+  privateData->results = NULL;
+  privateData->acquiredFirst = 0u;
+  privateData->acquiredCount = 0u;
+  privateData->acquiredIndex = 0u;
+  privateData->blockOffset = 0u;
+
+  /* Fails with older drivers, without the credit feature or if the device
+   * is not open with O_EXCL */
+  if (ioctl(privateData->fd, QUANTIS_IOCTL_GET_RING_INFO, info) < 0)
+  {
+    return;
+  }
+
+  ring = mmap(NULL, (size_t)info->blocks * info->block_size,
+              PROT_READ, MAP_SHARED, privateData->fd, 0);
+  if (ring == MAP_FAILED)
+  {
+    return;
+  }
+
+  results = mmap(NULL, (size_t)info->blocks * info->result_size,
+                 PROT_READ, MAP_SHARED, privateData->fd, (off_t)info->result_offset);
+  if (results == MAP_FAILED)
+  {
+    munmap(ring, (size_t)info->blocks * info->block_size);
+    return;
+  }
+
+  privateData->ring = (const unsigned char *)ring;
+  privateData->results = (const unsigned char *)results;
+}
+
+static void QuantisPciUnmapRing(QuantisPrivateData *privateData)
+{
+  const struct quantis_ring_info *info = &privateData->ringInfo;
+
+  if (privateData->ring == NULL)
+  {
+    return;
+  }
+
+  /* Blocks still acquired are released when the device is closed */
+  munmap((void *)privateData->ring, (size_t)info->blocks * info->block_size);
+  munmap((void *)privateData->results, (size_t)info->blocks * info->result_size);
+  privateData->ring = NULL;
+  privateData->results = NULL;
+}
+
+/**
+ * Reads from the mapped rx ring. Blocks are acquired as needed and released
+ * once read, a partially read block is kept for the next call.
+ */
+static int QuantisPciReadRing(QuantisPrivateData *privateData, unsigned char *buffer, size_t size)
+{
+  const struct quantis_ring_info *info = &privateData->ringInfo;
+  size_t readBytes = 0u;
+
+  while (readBytes < size)
+  {
+    unsigned int block;
+    unsigned int length;
+    size_t count;
+
+    if (privateData->acquiredIndex == privateData->acquiredCount)
+    {
+      /* Waits for enough blocks for the rest of the buffer, or at least one */
+      struct quantis_ring_span span;
+      size_t blocks = (size - readBytes + info->block_size - 1u) / info->block_size;
+      span.first = 0u;
+      span.count = (blocks < info->blocks) ? (unsigned int)blocks : info->blocks;
+      if (ioctl(privateData->fd, QUANTIS_IOCTL_RING_ACQUIRE, &span) < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        return QUANTIS_ERROR_IO;
+      }
+      privateData->acquiredFirst = span.first;
+      privateData->acquiredCount = span.count;
+      privateData->acquiredIndex = 0u;
+      privateData->blockOffset = 0u;
+    }
+
+    /* Length written by the card in the result of the block (second word) */
+    block = (privateData->acquiredFirst + privateData->acquiredIndex) % info->blocks;
+    memcpy(&length, privateData->results + (size_t)block * info->result_size + sizeof(unsigned int), sizeof(length));
+
+    count = length - privateData->blockOffset;
+    if (count > size - readBytes)
+    {
+      count = size - readBytes;
+    }
+    memcpy(buffer + readBytes,
+           privateData->ring + (size_t)block * info->block_size + privateData->blockOffset,
+           count);
+    readBytes += count;
+    privateData->blockOffset += (unsigned int)count;
+
+    if (privateData->blockOffset == length)
+    {
+      privateData->acquiredIndex++;
+      privateData->blockOffset = 0u;
+    }
+
+    /* Gives the blocks back to the card as soon as they are read */
+    if (privateData->acquiredIndex == privateData->acquiredCount)
+    {
+      unsigned int released = privateData->acquiredCount;
+      if (ioctl(privateData->fd, QUANTIS_IOCTL_RING_RELEASE, &released) < 0)
+      {
+        return QUANTIS_ERROR_IO;
+      }
+      privateData->acquiredCount = 0u;
+      privateData->acquiredIndex = 0u;
+    }
+  }
+
+  return (int)readBytes;
+}
+
 static int QuantisPciIoCtl(QuantisDeviceHandle *deviceHandle, unsigned long request, void *arg)
 {
   QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
@@ -176,6 +313,7 @@ void QuantisPciClose(QuantisDeviceHandle *deviceHandle)
     return;
   }
 
+  QuantisPciUnmapRing(_privateData);
   close(_privateData->fd);
 
   free(_privateData);
@@ -238,35 +376,46 @@ int QuantisPciGetBoardVersion(QuantisDeviceHandle *deviceHandle)
   }
 }
 
+static int QuantisPciGetDriverVersionRequest(QuantisDeviceHandle *deviceHandle, void *driverVersion)
+{
+  return QuantisPciIoCtl(deviceHandle, (int)QUANTIS_IOCTL_GET_DRIVER_VERSION, driverVersion);
+}
+
 /* GetDriverVersion */
 float QuantisPciGetDriverVersion()
 {
   int result;
   int deviceNumber = 0;
   int driverVersion = 0;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  int major = 0;
+  int minor = 0;
+  FILE *versionFile;
 
-  /* Open device */
-  result = QuantisOpen(QUANTIS_DEVICE_PCI, deviceNumber, &deviceHandle);
-  if (result < 0)
+  /* Version of the loaded module ("major.minor.patch"), without opening a device */
+  versionFile = fopen(QUANTIS_PCI_MODULE_VERSION_FILE, "r");
+  if (versionFile != NULL)
   {
-    /* Assumes there is no card installed */
-    return 0.0f;
+    result = fscanf(versionFile, "%d.%d", &major, &minor);
+    fclose(versionFile);
+    if (result == 2)
+    {
+      /* Same as QUANTIS_IOCTL_GET_DRIVER_VERSION (major * 10 + minor) */
+      return ((float)(major * 10 + minor)) / 10.0f;
+    }
   }
 
-  /* Perform request */
-  result = QuantisPciIoCtl(deviceHandle,
-                           (int)QUANTIS_IOCTL_GET_DRIVER_VERSION,
-                           &driverVersion);
+  /* Ask the device through the handle cached for the stateless functions:
+   * QuantisOpen would close it, under the feet of a concurrent read */
+  result = QuantisHandleCacheRequest(QUANTIS_DEVICE_PCI,
+                                     deviceNumber,
+                                     QuantisPciGetDriverVersionRequest,
+                                     &driverVersion);
   if (result < 0)
   {
     /* Assumes there is no card installed */
-    driverVersion = 0.0f;
+    driverVersion = 0;
   }
 
-  /* Close device */
-  QuantisClose(deviceHandle);
-
   return ((float)driverVersion) / 10.0f;
 }
 
@@ -409,7 +558,7 @@ int QuantisPciOpen(QuantisDeviceHandle *deviceHandle)
   /* Open device */
   sprintf(filename, "/dev/%s%d", QUANTIS_PCI_DEVICE_NAME, deviceHandle->deviceNumber);
 
-  fd = open(filename, O_RDONLY);
+  fd = open(filename, QuantisPciIsExclusive() ? (O_RDONLY | O_EXCL) : O_RDONLY);
   if (fd < 0)
   {
     return QUANTIS_ERROR_NO_DEVICE;
@@ -428,6 +577,13 @@ int QuantisPciOpen(QuantisDeviceHandle *deviceHandle)
   _privateData->fd = fd;
   /* The real serial number will be loaded in QuantisPciGetSerialNumber */
   _privateData->serialNumber[0] = '\0';
+  /* Zero-copy reads when the driver allows it */
+  _privateData->ring = NULL;
+  _privateData->results = NULL;
+  if (QuantisPciIsExclusive())
+  {
+    QuantisPciMapRing(_privateData);
+  }
 
   deviceHandle->privateData = _privateData;
 
@@ -462,10 +618,15 @@ int QuantisPciOpen(QuantisDeviceHandle *deviceHandle)
 /* Read */
 int QuantisPciRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
 {
-  /* Check if status is ok */
-  if (QuantisPciGetModulesStatus(deviceHandle) <= 0)
+  /* Check if status is ok (when required by the status check policy) */
+  if (QuantisStatusCheckIsDue(deviceHandle))
   {
-    return QUANTIS_ERROR_INVALID_STATUS;
+    int modulesStatus = QuantisPciGetModulesStatus(deviceHandle);
+    QuantisStatusCheckDone(deviceHandle, modulesStatus);
+    if (modulesStatus <= 0)
+    {
+      return QUANTIS_ERROR_INVALID_STATUS;
+    }
   }
 
   /*
@@ -476,6 +637,14 @@ int QuantisPciRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
   size_t readBytes = 0u;
   int result = QUANTIS_ERROR_IO;
   QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
+
+  if (_privateData->ring != NULL)
+  {
+    result = QuantisPciReadRing(_privateData, (unsigned char *)buffer, size);
+    QuantisStatusCheckUpdate(deviceHandle, result);
+    return result;
+  }
+
   while (readBytes < size)
   {
     result = read(_privateData->fd,
@@ -490,6 +659,7 @@ int QuantisPciRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
       }
       else
       {
+        QuantisStatusCheckUpdate(deviceHandle, QUANTIS_ERROR_IO);
         return QUANTIS_ERROR_IO;
       }
     }
@@ -497,6 +667,8 @@ int QuantisPciRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
     readBytes += result;
   }
 
+  QuantisStatusCheckUpdate(deviceHandle, (int)readBytes);
+
   return readBytes;
 }
 
@@ -0,0 +1,481 @@
+/*
+ * Quantis USB streaming reader (libusb asynchronous API)
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#include "QuantisLibConfig.h"
+
+#ifndef DISABLE_QUANTIS_USB
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "Quantis.h"
+#include "QuantisUsb_Commands.h"
+#include "QuantisUsb_Stream.h"
+
+/* Timeout (in milliseconds) of the libusb event loop iterations */
+#define QUANTIS_USB_STREAM_EVENT_TIMEOUT 100
+
+typedef struct QuantisUsbStreamTransfer
+{
+  QuantisUsbStream *stream;
+  struct libusb_transfer *transfer;
+  unsigned char *buffer;
+  int submitted;
+} QuantisUsbStreamTransfer;
+
+struct QuantisUsbStream
+{
+  libusb_context *libusbContext;
+  libusb_device_handle *libusbDeviceHandle;
+  unsigned char endpoint;
+  unsigned int packetSize;
+  unsigned int transferSize;
+
+  QuantisUsbStreamTransfer *transfers;
+  unsigned int transfersCount;
+  unsigned int inFlight;
+  unsigned int maxInFlight;
+
+  /* Ring buffer, head and tail are free running counters */
+  unsigned char *buffer;
+  size_t bufferSize;
+  size_t head;     /* bytes written by the transfers */
+  size_t tail;     /* bytes read by QuantisUsbStreamRead */
+  size_t reserved; /* room reserved by the transfers in flight */
+
+  int running;
+  int error;
+
+  pthread_t eventThread;
+  pthread_mutex_t mutex;
+  pthread_cond_t dataAvailable;
+};
+
+/**
+ * Submits the idle transfers which fit in the free space of the ring buffer.
+ * Must be called with the stream mutex held.
+ */
+static void QuantisUsbStreamSubmit(QuantisUsbStream *stream)
+{
+  unsigned int i;
+
+  for (i = 0u; i < stream->transfersCount; i++)
+  {
+    QuantisUsbStreamTransfer *streamTransfer = &stream->transfers[i];
+
+    if (!stream->running || stream->error)
+    {
+      return;
+    }
+
+    if (streamTransfer->submitted)
+    {
+      continue;
+    }
+
+    if ((stream->head - stream->tail) + stream->reserved + stream->transferSize > stream->bufferSize)
+    {
+      /* Not enough room, wait for data to be read */
+      return;
+    }
+
+    if (libusb_submit_transfer(streamTransfer->transfer) != LIBUSB_SUCCESS)
+    {
+      stream->error = QUANTIS_ERROR_IO;
+      pthread_cond_broadcast(&stream->dataAvailable);
+      return;
+    }
+
+    streamTransfer->submitted = 1;
+    stream->reserved += stream->transferSize;
+    stream->inFlight++;
+    if (stream->inFlight > stream->maxInFlight)
+    {
+      stream->maxInFlight = stream->inFlight;
+    }
+  }
+}
+
+/**
+ * Transfer completion callback, called from the event thread.
+ */
+static void LIBUSB_CALL QuantisUsbStreamCallback(struct libusb_transfer *transfer)
+{
+  QuantisUsbStreamTransfer *streamTransfer = (QuantisUsbStreamTransfer *)transfer->user_data;
+  QuantisUsbStream *stream = streamTransfer->stream;
+  size_t length = 0u;
+  size_t offset;
+  size_t firstPart;
+
+  pthread_mutex_lock(&stream->mutex);
+
+  streamTransfer->submitted = 0;
+  stream->reserved -= stream->transferSize;
+  stream->inFlight--;
+
+  switch (transfer->status)
+  {
+  case LIBUSB_TRANSFER_COMPLETED:
+  case LIBUSB_TRANSFER_TIMED_OUT:
+    /* Only whole packets are valid (see QuantisUsbRead) */
+    length = (size_t)transfer->actual_length;
+    length -= length % stream->packetSize;
+    break;
+
+  case LIBUSB_TRANSFER_CANCELLED:
+    break;
+
+  case LIBUSB_TRANSFER_NO_DEVICE:
+    stream->error = QUANTIS_ERROR_NO_DEVICE;
+    break;
+
+  default:
+    stream->error = QUANTIS_ERROR_IO;
+    break;
+  }
+
+  /* Copy data to the ring buffer (room has been reserved on submission) */
+  if (length > 0u)
+  {
+    offset = stream->head & (stream->bufferSize - 1u);
+    firstPart = stream->bufferSize - offset;
+    if (firstPart > length)
+    {
+      firstPart = length;
+    }
+    memcpy(stream->buffer + offset, streamTransfer->buffer, firstPart);
+    memcpy(stream->buffer, streamTransfer->buffer + firstPart, length - firstPart);
+    stream->head += length;
+  }
+
+  QuantisUsbStreamSubmit(stream);
+
+  pthread_cond_broadcast(&stream->dataAvailable);
+  pthread_mutex_unlock(&stream->mutex);
+}
+
+/**
+ * Handles libusb events until the stream is stopped and all the transfers
+ * have completed.
+ */
+static void *QuantisUsbStreamEventThread(void *arg)
+{
+  QuantisUsbStream *stream = (QuantisUsbStream *)arg;
+  struct timeval timeout;
+
+  while (1)
+  {
+    pthread_mutex_lock(&stream->mutex);
+    if (!stream->running && (stream->inFlight == 0u))
+    {
+      pthread_mutex_unlock(&stream->mutex);
+      break;
+    }
+    pthread_mutex_unlock(&stream->mutex);
+
+    timeout.tv_sec = 0;
+    timeout.tv_usec = QUANTIS_USB_STREAM_EVENT_TIMEOUT * 1000;
+    libusb_handle_events_timeout_completed(stream->libusbContext, &timeout, NULL);
+  }
+
+  return NULL;
+}
+
+/**
+ * Frees the stream and its transfers (which must not be in flight).
+ */
+static void QuantisUsbStreamFree(QuantisUsbStream *stream)
+{
+  unsigned int i;
+
+  if (stream->transfers)
+  {
+    for (i = 0u; i < stream->transfersCount; i++)
+    {
+      libusb_free_transfer(stream->transfers[i].transfer);
+      free(stream->transfers[i].buffer);
+    }
+    free(stream->transfers);
+  }
+
+  pthread_cond_destroy(&stream->dataAvailable);
+  pthread_mutex_destroy(&stream->mutex);
+
+  free(stream->buffer);
+  free(stream);
+}
+
+int QuantisUsbStreamStart(libusb_context *libusbContext,
+                          libusb_device_handle *libusbDeviceHandle,
+                          unsigned char endpoint,
+                          unsigned int packetSize,
+                          unsigned int transfersCount,
+                          size_t bufferSize,
+                          QuantisUsbStream **stream)
+{
+  QuantisUsbStream *_stream = NULL;
+  unsigned int i;
+
+  /* Consistency checks */
+  if ((packetSize == 0u) ||
+      (transfersCount == 0u) ||
+      ((bufferSize & (bufferSize - 1u)) != 0u) ||
+      (packetSize > bufferSize / QUANTIS_USB_STREAM_PACKETS_PER_TRANSFER) ||
+      (transfersCount > bufferSize / ((size_t)packetSize * QUANTIS_USB_STREAM_PACKETS_PER_TRANSFER)))
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  /* Allocate memory */
+  _stream = (QuantisUsbStream *)calloc(1, sizeof(QuantisUsbStream));
+  if (!_stream)
+  {
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+
+  _stream->libusbContext = libusbContext;
+  _stream->libusbDeviceHandle = libusbDeviceHandle;
+  _stream->endpoint = endpoint;
+  _stream->packetSize = packetSize;
+  _stream->transferSize = packetSize * QUANTIS_USB_STREAM_PACKETS_PER_TRANSFER;
+  _stream->transfersCount = transfersCount;
+  _stream->bufferSize = bufferSize;
+  _stream->running = 1;
+  pthread_mutex_init(&_stream->mutex, NULL);
+  pthread_cond_init(&_stream->dataAvailable, NULL);
+
+  _stream->buffer = (unsigned char *)malloc(bufferSize);
+  _stream->transfers = (QuantisUsbStreamTransfer *)calloc(transfersCount, sizeof(QuantisUsbStreamTransfer));
+  if (!_stream->buffer || !_stream->transfers)
+  {
+    QuantisUsbStreamFree(_stream);
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+
+  for (i = 0u; i < transfersCount; i++)
+  {
+    QuantisUsbStreamTransfer *streamTransfer = &_stream->transfers[i];
+
+    streamTransfer->stream = _stream;
+    streamTransfer->transfer = libusb_alloc_transfer(0);
+    streamTransfer->buffer = (unsigned char *)malloc(_stream->transferSize);
+    if (!streamTransfer->transfer || !streamTransfer->buffer)
+    {
+      QuantisUsbStreamFree(_stream);
+      return QUANTIS_ERROR_NO_MEMORY;
+    }
+
+    libusb_fill_bulk_transfer(streamTransfer->transfer,
+                              libusbDeviceHandle,
+                              endpoint,
+                              streamTransfer->buffer,
+                              (int)_stream->transferSize,
+                              QuantisUsbStreamCallback,
+                              streamTransfer,
+                              QUANTIS_USB_REQUEST_TIMEOUT);
+  }
+
+  /* Fill the queue */
+  pthread_mutex_lock(&_stream->mutex);
+  QuantisUsbStreamSubmit(_stream);
+  pthread_mutex_unlock(&_stream->mutex);
+
+  if (pthread_create(&_stream->eventThread, NULL, QuantisUsbStreamEventThread, _stream) != 0)
+  {
+    /* Without event thread, the transfers must be cancelled by hand */
+    pthread_mutex_lock(&_stream->mutex);
+    _stream->running = 0;
+    for (i = 0u; i < transfersCount; i++)
+    {
+      if (_stream->transfers[i].submitted)
+      {
+        libusb_cancel_transfer(_stream->transfers[i].transfer);
+      }
+    }
+    while (_stream->inFlight > 0u)
+    {
+      struct timeval timeout = {0, QUANTIS_USB_STREAM_EVENT_TIMEOUT * 1000};
+      pthread_mutex_unlock(&_stream->mutex);
+      libusb_handle_events_timeout_completed(libusbContext, &timeout, NULL);
+      pthread_mutex_lock(&_stream->mutex);
+    }
+    pthread_mutex_unlock(&_stream->mutex);
+
+    QuantisUsbStreamFree(_stream);
+    return QUANTIS_ERROR_OTHER;
+  }
+
+  *stream = _stream;
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisUsbStreamRead(QuantisUsbStream *stream, void *buffer, size_t size)
+{
+  size_t readBytes = 0u;
+  size_t available;
+  size_t offset;
+  size_t firstPart;
+  struct timespec deadline;
+  int result = 0;
+
+  pthread_mutex_lock(&stream->mutex);
+
+  while (readBytes < size)
+  {
+    available = stream->head - stream->tail;
+
+    if (available == 0u)
+    {
+      if (stream->error)
+      {
+        result = stream->error;
+        break;
+      }
+
+      /* Wait for a transfer to complete */
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_sec += QUANTIS_USB_REQUEST_TIMEOUT / 1000;
+      deadline.tv_nsec += (QUANTIS_USB_REQUEST_TIMEOUT % 1000) * 1000000L;
+      if (deadline.tv_nsec >= 1000000000L)
+      {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+      }
+
+      if (pthread_cond_timedwait(&stream->dataAvailable, &stream->mutex, &deadline) == ETIMEDOUT)
+      {
+        if (stream->head == stream->tail)
+        {
+          result = QUANTIS_ERROR_IO;
+          break;
+        }
+      }
+      continue;
+    }
+
+    if (available > size - readBytes)
+    {
+      available = size - readBytes;
+    }
+
+    /* Copy data to user's buffer */
+    offset = stream->tail & (stream->bufferSize - 1u);
+    firstPart = stream->bufferSize - offset;
+    if (firstPart > available)
+    {
+      firstPart = available;
+    }
+    memcpy((unsigned char *)buffer + readBytes, stream->buffer + offset, firstPart);
+    memcpy((unsigned char *)buffer + readBytes + firstPart, stream->buffer, available - firstPart);
+
+    stream->tail += available;
+    readBytes += available;
+
+    /* Room has been freed, refill the queue */
+    QuantisUsbStreamSubmit(stream);
+  }
+
+  pthread_mutex_unlock(&stream->mutex);
+
+  /* The data already copied is returned, the error is reported on next
+   * read (a stream error stays set, a timeout occurs again) */
+  if ((result < 0) && (readBytes == 0u))
+  {
+    return result;
+  }
+
+  return (int)readBytes;
+}
+
+void QuantisUsbStreamStop(QuantisUsbStream *stream)
+{
+  unsigned int i;
+
+  if (!stream)
+  {
+    return;
+  }
+
+  /* Cancel pending transfers, the event thread exits once they completed */
+  pthread_mutex_lock(&stream->mutex);
+  stream->running = 0;
+  for (i = 0u; i < stream->transfersCount; i++)
+  {
+    if (stream->transfers[i].submitted)
+    {
+      libusb_cancel_transfer(stream->transfers[i].transfer);
+    }
+  }
+  pthread_mutex_unlock(&stream->mutex);
+
+  pthread_join(stream->eventThread, NULL);
+
+  QuantisUsbStreamFree(stream);
+}
+
+unsigned int QuantisUsbStreamGetMaxInFlight(QuantisUsbStream *stream)
+{
+  unsigned int maxInFlight;
+
+  pthread_mutex_lock(&stream->mutex);
+  maxInFlight = stream->maxInFlight;
+  pthread_mutex_unlock(&stream->mutex);
+
+  return maxInFlight;
+}
+
+#else
+int unusedUsbStream; /* Silence `ISO C forbids an empty translation unit' warning.  */
+#endif /* DISABLE_QUANTIS_USB */
@@ -0,0 +1,151 @@
+/*
+ * Quantis USB streaming reader (libusb asynchronous API)
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#ifndef QUANTIS_USB_STREAM_H
+#define QUANTIS_USB_STREAM_H
+
+#include "QuantisLibConfig.h"
+
+#ifndef DISABLE_QUANTIS_USB
+
+#ifdef __FreeBSD__
+#include <libusb.h>
+#else
+#include <libusb-1.0/libusb.h>
+#endif
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * Default number of bulk transfers kept in flight by the stream. Can be
+   * overridden with the QUANTIS_USB_TRANSFERS environment variable. Setting
+   * it to 0 disables the stream (QuantisUsbRead then performs synchronous
+   * transfers).
+   */
+#define QUANTIS_USB_STREAM_TRANSFERS 8
+
+  /** Number of USB packets requested by a single bulk transfer */
+#define QUANTIS_USB_STREAM_PACKETS_PER_TRANSFER 32
+
+  /**
+   * Size (in bytes) of the buffer holding data received and not read yet.
+   * Must be a power of two.
+   */
+#define QUANTIS_USB_STREAM_BUFFER_SIZE (256 * 1024)
+
+  /**
+   * Streaming reader of a Quantis USB bulk endpoint.
+   *
+   * A queue of asynchronous bulk transfers is kept in flight so that the
+   * device never waits for the host between two packets. Completed transfers
+   * are copied in a ring buffer from which QuantisUsbStreamRead takes data.
+   * Transfers are only submitted when the ring buffer has room for them, so
+   * the device is not read faster than data is consumed (plus the buffer).
+   *
+   * libusb events are handled by a dedicated thread.
+   */
+  typedef struct QuantisUsbStream QuantisUsbStream;
+
+  /**
+   * Starts streaming data from a bulk endpoint.
+   * @param libusbContext the libusb context of the device.
+   * @param libusbDeviceHandle the libusb handle of the device (interface
+   * already claimed).
+   * @param endpoint the bulk IN endpoint.
+   * @param packetSize the maximal packet size of the endpoint. Only whole
+   * packets are delivered.
+   * @param transfersCount the number of transfers kept in flight.
+   * @param bufferSize the size of the ring buffer, must be a power of two
+   * large enough to hold all the transfers.
+   * @param stream a pointer to the created stream.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  int QuantisUsbStreamStart(libusb_context *libusbContext,
+                            libusb_device_handle *libusbDeviceHandle,
+                            unsigned char endpoint,
+                            unsigned int packetSize,
+                            unsigned int transfersCount,
+                            size_t bufferSize,
+                            QuantisUsbStream **stream);
+
+  /**
+   * Reads data received from the device, waiting for it if necessary.
+   * @return The number of read bytes on success, which is less than
+   * <em>size</em> when an error or a timeout occurred after some data was
+   * read, or a QUANTIS_ERROR code on failure. Once an error has been
+   * returned, the stream must be stopped.
+   */
+  int QuantisUsbStreamRead(QuantisUsbStream *stream,
+                           void *buffer,
+                           size_t size);
+
+  /**
+   * Cancels the pending transfers, stops the event thread and frees the
+   * stream.
+   */
+  void QuantisUsbStreamStop(QuantisUsbStream *stream);
+
+  /**
+   * Returns the maximal number of transfers that have been in flight at the
+   * same time since the stream has been started.
+   */
+  unsigned int QuantisUsbStreamGetMaxInFlight(QuantisUsbStream *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISABLE_QUANTIS_USB */
+#endif /* QUANTIS_USB_STREAM_H */
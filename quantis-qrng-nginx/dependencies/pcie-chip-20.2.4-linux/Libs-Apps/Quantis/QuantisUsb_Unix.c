@@ -72,6 +72,7 @@
 #include "Quantis.h"
 #include "Quantis_Internal.h"
 #include "QuantisUsb_Commands.h"
+#include "QuantisUsb_Stream.h"
 
 /* Driver version == libusb version */
 #define DRIVER_VERSION 1.0f
@@ -88,8 +89,36 @@ typedef struct QuantisPrivateData
   char serialNumber[255];
   char manufacturer[255];
   unsigned int usbMaxPacketSize;
+  unsigned int streamTransfers; /* 0 when streaming is disabled */
+  QuantisUsbStream *stream;     /* started on first read */
 } QuantisPrivateData;
 
+/**
+ * Returns the number of transfers to keep in flight, as set by the
+ * QUANTIS_USB_TRANSFERS environment variable.
+ */
+static unsigned int QuantisUsbGetStreamTransfers()
+{
+  const char *value = getenv("QUANTIS_USB_TRANSFERS");
+  char *end = NULL;
+  unsigned long transfers;
+
+  if ((value == NULL) || (*value == '\0'))
+  {
+    return QUANTIS_USB_STREAM_TRANSFERS;
+  }
+
+  /* Compared to the limit without multiplying, which could wrap */
+  transfers = strtoul(value, &end, 10);
+  if ((*end != '\0') ||
+      (transfers > QUANTIS_USB_STREAM_BUFFER_SIZE / (USB_MAX_BULK_PACKET_SIZE * QUANTIS_USB_STREAM_PACKETS_PER_TRANSFER)))
+  {
+    return QUANTIS_USB_STREAM_TRANSFERS;
+  }
+
+  return (unsigned int)transfers;
+}
+
 static int QuantisUsbGetIntValue(QuantisDeviceHandle *deviceHandle, char request)
 {
   QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
@@ -204,6 +233,10 @@ void QuantisUsbClose(QuantisDeviceHandle *deviceHandle)
     return;
   }
 
+  /* Transfers must be cancelled before releasing the interface */
+  QuantisUsbStreamStop(_privateData->stream);
+  _privateData->stream = NULL;
+
   libusb_release_interface(_privateData->libusbDeviceHandle, 0);
   libusb_close(_privateData->libusbDeviceHandle);
   libusb_exit(_privateData->libusbContext);
@@ -487,6 +520,8 @@ int QuantisUsbOpen(QuantisDeviceHandle *deviceHandle)
   /* Set private data */
   _privateData->libusbContext = libusbContext;
   _privateData->libusbDeviceHandle = libusbDeviceHandle;
+  _privateData->streamTransfers = QuantisUsbGetStreamTransfers();
+  _privateData->stream = NULL;
 
   /* Determine maximum packet size */
   result = libusb_get_config_descriptor(dev, 0, &usbConfig);
@@ -569,6 +604,52 @@ int QuantisUsbRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
   int readBytes = 0;
   int transferred = 0;
 
+  /*
+   * Check if the status of the module is ok. This is done once per read (at
+   * most) and not before each packet, since the control transfer costs as
+   * much as the bulk transfer itself.
+   */
+  if (QuantisStatusCheckIsDue(deviceHandle))
+  {
+    int modulesStatus = QuantisUsbGetModulesStatus(deviceHandle);
+    QuantisStatusCheckDone(deviceHandle, modulesStatus);
+    if (modulesStatus <= 0)
+    {
+      return QUANTIS_ERROR_INVALID_STATUS;
+    }
+  }
+
+  if (_privateData->streamTransfers > 0u)
+  {
+    /* Start streaming on first read */
+    if (!_privateData->stream)
+    {
+      result = QuantisUsbStreamStart(_privateData->libusbContext,
+                                     _privateData->libusbDeviceHandle,
+                                     QUANTIS_USB_ENDPOINT_BULK_IN,
+                                     _privateData->usbMaxPacketSize,
+                                     _privateData->streamTransfers,
+                                     QUANTIS_USB_STREAM_BUFFER_SIZE,
+                                     &_privateData->stream);
+      if (result < 0)
+      {
+        QuantisStatusCheckUpdate(deviceHandle, result);
+        return result;
+      }
+    }
+
+    result = QuantisUsbStreamRead(_privateData->stream, buffer, size);
+    if (result < 0)
+    {
+      /* The stream is restarted on next read */
+      QuantisUsbStreamStop(_privateData->stream);
+      _privateData->stream = NULL;
+    }
+
+    QuantisStatusCheckUpdate(deviceHandle, result);
+    return result;
+  }
+
   while (readBytes < (int)size)
   {
     size_t chunkSize = size - readBytes;
@@ -577,12 +658,6 @@ int QuantisUsbRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
       chunkSize = _privateData->usbMaxPacketSize;
     }
 
-    /* Check if the status of the module is ok */
-    if (QuantisUsbGetModulesStatus(deviceHandle) <= 0)
-    {
-      return QUANTIS_ERROR_INVALID_STATUS;
-    }
-
     /*
      * Read data
      *
@@ -596,6 +671,7 @@ int QuantisUsbRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
                                   QUANTIS_USB_REQUEST_TIMEOUT);
     if ((result < 0) || (transferred != (int)_privateData->usbMaxPacketSize))
     {
+      QuantisStatusCheckUpdate(deviceHandle, QUANTIS_ERROR_IO);
       return result;
     }
 
@@ -605,6 +681,8 @@ int QuantisUsbRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
     readBytes += chunkSize;
   }
 
+  QuantisStatusCheckUpdate(deviceHandle, readBytes);
+
   return readBytes;
 }
 
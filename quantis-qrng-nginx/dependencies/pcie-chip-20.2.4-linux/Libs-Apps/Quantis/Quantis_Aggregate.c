@@ -0,0 +1,836 @@
+/*
+ * Quantis aggregate device: stripes reads over several Quantis devices
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Quantis.h"
+#include "Quantis_Internal.h"
+
+typedef struct QuantisPrivateData QuantisPrivateData;
+
+/**
+ * A device of the aggregate and the worker thread reading from it.
+ */
+typedef struct QuantisAggregateMember
+{
+  QuantisPrivateData *aggregate;
+  QuantisDeviceType deviceType;
+  unsigned int deviceNumber;
+  QuantisDeviceHandle *deviceHandle; /* NULL while the device is dropped */
+  unsigned long long retryTime;      /* when a dropped device is opened again */
+  unsigned int retryDelay;           /* delay since the last drop, 0 if none */
+  pthread_t thread;
+  int threadStarted;
+
+  /* Read request given to the worker thread */
+  int pending;
+  unsigned char *buffer;
+  size_t size;
+  int result;
+  pthread_cond_t requestAvailable;
+} QuantisAggregateMember;
+
+struct QuantisPrivateData
+{
+  QuantisAggregateMember members[QUANTIS_AGGREGATE_MAX_DEVICES];
+  unsigned int membersCount;
+  unsigned int activeCount;
+  unsigned int nextMember; /* next member serving a small read */
+
+  /* Worker threads */
+  int running;
+  unsigned int requestsPending;
+  pthread_mutex_t mutex;
+  pthread_cond_t requestsDone;
+
+  char serialNumber[256];
+};
+
+/**
+ * Fills the list of the members with the devices given by the
+ * QUANTIS_AGGREGATE_DEVICES environment variable, a comma separated list of
+ * "pci:<number>" and "usb:<number>" entries, or with all the PCI and USB
+ * devices found when it is not set.
+ * @return the number of members.
+ */
+static unsigned int QuantisAggregateListDevices(QuantisDeviceType *deviceTypes,
+                                                unsigned int *deviceNumbers)
+{
+  const char *value = getenv("QUANTIS_AGGREGATE_DEVICES");
+  unsigned int count = 0u;
+  int i;
+
+  if ((value == NULL) || (*value == '\0'))
+  {
+    QuantisDeviceType types[] = {QUANTIS_DEVICE_PCI, QUANTIS_DEVICE_USB};
+    unsigned int t;
+    for (t = 0u; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+      int devicesCount = QuantisCount(types[t]);
+      for (i = 0; (i < devicesCount) && (count < QUANTIS_AGGREGATE_MAX_DEVICES); i++)
+      {
+        deviceTypes[count] = types[t];
+        deviceNumbers[count] = (unsigned int)i;
+        count++;
+      }
+    }
+    return count;
+  }
+
+  while ((*value != '\0') && (count < QUANTIS_AGGREGATE_MAX_DEVICES))
+  {
+    char *end = NULL;
+    unsigned long number;
+
+    if (strncmp(value, "pci:", 4) == 0)
+    {
+      deviceTypes[count] = QUANTIS_DEVICE_PCI;
+    }
+    else if (strncmp(value, "usb:", 4) == 0)
+    {
+      deviceTypes[count] = QUANTIS_DEVICE_USB;
+    }
+    else
+    {
+      /* Invalid entry, ignore the rest of the list */
+      break;
+    }
+
+    number = strtoul(value + 4, &end, 10);
+    if ((end == value + 4) || ((*end != ',') && (*end != '\0')) ||
+        (number >= MAX_QUANTIS_DEVICE))
+    {
+      break;
+    }
+    deviceNumbers[count] = (unsigned int)number;
+    count++;
+
+    value = (*end == ',') ? end + 1 : end;
+  }
+
+  return count;
+}
+
+/**
+ * Returns a modules mask with <em>count</em> modules.
+ */
+static int QuantisAggregateModulesMask(int count)
+{
+  if (count >= (int)(sizeof(int) * 8 - 1))
+  {
+    return 0x7fffffff;
+  }
+  return (1 << count) - 1;
+}
+
+/**
+ * Returns a monotonic time in milliseconds.
+ */
+static unsigned long long QuantisAggregateGetTimeMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000ull + (unsigned long long)ts.tv_nsec / 1000000ull;
+}
+
+/**
+ * Schedules the next attempt to open a dropped device, backing off while it
+ * keeps failing.
+ */
+static void QuantisAggregateScheduleRetry(QuantisAggregateMember *member)
+{
+  if (member->retryDelay == 0u)
+  {
+    member->retryDelay = QUANTIS_AGGREGATE_RETRY_MIN_DELAY;
+  }
+  else if (member->retryDelay < QUANTIS_AGGREGATE_RETRY_MAX_DELAY / 2u)
+  {
+    member->retryDelay *= 2u;
+  }
+  else
+  {
+    member->retryDelay = QUANTIS_AGGREGATE_RETRY_MAX_DELAY;
+  }
+  member->retryTime = QuantisAggregateGetTimeMs() + member->retryDelay;
+}
+
+/**
+ * Closes a device which failed and removes it from the aggregate until it
+ * is opened again by QuantisAggregateReprobe.
+ */
+static void QuantisAggregateDrop(QuantisPrivateData *aggregate, QuantisAggregateMember *member)
+{
+  if (member->deviceHandle == NULL)
+  {
+    return;
+  }
+
+  QuantisCloseInternal(member->deviceHandle);
+  member->deviceHandle = NULL;
+  aggregate->activeCount--;
+  QuantisAggregateScheduleRetry(member);
+}
+
+/**
+ * Opens again the dropped devices whose retry time has come, or all of them
+ * when <em>force</em> is set, and adds back the ones whose modules are fine.
+ * Must not be called while the worker threads read.
+ */
+static void QuantisAggregateReprobe(QuantisPrivateData *aggregate, int force)
+{
+  unsigned long long now = QuantisAggregateGetTimeMs();
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisAggregateMember *member = &aggregate->members[i];
+    QuantisDeviceHandle *deviceHandle = NULL;
+
+    if ((member->deviceHandle != NULL) || (!force && (now < member->retryTime)))
+    {
+      continue;
+    }
+
+    if (QuantisOpenInternal(member->deviceType, member->deviceNumber, &deviceHandle) < 0)
+    {
+      QuantisAggregateScheduleRetry(member);
+      continue;
+    }
+    if (deviceHandle->ops->GetModulesStatus(deviceHandle) <= 0)
+    {
+      QuantisCloseInternal(deviceHandle);
+      QuantisAggregateScheduleRetry(member);
+      continue;
+    }
+
+    member->deviceHandle = deviceHandle;
+    member->retryDelay = 0u;
+    aggregate->activeCount++;
+  }
+}
+
+/**
+ * Worker thread: reads from its device the parts of the requests assigned
+ * to it.
+ */
+static void *QuantisAggregateWorker(void *arg)
+{
+  QuantisAggregateMember *member = (QuantisAggregateMember *)arg;
+  QuantisPrivateData *aggregate = member->aggregate;
+  int result;
+
+  pthread_mutex_lock(&aggregate->mutex);
+  while (1)
+  {
+    while (aggregate->running && !member->pending)
+    {
+      pthread_cond_wait(&member->requestAvailable, &aggregate->mutex);
+    }
+    if (!aggregate->running)
+    {
+      break;
+    }
+    pthread_mutex_unlock(&aggregate->mutex);
+
+    result = QuantisReadHandled(member->deviceHandle, member->buffer, member->size);
+
+    pthread_mutex_lock(&aggregate->mutex);
+    member->result = result;
+    member->pending = 0;
+    aggregate->requestsPending--;
+    if (aggregate->requestsPending == 0u)
+    {
+      pthread_cond_signal(&aggregate->requestsDone);
+    }
+  }
+  pthread_mutex_unlock(&aggregate->mutex);
+
+  return NULL;
+}
+
+/**
+ * Reads a small request from a single device, the devices taking turns.
+ * Fails only when every device has failed, even after opening them again.
+ */
+static int QuantisAggregateReadSingle(QuantisPrivateData *aggregate,
+                                      unsigned char *buffer,
+                                      size_t size)
+{
+  int result = QUANTIS_ERROR_NO_DEVICE;
+  int reprobed = 0;
+
+  while (1)
+  {
+    QuantisAggregateMember *member;
+
+    if (aggregate->activeCount == 0u)
+    {
+      if (reprobed)
+      {
+        break;
+      }
+      QuantisAggregateReprobe(aggregate, 1);
+      reprobed = 1;
+      continue;
+    }
+
+    member = &aggregate->members[aggregate->nextMember];
+    aggregate->nextMember = (aggregate->nextMember + 1u) % aggregate->membersCount;
+    if (member->deviceHandle == NULL)
+    {
+      continue;
+    }
+
+    result = QuantisReadHandled(member->deviceHandle, buffer, size);
+    if (result == (int)size)
+    {
+      return result;
+    }
+
+    QuantisAggregateDrop(aggregate, member);
+    if (result >= 0)
+    {
+      result = QUANTIS_ERROR_IO;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Reads a large request: each device reads a contiguous stripe of the
+ * buffer in its worker thread. The stripes of the devices which failed are
+ * read again from the remaining ones.
+ */
+static int QuantisAggregateReadStriped(QuantisPrivateData *aggregate,
+                                       unsigned char *buffer,
+                                       size_t size)
+{
+  QuantisAggregateMember *failed[QUANTIS_AGGREGATE_MAX_DEVICES];
+  unsigned int failedCount = 0u;
+  unsigned int activeCount = aggregate->activeCount;
+  unsigned int stripe = 0u;
+  size_t offset = 0u;
+  unsigned int i;
+  int result = (int)size;
+
+  /* Assign stripes */
+  pthread_mutex_lock(&aggregate->mutex);
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisAggregateMember *member = &aggregate->members[i];
+    size_t end;
+    if (member->deviceHandle == NULL)
+    {
+      continue;
+    }
+
+    stripe++;
+    end = (size / activeCount) * stripe + ((stripe == activeCount) ? size % activeCount : 0u);
+    member->buffer = buffer + offset;
+    member->size = end - offset;
+    member->pending = 1;
+    aggregate->requestsPending++;
+    pthread_cond_signal(&member->requestAvailable);
+    offset = end;
+  }
+
+  /* Wait for the workers */
+  while (aggregate->requestsPending > 0u)
+  {
+    pthread_cond_wait(&aggregate->requestsDone, &aggregate->mutex);
+  }
+  pthread_mutex_unlock(&aggregate->mutex);
+
+  /* Drop the devices which failed */
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisAggregateMember *member = &aggregate->members[i];
+    if ((member->deviceHandle != NULL) && (member->result != (int)member->size))
+    {
+      QuantisAggregateDrop(aggregate, member);
+      failed[failedCount++] = member;
+    }
+  }
+
+  /* Read their stripes again */
+  for (i = 0u; (i < failedCount) && (result >= 0); i++)
+  {
+    if (aggregate->activeCount <= 1u)
+    {
+      result = QuantisAggregateReadSingle(aggregate, failed[i]->buffer, failed[i]->size);
+    }
+    else
+    {
+      result = QuantisAggregateReadStriped(aggregate, failed[i]->buffer, failed[i]->size);
+    }
+  }
+
+  return (result < 0) ? result : (int)size;
+}
+
+/* Board reset */
+int QuantisAggregateBoardReset(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int result = QUANTIS_SUCCESS;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if ((member != NULL) && (result == QUANTIS_SUCCESS))
+    {
+      result = member->ops->BoardReset(member);
+    }
+  }
+
+  return result;
+}
+
+/* Close */
+void QuantisAggregateClose(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  unsigned int i;
+
+  if (aggregate == NULL)
+  {
+    return;
+  }
+
+  /* Stop worker threads */
+  pthread_mutex_lock(&aggregate->mutex);
+  aggregate->running = 0;
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    pthread_cond_signal(&aggregate->members[i].requestAvailable);
+  }
+  pthread_mutex_unlock(&aggregate->mutex);
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisAggregateMember *member = &aggregate->members[i];
+    if (member->threadStarted)
+    {
+      pthread_join(member->thread, NULL);
+    }
+    QuantisAggregateDrop(aggregate, member);
+    pthread_cond_destroy(&member->requestAvailable);
+  }
+
+  pthread_cond_destroy(&aggregate->requestsDone);
+  pthread_mutex_destroy(&aggregate->mutex);
+  free(aggregate);
+  deviceHandle->privateData = NULL;
+}
+
+/* Count */
+int QuantisAggregateCount()
+{
+  QuantisDeviceType deviceTypes[QUANTIS_AGGREGATE_MAX_DEVICES];
+  unsigned int deviceNumbers[QUANTIS_AGGREGATE_MAX_DEVICES];
+
+  /* A single aggregate of all the devices */
+  return (QuantisAggregateListDevices(deviceTypes, deviceNumbers) > 0u) ? 1 : 0;
+}
+
+/* GetBoardVersion */
+int QuantisAggregateGetBoardVersion(QuantisDeviceHandle *deviceHandle)
+{
+  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  return QUANTIS_ERROR_OPERATION_NOT_SUPPORTED;
+}
+
+/* GetDriverVersion */
+float QuantisAggregateGetDriverVersion()
+{
+  /* Implemented by the library itself */
+  return QUANTIS_LIBRARY_VERSION;
+}
+
+/* GetManufacturer */
+char *QuantisAggregateGetManufacturer(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if (member != NULL)
+    {
+      return member->ops->GetManufacturer(member);
+    }
+  }
+
+  return (char *)QUANTIS_NOT_AVAILABLE;
+}
+
+/* GetModulesMask */
+int QuantisAggregateGetModulesMask(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int modulesCount = 0;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if (member != NULL)
+    {
+      int result = member->ops->GetModulesMask(member);
+      if (result < 0)
+      {
+        return result;
+      }
+      modulesCount += QuantisCountSetBits(result);
+    }
+  }
+
+  return QuantisAggregateModulesMask(modulesCount);
+}
+
+/* GetModulesDataRate */
+int QuantisAggregateGetModulesDataRate(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int dataRate = 0;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if (member != NULL)
+    {
+      int result = member->ops->GetModulesDataRate(member);
+      if (result < 0)
+      {
+        return result;
+      }
+      dataRate += result;
+    }
+  }
+
+  return dataRate;
+}
+
+/* GetModulesPower */
+int QuantisAggregateGetModulesPower(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int result = 0;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if (member != NULL)
+    {
+      /* Powered when all the devices are */
+      result = member->ops->GetModulesPower(member);
+      if (result <= 0)
+      {
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
+/* GetModulesStatus */
+int QuantisAggregateGetModulesStatus(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int modulesCount = 0;
+  unsigned int i;
+
+  QuantisAggregateReprobe(aggregate, 0);
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisAggregateMember *member = &aggregate->members[i];
+    if (member->deviceHandle != NULL)
+    {
+      int result = member->deviceHandle->ops->GetModulesStatus(member->deviceHandle);
+      if (result <= 0)
+      {
+        /* Keep serving from the other devices */
+        QuantisAggregateDrop(aggregate, member);
+        continue;
+      }
+      modulesCount += QuantisCountSetBits(result);
+    }
+  }
+
+  if (aggregate->activeCount == 0u)
+  {
+    return QUANTIS_ERROR_NO_DEVICE;
+  }
+
+  return QuantisAggregateModulesMask(modulesCount);
+}
+
+/* GetSerialNumber */
+char *QuantisAggregateGetSerialNumber(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  size_t length = 0u;
+  unsigned int i;
+
+  /* Comma separated list of the serial numbers of the devices */
+  aggregate->serialNumber[0] = '\0';
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if (member != NULL)
+    {
+      int written = snprintf(aggregate->serialNumber + length,
+                             sizeof(aggregate->serialNumber) - length,
+                             (length == 0u) ? "%s" : ",%s",
+                             member->ops->GetSerialNumber(member));
+      if ((written < 0) || ((size_t)written >= sizeof(aggregate->serialNumber) - length))
+      {
+        break;
+      }
+      length += (size_t)written;
+    }
+  }
+
+  return (length == 0u) ? (char *)QUANTIS_NO_SERIAL : aggregate->serialNumber;
+}
+
+/* ModulesDisable */
+int QuantisAggregateModulesDisable(QuantisDeviceHandle *deviceHandle, int moduleMask)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int result = QUANTIS_SUCCESS;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if ((member != NULL) && (result == QUANTIS_SUCCESS))
+    {
+      result = member->ops->ModulesDisable(member, moduleMask);
+    }
+  }
+
+  return result;
+}
+
+/* ModulesEnable */
+int QuantisAggregateModulesEnable(QuantisDeviceHandle *deviceHandle, int moduleMask)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int result = QUANTIS_SUCCESS;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if ((member != NULL) && (result == QUANTIS_SUCCESS))
+    {
+      result = member->ops->ModulesEnable(member, moduleMask);
+    }
+  }
+
+  return result;
+}
+
+/* Open */
+int QuantisAggregateOpen(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = NULL;
+  QuantisDeviceType deviceTypes[QUANTIS_AGGREGATE_MAX_DEVICES];
+  unsigned int deviceNumbers[QUANTIS_AGGREGATE_MAX_DEVICES];
+  unsigned int devicesCount;
+  unsigned int i;
+
+  /* There is a single aggregate */
+  if (deviceHandle->deviceNumber != 0)
+  {
+    return QUANTIS_ERROR_INVALID_DEVICE_NUMBER;
+  }
+
+  aggregate = (QuantisPrivateData *)malloc(sizeof(QuantisPrivateData));
+  if (aggregate == NULL)
+  {
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+  memset(aggregate, 0, sizeof(QuantisPrivateData));
+  aggregate->running = 1;
+  pthread_mutex_init(&aggregate->mutex, NULL);
+  pthread_cond_init(&aggregate->requestsDone, NULL);
+  deviceHandle->privateData = aggregate;
+
+  /* Open devices, the ones which cannot be opened are tried again later */
+  devicesCount = QuantisAggregateListDevices(deviceTypes, deviceNumbers);
+  for (i = 0u; i < devicesCount; i++)
+  {
+    QuantisAggregateMember *member = &aggregate->members[aggregate->membersCount];
+    member->aggregate = aggregate;
+    member->deviceType = deviceTypes[i];
+    member->deviceNumber = deviceNumbers[i];
+    pthread_cond_init(&member->requestAvailable, NULL);
+    aggregate->membersCount++;
+
+    if (QuantisOpenInternal(deviceTypes[i], deviceNumbers[i], &member->deviceHandle) < 0)
+    {
+      member->deviceHandle = NULL;
+      QuantisAggregateScheduleRetry(member);
+      continue;
+    }
+    aggregate->activeCount++;
+  }
+
+  /* On failure, QuantisAggregateClose is called by QuantisCloseInternal */
+  if (aggregate->activeCount == 0u)
+  {
+    return QUANTIS_ERROR_NO_DEVICE;
+  }
+
+  /* Start worker threads, not needed with a single device */
+  if (aggregate->membersCount > 1u)
+  {
+    for (i = 0u; i < aggregate->membersCount; i++)
+    {
+      QuantisAggregateMember *member = &aggregate->members[i];
+      if (pthread_create(&member->thread, NULL, QuantisAggregateWorker, member) != 0)
+      {
+        return QUANTIS_ERROR_OTHER;
+      }
+      member->threadStarted = 1;
+    }
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+/* Read */
+int QuantisAggregateRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+
+  if (size == 0u)
+  {
+    return 0;
+  }
+
+  /* Devices dropped after a failure come back */
+  QuantisAggregateReprobe(aggregate, 0);
+
+  if ((aggregate->activeCount <= 1u) || (size < QUANTIS_AGGREGATE_MIN_STRIPED_READ_SIZE))
+  {
+    /* Not worth waking the worker threads up */
+    return QuantisAggregateReadSingle(aggregate, (unsigned char *)buffer, size);
+  }
+
+  return QuantisAggregateReadStriped(aggregate, (unsigned char *)buffer, size);
+}
+
+int QuantisAggregateGetBusDeviceId(QuantisDeviceHandle *deviceHandle)
+{
+  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  return QUANTIS_ERROR_OPERATION_NOT_SUPPORTED;
+}
+
+char *QuantisAggregateTypeStrError(int errorNumber)
+{
+  errorNumber = errorNumber; /* Avoids unused parameter warning */
+  return (char *)NULL;
+}
+
+int QuantisAggregateGetAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int flag = 0;
+  unsigned int i;
+
+  /* Requested as soon as one device requests it */
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if (member != NULL)
+    {
+      int result = member->ops->GetAis31StartupTestsRequestFlag(member);
+      if (result < 0)
+      {
+        return result;
+      }
+      flag |= result;
+    }
+  }
+
+  return flag;
+}
+
+int QuantisAggregateClearAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *aggregate = (QuantisPrivateData *)deviceHandle->privateData;
+  int result = QUANTIS_SUCCESS;
+  unsigned int i;
+
+  for (i = 0u; i < aggregate->membersCount; i++)
+  {
+    QuantisDeviceHandle *member = aggregate->members[i].deviceHandle;
+    if ((member != NULL) && (result == QUANTIS_SUCCESS))
+    {
+      result = member->ops->ClearAis31StartupTestsRequestFlag(member);
+    }
+  }
+
+  return result;
+}
@@ -48,9 +48,23 @@
  * For history of changes, see ChangeLog.txt
  */
 
+#include <errno.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#if defined(unix) || defined(__unix) || defined(__unix__)
+#include <unistd.h> /* getpid, for fork detection */
+#define QUANTIS_FORK_DETECTION
+#endif
+
+#ifdef __linux__
+#include <linux/netlink.h> /* for device registry */
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 #include "Conversion.h"
 #include "Quantis.h"
@@ -65,6 +79,15 @@ char manufactuer[256];
 /* Size of the buffer used for QuantisReadXXX methods */
 #define QUANTIS_READ_XXX_BUFFER_SIZE 8
 
+/* Size of the random data buffer of the cached handles (QuantisReadScaledInt/Short) */
+#define QUANTIS_HANDLE_CACHE_BUFFER_SIZE 256
+
+/* Time (in milliseconds) the device registry is trusted without uevents */
+#define QUANTIS_REGISTRY_TIMEOUT 1000
+
+/* Size of the serial numbers kept by the device registry */
+#define QUANTIS_REGISTRY_SERIAL_SIZE 64
+
 #ifndef DISABLE_QUANTIS_PCI
 QuantisOperations QuantisOperationsPci =
     {
@@ -115,24 +138,650 @@ QuantisOperations QuantisOperationsUsb =
 };
 #endif /* DISABLE_QUANTIS_USB */
 
+QuantisOperations QuantisOperationsAggregate =
+    {
+        /*.BoardReset = */ QuantisAggregateBoardReset,
+        /*.Close = */ QuantisAggregateClose,
+        /*.Count = */ QuantisAggregateCount,
+        /*.GetBoardVersion = */ QuantisAggregateGetBoardVersion,
+        /*.GetDriverVersion = */ QuantisAggregateGetDriverVersion,
+        /*.GetManufacturer = */ QuantisAggregateGetManufacturer,
+        /*.GetModulesMask = */ QuantisAggregateGetModulesMask,
+        /*.GetModulesDataRate = */ QuantisAggregateGetModulesDataRate,
+        /*.GetModulesPower = */ QuantisAggregateGetModulesPower,
+        /*.GetModulesStatus = */ QuantisAggregateGetModulesStatus,
+        /*.GetSerialNumber = */ QuantisAggregateGetSerialNumber,
+        /*.ModulesDisable = */ QuantisAggregateModulesDisable,
+        /*.ModulesEnable = */ QuantisAggregateModulesEnable,
+        /*.Open = */ QuantisAggregateOpen,
+        /*.Read = */ QuantisAggregateRead,
+        /*.GetBusDeviceId = */ QuantisAggregateGetBusDeviceId,
+        /*.QuantisTypeStrError = */ QuantisAggregateTypeStrError,
+        /*.GetAis31StartupTestsRequestFlag*/ QuantisAggregateGetAis31StartupTestsRequestFlag,
+        /*.ClearAis31StartupTestsRequestFlag*/ QuantisAggregateClearAis31StartupTestsRequestFlag};
+
+#ifndef DISABLE_QUANTIS_REMOTE
+QuantisOperations QuantisOperationsRemote =
+    {
+        /*.BoardReset = */ QuantisRemoteBoardReset,
+        /*.Close = */ QuantisRemoteClose,
+        /*.Count = */ QuantisRemoteCount,
+        /*.GetBoardVersion = */ QuantisRemoteGetBoardVersion,
+        /*.GetDriverVersion = */ QuantisRemoteGetDriverVersion,
+        /*.GetManufacturer = */ QuantisRemoteGetManufacturer,
+        /*.GetModulesMask = */ QuantisRemoteGetModulesMask,
+        /*.GetModulesDataRate = */ QuantisRemoteGetModulesDataRate,
+        /*.GetModulesPower = */ QuantisRemoteGetModulesPower,
+        /*.GetModulesStatus = */ QuantisRemoteGetModulesStatus,
+        /*.GetSerialNumber = */ QuantisRemoteGetSerialNumber,
+        /*.ModulesDisable = */ QuantisRemoteModulesDisable,
+        /*.ModulesEnable = */ QuantisRemoteModulesEnable,
+        /*.Open = */ QuantisRemoteOpen,
+        /*.Read = */ QuantisRemoteRead,
+        /*.GetBusDeviceId = */ QuantisRemoteGetBusDeviceId,
+        /*.QuantisTypeStrError = */ QuantisRemoteTypeStrError,
+        /*.GetAis31StartupTestsRequestFlag*/ QuantisRemoteGetAis31StartupTestsRequestFlag,
+        /*.ClearAis31StartupTestsRequestFlag*/ QuantisRemoteClearAis31StartupTestsRequestFlag};
+#endif /* DISABLE_QUANTIS_REMOTE */
+
+/* ---------------------------- Handle cache ---------------------------- */
+
+/**
+ * Device handle kept open by the stateless API (QuantisRead, QuantisReadInt,
+ * QuantisGetModulesStatus...) so that each call does not pay a full device
+ * open and close.
+ *
+ * Entries are never freed once created, only their deviceHandle is closed,
+ * so a pointer to an entry stays valid for the whole life of the process.
+ *
+ * A forked child inherits the handles of its parent, which share its file
+ * descriptors, libusb handles and sockets. The child does not use nor close
+ * them, it opens its own (see QuantisHandleCacheCheckOwner). It drops the
+ * buffered random data too, which would otherwise be served by both.
+ */
+typedef struct QuantisHandleCacheEntry
+{
+  QuantisDeviceType deviceType;
+  unsigned int deviceNumber;
+  QuantisDeviceHandle *deviceHandle; /* NULL when the device is not open */
+  pthread_mutex_t mutex;             /* serializes requests on deviceHandle */
+#ifdef QUANTIS_FORK_DETECTION
+  pid_t ownerPid; /* process which opened deviceHandle and filled buffer */
+#endif
+  /* random data read in advance for QuantisReadScaledInt/Short */
+  unsigned char buffer[QUANTIS_HANDLE_CACHE_BUFFER_SIZE];
+  size_t bufferOffset;
+  size_t bufferSize;
+  struct QuantisHandleCacheEntry *next;
+} QuantisHandleCacheEntry;
+
+/* Protects the list of entries, not the entries themselves */
+static pthread_mutex_t quantisHandleCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+static QuantisHandleCacheEntry *quantisHandleCache = NULL;
+
+static int QuantisOpenDevice(QuantisDeviceType deviceType,
+                             unsigned int deviceNumber,
+                             QuantisDeviceHandle **deviceHandle);
+
+/**
+ * Returns the cache entry of a device, creating it when needed.
+ * @return the entry or NULL when memory allocation failed.
+ */
+static QuantisHandleCacheEntry *QuantisHandleCacheLookup(QuantisDeviceType deviceType,
+                                                         unsigned int deviceNumber,
+                                                         int create)
+{
+  QuantisHandleCacheEntry *entry;
+
+  pthread_mutex_lock(&quantisHandleCacheMutex);
+
+  for (entry = quantisHandleCache; entry != NULL; entry = entry->next)
+  {
+    if ((entry->deviceType == deviceType) && (entry->deviceNumber == deviceNumber))
+    {
+      break;
+    }
+  }
+
+  if ((entry == NULL) && create)
+  {
+    entry = (QuantisHandleCacheEntry *)malloc(sizeof(QuantisHandleCacheEntry));
+    if (entry)
+    {
+      entry->deviceType = deviceType;
+      entry->deviceNumber = deviceNumber;
+      entry->deviceHandle = NULL;
+      entry->bufferOffset = 0u;
+      entry->bufferSize = 0u;
+#ifdef QUANTIS_FORK_DETECTION
+      entry->ownerPid = getpid();
+#endif
+      pthread_mutex_init(&entry->mutex, NULL);
+      entry->next = quantisHandleCache;
+      quantisHandleCache = entry;
+    }
+  }
+
+  pthread_mutex_unlock(&quantisHandleCacheMutex);
+
+  return entry;
+}
+
+/**
+ * Forgets the handle of an entry inherited from the parent process, without
+ * closing it: that would release the USB interface or the socket the parent
+ * still uses. Drops the random data the parent buffered, so that parent and
+ * child never return the same bytes. Must be called with the mutex of the
+ * entry locked.
+ */
+static void QuantisHandleCacheCheckOwner(QuantisHandleCacheEntry *entry)
+{
+#ifdef QUANTIS_FORK_DETECTION
+  if (entry->ownerPid != getpid())
+  {
+    entry->deviceHandle = NULL;
+    memset(entry->buffer, 0, sizeof(entry->buffer));
+    entry->bufferOffset = 0u;
+    entry->bufferSize = 0u;
+    entry->ownerPid = getpid();
+  }
+#endif
+}
+
+/**
+ * Gets an open handle on the device from the cache, opening the device if it
+ * is not open yet. On success the entry is returned locked and MUST be given
+ * back with QuantisHandleCacheRelease.
+ * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+ */
+static int QuantisHandleCacheAcquire(QuantisDeviceType deviceType,
+                                     unsigned int deviceNumber,
+                                     QuantisHandleCacheEntry **cacheEntry)
+{
+  QuantisHandleCacheEntry *entry;
+  int result;
+
+  /* Consistency checks (avoids creating entries for invalid devices) */
+  if (deviceNumber >= MAX_QUANTIS_DEVICE)
+  {
+    return QUANTIS_ERROR_INVALID_DEVICE_NUMBER;
+  }
+
+  entry = QuantisHandleCacheLookup(deviceType, deviceNumber, 1);
+  if (!entry)
+  {
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+
+  pthread_mutex_lock(&entry->mutex);
+  QuantisHandleCacheCheckOwner(entry);
+
+  if (!entry->deviceHandle)
+  {
+    result = QuantisOpenDevice(deviceType, deviceNumber, &entry->deviceHandle);
+    if (result < 0)
+    {
+      entry->deviceHandle = NULL;
+      pthread_mutex_unlock(&entry->mutex);
+      return result;
+    }
+  }
+
+  *cacheEntry = entry;
+
+  return QUANTIS_SUCCESS;
+}
+
+/**
+ * Gives back an entry obtained with QuantisHandleCacheAcquire.
+ * @param result the result of the request performed on the handle. On
+ * failure the handle is closed, so that a device which has been unplugged or
+ * which returned an I/O error is opened again on next request.
+ */
+static void QuantisHandleCacheRelease(QuantisHandleCacheEntry *entry, int result)
+{
+  if (result < 0)
+  {
+    QuantisCloseInternal(entry->deviceHandle);
+    entry->deviceHandle = NULL;
+    entry->bufferSize = 0u;
+  }
+
+  pthread_mutex_unlock(&entry->mutex);
+}
+
+/**
+ * Reads random data from the buffer of the cache entry of a device, which is
+ * refilled with QUANTIS_HANDLE_CACHE_BUFFER_SIZE bytes when it does not hold
+ * enough data.
+ * @param size the number of bytes to read (not larger than
+ * QUANTIS_HANDLE_CACHE_BUFFER_SIZE).
+ * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+ */
+static int QuantisHandleCacheReadBuffered(QuantisDeviceType deviceType,
+                                          unsigned int deviceNumber,
+                                          void *buffer,
+                                          size_t size)
+{
+  int result = QUANTIS_SUCCESS;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
+
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
+  if (result < 0)
+  {
+    return result;
+  }
+
+  /* Refill buffer */
+  if (cacheEntry->bufferSize - cacheEntry->bufferOffset < size)
+  {
+    result = cacheEntry->deviceHandle->ops->Read(cacheEntry->deviceHandle,
+                                                 cacheEntry->buffer,
+                                                 sizeof(cacheEntry->buffer));
+    cacheEntry->bufferOffset = 0u;
+    cacheEntry->bufferSize = (result < 0) ? 0u : (size_t)result;
+  }
+
+  if (result >= 0)
+  {
+    if (cacheEntry->bufferSize - cacheEntry->bufferOffset < size)
+    {
+      result = QUANTIS_ERROR_IO;
+    }
+    else
+    {
+      memcpy(buffer, cacheEntry->buffer + cacheEntry->bufferOffset, size);
+      cacheEntry->bufferOffset += size;
+      result = QUANTIS_SUCCESS;
+    }
+  }
+
+  /* Give device handle back (closes it on error) */
+  QuantisHandleCacheRelease(cacheEntry, result);
+
+  return result;
+}
+
+/**
+ * Closes the cached handle of a device, if any. This is required before
+ * opening the device explicitly since a Quantis USB can only be claimed once.
+ */
+static void QuantisHandleCacheEvict(QuantisDeviceType deviceType,
+                                    unsigned int deviceNumber)
+{
+  QuantisHandleCacheEntry *entry = QuantisHandleCacheLookup(deviceType, deviceNumber, 0);
+  if (!entry)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&entry->mutex);
+  QuantisHandleCacheCheckOwner(entry);
+  QuantisCloseInternal(entry->deviceHandle);
+  entry->deviceHandle = NULL;
+  entry->bufferSize = 0u;
+  pthread_mutex_unlock(&entry->mutex);
+}
+
+int QuantisHandleCacheRequest(QuantisDeviceType deviceType,
+                              unsigned int deviceNumber,
+                              int (*request)(QuantisDeviceHandle *deviceHandle, void *argument),
+                              void *argument)
+{
+  QuantisHandleCacheEntry *entry = NULL;
+  int result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &entry);
+  if (result < 0)
+  {
+    return result;
+  }
+
+  result = request(entry->deviceHandle, argument);
+
+  QuantisHandleCacheRelease(entry, result);
+
+  return result;
+}
+
+void QuantisCloseCachedHandles()
+{
+  QuantisHandleCacheEntry *entry;
+
+  pthread_mutex_lock(&quantisHandleCacheMutex);
+  for (entry = quantisHandleCache; entry != NULL; entry = entry->next)
+  {
+    pthread_mutex_lock(&entry->mutex);
+    QuantisHandleCacheCheckOwner(entry);
+    QuantisCloseInternal(entry->deviceHandle);
+    entry->deviceHandle = NULL;
+    entry->bufferSize = 0u;
+    pthread_mutex_unlock(&entry->mutex);
+  }
+  pthread_mutex_unlock(&quantisHandleCacheMutex);
+}
+
+/* --------------------------- Device registry --------------------------- */
+
+/**
+ * Number of devices, driver version and serial numbers of the PCI and USB
+ * devices, answered from memory so that probing the devices does not scan
+ * /dev, walk the USB bus or open a device on each call.
+ *
+ * On Linux, the registry is refreshed when the kernel reports that a Quantis
+ * device has been added or removed (uevents). When uevents are not available, it is
+ * refreshed every QUANTIS_REGISTRY_TIMEOUT milliseconds. QuantisRescanDevices
+ * refreshes it on demand.
+ */
+typedef struct QuantisRegistryEntry
+{
+  unsigned int generation; /* quantisRegistryGeneration when filled */
+  int count;               /* -1 when unknown */
+  int driverVersionKnown;
+  float driverVersion;
+  char serialNumbers[MAX_QUANTIS_DEVICE][QUANTIS_REGISTRY_SERIAL_SIZE]; /* "" when unknown */
+} QuantisRegistryEntry;
+
+/* Subsystem of the character devices of the PCI driver (its class) */
+#define QUANTIS_REGISTRY_PCI_SUBSYSTEM "quantis_chip_pcie"
+
+/* Uevent PRODUCT prefix of Quantis USB (vendor 0x0ABA, in lowercase hex) */
+#define QUANTIS_REGISTRY_USB_PRODUCT "aba/"
+
+/* Index of the entries of PCI and USB devices */
+#define QUANTIS_REGISTRY_PCI 0
+#define QUANTIS_REGISTRY_USB 1
+
+static pthread_mutex_t quantisRegistryMutex = PTHREAD_MUTEX_INITIALIZER;
+static QuantisRegistryEntry quantisRegistry[2];
+/* Starts at 1, so that entries (generation 0) are filled on first use */
+static unsigned int quantisRegistryGeneration = 1u;
+static unsigned long long quantisRegistryTime = 0ull;
+
+#ifdef __linux__
+/* Socket receiving kernel uevents, -1 when not open, -2 when not available */
+static int quantisRegistrySocket = -1;
+/* Process which opened the socket, a forked child must open its own */
+static pid_t quantisRegistryPid = 0;
+#endif
+
+static unsigned long long QuantisGetTimeMs();
+
+#ifdef __linux__
+/**
+ * Tells whether a uevent adds or removes a Quantis device: a character device
+ * of the PCI driver, a device bound to it, or a Quantis USB. The other
+ * devices (disks, network interfaces, ...) leave the registry valid.
+ * @param message the uevent, "<action>@<devpath>" followed by the
+ * "KEY=value" environment, separated by '\0'.
+ */
+static int QuantisRegistryIsDeviceEvent(const char *message, size_t length)
+{
+  size_t offset;
+  int usb = 0;
+  int quantisUsb = 0;
+
+  if ((strncmp(message, "add@", 4) != 0) && (strncmp(message, "remove@", 7) != 0))
+  {
+    return 0;
+  }
+
+  for (offset = strlen(message) + 1u; offset < length; offset += strlen(message + offset) + 1u)
+  {
+    const char *variable = message + offset;
+
+    if ((strcmp(variable, "SUBSYSTEM=" QUANTIS_REGISTRY_PCI_SUBSYSTEM) == 0) ||
+        (strcmp(variable, "DRIVER=" QUANTIS_REGISTRY_PCI_SUBSYSTEM) == 0))
+    {
+      return 1;
+    }
+    else if (strcmp(variable, "SUBSYSTEM=usb") == 0)
+    {
+      usb = 1;
+    }
+    else if (strncmp(variable, "PRODUCT=" QUANTIS_REGISTRY_USB_PRODUCT,
+                     sizeof("PRODUCT=" QUANTIS_REGISTRY_USB_PRODUCT) - 1u) == 0)
+    {
+      quantisUsb = 1;
+    }
+  }
+
+  return usb && quantisUsb;
+}
+#endif
+
+/**
+ * Invalidates the registry when devices may have been added or removed
+ * since it was filled. Must be called with quantisRegistryMutex locked.
+ */
+static void QuantisRegistryPoll()
+{
+  unsigned long long now;
+
+#ifdef __linux__
+  char message[2048];
+  ssize_t length;
+
+  if ((quantisRegistrySocket >= 0) && (quantisRegistryPid != getpid()))
+  {
+    /* Events would be shared with the parent process */
+    close(quantisRegistrySocket);
+    quantisRegistrySocket = -1;
+  }
+
+  if (quantisRegistrySocket == -1)
+  {
+    struct sockaddr_nl address;
+
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1u; /* kernel uevents */
+
+    quantisRegistrySocket = socket(AF_NETLINK,
+                                   SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                                   NETLINK_KOBJECT_UEVENT);
+    if ((quantisRegistrySocket >= 0) &&
+        (bind(quantisRegistrySocket, (struct sockaddr *)&address, sizeof(address)) < 0))
+    {
+      close(quantisRegistrySocket);
+      quantisRegistrySocket = -1;
+    }
+
+    if (quantisRegistrySocket >= 0)
+    {
+      /* Events received before the socket was opened are lost */
+      quantisRegistryPid = getpid();
+      quantisRegistryGeneration++;
+    }
+    else
+    {
+      /* Not available (e.g. sandboxed), falls back to the timeout */
+      quantisRegistrySocket = -2;
+    }
+  }
+
+  if (quantisRegistrySocket >= 0)
+  {
+    /* Uevents are "<action>@<devpath>" followed by the environment */
+    while ((length = recv(quantisRegistrySocket, message, sizeof(message) - 1u, MSG_DONTWAIT)) != 0)
+    {
+      if (length < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        else if (errno == ENOBUFS)
+        {
+          /* Events have been dropped */
+          quantisRegistryGeneration++;
+          continue;
+        }
+        break;
+      }
+
+      message[length] = '\0';
+      if (QuantisRegistryIsDeviceEvent(message, (size_t)length))
+      {
+        quantisRegistryGeneration++;
+      }
+    }
+    return;
+  }
+#endif
+
+  now = QuantisGetTimeMs();
+  if (now - quantisRegistryTime >= QUANTIS_REGISTRY_TIMEOUT)
+  {
+    quantisRegistryTime = now;
+    quantisRegistryGeneration++;
+  }
+}
+
+/**
+ * Returns the up to date registry entry of a device type, locking the
+ * registry. The entry MUST be given back with QuantisRegistryRelease.
+ * @return the entry or NULL (with the registry unlocked) when the devices of
+ * this type are not registered.
+ */
+static QuantisRegistryEntry *QuantisRegistryAcquire(QuantisDeviceType deviceType)
+{
+  QuantisRegistryEntry *entry;
+
+  switch (deviceType)
+  {
+  case QUANTIS_DEVICE_PCI:
+    entry = &quantisRegistry[QUANTIS_REGISTRY_PCI];
+    break;
+
+  case QUANTIS_DEVICE_USB:
+    entry = &quantisRegistry[QUANTIS_REGISTRY_USB];
+    break;
+
+  default:
+    return NULL;
+  }
+
+  pthread_mutex_lock(&quantisRegistryMutex);
+
+  QuantisRegistryPoll();
+  if (entry->generation != quantisRegistryGeneration)
+  {
+    memset(entry, 0, sizeof(QuantisRegistryEntry));
+    entry->generation = quantisRegistryGeneration;
+    entry->count = -1;
+  }
+
+  return entry;
+}
+
+static void QuantisRegistryRelease()
+{
+  pthread_mutex_unlock(&quantisRegistryMutex);
+}
+
+/**
+ * Returns the number of devices of a type from the registry, counting them
+ * with <em>count</em> when unknown.
+ */
+static int QuantisRegistryCount(QuantisDeviceType deviceType, int (*count)())
+{
+  QuantisRegistryEntry *entry = QuantisRegistryAcquire(deviceType);
+  int result;
+
+  if (entry == NULL)
+  {
+    return count();
+  }
+
+  if (entry->count < 0)
+  {
+    /* Many threads probing the devices at once scan them only once */
+    result = count();
+    if (result >= 0)
+    {
+      entry->count = result;
+    }
+  }
+  else
+  {
+    result = entry->count;
+  }
+
+  QuantisRegistryRelease();
+
+  return result;
+}
+
+/**
+ * Returns the version of the driver of a device type from the registry,
+ * asking <em>getDriverVersion</em> when unknown.
+ */
+static float QuantisRegistryGetDriverVersion(QuantisDeviceType deviceType,
+                                             float (*getDriverVersion)())
+{
+  QuantisRegistryEntry *entry = QuantisRegistryAcquire(deviceType);
+  unsigned int generation;
+  float result;
+
+  if (entry == NULL)
+  {
+    return getDriverVersion();
+  }
+
+  if (entry->driverVersionKnown)
+  {
+    result = entry->driverVersion;
+    QuantisRegistryRelease();
+    return result;
+  }
+  generation = entry->generation;
+  QuantisRegistryRelease();
+
+  /* May open a device, the registry must not be locked meanwhile */
+  result = getDriverVersion();
+
+  /* 0.0 means there is no device yet */
+  if (result > 0.0f)
+  {
+    entry = QuantisRegistryAcquire(deviceType);
+    if (entry->generation == generation)
+    {
+      entry->driverVersion = result;
+      entry->driverVersionKnown = 1;
+    }
+    QuantisRegistryRelease();
+  }
+
+  return result;
+}
+
+void QuantisRescanDevices()
+{
+  pthread_mutex_lock(&quantisRegistryMutex);
+  quantisRegistryGeneration++;
+  pthread_mutex_unlock(&quantisRegistryMutex);
+}
+
+/* ------------------------------------------------------------------------ */
+
 int QuantisBoardReset(QuantisDeviceType deviceType,
                       unsigned int deviceNumber)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->BoardReset(deviceHandle);
+  result = cacheEntry->deviceHandle->ops->BoardReset(cacheEntry->deviceHandle);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -160,20 +809,20 @@ int QuantisGetBoardVersion(QuantisDeviceType deviceType,
                            unsigned int deviceNumber)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->GetBoardVersion(deviceHandle);
+  result = cacheEntry->deviceHandle->ops->GetBoardVersion(cacheEntry->deviceHandle);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -185,16 +834,26 @@ int QuantisCount(QuantisDeviceType deviceType)
   {
 #ifndef DISABLE_QUANTIS_PCI
   case QUANTIS_DEVICE_PCI:
-    result = QuantisOperationsPci.Count();
+    result = QuantisRegistryCount(deviceType, QuantisOperationsPci.Count);
     break;
 #endif /* DISABLE_QUANTIS_PCI */
 
 #ifndef DISABLE_QUANTIS_USB
   case QUANTIS_DEVICE_USB:
-    result = QuantisOperationsUsb.Count();
+    result = QuantisRegistryCount(deviceType, QuantisOperationsUsb.Count);
     break;
 #endif /* DISABLE_QUANTIS_USB */
 
+  case QUANTIS_DEVICE_AGGREGATE:
+    result = QuantisOperationsAggregate.Count();
+    break;
+
+#ifndef DISABLE_QUANTIS_REMOTE
+  case QUANTIS_DEVICE_REMOTE:
+    result = QuantisOperationsRemote.Count();
+    break;
+#endif /* DISABLE_QUANTIS_REMOTE */
+
   default:
     result = 0;
     break;
@@ -224,16 +883,26 @@ float QuantisGetDriverVersion(QuantisDeviceType deviceType)
   {
 #ifndef DISABLE_QUANTIS_PCI
   case QUANTIS_DEVICE_PCI:
-    result = QuantisOperationsPci.GetDriverVersion();
+    result = QuantisRegistryGetDriverVersion(deviceType, QuantisOperationsPci.GetDriverVersion);
     break;
 #endif /* DISABLE_QUANTIS_PCI */
 
 #ifndef DISABLE_QUANTIS_USB
   case QUANTIS_DEVICE_USB:
-    result = QuantisOperationsUsb.GetDriverVersion();
+    result = QuantisRegistryGetDriverVersion(deviceType, QuantisOperationsUsb.GetDriverVersion);
     break;
 #endif /* DISABLE_QUANTIS_USB */
 
+  case QUANTIS_DEVICE_AGGREGATE:
+    result = QuantisOperationsAggregate.GetDriverVersion();
+    break;
+
+#ifndef DISABLE_QUANTIS_REMOTE
+  case QUANTIS_DEVICE_REMOTE:
+    result = QuantisOperationsRemote.GetDriverVersion();
+    break;
+#endif /* DISABLE_QUANTIS_REMOTE */
+
   default:
     result = (float)QUANTIS_ERROR_NO_DRIVER;
     break;
@@ -247,21 +916,21 @@ char *QuantisGetManufacturer(QuantisDeviceType deviceType,
 {
   int result = 0;
   char *sn = NULL;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return (char *)QUANTIS_NOT_AVAILABLE;
   }
 
   /* Perform request and copy string locally */
-  sn = deviceHandle->ops->GetManufacturer(deviceHandle);
+  sn = cacheEntry->deviceHandle->ops->GetManufacturer(cacheEntry->deviceHandle);
   memcpy(manufactuer, sn, strlen(sn));
   manufactuer[strlen(sn)] = 0;
 
-  QuantisCloseInternal(deviceHandle);
+  QuantisHandleCacheRelease(cacheEntry, QUANTIS_SUCCESS);
 
   return manufactuer;
 }
@@ -282,20 +951,20 @@ int QuantisGetModulesMask(QuantisDeviceType deviceType,
                           unsigned int deviceNumber)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->GetModulesMask(deviceHandle);
+  result = cacheEntry->deviceHandle->ops->GetModulesMask(cacheEntry->deviceHandle);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -309,20 +978,20 @@ int QuantisGetModulesDataRate(QuantisDeviceType deviceType,
                               unsigned int deviceNumber)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->GetModulesDataRate(deviceHandle);
+  result = cacheEntry->deviceHandle->ops->GetModulesDataRate(cacheEntry->deviceHandle);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -331,20 +1000,20 @@ int QuantisGetModulesPower(QuantisDeviceType deviceType,
                            unsigned int deviceNumber)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->GetModulesPower(deviceHandle);
+  result = cacheEntry->deviceHandle->ops->GetModulesPower(cacheEntry->deviceHandle);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -353,20 +1022,20 @@ int QuantisGetModulesStatus(QuantisDeviceType deviceType,
                             unsigned int deviceNumber)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->GetModulesStatus(deviceHandle);
+  result = cacheEntry->deviceHandle->ops->GetModulesStatus(cacheEntry->deviceHandle);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -376,21 +1045,53 @@ char *QuantisGetSerialNumber(QuantisDeviceType deviceType,
 {
   int result = 0;
   char *sn = NULL;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
+  QuantisRegistryEntry *registryEntry = NULL;
+  unsigned int generation = 0u;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Serial number known by the registry */
+  if (deviceNumber < MAX_QUANTIS_DEVICE)
+  {
+    registryEntry = QuantisRegistryAcquire(deviceType);
+  }
+  if (registryEntry != NULL)
+  {
+    if (registryEntry->serialNumbers[deviceNumber][0] != '\0')
+    {
+      strcpy(serialNumber, registryEntry->serialNumbers[deviceNumber]);
+      QuantisRegistryRelease();
+      return serialNumber;
+    }
+    generation = registryEntry->generation;
+    QuantisRegistryRelease();
+  }
+
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return (char *)QUANTIS_NO_SERIAL;
   }
 
   /* Perform request and copy serial number locally */
-  sn = deviceHandle->ops->GetSerialNumber(deviceHandle);
+  sn = cacheEntry->deviceHandle->ops->GetSerialNumber(cacheEntry->deviceHandle);
   memcpy(serialNumber, sn, strlen(sn));
   serialNumber[strlen(sn)] = 0;
 
-  QuantisCloseInternal(deviceHandle);
+  QuantisHandleCacheRelease(cacheEntry, QUANTIS_SUCCESS);
+
+  /* Remember it, unless the devices changed meanwhile */
+  if ((registryEntry != NULL) &&
+      (strcmp(serialNumber, QUANTIS_NO_SERIAL) != 0) &&
+      (strlen(serialNumber) < QUANTIS_REGISTRY_SERIAL_SIZE))
+  {
+    registryEntry = QuantisRegistryAcquire(deviceType);
+    if (registryEntry->generation == generation)
+    {
+      strcpy(registryEntry->serialNumbers[deviceNumber], serialNumber);
+    }
+    QuantisRegistryRelease();
+  }
 
   return serialNumber;
 }
@@ -400,20 +1101,20 @@ int QuantisModulesDisable(QuantisDeviceType deviceType,
                           int modulesMask)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->ModulesDisable(deviceHandle, modulesMask);
+  result = cacheEntry->deviceHandle->ops->ModulesDisable(cacheEntry->deviceHandle, modulesMask);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -423,20 +1124,20 @@ int QuantisModulesEnable(QuantisDeviceType deviceType,
                          int modulesMask)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->ModulesEnable(deviceHandle, modulesMask);
+  result = cacheEntry->deviceHandle->ops->ModulesEnable(cacheEntry->deviceHandle, modulesMask);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -446,24 +1147,24 @@ int QuantisModulesReset(QuantisDeviceType deviceType,
                         int modulesMask)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Perform request */
-  result = deviceHandle->ops->ModulesDisable(deviceHandle, modulesMask);
+  result = cacheEntry->deviceHandle->ops->ModulesDisable(cacheEntry->deviceHandle, modulesMask);
   if (result == QUANTIS_SUCCESS)
   {
-    result = deviceHandle->ops->ModulesEnable(deviceHandle, modulesMask);
+    result = cacheEntry->deviceHandle->ops->ModulesEnable(cacheEntry->deviceHandle, modulesMask);
   }
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
+  /* Give device handle back */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -501,6 +1202,16 @@ int QuantisClearAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle)
 int QuantisOpenInternal(QuantisDeviceType deviceType,
                         unsigned int deviceNumber,
                         QuantisDeviceHandle **deviceHandle)
+{
+  /* The device may be held by the handle cache of the stateless functions */
+  QuantisHandleCacheEvict(deviceType, deviceNumber);
+
+  return QuantisOpenDevice(deviceType, deviceNumber, deviceHandle);
+}
+
+static int QuantisOpenDevice(QuantisDeviceType deviceType,
+                             unsigned int deviceNumber,
+                             QuantisDeviceHandle **deviceHandle)
 {
   QuantisDeviceHandle *_deviceHandle = NULL;
   QuantisOperations *quantisOperations = NULL;
@@ -526,6 +1237,16 @@ int QuantisOpenInternal(QuantisDeviceType deviceType,
     break;
 #endif /* DISABLE_QUANTIS_USB */
 
+  case QUANTIS_DEVICE_AGGREGATE:
+    quantisOperations = &QuantisOperationsAggregate;
+    break;
+
+#ifndef DISABLE_QUANTIS_REMOTE
+  case QUANTIS_DEVICE_REMOTE:
+    quantisOperations = &QuantisOperationsRemote;
+    break;
+#endif /* DISABLE_QUANTIS_REMOTE */
+
   default:
     return QUANTIS_ERROR_NO_DEVICE;
     break;
@@ -543,6 +1264,9 @@ int QuantisOpenInternal(QuantisDeviceType deviceType,
   _deviceHandle->deviceType = deviceType;
   _deviceHandle->ops = quantisOperations;
   _deviceHandle->privateData = NULL;
+  QuantisSetStatusCheckPolicy(_deviceHandle,
+                              QUANTIS_STATUS_CHECK_DEFAULT_POLICY,
+                              QUANTIS_STATUS_CHECK_DEFAULT_INTERVAL);
 
   /* Open device */
   result = _deviceHandle->ops->Open(_deviceHandle);
@@ -564,7 +1288,7 @@ int QuantisRead(QuantisDeviceType deviceType,
                 size_t size)
 {
   int result;
-  QuantisDeviceHandle *deviceHandle = NULL;
+  QuantisHandleCacheEntry *cacheEntry = NULL;
 
   if (size == 0u)
   {
@@ -575,19 +1299,18 @@ int QuantisRead(QuantisDeviceType deviceType,
     return QUANTIS_ERROR_INVALID_READ_SIZE;
   }
 
-  /* Open device */
-  result = QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle);
+  /* Get device handle */
+  result = QuantisHandleCacheAcquire(deviceType, deviceNumber, &cacheEntry);
   if (result < 0)
   {
     return result;
   }
 
   /* Read data */
-  result = deviceHandle->ops->Read(deviceHandle, buffer, size);
+  result = cacheEntry->deviceHandle->ops->Read(cacheEntry->deviceHandle, buffer, size);
 
-  /* Close device */
-  QuantisCloseInternal(deviceHandle);
-  deviceHandle = NULL;
+  /* Give device handle back (closes it on error) */
+  QuantisHandleCacheRelease(cacheEntry, result);
 
   return result;
 }
@@ -632,6 +1355,109 @@ int QuantisReadHandled(QuantisDeviceHandle *deviceHandle,
   return result;
 }
 
+/* ------------------------- Status check policy ------------------------- */
+
+/**
+ * Returns a monotonic time in milliseconds.
+ */
+static unsigned long long QuantisGetTimeMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000ull + (unsigned long long)ts.tv_nsec / 1000000ull;
+}
+
+int QuantisSetStatusCheckPolicy(QuantisDeviceHandle *deviceHandle,
+                                QuantisStatusCheckPolicy policy,
+                                unsigned int interval)
+{
+  if (deviceHandle == NULL)
+  {
+    return QUANTIS_ERROR_IO;
+  }
+
+  switch (policy)
+  {
+  case QUANTIS_STATUS_CHECK_EVERY_READ:
+  case QUANTIS_STATUS_CHECK_AFTER_ERROR:
+    break;
+
+  case QUANTIS_STATUS_CHECK_EVERY_BYTES:
+  case QUANTIS_STATUS_CHECK_EVERY_MS:
+    if (interval == 0u)
+    {
+      return QUANTIS_ERROR_INVALID_PARAMETER;
+    }
+    break;
+
+  default:
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  deviceHandle->statusCheck.policy = policy;
+  deviceHandle->statusCheck.interval = interval;
+  /* Always check the status on first read following a policy change */
+  deviceHandle->statusCheck.pending = 1;
+  deviceHandle->statusCheck.bytesSinceCheck = 0u;
+  deviceHandle->statusCheck.lastCheck = 0ull;
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisStatusCheckIsDue(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisStatusCheck *statusCheck = &deviceHandle->statusCheck;
+
+  if (statusCheck->pending)
+  {
+    return 1;
+  }
+
+  switch (statusCheck->policy)
+  {
+  case QUANTIS_STATUS_CHECK_EVERY_BYTES:
+    return (statusCheck->bytesSinceCheck >= statusCheck->interval);
+
+  case QUANTIS_STATUS_CHECK_EVERY_MS:
+    return ((QuantisGetTimeMs() - statusCheck->lastCheck) >= statusCheck->interval);
+
+  case QUANTIS_STATUS_CHECK_AFTER_ERROR:
+    return 0;
+
+  case QUANTIS_STATUS_CHECK_EVERY_READ:
+  default:
+    return 1;
+  }
+}
+
+void QuantisStatusCheckDone(QuantisDeviceHandle *deviceHandle, int modulesStatus)
+{
+  QuantisStatusCheck *statusCheck = &deviceHandle->statusCheck;
+
+  statusCheck->pending = (modulesStatus <= 0);
+  statusCheck->bytesSinceCheck = 0u;
+  if (statusCheck->policy == QUANTIS_STATUS_CHECK_EVERY_MS)
+  {
+    statusCheck->lastCheck = QuantisGetTimeMs();
+  }
+}
+
+void QuantisStatusCheckUpdate(QuantisDeviceHandle *deviceHandle, int result)
+{
+  QuantisStatusCheck *statusCheck = &deviceHandle->statusCheck;
+
+  if (result < 0)
+  {
+    statusCheck->pending = 1;
+  }
+  else
+  {
+    statusCheck->bytesSinceCheck += (size_t)result;
+  }
+}
+
+/* ------------------------------------------------------------------------ */
+
 int QuantisReadDouble_01(QuantisDeviceType deviceType,
                          unsigned int deviceNumber,
                          double *value)
@@ -779,28 +1605,22 @@ int QuantisReadScaledInt(QuantisDeviceType deviceType,
   int tmp;
   int result;
 
-  const int BITS = sizeof(tmp) * 8;
-  const unsigned long long RANGE = max - min + 1;
-  const unsigned long long MAX_RANGE = 1ull << BITS;
-  const unsigned long long LIMIT = MAX_RANGE - (MAX_RANGE % RANGE);
-
   if (min > max)
   {
     return QUANTIS_ERROR_INVALID_PARAMETER;
   }
 
-  // Chooses the highest number that is the largest multiple of the output range
-  // (discard values higher the output range)
+  // Discards the random numbers which would bias the output range
   do
   {
-    result = QuantisReadInt(deviceType, deviceNumber, &tmp);
+    result = QuantisHandleCacheReadBuffered(deviceType, deviceNumber, &tmp, sizeof(tmp));
     if (result != QUANTIS_SUCCESS)
     {
       return result;
     }
-  } while ((tmp > 0) && ((unsigned long long)tmp >= LIMIT));
+  } while (ConvertToScaledIntArray(&tmp, 1u, min, max) == 0u);
 
-  *value = (tmp % RANGE) + min;
+  *value = tmp;
 
   return QUANTIS_SUCCESS;
 }
@@ -813,28 +1633,230 @@ int QuantisReadScaledShort(QuantisDeviceType deviceType,
 {
   short tmp;
   int result;
-  const int BITS = sizeof(tmp) * 8;
-  const unsigned int RANGE = max - min + 1;
-  const unsigned int MAX_RANGE = 1u << BITS;
-  const unsigned int LIMIT = MAX_RANGE - (MAX_RANGE % RANGE);
 
   if (min > max)
   {
     return QUANTIS_ERROR_INVALID_PARAMETER;
   }
 
-  // Chooses the highest number that is the largest multiple of the output range
-  // (discard values higher the output range)
+  // Discards the random numbers which would bias the output range
   do
   {
-    result = QuantisReadShort(deviceType, deviceNumber, &tmp);
+    result = QuantisHandleCacheReadBuffered(deviceType, deviceNumber, &tmp, sizeof(tmp));
+    if (result != QUANTIS_SUCCESS)
+    {
+      return result;
+    }
+  } while (ConvertToScaledShortArray(&tmp, 1u, min, max) == 0u);
+
+  *value = tmp;
+
+  return QUANTIS_SUCCESS;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**
+ * Fills <em>buffer</em> with <em>count</em> random values of
+ * <em>valueSize</em> bytes read from the device by chunks of
+ * QUANTIS_MAX_READ_SIZE bytes.
+ * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+ */
+static int QuantisReadHandledAll(QuantisDeviceHandle *deviceHandle,
+                                 void *buffer,
+                                 size_t count,
+                                 size_t valueSize)
+{
+  size_t size = count * valueSize;
+  size_t offset;
+  size_t chunkSize;
+  int result;
+
+  if ((deviceHandle == NULL) || ((buffer == NULL) && (count > 0u)) ||
+      (count > (size_t)-1 / valueSize))
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  for (offset = 0u; offset < size; offset += chunkSize)
+  {
+    chunkSize = size - offset;
+    if (chunkSize > QUANTIS_MAX_READ_SIZE)
+    {
+      chunkSize = QUANTIS_MAX_READ_SIZE;
+    }
+
+    result = QuantisReadHandled(deviceHandle, (char *)buffer + offset, chunkSize);
+    if (result < 0)
+    {
+      return result;
+    }
+    else if ((size_t)result != chunkSize)
+    {
+      return QUANTIS_ERROR_IO;
+    }
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisReadDoubles_01(QuantisDeviceHandle *deviceHandle,
+                          double *values,
+                          size_t count)
+{
+  int result = QuantisReadHandledAll(deviceHandle, values, count, sizeof(*values));
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  ConvertToDoubleArray_01(values, (const char *)values, count);
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisReadFloats_01(QuantisDeviceHandle *deviceHandle,
+                         float *values,
+                         size_t count)
+{
+  int result = QuantisReadHandledAll(deviceHandle, values, count, sizeof(*values));
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  ConvertToFloatArray_01(values, (const char *)values, count);
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisReadInts(QuantisDeviceHandle *deviceHandle,
+                    int *values,
+                    size_t count)
+{
+  // random bytes are random ints, no conversion needed
+  return QuantisReadHandledAll(deviceHandle, values, count, sizeof(*values));
+}
+
+int QuantisReadShorts(QuantisDeviceHandle *deviceHandle,
+                      short *values,
+                      size_t count)
+{
+  return QuantisReadHandledAll(deviceHandle, values, count, sizeof(*values));
+}
+
+int QuantisReadScaledDoubles(QuantisDeviceHandle *deviceHandle,
+                             double *values,
+                             size_t count,
+                             double min,
+                             double max)
+{
+  const double range = max - min;
+  size_t i;
+  int result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  result = QuantisReadDoubles_01(deviceHandle, values, count);
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  for (i = 0u; i < count; i++)
+  {
+    values[i] = values[i] * range + min;
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisReadScaledFloats(QuantisDeviceHandle *deviceHandle,
+                            float *values,
+                            size_t count,
+                            float min,
+                            float max)
+{
+  const float range = max - min;
+  size_t i;
+  int result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  result = QuantisReadFloats_01(deviceHandle, values, count);
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  for (i = 0u; i < count; i++)
+  {
+    values[i] = values[i] * range + min;
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisReadScaledInts(QuantisDeviceHandle *deviceHandle,
+                          int *values,
+                          size_t count,
+                          int min,
+                          int max)
+{
+  size_t done = 0u;
+  int result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  // Values discarded to avoid a bias are read again, all at once
+  while (done < count)
+  {
+    result = QuantisReadInts(deviceHandle, values + done, count - done);
     if (result != QUANTIS_SUCCESS)
     {
       return result;
     }
-  } while ((tmp > 0) && ((unsigned int)tmp >= LIMIT));
 
-  *value = (tmp % RANGE) + min;
+    done += ConvertToScaledIntArray(values + done, count - done, min, max);
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisReadScaledShorts(QuantisDeviceHandle *deviceHandle,
+                            short *values,
+                            size_t count,
+                            short min,
+                            short max)
+{
+  size_t done = 0u;
+  int result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  // Values discarded to avoid a bias are read again, all at once
+  while (done < count)
+  {
+    result = QuantisReadShorts(deviceHandle, values + done, count - done);
+    if (result != QUANTIS_SUCCESS)
+    {
+      return result;
+    }
+
+    done += ConvertToScaledShortArray(values + done, count - done, min, max);
+  }
 
   return QUANTIS_SUCCESS;
 }
@@ -921,6 +1943,16 @@ char *QuantisFullStrError(QuantisDeviceType deviceType, QuantisError errorNumber
       break;
 #endif /* DISABLE_QUANTIS_USB */
 
+    case QUANTIS_DEVICE_AGGREGATE:
+      msg = QuantisOperationsAggregate.QuantisTypeStrError(errorNumber);
+      break;
+
+#ifndef DISABLE_QUANTIS_REMOTE
+    case QUANTIS_DEVICE_REMOTE:
+      msg = QuantisOperationsRemote.QuantisTypeStrError(errorNumber);
+      break;
+#endif /* DISABLE_QUANTIS_REMOTE */
+
     default:
       break;
     }
@@ -56,13 +56,49 @@ using namespace std;
 
 // -------------------------- Private members --------------------------
 
-/** 
- * Quantis device handler.
- * 
- * This internal variable is declared here to avoid inclusion of 
- * Quantis_Internal.h in Quantis.hpp.
+#ifdef CXX11_SUPPORTED
+namespace
+{
+/**
+ * Error category of the QUANTIS_ERROR codes.
  */
-QuantisDeviceHandle *deviceHandle = NULL;
+class QuantisErrorCategory : public std::error_category
+{
+public:
+  const char *name() const noexcept
+  {
+    return "quantis";
+  }
+
+  std::string message(int condition) const
+  {
+    return string(QuantisStrError(static_cast<QuantisError>(condition)));
+  }
+};
+} // namespace
+
+const std::error_category &idQ::quantis_category() noexcept
+{
+  static const QuantisErrorCategory category;
+  return category;
+}
+
+/**
+ * Sets an error code from the result of a Quantis function.
+ * @return true on success.
+ */
+static inline bool SetErrorCode(int result, std::error_code &ec) noexcept
+{
+  if (result < 0)
+  {
+    ec.assign(result, idQ::quantis_category());
+    return false;
+  }
+
+  ec.clear();
+  return true;
+}
+#endif
 
 /**
  * Checks if a Quantis function returned an error.
@@ -70,7 +106,7 @@ QuantisDeviceHandle *deviceHandle = NULL;
  * @throw std::runtime_error if result is negative. The exception message
  * contains details about the error.
  */
-void inline CheckError(int result) throw(std::runtime_error)
+void inline CheckError(int result)
 {
   // All errors are negative
   if (result < 0)
@@ -86,7 +122,7 @@ void inline CheckError(int result) throw(std::runtime_error)
  * @throw std::runtime_error if result is negative. The exception message
  * contains details about the error.
  */
-void inline CheckFullError(QuantisDeviceType deviceType, int result) throw(std::runtime_error)
+void inline CheckFullError(QuantisDeviceType deviceType, int result)
 {
   // All errors are negative
   if (result < 0)
@@ -98,25 +134,64 @@ void inline CheckFullError(QuantisDeviceType deviceType, int result) throw(std::
 
 // ------------------------ Functions implementation ------------------------
 
-idQ::Quantis::Quantis(QuantisDeviceType deviceType, unsigned int deviceNumber) throw(std::runtime_error)
+idQ::Quantis::Quantis(QuantisDeviceType deviceType, unsigned int deviceNumber)
     : _deviceType(deviceType),
-      _deviceNumber(deviceNumber)
+      _deviceNumber(deviceNumber),
+      _deviceHandle(NULL)
 {
-  CheckError(QuantisOpenInternal(deviceType, deviceNumber, &deviceHandle));
+  CheckError(QuantisOpenInternal(deviceType, deviceNumber, &_deviceHandle));
 }
 
+#ifdef CXX11_SUPPORTED
+idQ::Quantis::Quantis(QuantisDeviceType deviceType, unsigned int deviceNumber, std::error_code &ec) noexcept
+    : _deviceType(deviceType),
+      _deviceNumber(deviceNumber),
+      _deviceHandle(NULL)
+{
+  if (!SetErrorCode(QuantisOpenInternal(deviceType, deviceNumber, &_deviceHandle), ec))
+  {
+    _deviceHandle = NULL;
+  }
+}
+
+idQ::Quantis::Quantis(Quantis &&other) noexcept
+    : _deviceType(other._deviceType),
+      _deviceNumber(other._deviceNumber),
+      _deviceHandle(other._deviceHandle)
+{
+  other._deviceHandle = NULL;
+}
+
+idQ::Quantis &idQ::Quantis::operator=(Quantis &&other) noexcept
+{
+  if (this != &other)
+  {
+    QuantisCloseInternal(_deviceHandle);
+    _deviceType = other._deviceType;
+    _deviceNumber = other._deviceNumber;
+    _deviceHandle = other._deviceHandle;
+    other._deviceHandle = NULL;
+  }
+  return *this;
+}
+#endif
+
 idQ::Quantis::~Quantis()
 {
-  QuantisCloseInternal(deviceHandle);
+  QuantisCloseInternal(_deviceHandle);
+}
+
+bool idQ::Quantis::IsOpen() const
+{
+  return (_deviceHandle != NULL);
 }
 
 void idQ::Quantis::BoardReset() const
-    throw(std::runtime_error)
 {
-  CheckError(deviceHandle->ops->BoardReset(deviceHandle));
+  CheckError(_deviceHandle->ops->BoardReset(_deviceHandle));
 }
 
-int idQ::Quantis::Count(QuantisDeviceType deviceType) throw(std::runtime_error)
+int idQ::Quantis::Count(QuantisDeviceType deviceType)
 {
   int result = QuantisCount(deviceType);
   CheckError(result);
@@ -124,22 +199,20 @@ int idQ::Quantis::Count(QuantisDeviceType deviceType) throw(std::runtime_error)
 }
 
 int idQ::Quantis::GetBoardVersion() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->GetBoardVersion(deviceHandle);
+  int result = _deviceHandle->ops->GetBoardVersion(_deviceHandle);
   CheckError(result);
   return result;
 }
 
 float idQ::Quantis::GetDriverVersion() const
-    throw(std::runtime_error)
 {
-  float result = deviceHandle->ops->GetDriverVersion();
+  float result = _deviceHandle->ops->GetDriverVersion();
   CheckError(static_cast<int>(result));
   return result;
 }
 
-float idQ::Quantis::GetDriverVersion(QuantisDeviceType deviceType) throw(std::runtime_error)
+float idQ::Quantis::GetDriverVersion(QuantisDeviceType deviceType)
 {
   float result = QuantisGetDriverVersion(deviceType);
   CheckError(static_cast<int>(result));
@@ -153,97 +226,85 @@ float idQ::Quantis::GetLibVersion()
 
 std::string idQ::Quantis::GetManufacturer() const
 {
-  return string(deviceHandle->ops->GetManufacturer(deviceHandle));
+  return string(_deviceHandle->ops->GetManufacturer(_deviceHandle));
 }
 
 int idQ::Quantis::GetModulesCount() const
-    throw(std::runtime_error)
 {
   int modulesMask = GetModulesMask();
   return QuantisCountSetBits(modulesMask);
 }
 
 int idQ::Quantis::GetModulesMask() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->GetModulesMask(deviceHandle);
+  int result = _deviceHandle->ops->GetModulesMask(_deviceHandle);
   CheckError(result);
   return result;
 }
 
 int idQ::Quantis::GetModulesDataRate() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->GetModulesDataRate(deviceHandle);
+  int result = _deviceHandle->ops->GetModulesDataRate(_deviceHandle);
   CheckError(result);
   return result;
 }
 
 int idQ::Quantis::GetModulesStatus() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->GetModulesStatus(deviceHandle);
+  int result = _deviceHandle->ops->GetModulesStatus(_deviceHandle);
   CheckError(result);
   return result;
 }
 
 bool idQ::Quantis::GetModulesPower() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->GetModulesPower(deviceHandle);
+  int result = _deviceHandle->ops->GetModulesPower(_deviceHandle);
   CheckError(result);
   return (result != 0);
 }
 
 std::string idQ::Quantis::GetSerialNumber() const
 {
-  return string(deviceHandle->ops->GetSerialNumber(deviceHandle));
+  return string(_deviceHandle->ops->GetSerialNumber(_deviceHandle));
 }
 
 void idQ::Quantis::ModulesDisable(int modulesMask) const
-    throw(std::runtime_error)
 {
-  CheckError(deviceHandle->ops->ModulesDisable(deviceHandle, modulesMask));
+  CheckError(_deviceHandle->ops->ModulesDisable(_deviceHandle, modulesMask));
 }
 
 void idQ::Quantis::ModulesEnable(int modulesMask) const
-    throw(std::runtime_error)
 {
-  CheckError(deviceHandle->ops->ModulesEnable(deviceHandle, modulesMask));
+  CheckError(_deviceHandle->ops->ModulesEnable(_deviceHandle, modulesMask));
 }
 
 void idQ::Quantis::ModulesReset(int modulesMask) const
-    throw(std::runtime_error)
 {
   ModulesDisable(modulesMask);
   ModulesEnable(modulesMask);
 }
 
 int idQ::Quantis::GetBusDeviceId() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->GetBusDeviceId(deviceHandle);
+  int result = _deviceHandle->ops->GetBusDeviceId(_deviceHandle);
   CheckError(result);
   return result;
 }
 
 int idQ::Quantis::GetAis31StartupTestsRequestFlag() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->GetAis31StartupTestsRequestFlag(deviceHandle);
+  int result = _deviceHandle->ops->GetAis31StartupTestsRequestFlag(_deviceHandle);
   CheckError(result);
   return result;
 }
 
 void idQ::Quantis::ClearAis31StartupTestsRequestFlag() const
-    throw(std::runtime_error)
 {
-  int result = deviceHandle->ops->ClearAis31StartupTestsRequestFlag(deviceHandle);
+  int result = _deviceHandle->ops->ClearAis31StartupTestsRequestFlag(_deviceHandle);
   CheckError(result);
 }
 
 std::string idQ::Quantis::Read(size_t size) const
-    throw(std::runtime_error)
 {
   string buffer;
   buffer.resize(size);
@@ -259,32 +320,99 @@ std::string idQ::Quantis::Read(size_t size) const
   return buffer;
 }
 
-void idQ::Quantis::Read(void *buffer, size_t size) const
-    throw(std::runtime_error)
+int idQ::Quantis::ReadInternal(void *buffer, size_t size) const
 {
+  int readBytes;
+
   if (size == 0u)
   {
-    return;
+    return QUANTIS_SUCCESS;
   }
   else if (size > QUANTIS_MAX_READ_SIZE)
+  {
+    return QUANTIS_ERROR_INVALID_READ_SIZE;
+  }
+  else if (!_deviceHandle)
+  {
+    return QUANTIS_ERROR_NO_DEVICE;
+  }
+
+  readBytes = _deviceHandle->ops->Read(_deviceHandle, buffer, size);
+  if (readBytes < 0)
+  {
+    return readBytes;
+  }
+  else if (static_cast<size_t>(readBytes) != size)
+  {
+    return QUANTIS_ERROR_IO;
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int idQ::Quantis::ReadScaledInt(int &value, int min, int max) const
+{
+  int result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  // Discards the random numbers which would bias the output range
+  do
+  {
+    result = ReadInternal(&value, sizeof(value));
+    if (result < 0)
+    {
+      return result;
+    }
+  } while (ConvertToScaledIntArray(&value, 1u, min, max) == 0u);
+
+  return QUANTIS_SUCCESS;
+}
+
+int idQ::Quantis::ReadScaledShort(short &value, short min, short max) const
+{
+  int result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  // Discards the random numbers which would bias the output range
+  do
+  {
+    result = ReadInternal(&value, sizeof(value));
+    if (result < 0)
+    {
+      return result;
+    }
+  } while (ConvertToScaledShortArray(&value, 1u, min, max) == 0u);
+
+  return QUANTIS_SUCCESS;
+}
+
+void idQ::Quantis::Read(void *buffer, size_t size) const
+{
+  if (size > QUANTIS_MAX_READ_SIZE)
   {
     // Throws error
     CheckError(QUANTIS_ERROR_INVALID_READ_SIZE);
   }
 
-  int readBytes = deviceHandle->ops->Read(deviceHandle, buffer, size);
-  CheckFullError(_deviceType, readBytes);
+  CheckFullError(_deviceType, ReadInternal(buffer, size));
 }
 
 double idQ::Quantis::ReadDouble() const
-    throw(std::runtime_error)
 {
-  string buffer = Read(sizeof(double));
-  return ConvertToDouble_01(buffer.c_str());
+  char buffer[sizeof(double)];
+  Read(buffer, sizeof(buffer));
+  return ConvertToDouble_01(buffer);
 }
 
 double idQ::Quantis::ReadDouble(double min, double max) const
-    throw(std::runtime_error)
 {
   if (min > max)
   {
@@ -296,14 +424,13 @@ double idQ::Quantis::ReadDouble(double min, double max) const
 }
 
 float idQ::Quantis::ReadFloat() const
-    throw(std::runtime_error)
 {
-  string buffer = Read(sizeof(float));
-  return ConvertToFloat_01(buffer.c_str());
+  char buffer[sizeof(float)];
+  Read(buffer, sizeof(buffer));
+  return ConvertToFloat_01(buffer);
 }
 
 float idQ::Quantis::ReadFloat(float min, float max) const
-    throw(std::runtime_error)
 {
   if (min > max)
   {
@@ -315,65 +442,114 @@ float idQ::Quantis::ReadFloat(float min, float max) const
 }
 
 int idQ::Quantis::ReadInt() const
-    throw(std::runtime_error)
 {
-  string buffer = Read(sizeof(int));
-  return ConvertToInt(buffer.c_str());
+  char buffer[sizeof(int)];
+  Read(buffer, sizeof(buffer));
+  return ConvertToInt(buffer);
 }
 
 int idQ::Quantis::ReadInt(int min, int max) const
-    throw(std::runtime_error)
 {
-  int tmp;
-  const int BITS = sizeof(tmp) * 8;
-  const unsigned long long RANGE = max - min + 1;
-  const unsigned long long MAX_RANGE = 1ull << BITS;
-  const unsigned long long LIMIT = MAX_RANGE - (MAX_RANGE % RANGE);
+  int value = 0;
+  CheckFullError(_deviceType, ReadScaledInt(value, min, max));
+  return value;
+}
 
-  if (min > max)
+short idQ::Quantis::ReadShort() const
+{
+  char buffer[sizeof(short)];
+  Read(buffer, sizeof(buffer));
+  return ConvertToShort(buffer);
+}
+
+short idQ::Quantis::ReadShort(short min, short max) const
+{
+  short value = 0;
+  CheckFullError(_deviceType, ReadScaledShort(value, min, max));
+  return value;
+}
+
+#ifdef CXX11_SUPPORTED
+void idQ::Quantis::Read(void *buffer, size_t size, std::error_code &ec) const noexcept
+{
+  SetErrorCode(ReadInternal(buffer, size), ec);
+}
+
+double idQ::Quantis::ReadDouble(std::error_code &ec) const noexcept
+{
+  char buffer[sizeof(double)];
+  if (!SetErrorCode(ReadInternal(buffer, sizeof(buffer)), ec))
   {
-    // Throw error
-    CheckError(QUANTIS_ERROR_INVALID_PARAMETER);
+    return 0.0;
   }
+  return ConvertToDouble_01(buffer);
+}
 
-  // Chooses the highest number that is the largest multiple of the output range
-  // (discard values higher the output range)
-  do
+double idQ::Quantis::ReadDouble(double min, double max, std::error_code &ec) const noexcept
+{
+  if (!SetErrorCode((min > max) ? QUANTIS_ERROR_INVALID_PARAMETER : QUANTIS_SUCCESS, ec))
   {
-    tmp = ReadInt();
-  } while ((tmp > 0) && (static_cast<unsigned long long>(tmp) >= LIMIT));
+    return 0.0;
+  }
+  return ReadDouble(ec) * (max - min) + min;
+}
 
-  return static_cast<int>(tmp % RANGE + min);
+float idQ::Quantis::ReadFloat(std::error_code &ec) const noexcept
+{
+  char buffer[sizeof(float)];
+  if (!SetErrorCode(ReadInternal(buffer, sizeof(buffer)), ec))
+  {
+    return 0.0f;
+  }
+  return ConvertToFloat_01(buffer);
 }
 
-short idQ::Quantis::ReadShort() const
-    throw(std::runtime_error)
+float idQ::Quantis::ReadFloat(float min, float max, std::error_code &ec) const noexcept
 {
-  string buffer = Read(sizeof(short));
-  return ConvertToShort(buffer.c_str());
+  if (!SetErrorCode((min > max) ? QUANTIS_ERROR_INVALID_PARAMETER : QUANTIS_SUCCESS, ec))
+  {
+    return 0.0f;
+  }
+  return ReadFloat(ec) * (max - min) + min;
 }
 
-short idQ::Quantis::ReadShort(short min, short max) const
-    throw(std::runtime_error)
+int idQ::Quantis::ReadInt(std::error_code &ec) const noexcept
 {
-  short tmp;
-  const int BITS = sizeof(tmp) * 8;
-  const unsigned int RANGE = max - min + 1;
-  const unsigned int MAX_RANGE = 1u << BITS;
-  const unsigned int LIMIT = MAX_RANGE - (MAX_RANGE % RANGE);
+  char buffer[sizeof(int)];
+  if (!SetErrorCode(ReadInternal(buffer, sizeof(buffer)), ec))
+  {
+    return 0;
+  }
+  return ConvertToInt(buffer);
+}
 
-  if (min > max)
+int idQ::Quantis::ReadInt(int min, int max, std::error_code &ec) const noexcept
+{
+  int value = 0;
+  if (!SetErrorCode(ReadScaledInt(value, min, max), ec))
   {
-    // Throw error
-    CheckError(QUANTIS_ERROR_INVALID_PARAMETER);
+    return 0;
   }
+  return value;
+}
 
-  // Chooses the highest number that is the largest multiple of the output range
-  // (discard values higher the output range)
-  do
+short idQ::Quantis::ReadShort(std::error_code &ec) const noexcept
+{
+  char buffer[sizeof(short)];
+  if (!SetErrorCode(ReadInternal(buffer, sizeof(buffer)), ec))
   {
-    tmp = ReadShort();
-  } while ((tmp > 0) && (static_cast<unsigned int>(tmp) >= LIMIT));
+    return 0;
+  }
+  return ConvertToShort(buffer);
+}
 
-  return static_cast<short>(tmp % RANGE + min);
+short idQ::Quantis::ReadShort(short min, short max, std::error_code &ec) const noexcept
+{
+  short value = 0;
+  if (!SetErrorCode(ReadScaledShort(value, min, max), ec))
+  {
+    return 0;
+  }
+  return value;
 }
+#endif
@@ -114,11 +114,44 @@ extern "C"
    */
   void QuantisCloseInternal(QuantisDeviceHandle *deviceHandle);
 
+  /**
+   * Performs a request on the handle of a device cached for the stateless
+   * functions, opening it if needed. Unlike QuantisOpenInternal, a cached
+   * handle is neither evicted nor closed, unless the request fails.
+   * @param request the request, given the handle and <em>argument</em>.
+   * @return the result of the request or a QUANTIS_ERROR code on failure.
+   */
+  int QuantisHandleCacheRequest(QuantisDeviceType deviceType,
+                                unsigned int deviceNumber,
+                                int (*request)(QuantisDeviceHandle *deviceHandle, void *argument),
+                                void *argument);
+
   /**
    * Count the number of bits in values that are set (that is they are 1)
    */
   int QuantisCountSetBits(int value);
 
+  /**
+   * Tells whether the status of the modules must be checked before reading,
+   * according to the status check policy of the handle.
+   * @return 1 if the status must be checked, 0 otherwise.
+   */
+  int QuantisStatusCheckIsDue(QuantisDeviceHandle *deviceHandle);
+
+  /**
+   * Records the result of a status check.
+   * @param modulesStatus the value returned by GetModulesStatus. When the
+   * status is not valid, the check stays due for next read.
+   */
+  void QuantisStatusCheckDone(QuantisDeviceHandle *deviceHandle, int modulesStatus);
+
+  /**
+   * Records the result of a read.
+   * @param result the number of bytes read or a QUANTIS_ERROR code, in which
+   * case the status will be checked on next read.
+   */
+  void QuantisStatusCheckUpdate(QuantisDeviceHandle *deviceHandle, int result);
+
   /******************** Quantis PCI functions declarations ********************
    *
    * Definition of Quantis PCI function is in QuantisPci_MyOs.c
@@ -229,6 +262,122 @@ extern "C"
 
 #endif /* DISABLE_QUANTIS_USB */
 
+  /***************** Quantis aggregate functions declarations *****************
+   *
+   * Definition of Quantis aggregate function is in Quantis_Aggregate.c
+   *
+   */
+
+  /** Maximal number of devices of the aggregate device */
+#define QUANTIS_AGGREGATE_MAX_DEVICES 16
+
+  /**
+   * Minimal size (in bytes) of a read striped over the devices of the
+   * aggregate, smaller reads are served by a single device.
+   */
+#define QUANTIS_AGGREGATE_MIN_STRIPED_READ_SIZE 4096
+
+  /**
+   * Delays (in milliseconds) before a device dropped from the aggregate is
+   * opened again, doubled each time it fails again up to the maximum.
+   */
+#define QUANTIS_AGGREGATE_RETRY_MIN_DELAY 10
+#define QUANTIS_AGGREGATE_RETRY_MAX_DELAY 5000
+
+  int QuantisAggregateBoardReset(QuantisDeviceHandle *deviceHandle);
+
+  void QuantisAggregateClose(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateCount();
+
+  int QuantisAggregateGetBoardVersion(QuantisDeviceHandle *deviceHandle);
+
+  float QuantisAggregateGetDriverVersion();
+
+  char *QuantisAggregateGetManufacturer(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateGetModulesMask(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateGetModulesDataRate(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateGetModulesPower(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateGetModulesStatus(QuantisDeviceHandle *deviceHandle);
+
+  char *QuantisAggregateGetSerialNumber(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateModulesDisable(QuantisDeviceHandle *deviceHandle,
+                                     int moduleMask);
+
+  int QuantisAggregateModulesEnable(QuantisDeviceHandle *deviceHandle,
+                                    int moduleMask);
+
+  int QuantisAggregateOpen(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateRead(QuantisDeviceHandle *deviceHandle,
+                           void *buffer,
+                           size_t size);
+
+  int QuantisAggregateGetBusDeviceId(QuantisDeviceHandle *deviceHandle);
+
+  char *QuantisAggregateTypeStrError(int errorNumber);
+
+  int QuantisAggregateGetAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisAggregateClearAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle);
+
+  /******************* Quantis remote functions declarations *******************
+   *
+   * Definition of Quantis remote function is in Quantis_Remote.c
+   *
+   */
+
+#ifndef DISABLE_QUANTIS_REMOTE
+
+  int QuantisRemoteBoardReset(QuantisDeviceHandle *deviceHandle);
+
+  void QuantisRemoteClose(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteCount();
+
+  int QuantisRemoteGetBoardVersion(QuantisDeviceHandle *deviceHandle);
+
+  float QuantisRemoteGetDriverVersion();
+
+  char *QuantisRemoteGetManufacturer(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteGetModulesMask(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteGetModulesDataRate(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteGetModulesPower(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteGetModulesStatus(QuantisDeviceHandle *deviceHandle);
+
+  char *QuantisRemoteGetSerialNumber(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteModulesDisable(QuantisDeviceHandle *deviceHandle,
+                                  int moduleMask);
+
+  int QuantisRemoteModulesEnable(QuantisDeviceHandle *deviceHandle,
+                                 int moduleMask);
+
+  int QuantisRemoteOpen(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteRead(QuantisDeviceHandle *deviceHandle,
+                        void *buffer,
+                        size_t size);
+
+  int QuantisRemoteGetBusDeviceId(QuantisDeviceHandle *deviceHandle);
+
+  char *QuantisRemoteTypeStrError(int errorNumber);
+
+  int QuantisRemoteGetAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle);
+
+  int QuantisRemoteClearAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle);
+
+#endif /* DISABLE_QUANTIS_REMOTE */
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,6 +59,8 @@
 #include <cstdlib>
 #endif
 
+#include <stdint.h>
+
 #include "Quantis.h"
 
 // ---------------------- Internal functions definitions ----------------------
@@ -107,6 +109,71 @@ static void _CheckResult(JNIEnv *env, int result)
   _ThrowJavaException(env, QuantisStrError(errorNumber));
 }
 
+/**
+ * Size (in bytes) of the native buffer through which a Java array is read.
+ * The device is not read into the array itself, since the garbage collector
+ * may be blocked as long as an array is pinned.
+ */
+#define QUANTIS_JAVA_ARRAY_READ_SIZE (64 * 1024)
+
+/**
+ * Converts a handle given by the Java side, raising an error if it is NULL.
+ */
+static QuantisDeviceHandle *_GetDeviceHandle(JNIEnv *env, jlong jDeviceHandle)
+{
+  QuantisDeviceHandle *deviceHandle = reinterpret_cast<QuantisDeviceHandle *>(static_cast<intptr_t>(jDeviceHandle));
+  if (deviceHandle == NULL)
+  {
+    _ThrowJavaException(env, QuantisStrError(QUANTIS_ERROR_NO_DEVICE));
+  }
+  return deviceHandle;
+}
+
+/**
+ * Checks that [jOffset, jOffset + jSize) lies within a buffer of jCapacity
+ * bytes, raising an error otherwise.
+ * @return true when the range is valid.
+ */
+static bool _CheckRange(JNIEnv *env, jlong jCapacity, jint jOffset, jint jSize)
+{
+  if ((jOffset < 0) || (jSize < 0) ||
+      (static_cast<jlong>(jOffset) + static_cast<jlong>(jSize) > jCapacity))
+  {
+    _ThrowJavaException(env, QuantisStrError(QUANTIS_ERROR_INVALID_PARAMETER));
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Reads exactly size bytes by chunks of at most QUANTIS_MAX_READ_SIZE bytes.
+ * @return size on success or a QUANTIS_ERROR code on failure.
+ */
+static int _ReadHandledAll(QuantisDeviceHandle *deviceHandle, char *buffer, size_t size)
+{
+  size_t readBytes = 0u;
+  while (readBytes < size)
+  {
+    size_t chunkSize = size - readBytes;
+    if (chunkSize > QUANTIS_MAX_READ_SIZE)
+    {
+      chunkSize = QUANTIS_MAX_READ_SIZE;
+    }
+
+    int result = QuantisReadHandled(deviceHandle, buffer + readBytes, chunkSize);
+    if (result < 0)
+    {
+      return result;
+    }
+    else if (static_cast<size_t>(result) != chunkSize)
+    {
+      return QUANTIS_ERROR_IO;
+    }
+    readBytes += chunkSize;
+  }
+  return static_cast<int>(size);
+}
+
 // ----------------------- JNI functions implementation -----------------------
 
 JNIEXPORT void Java_com_idquantique_quantis_Quantis_QuantisBoardReset(
@@ -472,6 +539,146 @@ JNIEXPORT jbyteArray Java_com_idquantique_quantis_Quantis_QuantisRead(
   return jBuffer;
 }
 
+JNIEXPORT jlong Java_com_idquantique_quantis_Quantis_QuantisOpen(
+    JNIEnv *env,
+    jclass /*obj*/,
+    jint jDeviceType,
+    jint jDeviceNumber)
+{
+  // Consistency check
+  _CheckDeviceNumber(env, jDeviceNumber);
+
+  // Convert types
+  QuantisDeviceType deviceType = static_cast<QuantisDeviceType>(jDeviceType);
+  unsigned int deviceNumber = static_cast<unsigned int>(jDeviceNumber);
+
+  // Perform request
+  QuantisDeviceHandle *deviceHandle = NULL;
+  int result = QuantisOpen(deviceType, deviceNumber, &deviceHandle);
+  if (result < 0)
+  {
+    _CheckResult(env, result);
+    return 0;
+  }
+  return static_cast<jlong>(reinterpret_cast<intptr_t>(deviceHandle));
+}
+
+JNIEXPORT void Java_com_idquantique_quantis_Quantis_QuantisClose(
+    JNIEnv * /*env*/,
+    jclass /*obj*/,
+    jlong jDeviceHandle)
+{
+  // Convert types
+  QuantisDeviceHandle *deviceHandle = reinterpret_cast<QuantisDeviceHandle *>(static_cast<intptr_t>(jDeviceHandle));
+
+  // Perform request
+  if (deviceHandle != NULL)
+  {
+    QuantisClose(deviceHandle);
+  }
+}
+
+JNIEXPORT jint Java_com_idquantique_quantis_Quantis_QuantisReadHandledDirect(
+    JNIEnv *env,
+    jclass /*obj*/,
+    jlong jDeviceHandle,
+    jobject jByteBuffer,
+    jint jOffset,
+    jint jSize)
+{
+  // Convert types
+  QuantisDeviceHandle *deviceHandle = _GetDeviceHandle(env, jDeviceHandle);
+  if (deviceHandle == NULL)
+  {
+    return 0;
+  }
+
+  char *buffer = static_cast<char *>(env->GetDirectBufferAddress(jByteBuffer));
+  if (buffer == NULL)
+  {
+    // Not a direct buffer
+    _ThrowJavaException(env, QuantisStrError(QUANTIS_ERROR_INVALID_PARAMETER));
+    return 0;
+  }
+
+  // Consistency check
+  if (!_CheckRange(env, static_cast<jlong>(env->GetDirectBufferCapacity(jByteBuffer)), jOffset, jSize))
+  {
+    return 0;
+  }
+
+  // Perform request, directly into the buffer
+  int result = _ReadHandledAll(deviceHandle, buffer + jOffset, static_cast<size_t>(jSize));
+  _CheckResult(env, result);
+  return static_cast<jint>(result);
+}
+
+JNIEXPORT jint Java_com_idquantique_quantis_Quantis_QuantisReadHandledArray(
+    JNIEnv *env,
+    jclass /*obj*/,
+    jlong jDeviceHandle,
+    jbyteArray jArray,
+    jint jOffset,
+    jint jSize)
+{
+  // Convert types
+  QuantisDeviceHandle *deviceHandle = _GetDeviceHandle(env, jDeviceHandle);
+  if (deviceHandle == NULL)
+  {
+    return 0;
+  }
+
+  // Consistency check
+  if (jArray == NULL)
+  {
+    _ThrowJavaException(env, QuantisStrError(QUANTIS_ERROR_INVALID_PARAMETER));
+    return 0;
+  }
+  if (!_CheckRange(env, static_cast<jlong>(env->GetArrayLength(jArray)), jOffset, jSize))
+  {
+    return 0;
+  }
+
+  if (jSize == 0)
+  {
+    return 0;
+  }
+
+  // Perform request into a native buffer, then copy it to the array, which
+  // is therefore never pinned while the device is read
+  jint bufferSize = (jSize < QUANTIS_JAVA_ARRAY_READ_SIZE) ? jSize : QUANTIS_JAVA_ARRAY_READ_SIZE;
+  char *buffer = (char *)malloc(static_cast<size_t>(bufferSize));
+  if (!buffer)
+  {
+    _ThrowJavaException(env, QuantisStrError(QUANTIS_ERROR_NO_MEMORY));
+    return 0;
+  }
+
+  jint readBytes = 0;
+  while (readBytes < jSize)
+  {
+    jint chunkSize = jSize - readBytes;
+    if (chunkSize > bufferSize)
+    {
+      chunkSize = bufferSize;
+    }
+
+    int result = _ReadHandledAll(deviceHandle, buffer, static_cast<size_t>(chunkSize));
+    if (result < 0)
+    {
+      free(buffer);
+      _CheckResult(env, result);
+      return 0;
+    }
+
+    env->SetByteArrayRegion(jArray, jOffset + readBytes, chunkSize, (jbyte *)buffer);
+    readBytes += chunkSize;
+  }
+
+  free(buffer);
+  return readBytes;
+}
+
 JNIEXPORT jdouble Java_com_idquantique_quantis_Quantis_QuantisReadDouble01(
     JNIEnv *env,
     jclass /*obj*/,
@@ -173,6 +173,47 @@ extern "C"
       jint jDeviceNumber,
       jsize jSize);
 
+  /**
+   * Opens the device and returns its handle as a long, to be given to the
+   * QuantisReadHandled* functions and released with QuantisClose.
+   */
+  JNIEXPORT jlong Java_com_idquantique_quantis_Quantis_QuantisOpen(
+      JNIEnv *env,
+      jclass obj,
+      jint jDeviceType,
+      jint jDeviceNumber);
+
+  JNIEXPORT void Java_com_idquantique_quantis_Quantis_QuantisClose(
+      JNIEnv *env,
+      jclass obj,
+      jlong jDeviceHandle);
+
+  /**
+   * Reads jSize bytes into a direct ByteBuffer, starting at jOffset. The
+   * data is written in place: no temporary buffer nor copy is involved.
+   * @return the number of read bytes.
+   */
+  JNIEXPORT jint Java_com_idquantique_quantis_Quantis_QuantisReadHandledDirect(
+      JNIEnv *env,
+      jclass obj,
+      jlong jDeviceHandle,
+      jobject jByteBuffer,
+      jint jOffset,
+      jint jSize);
+
+  /**
+   * Reads jSize bytes into a byte array, starting at jOffset. The data is
+   * read into a native buffer, then copied with SetByteArrayRegion.
+   * @return the number of read bytes.
+   */
+  JNIEXPORT jint Java_com_idquantique_quantis_Quantis_QuantisReadHandledArray(
+      JNIEnv *env,
+      jclass obj,
+      jlong jDeviceHandle,
+      jbyteArray jArray,
+      jint jOffset,
+      jint jSize);
+
   JNIEXPORT jdouble Java_com_idquantique_quantis_Quantis_QuantisReadDouble01(
       JNIEnv *env,
       jclass obj,
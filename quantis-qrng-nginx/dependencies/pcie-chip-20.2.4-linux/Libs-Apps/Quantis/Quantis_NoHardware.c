@@ -49,29 +49,442 @@
  */
 
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#ifdef _MSC_VER
+#include "msc_stdint.h"
+#else
+#include <stdint.h>
 #endif
 
 #include "Quantis.h"
 #include "Quantis_Internal.h"
 
-int modulesStatusPci = 15; /* 4 modules enabled */
-int modulesStatusUsb = 1;  /* 1 module enabled */
+/* Modules status of a device when opened */
+#define QUANTIS_NOHW_MODULES_STATUS_PCI 15 /* 4 modules enabled */
+#define QUANTIS_NOHW_MODULES_STATUS_USB 1  /* 1 module enabled */
 
 int ais31StartupTestsRequestFlag = 1;
 
+/* Slack (in microseconds) absorbing the overshoot of the sleeps of the rate model */
+#define QUANTIS_NOHW_RATE_SLACK 1000
+
+/**
+ * Simulation parameters, shared by all the devices. They are read from the
+ * file given by the QUANTIS_NOHW_CONFIG environment variable (one
+ * "key = value" per line, '#' starts a comment), then from the
+ * QUANTIS_NOHW_<KEY> environment variables:
+ * - seed: seed of the random data (default 0)
+ * - devices: number of devices of each type (default 1)
+ * - rate: data rate in bytes per second, 0 for unlimited (default) or
+ *   "modules" for the data rate of the modules of the device
+ * - latency: duration of a read, besides the data rate, in microseconds
+ * - jitter: maximal random duration added to the latency, in microseconds
+ * - read_failure_rate: probability that a read fails with QUANTIS_ERROR_IO
+ * - status_failure_rate: probability that a modules status check fails
+ */
+typedef struct QuantisNoHwConfig
+{
+  unsigned long long seed;
+  int devicesCount;
+  double rate; /* negative for the data rate of the modules */
+  double latency;
+  double jitter;
+  double readFailureRate;
+  double statusFailureRate;
+} QuantisNoHwConfig;
+
+static QuantisNoHwConfig quantisNoHwConfig = {0ull, 1, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+/* Number of handles opened so far, gives a distinct stream to each handle */
+static unsigned int quantisNoHwOpenCount = 0u;
+
+/**
+ * Simulated device.
+ */
+typedef struct QuantisPrivateData
+{
+  /* Philox4x32-10 generator: the random data is the encryption of a counter */
+  uint32_t key[2];
+  uint64_t counter;
+  unsigned char block[16];
+  size_t blockOffset; /* sizeof(block) when the block has been consumed */
+
+  /* Generator of the latency jitter and of the failures */
+  uint64_t eventState;
+
+  /* Time (in microseconds) at which the device is done with last read */
+  unsigned long long busyUntil;
+
+  /* Modules status, set by ModulesDisable and ModulesEnable */
+  int modulesStatus;
+} QuantisPrivateData;
+
+/* ---------------------------- Configuration ---------------------------- */
+
+/**
+ * Sets a simulation parameter, invalid values are ignored.
+ */
+static void QuantisNoHwSetParameter(const char *key, const char *value)
+{
+  QuantisNoHwConfig *config = &quantisNoHwConfig;
+  char *end = NULL;
+  double number;
+
+  if (strcmp(key, "seed") == 0)
+  {
+    unsigned long long seed = strtoull(value, &end, 0);
+    if ((end != value) && (*end == '\0'))
+    {
+      config->seed = seed;
+    }
+    return;
+  }
+  else if ((strcmp(key, "rate") == 0) && (strcmp(value, "modules") == 0))
+  {
+    config->rate = -1.0;
+    return;
+  }
+
+  number = strtod(value, &end);
+  if ((end == value) || (*end != '\0') || (number < 0.0))
+  {
+    return;
+  }
+
+  if ((strcmp(key, "devices") == 0) && (number >= 1.0) && (number <= MAX_QUANTIS_DEVICE))
+  {
+    config->devicesCount = (int)number;
+  }
+  else if (strcmp(key, "rate") == 0)
+  {
+    config->rate = number;
+  }
+  else if (strcmp(key, "latency") == 0)
+  {
+    config->latency = number;
+  }
+  else if (strcmp(key, "jitter") == 0)
+  {
+    config->jitter = number;
+  }
+  else if ((strcmp(key, "read_failure_rate") == 0) && (number <= 1.0))
+  {
+    config->readFailureRate = number;
+  }
+  else if ((strcmp(key, "status_failure_rate") == 0) && (number <= 1.0))
+  {
+    config->statusFailureRate = number;
+  }
+}
+
+/**
+ * Removes the leading and trailing blanks of a string, in place.
+ */
+static char *QuantisNoHwTrim(char *string)
+{
+  char *end;
+
+  while ((*string == ' ') || (*string == '\t'))
+  {
+    string++;
+  }
+
+  end = string + strlen(string);
+  while ((end > string) &&
+         ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\r') || (end[-1] == '\n')))
+  {
+    end--;
+  }
+  *end = '\0';
+
+  return string;
+}
+
+static void QuantisNoHwLoadConfig()
+{
+  const char *keys[] = {"seed", "devices", "rate", "latency", "jitter",
+                        "read_failure_rate", "status_failure_rate"};
+  const char *fileName = getenv("QUANTIS_NOHW_CONFIG");
+  unsigned int i;
+
+  /* Configuration file */
+  if ((fileName != NULL) && (*fileName != '\0'))
+  {
+    FILE *file = fopen(fileName, "r");
+    if (file != NULL)
+    {
+      char line[256];
+      while (fgets(line, sizeof(line), file) != NULL)
+      {
+        char *separator;
+        char *comment = strchr(line, '#');
+        if (comment != NULL)
+        {
+          *comment = '\0';
+        }
+
+        separator = strchr(line, '=');
+        if (separator != NULL)
+        {
+          *separator = '\0';
+          QuantisNoHwSetParameter(QuantisNoHwTrim(line), QuantisNoHwTrim(separator + 1));
+        }
+      }
+      fclose(file);
+    }
+  }
+
+  /* Environment variables */
+  for (i = 0u; i < sizeof(keys) / sizeof(keys[0]); i++)
+  {
+    char name[64];
+    const char *value;
+    size_t c;
+
+    strcpy(name, "QUANTIS_NOHW_");
+    for (c = 0u; keys[i][c] != '\0'; c++)
+    {
+      name[13 + c] = (char)((keys[i][c] >= 'a' && keys[i][c] <= 'z') ? keys[i][c] - 'a' + 'A' : keys[i][c]);
+    }
+    name[13 + c] = '\0';
+
+    value = getenv(name);
+    if (value != NULL)
+    {
+      QuantisNoHwSetParameter(keys[i], value);
+    }
+  }
+}
+
+static const QuantisNoHwConfig *QuantisNoHwGetConfig()
+{
+#ifdef _WIN32
+  static volatile LONG loaded = 0;
+  if (InterlockedCompareExchange(&loaded, 1, 0) == 0)
+  {
+    QuantisNoHwLoadConfig();
+  }
+#else
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  pthread_once(&once, QuantisNoHwLoadConfig);
+#endif
+
+  return &quantisNoHwConfig;
+}
+
+/* ------------------------------ Generators ------------------------------ */
+
+/**
+ * Encrypts a counter with Philox4x32-10 (Salmon et al., "Parallel random
+ * numbers: as easy as 1, 2, 3", SC'11).
+ */
+static void QuantisNoHwPhilox(const uint32_t key[2], uint64_t counter, unsigned char *block)
+{
+  uint32_t c[4];
+  uint32_t k[2];
+  int round;
+  int i;
+
+  c[0] = (uint32_t)counter;
+  c[1] = (uint32_t)(counter >> 32);
+  c[2] = 0u;
+  c[3] = 0u;
+  k[0] = key[0];
+  k[1] = key[1];
+
+  for (round = 0; round < 10; round++)
+  {
+    uint64_t product0 = (uint64_t)0xD2511F53u * c[0];
+    uint64_t product1 = (uint64_t)0xCD9E8D57u * c[2];
+    uint32_t c0 = (uint32_t)(product1 >> 32) ^ c[1] ^ k[0];
+    uint32_t c2 = (uint32_t)(product0 >> 32) ^ c[3] ^ k[1];
+    c[1] = (uint32_t)product1;
+    c[3] = (uint32_t)product0;
+    c[0] = c0;
+    c[2] = c2;
+    k[0] += 0x9E3779B9u;
+    k[1] += 0xBB67AE85u;
+  }
+
+  /* Little endian output */
+  for (i = 0; i < 4; i++)
+  {
+    block[4 * i] = (unsigned char)c[i];
+    block[4 * i + 1] = (unsigned char)(c[i] >> 8);
+    block[4 * i + 2] = (unsigned char)(c[i] >> 16);
+    block[4 * i + 3] = (unsigned char)(c[i] >> 24);
+  }
+}
+
+/**
+ * Fills a buffer with the next bytes of the stream of the device. The
+ * stream does not depend on how it is split into reads.
+ */
+static void QuantisNoHwGenerate(QuantisPrivateData *device, unsigned char *buffer, size_t size)
+{
+  size_t remaining;
+
+  /* Rest of current block */
+  remaining = sizeof(device->block) - device->blockOffset;
+  if (remaining > size)
+  {
+    remaining = size;
+  }
+  memcpy(buffer, device->block + device->blockOffset, remaining);
+  device->blockOffset += remaining;
+  buffer += remaining;
+  size -= remaining;
+
+  /* Whole blocks */
+  while (size >= sizeof(device->block))
+  {
+    QuantisNoHwPhilox(device->key, device->counter++, buffer);
+    buffer += sizeof(device->block);
+    size -= sizeof(device->block);
+  }
+
+  /* Beginning of next block */
+  if (size > 0u)
+  {
+    QuantisNoHwPhilox(device->key, device->counter++, device->block);
+    memcpy(buffer, device->block, size);
+    device->blockOffset = size;
+  }
+}
+
+/**
+ * Returns a random number in [0, 1) for the events of the device (splitmix64).
+ */
+static double QuantisNoHwEvent(QuantisPrivateData *device)
+{
+  uint64_t z = (device->eventState += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z ^= z >> 31;
+  return (double)(z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* -------------------------------- Timing -------------------------------- */
+
 /**
- * A reentrant pseudo-random integer between 0 and 32767.
- * @param nextp returns the
- * @return a pseudo-random integer between 0 and 32767.
+ * Returns a monotonic time in microseconds.
  */
-int QuantisRandR(unsigned int *nextp)
+static unsigned long long QuantisNoHwGetTimeUs()
 {
-  *nextp = *nextp * 1103515245 + 12345;
-  return (unsigned int)(*nextp / 65536) % 32768;
+#ifdef _WIN32
+  return (unsigned long long)GetTickCount64() * 1000ull;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000ull + (unsigned long long)ts.tv_nsec / 1000ull;
+#endif
+}
+
+/**
+ * Waits for the simulated device to complete a read of <em>size</em> bytes.
+ */
+static void QuantisNoHwWait(QuantisDeviceHandle *deviceHandle, size_t size)
+{
+  QuantisPrivateData *device = (QuantisPrivateData *)deviceHandle->privateData;
+  const QuantisNoHwConfig *config = QuantisNoHwGetConfig();
+  unsigned long long now;
+  double rate = config->rate;
+  double duration = config->latency;
+
+  if (config->jitter > 0.0)
+  {
+    duration += config->jitter * QuantisNoHwEvent(device);
+  }
+  if (rate < 0.0)
+  {
+    rate = (double)deviceHandle->ops->GetModulesDataRate(deviceHandle);
+  }
+  if (rate > 0.0)
+  {
+    duration += (double)size * 1e6 / rate;
+  }
+  if (duration <= 0.0)
+  {
+    return;
+  }
+
+  /*
+   * Back to back reads are timed from the end of the previous one, so that
+   * the overshoot of the sleeps does not lower the data rate.
+   */
+  now = QuantisNoHwGetTimeUs();
+  if (device->busyUntil + QUANTIS_NOHW_RATE_SLACK < now)
+  {
+    device->busyUntil = now;
+  }
+  device->busyUntil += (unsigned long long)duration;
+
+  if (device->busyUntil > now)
+  {
+#ifdef _WIN32
+    Sleep((DWORD)((device->busyUntil - now) / 1000ull));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(device->busyUntil / 1000000ull);
+    ts.tv_nsec = (long)(device->busyUntil % 1000000ull) * 1000l;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+    {
+      /* Interrupted, sleep again */
+    }
+#endif
+  }
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**
+ * Returns the modules status of the device, or 0 when a status failure is
+ * injected.
+ */
+static int QuantisNoHwModulesStatus(QuantisDeviceHandle *deviceHandle)
+{
+  const QuantisNoHwConfig *config = QuantisNoHwGetConfig();
+  QuantisPrivateData *device = (QuantisPrivateData *)deviceHandle->privateData;
+
+  if (device == NULL)
+  {
+    return (deviceHandle->deviceType == QUANTIS_DEVICE_USB) ? QUANTIS_NOHW_MODULES_STATUS_USB
+                                                           : QUANTIS_NOHW_MODULES_STATUS_PCI;
+  }
+
+  if ((config->statusFailureRate > 0.0) &&
+      (QuantisNoHwEvent(device) < config->statusFailureRate))
+  {
+    return 0;
+  }
+
+  return device->modulesStatus;
+}
+
+/**
+ * Sets the modules status of the device, other handles are not affected.
+ */
+static int QuantisNoHwSetModulesStatus(QuantisDeviceHandle *deviceHandle, int modulesStatus)
+{
+  QuantisPrivateData *device = (QuantisPrivateData *)deviceHandle->privateData;
+
+  if (device == NULL)
+  {
+    return QUANTIS_ERROR_NO_DEVICE;
+  }
+
+  device->modulesStatus = modulesStatus;
+  return QUANTIS_SUCCESS;
 }
 
 /* Board reset */
@@ -90,25 +503,24 @@ int QuantisUsbBoardReset(QuantisDeviceHandle *deviceHandle)
 /* Close */
 void QuantisPciClose(QuantisDeviceHandle *deviceHandle)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  free(deviceHandle->privateData);
+  deviceHandle->privateData = NULL;
 }
 
 void QuantisUsbClose(QuantisDeviceHandle *deviceHandle)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  QuantisPciClose(deviceHandle);
 }
 
 /* Count */
 int QuantisPciCount()
 {
-  /* One device detected */
-  return 1;
+  return QuantisNoHwGetConfig()->devicesCount;
 }
 
 int QuantisUsbCount()
 {
-  /* One device detected */
-  return 1;
+  return QuantisNoHwGetConfig()->devicesCount;
 }
 
 /* GetBoardVersion */
@@ -168,20 +580,19 @@ int QuantisPciGetModulesDataRate(QuantisDeviceHandle *deviceHandle)
 
 int QuantisUsbGetModulesDataRate(QuantisDeviceHandle *deviceHandle)
 {
-  return QuantisPciGetModulesDataRate(deviceHandle);
+  return QUANTIS_MODULE_DATA_RATE *
+         QuantisCountSetBits(QuantisUsbGetModulesMask(deviceHandle));
 }
 
 /* GetModulesStatus */
 int QuantisPciGetModulesStatus(QuantisDeviceHandle *deviceHandle)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
-  return modulesStatusPci;
+  return QuantisNoHwModulesStatus(deviceHandle);
 }
 
 int QuantisUsbGetModulesStatus(QuantisDeviceHandle *deviceHandle)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
-  return modulesStatusUsb;
+  return QuantisNoHwModulesStatus(deviceHandle);
 }
 
 /* GetModulesPower */
@@ -212,31 +623,23 @@ char *QuantisUsbGetSerialNumber(QuantisDeviceHandle *deviceHandle)
 /* ModulesDisable */
 int QuantisPciModulesDisable(QuantisDeviceHandle *deviceHandle, int moduleMask)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
-  modulesStatusPci = moduleMask;
-  return QUANTIS_SUCCESS;
+  return QuantisNoHwSetModulesStatus(deviceHandle, moduleMask);
 }
 
 int QuantisUsbModulesDisable(QuantisDeviceHandle *deviceHandle, int moduleMask)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
-  modulesStatusUsb = moduleMask;
-  return QUANTIS_SUCCESS;
+  return QuantisNoHwSetModulesStatus(deviceHandle, moduleMask);
 }
 
 /* ModulesEnable */
 int QuantisPciModulesEnable(QuantisDeviceHandle *deviceHandle, int moduleMask)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
-  modulesStatusPci = moduleMask;
-  return QUANTIS_SUCCESS;
+  return QuantisNoHwSetModulesStatus(deviceHandle, moduleMask);
 }
 
 int QuantisUsbModulesEnable(QuantisDeviceHandle *deviceHandle, int moduleMask)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
-  modulesStatusUsb = moduleMask;
-  return QUANTIS_SUCCESS;
+  return QuantisNoHwSetModulesStatus(deviceHandle, moduleMask);
 }
 
 int QuantisPciGetBusDeviceId(QuantisDeviceHandle *deviceHandle)
@@ -305,24 +708,48 @@ int QuantisUsbClearAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandl
 /* Open */
 int QuantisPciOpen(QuantisDeviceHandle *deviceHandle)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  const QuantisNoHwConfig *config = QuantisNoHwGetConfig();
+  QuantisPrivateData *device = (QuantisPrivateData *)malloc(sizeof(QuantisPrivateData));
+  unsigned int openCount;
+
+  if (device == NULL)
+  {
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+
+#ifdef _WIN32
+  openCount = (unsigned int)InterlockedIncrement((volatile LONG *)&quantisNoHwOpenCount) - 1u;
+#else
+  openCount = __sync_fetch_and_add(&quantisNoHwOpenCount, 1u);
+#endif
+
+  /* Each handle has its own stream, reproducible for a given seed */
+  device->key[0] = (uint32_t)config->seed ^ openCount;
+  device->key[1] = (uint32_t)(config->seed >> 32) ^
+                   ((uint32_t)deviceHandle->deviceType << 24) ^
+                   (uint32_t)deviceHandle->deviceNumber;
+  device->counter = 0u;
+  device->blockOffset = sizeof(device->block);
+  device->eventState = ((uint64_t)device->key[1] << 32) | device->key[0];
+  device->busyUntil = 0ull;
+  device->modulesStatus = (deviceHandle->deviceType == QUANTIS_DEVICE_USB) ? QUANTIS_NOHW_MODULES_STATUS_USB
+                                                                          : QUANTIS_NOHW_MODULES_STATUS_PCI;
+
+  deviceHandle->privateData = device;
 
   return QUANTIS_SUCCESS;
 }
 
 int QuantisUsbOpen(QuantisDeviceHandle *deviceHandle)
 {
-  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
-
-  return QUANTIS_SUCCESS;
+  return QuantisPciOpen(deviceHandle);
 }
 
 /* Read */
 int QuantisPciRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
 {
-  size_t readBytes = 0u;
-  static unsigned int seed = 0u;
-  unsigned char *charBuffer = (unsigned char *)buffer;
+  const QuantisNoHwConfig *config = QuantisNoHwGetConfig();
+  QuantisPrivateData *device = (QuantisPrivateData *)deviceHandle->privateData;
 
   /* Consistency check */
   if (size == 0)
@@ -332,21 +759,35 @@ int QuantisPciRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
   }
 
   /*
-   * Use ops instead of directly calling QuantisPciGetModulesStatus
-   * since QuantisUsbread also uses this function...
+   * Check if status is ok (when required by the status check policy). Use
+   * ops instead of directly calling QuantisPciGetModulesStatus since
+   * QuantisUsbRead also uses this function...
    */
-  if (deviceHandle->ops->GetModulesStatus(deviceHandle) <= 0)
+  if (QuantisStatusCheckIsDue(deviceHandle))
   {
-    return QUANTIS_ERROR_NO_MODULE;
+    int modulesStatus = deviceHandle->ops->GetModulesStatus(deviceHandle);
+    QuantisStatusCheckDone(deviceHandle, modulesStatus);
+    if (modulesStatus <= 0)
+    {
+      return QUANTIS_ERROR_INVALID_STATUS;
+    }
   }
 
-  /* Using internal PRNG */
-  while (readBytes < size)
+  /* Time taken by the device */
+  QuantisNoHwWait(deviceHandle, size);
+
+  /* Injected failure */
+  if ((config->readFailureRate > 0.0) && (QuantisNoHwEvent(device) < config->readFailureRate))
   {
-    *charBuffer++ = (unsigned char)QuantisRandR(&seed);
-    readBytes++;
+    QuantisStatusCheckUpdate(deviceHandle, QUANTIS_ERROR_IO);
+    return QUANTIS_ERROR_IO;
   }
-  return (int)readBytes;
+
+  QuantisNoHwGenerate(device, (unsigned char *)buffer, size);
+
+  QuantisStatusCheckUpdate(deviceHandle, (int)size);
+
+  return (int)size;
 }
 
 int QuantisUsbRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
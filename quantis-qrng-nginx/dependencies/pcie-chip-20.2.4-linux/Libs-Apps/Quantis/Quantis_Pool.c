@@ -0,0 +1,484 @@
+/*
+ * Quantis random data pool
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Quantis.h"
+#include "Quantis_Pool.h"
+
+/** Size (in bytes) of a cache line, fields written by different threads are kept apart */
+#define QUANTIS_POOL_CACHE_LINE 64
+
+#define QUANTIS_POOL_ALIGNED __attribute__((aligned(QUANTIS_POOL_CACHE_LINE)))
+
+/** Delays (in milliseconds) before the producer reads again after a failure,
+ * doubled after each failure up to the maximum */
+#define QUANTIS_POOL_RETRY_MIN_DELAY 10
+#define QUANTIS_POOL_RETRY_MAX_DELAY 1000
+
+struct QuantisPool
+{
+  /* Free running counter of the bytes written, only written by the producer */
+  size_t head QUANTIS_POOL_ALIGNED;
+
+  /* Free running counter of the bytes read, only written by the consumers */
+  size_t tail QUANTIS_POOL_ALIGNED;
+
+  /* Set once at creation */
+  unsigned char *buffer QUANTIS_POOL_ALIGNED;
+  size_t capacity; /* power of two */
+  size_t lowWatermark;
+  size_t highWatermark;
+  QuantisDeviceHandle *deviceHandle;
+
+  /* Slow path (producer sleeping or consumers waiting) */
+  int running;
+  int error; /* error of the last read, 0 once the device reads again */
+  int producerSleeping;
+  int consumersWaiting;
+  pthread_t producerThread;
+  pthread_mutex_t mutex;
+  pthread_cond_t dataAvailable;
+  pthread_cond_t spaceAvailable;
+};
+
+/**
+ * Copies <em>size</em> bytes starting at <em>position</em> out of the ring.
+ */
+static void QuantisPoolCopy(QuantisPool *pool, size_t position, unsigned char *buffer, size_t size)
+{
+  size_t offset = position & (pool->capacity - 1u);
+  size_t firstPart = pool->capacity - offset;
+
+  if (firstPart > size)
+  {
+    firstPart = size;
+  }
+
+  memcpy(buffer, pool->buffer + offset, firstPart);
+  memcpy(buffer + firstPart, pool->buffer, size - firstPart);
+}
+
+/**
+ * Wakes the producer up if it sleeps while the available data is below the
+ * low watermark.
+ */
+static void QuantisPoolWakeProducer(QuantisPool *pool, size_t available)
+{
+  if ((available < pool->lowWatermark) &&
+      __atomic_load_n(&pool->producerSleeping, __ATOMIC_SEQ_CST))
+  {
+    pthread_mutex_lock(&pool->mutex);
+    pthread_cond_signal(&pool->spaceAvailable);
+    pthread_mutex_unlock(&pool->mutex);
+  }
+}
+
+/**
+ * Takes between <em>minSize</em> and <em>maxSize</em> bytes from the ring.
+ * This is the fast path of the consumers: the data is copied first, then
+ * claimed by moving the tail forward. If another consumer moved the tail in
+ * the meantime, the copy may be stale and is done again.
+ * @return the number of bytes taken, 0 when less than <em>minSize</em>
+ * bytes are available.
+ */
+static size_t QuantisPoolTake(QuantisPool *pool, unsigned char *buffer, size_t minSize, size_t maxSize)
+{
+  size_t tail = __atomic_load_n(&pool->tail, __ATOMIC_RELAXED);
+  size_t head;
+  size_t size;
+
+  while (1)
+  {
+    head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+    size = head - tail;
+    if ((size == 0u) || (size < minSize))
+    {
+      return 0u;
+    }
+    if (size > maxSize)
+    {
+      size = maxSize;
+    }
+
+    QuantisPoolCopy(pool, tail, buffer, size);
+
+    if (__atomic_compare_exchange_n(&pool->tail, &tail, tail + size, 0,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    {
+      break;
+    }
+    /* tail now holds the new value, try again */
+  }
+
+  QuantisPoolWakeProducer(pool, head - tail - size);
+
+  return size;
+}
+
+/**
+ * Waits <em>delay</em> milliseconds before the producer reads again after a
+ * failure, or until the pool is destroyed.
+ */
+static void QuantisPoolRetryWait(QuantisPool *pool, int delay)
+{
+  struct timespec deadline;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += delay / 1000;
+  deadline.tv_nsec += (delay % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L)
+  {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock(&pool->mutex);
+  while (pool->running)
+  {
+    if (pthread_cond_timedwait(&pool->spaceAvailable, &pool->mutex, &deadline) == ETIMEDOUT)
+    {
+      break;
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * Producer thread: keeps the available data between the watermarks. A read
+ * failure is reported to the consumers and the device is read again after a
+ * delay, the error is cleared as soon as a read succeeds.
+ */
+static void *QuantisPoolProducer(void *arg)
+{
+  QuantisPool *pool = (QuantisPool *)arg;
+  size_t head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+  size_t available;
+  size_t chunkSize;
+  int retryDelay = 0;
+  int result;
+
+  while (__atomic_load_n(&pool->running, __ATOMIC_ACQUIRE))
+  {
+    available = head - __atomic_load_n(&pool->tail, __ATOMIC_ACQUIRE);
+
+    if (available >= pool->highWatermark)
+    {
+      /* Full enough, sleep until the low watermark is reached */
+      pthread_mutex_lock(&pool->mutex);
+      __atomic_store_n(&pool->producerSleeping, 1, __ATOMIC_SEQ_CST);
+      while (pool->running &&
+             (head - __atomic_load_n(&pool->tail, __ATOMIC_SEQ_CST) >= pool->lowWatermark))
+      {
+        pthread_cond_wait(&pool->spaceAvailable, &pool->mutex);
+      }
+      __atomic_store_n(&pool->producerSleeping, 0, __ATOMIC_SEQ_CST);
+      pthread_mutex_unlock(&pool->mutex);
+      continue;
+    }
+
+    /* Read directly into the ring, up to its end */
+    chunkSize = pool->highWatermark - available;
+    if (chunkSize > pool->capacity - (head & (pool->capacity - 1u)))
+    {
+      chunkSize = pool->capacity - (head & (pool->capacity - 1u));
+    }
+    if (chunkSize > QUANTIS_POOL_READ_SIZE)
+    {
+      chunkSize = QUANTIS_POOL_READ_SIZE;
+    }
+
+    result = QuantisReadHandled(pool->deviceHandle,
+                                pool->buffer + (head & (pool->capacity - 1u)),
+                                chunkSize);
+    if (result < 0)
+    {
+      __atomic_store_n(&pool->error, result, __ATOMIC_SEQ_CST);
+    }
+    else
+    {
+      /* Publish data */
+      head += (size_t)result;
+      __atomic_store_n(&pool->head, head, __ATOMIC_SEQ_CST);
+
+      /* The device is back */
+      if (retryDelay != 0)
+      {
+        __atomic_store_n(&pool->error, 0, __ATOMIC_SEQ_CST);
+        retryDelay = 0;
+      }
+    }
+
+    if ((result < 0) || __atomic_load_n(&pool->consumersWaiting, __ATOMIC_SEQ_CST))
+    {
+      pthread_mutex_lock(&pool->mutex);
+      pthread_cond_broadcast(&pool->dataAvailable);
+      pthread_mutex_unlock(&pool->mutex);
+    }
+
+    if (result < 0)
+    {
+      retryDelay = (retryDelay == 0) ? QUANTIS_POOL_RETRY_MIN_DELAY : 2 * retryDelay;
+      if (retryDelay > QUANTIS_POOL_RETRY_MAX_DELAY)
+      {
+        retryDelay = QUANTIS_POOL_RETRY_MAX_DELAY;
+      }
+      QuantisPoolRetryWait(pool, retryDelay);
+    }
+  }
+
+  return NULL;
+}
+
+int QuantisPoolCreate(QuantisDeviceHandle *deviceHandle,
+                      size_t capacity,
+                      size_t lowWatermark,
+                      size_t highWatermark,
+                      QuantisPool **pool)
+{
+  QuantisPool *_pool = NULL;
+  void *memory = NULL;
+  size_t roundedCapacity;
+
+  if ((deviceHandle == NULL) || (pool == NULL))
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  /* Default values */
+  if (capacity == 0u)
+  {
+    capacity = QUANTIS_POOL_DEFAULT_CAPACITY;
+  }
+  roundedCapacity = QUANTIS_POOL_CACHE_LINE;
+  while (roundedCapacity < capacity)
+  {
+    roundedCapacity <<= 1;
+    if (roundedCapacity == 0u)
+    {
+      return QUANTIS_ERROR_INVALID_PARAMETER;
+    }
+  }
+  capacity = roundedCapacity;
+
+  if (highWatermark == 0u)
+  {
+    highWatermark = capacity;
+  }
+  if (lowWatermark == 0u)
+  {
+    lowWatermark = highWatermark / 4u;
+  }
+
+  /* Consistency checks */
+  if ((highWatermark > capacity) || (lowWatermark > highWatermark))
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  /* Allocate memory */
+  if (posix_memalign(&memory, QUANTIS_POOL_CACHE_LINE, sizeof(QuantisPool)) != 0)
+  {
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+  _pool = (QuantisPool *)memory;
+  memset(_pool, 0, sizeof(QuantisPool));
+
+  if (posix_memalign(&memory, QUANTIS_POOL_CACHE_LINE, capacity) != 0)
+  {
+    free(_pool);
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+  _pool->buffer = (unsigned char *)memory;
+
+  _pool->capacity = capacity;
+  _pool->lowWatermark = lowWatermark;
+  _pool->highWatermark = highWatermark;
+  _pool->deviceHandle = deviceHandle;
+  _pool->running = 1;
+  pthread_mutex_init(&_pool->mutex, NULL);
+  pthread_cond_init(&_pool->dataAvailable, NULL);
+  pthread_cond_init(&_pool->spaceAvailable, NULL);
+
+  /* Start producer */
+  if (pthread_create(&_pool->producerThread, NULL, QuantisPoolProducer, _pool) != 0)
+  {
+    pthread_cond_destroy(&_pool->spaceAvailable);
+    pthread_cond_destroy(&_pool->dataAvailable);
+    pthread_mutex_destroy(&_pool->mutex);
+    free(_pool->buffer);
+    free(_pool);
+    return QUANTIS_ERROR_OTHER;
+  }
+
+  *pool = _pool;
+
+  return QUANTIS_SUCCESS;
+}
+
+void QuantisPoolDestroy(QuantisPool *pool)
+{
+  if (pool == NULL)
+  {
+    return;
+  }
+
+  /* Stop producer */
+  pthread_mutex_lock(&pool->mutex);
+  __atomic_store_n(&pool->running, 0, __ATOMIC_SEQ_CST);
+  pthread_cond_signal(&pool->spaceAvailable);
+  pthread_cond_broadcast(&pool->dataAvailable);
+  pthread_mutex_unlock(&pool->mutex);
+
+  pthread_join(pool->producerThread, NULL);
+
+  pthread_cond_destroy(&pool->spaceAvailable);
+  pthread_cond_destroy(&pool->dataAvailable);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->buffer);
+  free(pool);
+}
+
+int QuantisPoolTryRead(QuantisPool *pool, void *buffer, size_t size)
+{
+  int error;
+
+  if (pool == NULL)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  if (size == 0u)
+  {
+    return 0;
+  }
+  else if ((size > QUANTIS_MAX_READ_SIZE) || (size > pool->capacity))
+  {
+    return QUANTIS_ERROR_INVALID_READ_SIZE;
+  }
+
+  if (QuantisPoolTake(pool, (unsigned char *)buffer, size, size) == size)
+  {
+    return (int)size;
+  }
+
+  /* Not enough data: report producer's error, if any */
+  error = __atomic_load_n(&pool->error, __ATOMIC_SEQ_CST);
+  return (error < 0) ? error : 0;
+}
+
+int QuantisPoolRead(QuantisPool *pool, void *buffer, size_t size)
+{
+  size_t readBytes = 0u;
+  int error;
+
+  if (pool == NULL)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  if (size == 0u)
+  {
+    return 0;
+  }
+  else if (size > QUANTIS_MAX_READ_SIZE)
+  {
+    return QUANTIS_ERROR_INVALID_READ_SIZE;
+  }
+
+  while (1)
+  {
+    /* Fast path */
+    readBytes += QuantisPoolTake(pool, (unsigned char *)buffer + readBytes, 1u, size - readBytes);
+    if (readBytes == size)
+    {
+      return (int)size;
+    }
+
+    /* Slow path: wait for the producer */
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_add_fetch(&pool->consumersWaiting, 1, __ATOMIC_SEQ_CST);
+    while ((QuantisPoolAvailable(pool) == 0u) &&
+           (__atomic_load_n(&pool->error, __ATOMIC_SEQ_CST) == 0) &&
+           pool->running)
+    {
+      pthread_cond_wait(&pool->dataAvailable, &pool->mutex);
+    }
+    __atomic_sub_fetch(&pool->consumersWaiting, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pool->mutex);
+
+    /* Data may have been taken by other consumers, then just wait again.
+     * Bytes already taken are not lost, the error comes with next read */
+    if (QuantisPoolAvailable(pool) == 0u)
+    {
+      error = __atomic_load_n(&pool->error, __ATOMIC_SEQ_CST);
+      if (error >= 0)
+      {
+        error = __atomic_load_n(&pool->running, __ATOMIC_SEQ_CST) ? 0 : QUANTIS_ERROR_IO;
+      }
+      if (error < 0)
+      {
+        return (readBytes > 0u) ? (int)readBytes : error;
+      }
+    }
+  }
+}
+
+size_t QuantisPoolAvailable(QuantisPool *pool)
+{
+  size_t tail = __atomic_load_n(&pool->tail, __ATOMIC_SEQ_CST);
+  size_t head = __atomic_load_n(&pool->head, __ATOMIC_SEQ_CST);
+
+  return head - tail;
+}
@@ -0,0 +1,155 @@
+/*
+ * Quantis random data pool
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#ifndef QUANTIS_POOL_H
+#define QUANTIS_POOL_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#else
+#include <stddef.h>
+#endif
+
+#include "DllMain.h"
+#include "Quantis.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /** Default capacity (in bytes) of a pool */
+#define QUANTIS_POOL_DEFAULT_CAPACITY (1024 * 1024)
+
+  /** Maximal size (in bytes) requested to the device at once by the producer */
+#define QUANTIS_POOL_READ_SIZE (64 * 1024)
+
+  /**
+   * Pool of random data prefetched from a Quantis device.
+   *
+   * A producer thread reads random data from the device into a lock-free
+   * ring buffer: as soon as the amount of available data falls below the low
+   * watermark, the producer refills the ring up to the high watermark.
+   * Consumers take data from the ring without any lock nor system call as
+   * long as enough data is available (wait-free with a single consumer,
+   * lock-free with several consumers), so small requests are served from
+   * memory instead of waiting for the device.
+   *
+   * Each byte of the pool is delivered to a single consumer.
+   */
+  typedef struct QuantisPool QuantisPool;
+
+  /**
+   * Creates a pool and starts its producer thread.
+   * @param deviceHandle a pointer to a handle the device. The handle is used
+   * by the producer thread only, and MUST NOT be used nor closed by the
+   * caller until the pool is destroyed.
+   * @param capacity the size (in bytes) of the ring buffer. It is rounded up
+   * to a power of two. 0 selects QUANTIS_POOL_DEFAULT_CAPACITY.
+   * @param lowWatermark the amount of available data (in bytes) below which
+   * the producer starts reading from the device. 0 selects capacity / 4.
+   * @param highWatermark the amount of available data (in bytes) at which
+   * the producer stops reading from the device. 0 selects capacity.
+   * @param pool a pointer to the created pool.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisPoolCreate(QuantisDeviceHandle *deviceHandle,
+                                   size_t capacity,
+                                   size_t lowWatermark,
+                                   size_t highWatermark,
+                                   QuantisPool **pool);
+
+  /**
+   * Stops the producer thread and destroys the pool. The device handle given
+   * to QuantisPoolCreate may be used again once this function returns.
+   * @param pool a pointer to the pool.
+   */
+  DLL_EXPORT void QuantisPoolDestroy(QuantisPool *pool);
+
+  /**
+   * Reads random data from the pool, waiting for the producer when not
+   * enough data is available.
+   * @param pool a pointer to the pool.
+   * @param buffer a pointer to a destination buffer. This buffer MUST
+   * already be allocated. Its size must be at least <em>size</em> bytes.
+   * @param size the number of bytes to read (not larger than QUANTIS_MAX_READ_SIZE).
+   * @return The number of read bytes on success, less than <em>size</em> when
+   * the pool ran out while the device fails or the pool is being destroyed,
+   * or a QUANTIS_ERROR code on failure when nothing was read (the error
+   * returned by the device, the producer keeps reading it again).
+   */
+  DLL_EXPORT int QuantisPoolRead(QuantisPool *pool,
+                                 void *buffer,
+                                 size_t size);
+
+  /**
+   * Reads random data from the pool without waiting.
+   * @param pool a pointer to the pool.
+   * @param buffer a pointer to a destination buffer.
+   * @param size the number of bytes to read (not larger than QUANTIS_MAX_READ_SIZE).
+   * @return <em>size</em> when the pool held enough data, 0 when it did not
+   * (nothing is read in that case) or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisPoolTryRead(QuantisPool *pool,
+                                    void *buffer,
+                                    size_t size);
+
+  /**
+   * Returns the amount of random data (in bytes) currently available in the
+   * pool.
+   * @param pool a pointer to the pool.
+   */
+  DLL_EXPORT size_t QuantisPoolAvailable(QuantisPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUANTIS_POOL_H */
@@ -0,0 +1,772 @@
+/*
+ * Quantis remote device: random data served by QuantisServer over a socket
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#include <errno.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Quantis.h"
+#include "Quantis_Internal.h"
+#include "Quantis_Remote.h"
+
+#ifndef MSG_NOSIGNAL
+/* Not available on Mac OS X, SIGPIPE must be ignored by the application */
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef struct QuantisPrivateData
+{
+  char address[256];
+  int socket; /* -1 when not connected */
+  unsigned char buffer[QUANTIS_REMOTE_BATCH_SIZE];
+  size_t bufferOffset;
+  size_t bufferSize;
+  char serialNumber[256];
+  char manufacturer[256];
+} QuantisPrivateData;
+
+/* --------------------------- Sockets helpers --------------------------- */
+
+/**
+ * Sets the time a receive on the socket waits for data.
+ */
+static void QuantisRemoteSetTimeout(int fd, unsigned int timeout)
+{
+  struct timeval tv;
+
+  tv.tv_sec = (time_t)(timeout / 1000u);
+  tv.tv_usec = (suseconds_t)((timeout % 1000u) * 1000u);
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+/**
+ * Returns 1 if a TCP address is on the loopback interface, 0 otherwise.
+ */
+static int QuantisRemoteIsLoopback(const struct sockaddr *address)
+{
+  if (address->sa_family == AF_INET)
+  {
+    const struct sockaddr_in *in = (const struct sockaddr_in *)address;
+    return (ntohl(in->sin_addr.s_addr) >> 24) == 127u;
+  }
+  else if (address->sa_family == AF_INET6)
+  {
+    const struct in6_addr *in6 = &((const struct sockaddr_in6 *)address)->sin6_addr;
+    return IN6_IS_ADDR_LOOPBACK(in6) || (IN6_IS_ADDR_V4MAPPED(in6) && (in6->s6_addr[12] == 127u));
+  }
+
+  return 0;
+}
+
+/**
+ * Creates a socket bound or connected to an address.
+ * @param listening 1 to bind the socket and listen, 0 to connect it.
+ * @param allowNetwork 1 to listen on a TCP address which is not loopback.
+ * @return a socket descriptor on success or a QUANTIS_ERROR code on failure.
+ */
+static int QuantisRemoteOpenSocket(const char *address, int listening, int allowNetwork)
+{
+  int fd = -1;
+
+  if (address == NULL)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  if ((strncmp(address, "unix:", 5) == 0) || (strncmp(address, "tcp:", 4) != 0))
+  {
+    const char *path = (strncmp(address, "unix:", 5) == 0) ? address + 5 : address;
+    struct sockaddr_un sockAddress;
+
+    if ((*path == '\0') || (strlen(path) >= sizeof(sockAddress.sun_path)))
+    {
+      return QUANTIS_ERROR_INVALID_PARAMETER;
+    }
+    memset(&sockAddress, 0, sizeof(sockAddress));
+    sockAddress.sun_family = AF_UNIX;
+    strcpy(sockAddress.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+      return QUANTIS_ERROR_IO;
+    }
+
+    if (listening)
+    {
+      unlink(sockAddress.sun_path);
+      if ((bind(fd, (struct sockaddr *)&sockAddress, sizeof(sockAddress)) < 0) ||
+          (listen(fd, SOMAXCONN) < 0))
+      {
+        close(fd);
+        return QUANTIS_ERROR_IO;
+      }
+    }
+    else if (connect(fd, (struct sockaddr *)&sockAddress, sizeof(sockAddress)) < 0)
+    {
+      close(fd);
+      return QUANTIS_ERROR_NO_DEVICE;
+    }
+  }
+  else
+  {
+    struct addrinfo hints;
+    struct addrinfo *addresses = NULL;
+    struct addrinfo *info;
+    char host[256];
+    const char *port = strrchr(address + 4, ':');
+    size_t hostLength;
+    int refused = 0;
+    int one = 1;
+
+    if ((port == NULL) || ((size_t)(port - (address + 4)) >= sizeof(host)))
+    {
+      return QUANTIS_ERROR_INVALID_PARAMETER;
+    }
+
+    /* Host, without the brackets of an IPv6 address */
+    hostLength = (size_t)(port - (address + 4));
+    memcpy(host, address + 4, hostLength);
+    host[hostLength] = '\0';
+    if ((hostLength >= 2u) && (host[0] == '[') && (host[hostLength - 1u] == ']'))
+    {
+      memmove(host, host + 1, hostLength - 2u);
+      host[hostLength - 2u] = '\0';
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    if (getaddrinfo((host[0] != '\0') ? host : NULL, port + 1, &hints, &addresses) != 0)
+    {
+      return QUANTIS_ERROR_INVALID_PARAMETER;
+    }
+
+    for (info = addresses; info != NULL; info = info->ai_next)
+    {
+      /* The data would be served to the network, in clear */
+      if (listening && !allowNetwork && !QuantisRemoteIsLoopback(info->ai_addr))
+      {
+        refused = 1;
+        continue;
+      }
+
+      fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+      if (fd < 0)
+      {
+        continue;
+      }
+
+      if (listening)
+      {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if ((bind(fd, info->ai_addr, info->ai_addrlen) == 0) &&
+            (listen(fd, SOMAXCONN) == 0))
+        {
+          break;
+        }
+      }
+      else if (connect(fd, info->ai_addr, info->ai_addrlen) == 0)
+      {
+        /* Requests are small and wait for their response */
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        break;
+      }
+
+      close(fd);
+      fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd < 0)
+    {
+      if (refused)
+      {
+        return QUANTIS_ERROR_INVALID_PARAMETER;
+      }
+      return listening ? QUANTIS_ERROR_IO : QUANTIS_ERROR_NO_DEVICE;
+    }
+  }
+
+  return fd;
+}
+
+int QuantisRemoteConnect(const char *address)
+{
+  int fd = QuantisRemoteOpenSocket(address, 0, 0);
+
+  /* A server which stopped answering must not block the reader forever */
+  if (fd >= 0)
+  {
+    QuantisRemoteSetTimeout(fd, QUANTIS_REMOTE_TIMEOUT);
+  }
+
+  return fd;
+}
+
+int QuantisRemoteListen(const char *address, int allowNetwork)
+{
+  return QuantisRemoteOpenSocket(address, 1, allowNetwork);
+}
+
+/**
+ * Returns 1 if the server closed the connection, e.g. after the client was
+ * idle for too long, 0 otherwise.
+ */
+static int QuantisRemoteIsClosed(int fd)
+{
+  struct pollfd pfd;
+  char byte;
+
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (poll(&pfd, 1, 0) <= 0)
+  {
+    return 0;
+  }
+
+  /* Readable without a request pending: end of stream or error */
+  return recv(fd, &byte, 1u, MSG_PEEK | MSG_DONTWAIT) <= 0;
+}
+
+/**
+ * Sends exactly <em>size</em> bytes.
+ * @return QUANTIS_SUCCESS on success or QUANTIS_ERROR_IO on failure.
+ */
+static int QuantisRemoteSendAll(int fd, const void *buffer, size_t size)
+{
+  const unsigned char *data = (const unsigned char *)buffer;
+
+  while (size > 0u)
+  {
+    ssize_t result = send(fd, data, size, MSG_NOSIGNAL);
+    if (result < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return QUANTIS_ERROR_IO;
+    }
+    data += result;
+    size -= (size_t)result;
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisRemoteSend(int fd,
+                      int32_t first,
+                      uint32_t second,
+                      const void *payload,
+                      size_t length)
+{
+  unsigned char header[QUANTIS_REMOTE_HEADER_SIZE];
+  int i;
+
+  for (i = 0; i < 4; i++)
+  {
+    header[i] = (unsigned char)((uint32_t)first >> (24 - 8 * i));
+    header[4 + i] = (unsigned char)(second >> (24 - 8 * i));
+  }
+
+  if (QuantisRemoteSendAll(fd, header, sizeof(header)) < 0)
+  {
+    return QUANTIS_ERROR_IO;
+  }
+
+  return QuantisRemoteSendAll(fd, payload, length);
+}
+
+int QuantisRemoteReceive(int fd, void *buffer, size_t size)
+{
+  unsigned char *data = (unsigned char *)buffer;
+
+  while (size > 0u)
+  {
+    ssize_t result = recv(fd, data, size, 0);
+    if (result < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      /* Including EAGAIN when the receive timeout expired */
+      return QUANTIS_ERROR_IO;
+    }
+    else if (result == 0)
+    {
+      /* Connection closed */
+      return QUANTIS_ERROR_IO;
+    }
+    data += result;
+    size -= (size_t)result;
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int QuantisRemoteReceiveHeader(int fd, int32_t *first, uint32_t *second)
+{
+  unsigned char header[QUANTIS_REMOTE_HEADER_SIZE];
+  uint32_t value = 0u;
+  int i;
+
+  if (QuantisRemoteReceive(fd, header, sizeof(header)) < 0)
+  {
+    return QUANTIS_ERROR_IO;
+  }
+
+  for (i = 0; i < 4; i++)
+  {
+    value = (value << 8) | header[i];
+  }
+  *first = (int32_t)value;
+
+  value = 0u;
+  for (i = 4; i < 8; i++)
+  {
+    value = (value << 8) | header[i];
+  }
+  *second = value;
+
+  return QUANTIS_SUCCESS;
+}
+
+/* ---------------------------- Remote device ---------------------------- */
+
+/**
+ * Returns the address of a remote device from the comma separated list of
+ * the QUANTIS_REMOTE_ADDRESS environment variable. When it is not set, the
+ * only device is the server on QUANTIS_REMOTE_DEFAULT_ADDRESS, if its socket
+ * exists.
+ * @return 1 if the device exists, 0 otherwise.
+ */
+static int QuantisRemoteGetAddress(unsigned int deviceNumber, char *address, size_t size)
+{
+  const char *list = getenv("QUANTIS_REMOTE_ADDRESS");
+  unsigned int number = 0u;
+
+  if (list == NULL)
+  {
+    const char *defaultAddress = QUANTIS_REMOTE_DEFAULT_ADDRESS;
+    if ((deviceNumber != 0u) || (access(defaultAddress + 5, F_OK) != 0) ||
+        (strlen(defaultAddress) >= size))
+    {
+      return 0;
+    }
+    strcpy(address, defaultAddress);
+    return 1;
+  }
+
+  while (*list != '\0')
+  {
+    const char *end = strchr(list, ',');
+    size_t length = (end != NULL) ? (size_t)(end - list) : strlen(list);
+
+    if ((length > 0u) && (number++ == deviceNumber))
+    {
+      if (length >= size)
+      {
+        return 0;
+      }
+      memcpy(address, list, length);
+      address[length] = '\0';
+      return 1;
+    }
+
+    list += length;
+    if (*list == ',')
+    {
+      list++;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Sends a request to the server, connecting to it first when needed. The
+ * connection is closed on failure and opened again by next request.
+ * @param payload a buffer receiving the payload of the response, of
+ * <em>size</em> bytes.
+ * @param length the length of the payload received, may be NULL when no
+ * payload is expected.
+ * @return the result of the request or a QUANTIS_ERROR code on failure.
+ */
+static int QuantisRemoteRequest(QuantisDeviceHandle *deviceHandle,
+                                QuantisRemoteCommand command,
+                                uint32_t argument,
+                                void *payload,
+                                size_t size,
+                                size_t *length)
+{
+  QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
+  int32_t result;
+  uint32_t payloadLength;
+
+  /* The server closes the connections of idle clients, connect again */
+  if ((_privateData->socket >= 0) && QuantisRemoteIsClosed(_privateData->socket))
+  {
+    close(_privateData->socket);
+    _privateData->socket = -1;
+  }
+
+  if (_privateData->socket < 0)
+  {
+    int fd = QuantisRemoteConnect(_privateData->address);
+    if (fd < 0)
+    {
+      return fd;
+    }
+    _privateData->socket = fd;
+  }
+
+  if ((QuantisRemoteSend(_privateData->socket, (int32_t)command, argument, NULL, 0u) < 0) ||
+      (QuantisRemoteReceiveHeader(_privateData->socket, &result, &payloadLength) < 0) ||
+      (payloadLength > size) ||
+      (QuantisRemoteReceive(_privateData->socket, payload, payloadLength) < 0))
+  {
+    close(_privateData->socket);
+    _privateData->socket = -1;
+    return QUANTIS_ERROR_IO;
+  }
+
+  if (length != NULL)
+  {
+    *length = payloadLength;
+  }
+
+  return (int)result;
+}
+
+/**
+ * Requests a string, returns <em>defaultValue</em> on failure.
+ */
+static char *QuantisRemoteRequestString(QuantisDeviceHandle *deviceHandle,
+                                        QuantisRemoteCommand command,
+                                        char *string,
+                                        size_t size,
+                                        const char *defaultValue)
+{
+  size_t length = 0u;
+  int result = QuantisRemoteRequest(deviceHandle, command, 0u, string, size - 1u, &length);
+  if (result < 0)
+  {
+    return (char *)defaultValue;
+  }
+
+  string[length] = '\0';
+  return string;
+}
+
+/* Board reset */
+int QuantisRemoteBoardReset(QuantisDeviceHandle *deviceHandle)
+{
+  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+
+  /* The device is shared, only the server may reset it */
+  return QUANTIS_ERROR_OPERATION_NOT_SUPPORTED;
+}
+
+/* Close */
+void QuantisRemoteClose(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
+  if (_privateData == NULL)
+  {
+    return;
+  }
+
+  if (_privateData->socket >= 0)
+  {
+    close(_privateData->socket);
+  }
+
+  /* Do not leave random data in memory */
+  memset(_privateData->buffer, 0, sizeof(_privateData->buffer));
+  free(_privateData);
+  deviceHandle->privateData = NULL;
+}
+
+/* Count */
+int QuantisRemoteCount()
+{
+  char address[256];
+  int count = 0;
+
+  while ((count < MAX_QUANTIS_DEVICE) &&
+         QuantisRemoteGetAddress((unsigned int)count, address, sizeof(address)))
+  {
+    count++;
+  }
+
+  return count;
+}
+
+/* GetBoardVersion */
+int QuantisRemoteGetBoardVersion(QuantisDeviceHandle *deviceHandle)
+{
+  return QuantisRemoteRequest(deviceHandle, QUANTIS_REMOTE_GET_BOARD_VERSION, 0u, NULL, 0u, NULL);
+}
+
+/* GetDriverVersion */
+float QuantisRemoteGetDriverVersion()
+{
+  /* Implemented by the library itself */
+  return QUANTIS_LIBRARY_VERSION;
+}
+
+/* GetManufacturer */
+char *QuantisRemoteGetManufacturer(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
+  return QuantisRemoteRequestString(deviceHandle,
+                                    QUANTIS_REMOTE_GET_MANUFACTURER,
+                                    _privateData->manufacturer,
+                                    sizeof(_privateData->manufacturer),
+                                    QUANTIS_NOT_AVAILABLE);
+}
+
+/* GetModulesMask */
+int QuantisRemoteGetModulesMask(QuantisDeviceHandle *deviceHandle)
+{
+  return QuantisRemoteRequest(deviceHandle, QUANTIS_REMOTE_GET_MODULES_MASK, 0u, NULL, 0u, NULL);
+}
+
+/* GetModulesDataRate */
+int QuantisRemoteGetModulesDataRate(QuantisDeviceHandle *deviceHandle)
+{
+  return QuantisRemoteRequest(deviceHandle, QUANTIS_REMOTE_GET_MODULES_DATA_RATE, 0u, NULL, 0u, NULL);
+}
+
+/* GetModulesPower */
+int QuantisRemoteGetModulesPower(QuantisDeviceHandle *deviceHandle)
+{
+  return QuantisRemoteRequest(deviceHandle, QUANTIS_REMOTE_GET_MODULES_POWER, 0u, NULL, 0u, NULL);
+}
+
+/* GetModulesStatus */
+int QuantisRemoteGetModulesStatus(QuantisDeviceHandle *deviceHandle)
+{
+  return QuantisRemoteRequest(deviceHandle, QUANTIS_REMOTE_GET_MODULES_STATUS, 0u, NULL, 0u, NULL);
+}
+
+/* GetSerialNumber */
+char *QuantisRemoteGetSerialNumber(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
+  return QuantisRemoteRequestString(deviceHandle,
+                                    QUANTIS_REMOTE_GET_SERIAL_NUMBER,
+                                    _privateData->serialNumber,
+                                    sizeof(_privateData->serialNumber),
+                                    QUANTIS_NO_SERIAL);
+}
+
+/* ModulesDisable */
+int QuantisRemoteModulesDisable(QuantisDeviceHandle *deviceHandle, int moduleMask)
+{
+  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  moduleMask = moduleMask;
+  return QUANTIS_ERROR_OPERATION_NOT_SUPPORTED;
+}
+
+/* ModulesEnable */
+int QuantisRemoteModulesEnable(QuantisDeviceHandle *deviceHandle, int moduleMask)
+{
+  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  moduleMask = moduleMask;
+  return QUANTIS_ERROR_OPERATION_NOT_SUPPORTED;
+}
+
+/* Open */
+int QuantisRemoteOpen(QuantisDeviceHandle *deviceHandle)
+{
+  QuantisPrivateData *_privateData = NULL;
+  int fd;
+
+  _privateData = (QuantisPrivateData *)malloc(sizeof(QuantisPrivateData));
+  if (_privateData == NULL)
+  {
+    return QUANTIS_ERROR_NO_MEMORY;
+  }
+  _privateData->socket = -1;
+  _privateData->bufferOffset = 0u;
+  _privateData->bufferSize = 0u;
+  deviceHandle->privateData = _privateData;
+
+  if (!QuantisRemoteGetAddress((unsigned int)deviceHandle->deviceNumber,
+                               _privateData->address,
+                               sizeof(_privateData->address)))
+  {
+    return QUANTIS_ERROR_INVALID_DEVICE_NUMBER;
+  }
+
+  /* Fails early when the server is not available */
+  fd = QuantisRemoteConnect(_privateData->address);
+  if (fd < 0)
+  {
+    return fd;
+  }
+  _privateData->socket = fd;
+
+  return QUANTIS_SUCCESS;
+}
+
+/* Read, returns the bytes already copied when a later request fails */
+int QuantisRemoteRead(QuantisDeviceHandle *deviceHandle, void *buffer, size_t size)
+{
+  QuantisPrivateData *_privateData = (QuantisPrivateData *)deviceHandle->privateData;
+  unsigned char *data = (unsigned char *)buffer;
+  size_t readBytes = 0u;
+  size_t length;
+  int result = QUANTIS_SUCCESS;
+
+  while (readBytes < size)
+  {
+    size_t chunkSize = size - readBytes;
+
+    /* Data left from previous batch */
+    if (_privateData->bufferOffset < _privateData->bufferSize)
+    {
+      if (chunkSize > _privateData->bufferSize - _privateData->bufferOffset)
+      {
+        chunkSize = _privateData->bufferSize - _privateData->bufferOffset;
+      }
+      memcpy(data + readBytes, _privateData->buffer + _privateData->bufferOffset, chunkSize);
+      _privateData->bufferOffset += chunkSize;
+      readBytes += chunkSize;
+      continue;
+    }
+
+    if (chunkSize >= QUANTIS_REMOTE_BATCH_SIZE)
+    {
+      /* Large read, directly into the buffer */
+      if (chunkSize > QUANTIS_REMOTE_MAX_READ_SIZE)
+      {
+        chunkSize = QUANTIS_REMOTE_MAX_READ_SIZE;
+      }
+      result = QuantisRemoteRequest(deviceHandle, QUANTIS_REMOTE_READ, (uint32_t)chunkSize,
+                                    data + readBytes, chunkSize, &length);
+      if (result < 0)
+      {
+        break;
+      }
+      readBytes += length;
+      if (length != chunkSize)
+      {
+        result = QUANTIS_ERROR_IO;
+        break;
+      }
+    }
+    else
+    {
+      /* Small read, request a whole batch */
+      result = QuantisRemoteRequest(deviceHandle, QUANTIS_REMOTE_READ, QUANTIS_REMOTE_BATCH_SIZE,
+                                    _privateData->buffer, sizeof(_privateData->buffer), &length);
+      if (result < 0)
+      {
+        break;
+      }
+      _privateData->bufferOffset = 0u;
+      _privateData->bufferSize = length;
+      if (length == 0u)
+      {
+        result = QUANTIS_ERROR_IO;
+        break;
+      }
+    }
+  }
+
+  /* Bytes already copied are not lost, the error comes with next read */
+  if ((readBytes == 0u) && (result < 0))
+  {
+    return result;
+  }
+
+  return (int)readBytes;
+}
+
+int QuantisRemoteGetBusDeviceId(QuantisDeviceHandle *deviceHandle)
+{
+  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  return QUANTIS_ERROR_OPERATION_NOT_SUPPORTED;
+}
+
+char *QuantisRemoteTypeStrError(int errorNumber)
+{
+  errorNumber = errorNumber; /* Avoids unused parameter warning */
+  return (char *)NULL;
+}
+
+int QuantisRemoteGetAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle)
+{
+  return QuantisRemoteRequest(deviceHandle,
+                              QUANTIS_REMOTE_GET_AIS31_STARTUP_TESTS_REQUEST_FLAG,
+                              0u, NULL, 0u, NULL);
+}
+
+int QuantisRemoteClearAis31StartupTestsRequestFlag(QuantisDeviceHandle *deviceHandle)
+{
+  deviceHandle = deviceHandle; /* Avoids unused parameter warning */
+  return QUANTIS_ERROR_OPERATION_NOT_SUPPORTED;
+}
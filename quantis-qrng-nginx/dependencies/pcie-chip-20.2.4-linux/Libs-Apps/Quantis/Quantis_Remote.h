@@ -0,0 +1,208 @@
+/*
+ * Quantis remote device protocol
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#ifndef QUANTIS_REMOTE_H
+#define QUANTIS_REMOTE_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#else
+#include <stddef.h>
+#endif
+
+#ifdef _MSC_VER
+#include "msc_stdint.h"
+#else
+#include <stdint.h>
+#endif
+
+#include "DllMain.h"
+#include "Quantis.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * Protocol between the remote device (QUANTIS_DEVICE_REMOTE) and
+   * QuantisServer, over a Unix-domain or a TCP socket.
+   *
+   * Nothing is authenticated nor encrypted: whoever reaches the socket gets
+   * random data, and whoever sees the traffic sees the data. The access to
+   * a Unix-domain socket is set by the permissions of its file, a TCP
+   * socket is only served on the loopback interface unless explicitly
+   * allowed by QuantisRemoteListen.
+   *
+   * Frames start with a header of two 32-bit big endian integers:
+   * - request: command, argument
+   * - response: result (number of bytes or QUANTIS_ERROR code), length of
+   *   the payload which follows the header
+   *
+   * The client sends a request and waits for its response before sending
+   * the next one.
+   */
+  DLL_EXPORT typedef enum {
+    /** Reads <em>argument</em> bytes of random data, sent as payload */
+    QUANTIS_REMOTE_READ = 1,
+
+    /** Returns the modules mask of the device */
+    QUANTIS_REMOTE_GET_MODULES_MASK = 2,
+
+    /** Returns the data rate of the device */
+    QUANTIS_REMOTE_GET_MODULES_DATA_RATE = 3,
+
+    /** Returns the modules power of the device */
+    QUANTIS_REMOTE_GET_MODULES_POWER = 4,
+
+    /** Returns the modules status of the device */
+    QUANTIS_REMOTE_GET_MODULES_STATUS = 5,
+
+    /** Returns the board version of the device */
+    QUANTIS_REMOTE_GET_BOARD_VERSION = 6,
+
+    /** Returns the serial number of the device, sent as payload */
+    QUANTIS_REMOTE_GET_SERIAL_NUMBER = 7,
+
+    /** Returns the manufacturer of the device, sent as payload */
+    QUANTIS_REMOTE_GET_MANUFACTURER = 8,
+
+    /** Returns the AIS 31 startup tests request flag of the device */
+    QUANTIS_REMOTE_GET_AIS31_STARTUP_TESTS_REQUEST_FLAG = 9
+  } QuantisRemoteCommand;
+
+  /** Address of the server when none is given */
+#define QUANTIS_REMOTE_DEFAULT_ADDRESS "unix:/var/run/quantis.sock"
+
+  /** Size (in bytes) of the header of a frame */
+#define QUANTIS_REMOTE_HEADER_SIZE 8
+
+  /** Maximal size (in bytes) of random data requested at once */
+#define QUANTIS_REMOTE_MAX_READ_SIZE (1024 * 1024)
+
+  /**
+   * Size (in bytes) of the random data requested at once by the remote
+   * device for small reads. The rest is kept for next reads, so that many
+   * small reads cost a single round trip.
+   */
+#define QUANTIS_REMOTE_BATCH_SIZE (64 * 1024)
+
+  /**
+   * Time (in milliseconds) the remote device waits for the data of a
+   * response before failing with QUANTIS_ERROR_IO. It must be longer than
+   * the server may delay a read to limit the data rate.
+   */
+#define QUANTIS_REMOTE_TIMEOUT 30000
+
+  /**
+   * Connects to a server. Receiving from the socket times out after
+   * QUANTIS_REMOTE_TIMEOUT.
+   * @param address "unix:<path>" or "tcp:<host>:<port>", a path without
+   * prefix being a Unix-domain socket.
+   * @return a socket descriptor on success or a QUANTIS_ERROR code on failure.
+   */
+  DLL_EXPORT int QuantisRemoteConnect(const char *address);
+
+  /**
+   * Creates a socket listening for clients. An existing Unix-domain socket
+   * file is replaced.
+   * @param address "unix:<path>" or "tcp:<host>:<port>", a path without
+   * prefix being a Unix-domain socket.
+   * @param allowNetwork 0 to only listen on a loopback TCP address, 1 to
+   * accept any address, which gives the random data to every host reaching
+   * the port, in clear.
+   * @return a socket descriptor on success or a QUANTIS_ERROR code on
+   * failure (QUANTIS_ERROR_INVALID_PARAMETER for an address which is not
+   * allowed).
+   */
+  DLL_EXPORT int QuantisRemoteListen(const char *address, int allowNetwork);
+
+  /**
+   * Sends a frame.
+   * @param fd a socket descriptor.
+   * @param first the command of a request or the result of a response.
+   * @param second the argument of a request or the length of the payload
+   * of a response.
+   * @param payload the payload of a response, may be NULL when
+   * <em>length</em> is 0.
+   * @param length the length (in bytes) of the payload.
+   * @return QUANTIS_SUCCESS on success or QUANTIS_ERROR_IO on failure.
+   */
+  DLL_EXPORT int QuantisRemoteSend(int fd,
+                                   int32_t first,
+                                   uint32_t second,
+                                   const void *payload,
+                                   size_t length);
+
+  /**
+   * Receives the header of a frame.
+   * @return QUANTIS_SUCCESS on success or QUANTIS_ERROR_IO on failure (or
+   * when the connection is closed or the receive timeout of the socket
+   * expires).
+   */
+  DLL_EXPORT int QuantisRemoteReceiveHeader(int fd,
+                                            int32_t *first,
+                                            uint32_t *second);
+
+  /**
+   * Receives exactly <em>size</em> bytes.
+   * @return QUANTIS_SUCCESS on success or QUANTIS_ERROR_IO on failure (or
+   * when the connection is closed or the receive timeout of the socket
+   * expires).
+   */
+  DLL_EXPORT int QuantisRemoteReceive(int fd,
+                                      void *buffer,
+                                      size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUANTIS_REMOTE_H */
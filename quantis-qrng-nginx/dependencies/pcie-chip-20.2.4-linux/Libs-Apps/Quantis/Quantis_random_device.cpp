@@ -53,15 +53,18 @@
 #include <sstream>
 #include <limits>
 #include <stdexcept>
-
-#define BUFFER_SIZE 4
+#include <string.h>
 
 using namespace std;
 
-idQ::random_device::random_device(const string &token) throw(runtime_error)
+idQ::random_device::random_device(const string &token)
+    : buffer(DEFAULT_BUFFER_SIZE),
+      bufferPosition(DEFAULT_BUFFER_SIZE),
+      quantis(NULL)
 {
   QuantisDeviceType deviceType;
   unsigned int deviceNumber;
+  string::size_type optionsPosition = token.find(':');
 
   try
   {
@@ -80,9 +83,31 @@ idQ::random_device::random_device(const string &token) throw(runtime_error)
       msg << "Quantis_C++11::random_device: Unrecognised device type. ";
       throw runtime_error(msg.str());
     }
-    deviceNumber = ConvertFromString<unsigned int>(token.substr(1, token.size()));
+    deviceNumber = ConvertFromString<unsigned int>(token.substr(1, optionsPosition - 1));
+
+    if (optionsPosition != string::npos)
+    {
+      vector<string> options = SplitString<string>(token.substr(optionsPosition + 1), ",");
+      for (size_t i = 0; i < options.size(); i++)
+      {
+        string::size_type valuePosition = options[i].find('=');
+        if ((valuePosition == string::npos) || (options[i].compare(0, valuePosition, "buf") != 0))
+        {
+          throw runtime_error("Unrecognised option " + options[i] + ". ");
+        }
+
+        size_t bufferSize = ConvertFromString<size_t>(options[i].substr(valuePosition + 1));
+        bufferSize -= bufferSize % sizeof(result_type);
+        if ((bufferSize == 0) || (bufferSize > QUANTIS_MAX_READ_SIZE))
+        {
+          throw runtime_error("Invalid buffer size " + options[i] + ". ");
+        }
+        buffer.resize(bufferSize);
+        bufferPosition = bufferSize;
+      }
+    }
   }
-  catch (runtime_error e)
+  catch (const runtime_error &e)
   {
     stringstream msg;
     msg << "Quantis_C++11::random_device: Could not read the input parameters. "
@@ -101,7 +126,7 @@ idQ::random_device::random_device(const string &token) throw(runtime_error)
   {
     quantis = new Quantis(static_cast<QuantisDeviceType>(deviceType), deviceNumber);
   }
-  catch (runtime_error e)
+  catch (const runtime_error &e)
   {
     stringstream msg;
     msg << "Quantis_C++11::random_device: Could not instantiate Quantis. "
@@ -119,23 +144,32 @@ idQ::random_device::random_device(const string &token) throw(runtime_error)
 
 idQ::random_device::~random_device()
 {
-  if (quantis)
-  {
-    quantis->~Quantis();
-  }
+  delete quantis;
 }
 
 // generating functions
-idQ::random_device::result_type idQ::random_device::operator()() throw(std::runtime_error)
+idQ::random_device::result_type idQ::random_device::operator()()
 {
   unsigned int returnValue;
-  unsigned char buffer[BUFFER_SIZE];
 
+  if (bufferPosition + sizeof(result_type) > buffer.size())
+  {
+    Refill();
+  }
+
+  Convert(&buffer[bufferPosition], returnValue);
+  bufferPosition += sizeof(result_type);
+
+  return static_cast<result_type>(returnValue);
+}
+
+void idQ::random_device::Refill()
+{
   try
   {
-    quantis->Read(buffer, BUFFER_SIZE);
+    quantis->Read(&buffer[0], buffer.size());
   }
-  catch (runtime_error e)
+  catch (const runtime_error &e)
   {
     stringstream msg;
     msg << "Quantis_C++11::operator()(): Could not perform a Quantis read. "
@@ -150,25 +184,55 @@ idQ::random_device::result_type idQ::random_device::operator()() throw(std::runt
     throw runtime_error(msg.str());
   }
 
-  try
+  bufferPosition = 0;
+}
+
+void idQ::random_device::Fill(result_type *values, size_t count)
+{
+  size_t i = 0;
+
+  // Values held by the buffer
+  for (; (i < count) && (bufferPosition + sizeof(result_type) <= buffer.size()); i++)
   {
-    Convert(buffer, returnValue);
+    Convert(&buffer[bufferPosition], values[i]);
+    bufferPosition += sizeof(result_type);
   }
-  catch (runtime_error e)
+
+  // Requests larger than the buffer are read directly and converted in place
+  if ((count - i) * sizeof(result_type) >= buffer.size())
   {
-    stringstream msg;
-    msg << "Quantis_C++11::operator()(): Could not convert the result of the Quantis read. "
-        << e.what();
-    throw runtime_error(msg.str());
+    unsigned char *bytes = reinterpret_cast<unsigned char *>(&values[i]);
+    size_t size = (count - i) * sizeof(result_type);
+
+    for (size_t offset = 0; offset < size; offset += QUANTIS_MAX_READ_SIZE)
+    {
+      size_t chunkSize = (size - offset < QUANTIS_MAX_READ_SIZE) ? (size - offset) : QUANTIS_MAX_READ_SIZE;
+      try
+      {
+        quantis->Read(&bytes[offset], chunkSize);
+      }
+      catch (const runtime_error &e)
+      {
+        stringstream msg;
+        msg << "Quantis_C++11::generate(): Could not perform a Quantis read. "
+            << e.what();
+        throw runtime_error(msg.str());
+      }
+    }
+
+    for (; i < count; i++)
+    {
+      unsigned char in[sizeof(result_type)];
+      memcpy(in, &values[i], sizeof(in));
+      Convert(in, values[i]);
+    }
   }
-  catch (...)
+
+  // Remaining values
+  for (; i < count; i++)
   {
-    stringstream msg;
-    msg << "Quantis_C++11::operator()(): Could not convert the result of the Quantis read. "
-        << "Exception of unknown type.";
-    throw runtime_error(msg.str());
+    values[i] = (*this)();
   }
-  return static_cast<result_type>(returnValue);
 }
 
 double idQ::random_device::entropy() const NOEXCEPT
@@ -24,6 +24,9 @@
  * to be deleted. We have therefore included a destructor function that is not present in the
  * standard and should be used to free the memory allocated to the Quantis object.
  *
+ * Random data is read from the device by blocks (4096 bytes by default, see the
+ * "buf" option of the constructor) and the results are served from memory.
+ *
  * The function "entropy" will be implemented in future releases.
  *
  */
@@ -33,6 +36,7 @@
 #include "Quantis.hpp"
 #include <vector>
 #include <limits.h>
+#include <stddef.h>
 
 #ifdef _WIN32
 //so far, the C++11 features we need do not exist in
@@ -71,10 +75,13 @@ public:
     * Constructor of the random_device class. Takes as input a string telling it
     * which device type and device number is desired. E.g. to access the Quantis USB device
     * with number 0, give it as input the string "u0".
-   * @param token Contains the encoded device type and number
+    * Options may follow a colon, separated by commas. The only option is "buf", the
+    * size in bytes of the blocks read from the device (rounded down to a multiple of
+    * sizeof(result_type), 4 reads the device for each result). E.g. "p0:buf=65536".
+   * @param token Contains the encoded device type and number, and the options
    * @throw runtime_error
     */
-  explicit random_device(const std::string &token = "") throw(std::runtime_error);
+  explicit random_device(const std::string &token = "");
 
   /**
     * Deconstructor function not in the C++11 standard.
@@ -103,9 +110,37 @@ public:
     * Returns the next random number from the underlying Quantis.
     * @param runtime_error
     */
-  result_type operator()() throw(std::runtime_error);
+  result_type operator()();
+
+  /**
+    * Function not in the C++11 standard.
+    * Fills the range [first, last) with random numbers, as std::seed_seq::generate
+    * does: can be used wherever a seed sequence is expected.
+    * @param first the beginning of the range to fill.
+    * @param last the end of the range to fill.
+    * @throw runtime_error
+    */
+  template <class RandomAccessIterator>
+  void generate(RandomAccessIterator first, RandomAccessIterator last);
 
 private:
+  /**
+    * Default size (in bytes) of the blocks read from the device.
+    */
+  static const size_t DEFAULT_BUFFER_SIZE = 4096;
+
+  /**
+    * Size (in bytes) of the chunks filled by generate(), larger than the default
+    * buffer so that Fill() reads them directly into the range.
+    */
+  static const size_t GENERATE_CHUNK_SIZE = 64 * 1024;
+
+  /**
+    * Random data read from the device and not returned yet, starting at bufferPosition.
+    */
+  std::vector<unsigned char> buffer;
+  size_t bufferPosition;
+
   /**
     * A pointer to the Quantis device.
     */
@@ -120,6 +155,23 @@ private:
     */
   void Convert(const unsigned char *in, unsigned int &out);
 
+  /**
+    * Internal function not in the C++11 standard.
+    * Reads a new block of random data into the buffer.
+    * @throw runtime_error
+    */
+  void Refill();
+
+  /**
+    * Internal function not in the C++11 standard.
+    * Fills an array with random numbers. Values held by the buffer are used first,
+    * large requests are then read directly into the array.
+    * @param values the array to fill.
+    * @param count the number of values to fill.
+    * @throw runtime_error
+    */
+  void Fill(result_type *values, size_t count);
+
   /**
       * Internal function not in the C++11 standard.
       * Convert a string to a non-string type.
@@ -143,11 +195,37 @@ private:
   /**
      * Copy constructors are explicitly disallowed in C++11
      */
-#ifdef CXX_11_SUPPORTED
+#ifdef CXX11_SUPPORTED
   random_device(const random_device &) = delete;
   void operator=(const random_device &) = delete;
 #endif
 };
+
+template <class RandomAccessIterator>
+void random_device::generate(RandomAccessIterator first, RandomAccessIterator last)
+{
+  size_t chunkCount = GENERATE_CHUNK_SIZE / sizeof(result_type);
+  if (chunkCount > static_cast<size_t>(last - first))
+  {
+    chunkCount = static_cast<size_t>(last - first);
+  }
+  std::vector<result_type> values(chunkCount);
+
+  while (first != last)
+  {
+    size_t count = static_cast<size_t>(last - first);
+    if (count > chunkCount)
+    {
+      count = chunkCount;
+    }
+
+    Fill(&values[0], count);
+    for (size_t i = 0; i < count; ++i, ++first)
+    {
+      *first = values[i];
+    }
+  }
+}
 } // namespace idQ
 
 #endif //QUANTIS_RANDOM_DEVICE
@@ -0,0 +1,171 @@
+/*
+ * Quantis aggregate device benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Compares reads from a single device with reads from the aggregate device
+ * striping them over several devices, using the hardware-less library.
+ * Set QUANTIS_NOHW_RATE=modules to simulate the data rate of the devices.
+ *
+ * Usage: QuantisAggregateBench [number of devices] [size in MiB] [read size in bytes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Quantis/Quantis.h"
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int Bench(const char *name,
+                 QuantisDeviceType deviceType,
+                 unsigned char *buffer,
+                 size_t totalSize,
+                 size_t readSize)
+{
+  QuantisDeviceHandle *deviceHandle = NULL;
+  size_t readBytes = 0u;
+  double start;
+  double elapsed;
+  int result;
+
+  result = QuantisOpen(deviceType, 0, &deviceHandle);
+  if (result < 0)
+  {
+    fprintf(stderr, "QuantisOpen failed: %s\n", QuantisStrError(result));
+    return result;
+  }
+
+  start = GetTime();
+  while (readBytes < totalSize)
+  {
+    result = QuantisReadHandled(deviceHandle, buffer, readSize);
+    if (result < 0)
+    {
+      fprintf(stderr, "QuantisReadHandled failed: %s\n", QuantisStrError(result));
+      QuantisClose(deviceHandle);
+      return result;
+    }
+    readBytes += (size_t)result;
+  }
+  elapsed = GetTime() - start;
+
+  printf("%-10s: %10.2f MB/s\n", name, (double)readBytes / elapsed / 1e6);
+
+  QuantisClose(deviceHandle);
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  char devices[256];
+  size_t length = 0u;
+  unsigned long devicesCount = 4ul;
+  size_t totalSize = 64u * 1024u * 1024u;
+  size_t readSize = 1024u * 1024u;
+  unsigned char *buffer;
+  unsigned long i;
+  int result;
+
+  if (argc > 1)
+  {
+    devicesCount = strtoul(argv[1], NULL, 10);
+  }
+  if (argc > 2)
+  {
+    totalSize = (size_t)strtoul(argv[2], NULL, 10) * 1024u * 1024u;
+  }
+  if (argc > 3)
+  {
+    readSize = (size_t)strtoul(argv[3], NULL, 10);
+  }
+  if ((devicesCount == 0ul) || (devicesCount > 16ul) || (totalSize == 0u) ||
+      (readSize == 0u) || (readSize > QUANTIS_MAX_READ_SIZE))
+  {
+    fprintf(stderr, "Usage: %s [number of devices (<= 16)] [size in MiB] [read size in bytes]\n", argv[0]);
+    return 1;
+  }
+
+  /* Aggregate of simulated PCI devices */
+  for (i = 0ul; i < devicesCount; i++)
+  {
+    length += (size_t)snprintf(devices + length, sizeof(devices) - length,
+                               (i == 0ul) ? "pci:%lu" : ",pci:%lu", i);
+  }
+  setenv("QUANTIS_AGGREGATE_DEVICES", devices, 1);
+
+  buffer = (unsigned char *)malloc(readSize);
+  if (!buffer)
+  {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+
+  printf("Reading %lu MiB by blocks of %lu bytes, aggregate of %lu devices\n",
+         (unsigned long)(totalSize / (1024u * 1024u)),
+         (unsigned long)readSize,
+         devicesCount);
+
+  result = Bench("device", QUANTIS_DEVICE_PCI, buffer, totalSize, readSize);
+  if (result == 0)
+  {
+    result = Bench("aggregate", QUANTIS_DEVICE_AGGREGATE, buffer, totalSize, readSize);
+  }
+
+  free(buffer);
+
+  return (result == 0) ? 0 : 1;
+}
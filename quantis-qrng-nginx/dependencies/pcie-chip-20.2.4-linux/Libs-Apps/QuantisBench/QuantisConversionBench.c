@@ -0,0 +1,280 @@
+/*
+ * Quantis conversion kernels benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Checks that every conversion kernel supported by the CPU produces the
+ * same output as the scalar reference kernel, then measures their
+ * throughput on hexadecimal encoding and decoding and on the conversion of
+ * random words to doubles and floats between 0.0 and 1.0.
+ *
+ * Usage: QuantisConversionBench [size in bytes] [repetitions]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Quantis/Conversion.h"
+#include "Quantis/Conversion_Kernels.h"
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t NextRandom(uint64_t *state)
+{
+  /* xorshift64* */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 0x2545F4914F6CDD1DULL;
+}
+
+typedef enum
+{
+  BENCH_TO_HEXA = 0,
+  BENCH_FROM_HEXA = 1,
+  BENCH_TO_DOUBLES = 2,
+  BENCH_TO_FLOATS = 3
+} BenchConversion;
+
+#define BENCH_CONVERSIONS_COUNT 4
+
+static const char *benchConversionNames[BENCH_CONVERSIONS_COUNT] = {
+    "to hexa",
+    "from hexa",
+    "to doubles",
+    "to floats"};
+
+/**
+ * Runs a conversion of <em>size</em> random bytes.
+ * @return the size (in bytes) of the output.
+ */
+static size_t Run(BenchConversion conversion,
+                  ConversionKernel kernel,
+                  const unsigned char *data,
+                  const char *hexa,
+                  void *output,
+                  size_t size)
+{
+  switch (conversion)
+  {
+  case BENCH_TO_HEXA:
+    ConversionKernelByteArrayToHexa(kernel, (char *)output, data, size);
+    return 2u * size + 1u;
+
+  case BENCH_FROM_HEXA:
+    ConversionKernelHexaToByteArray(kernel, (unsigned char *)output, hexa, size);
+    return size;
+
+  case BENCH_TO_DOUBLES:
+    ConversionKernelToDoubleArray_01(kernel, (double *)output, (const char *)data, size / sizeof(double));
+    return (size / sizeof(double)) * sizeof(double);
+
+  default:
+    ConversionKernelToFloatArray_01(kernel, (float *)output, (const char *)data, size / sizeof(float));
+    return (size / sizeof(float)) * sizeof(float);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  size_t size = 1024u * 1024u;
+  unsigned long repetitions = 100ul;
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  unsigned char *data;
+  char *hexa;
+  unsigned char *expected;
+  unsigned char *output;
+  size_t outputSize;
+  size_t i;
+  unsigned long r;
+  int conversion;
+  int kernel;
+  int failures = 0;
+
+  if (argc > 1)
+  {
+    size = (size_t)strtoul(argv[1], NULL, 10);
+  }
+  if (argc > 2)
+  {
+    repetitions = strtoul(argv[2], NULL, 10);
+  }
+  if ((size == 0u) || (repetitions == 0ul))
+  {
+    fprintf(stderr, "Usage: %s [size in bytes] [repetitions]\n", argv[0]);
+    return 1;
+  }
+
+  data = (unsigned char *)malloc(size);
+  hexa = (char *)malloc(2u * size + 1u);
+  expected = (unsigned char *)malloc(2u * size + 1u);
+  output = (unsigned char *)malloc(2u * size + 1u);
+  if (!data || !hexa || !expected || !output)
+  {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+  for (i = 0u; i < size; i++)
+  {
+    data[i] = (unsigned char)NextRandom(&state);
+  }
+  /* Corner cases: all zeros and all ones */
+  if (size >= 16u)
+  {
+    memset(data, 0, 8u);
+    memset(data + 8u, 0xFF, 8u);
+  }
+  ConversionKernelByteArrayToHexa(CONVERSION_KERNEL_SCALAR, hexa, data, size);
+  /* Characters which are not lowercase digits are read as 0 */
+  if (size >= 8u)
+  {
+    memcpy(hexa, "AF:g/\xA0" "9a", 8u);
+  }
+
+  printf("Conversions of %lu bytes, %lu repetitions (default kernels: hexa %s, doubles %s, floats %s)\n",
+         (unsigned long)size, repetitions,
+         ConversionKernelGetName(ConversionKernelGetDefault(CONVERSION_OPERATION_HEXA)),
+         ConversionKernelGetName(ConversionKernelGetDefault(CONVERSION_OPERATION_DOUBLE)),
+         ConversionKernelGetName(ConversionKernelGetDefault(CONVERSION_OPERATION_FLOAT)));
+  printf("%12s %10s %8s %12s\n", "conversion", "kernel", "check", "MB/s data");
+
+  for (conversion = 0; conversion < BENCH_CONVERSIONS_COUNT; conversion++)
+  {
+    outputSize = Run((BenchConversion)conversion, CONVERSION_KERNEL_SCALAR, data, hexa, expected, size);
+
+    for (kernel = 0; kernel < CONVERSION_KERNELS_COUNT; kernel++)
+    {
+      const char *check = "ok";
+      double start;
+      double elapsed;
+
+      if (!ConversionKernelIsSupported((ConversionKernel)kernel))
+      {
+        printf("%12s %10s %8s\n", benchConversionNames[conversion],
+               ConversionKernelGetName((ConversionKernel)kernel), "n/a");
+        continue;
+      }
+
+      memset(output, 0xA5, 2u * size + 1u);
+
+      start = GetTime();
+      for (r = 0ul; r < repetitions; r++)
+      {
+        Run((BenchConversion)conversion, (ConversionKernel)kernel, data, hexa, output, size);
+      }
+      elapsed = GetTime() - start;
+
+      if (memcmp(output, expected, outputSize) != 0)
+      {
+        check = "FAILED";
+        failures++;
+      }
+
+      printf("%12s %10s %8s %12.1f\n",
+             benchConversionNames[conversion],
+             ConversionKernelGetName((ConversionKernel)kernel),
+             check,
+             (double)size * (double)repetitions / elapsed / 1e6);
+    }
+  }
+
+  /* In place conversions */
+  for (kernel = 0; kernel < CONVERSION_KERNELS_COUNT; kernel++)
+  {
+    if (!ConversionKernelIsSupported((ConversionKernel)kernel))
+    {
+      continue;
+    }
+
+    outputSize = Run(BENCH_TO_DOUBLES, CONVERSION_KERNEL_SCALAR, data, hexa, expected, size);
+    memcpy(output, data, size);
+    ConversionKernelToDoubleArray_01((ConversionKernel)kernel, (double *)output, (const char *)output, size / sizeof(double));
+    if (memcmp(output, expected, outputSize) != 0)
+    {
+      printf("%12s %10s %8s\n", "in place", ConversionKernelGetName((ConversionKernel)kernel), "FAILED");
+      failures++;
+    }
+  }
+
+  /* Single value conversions, same values as the arrays */
+  ConvertToDoubleArray_01((double *)expected, (const char *)data, size / sizeof(double));
+  for (r = 0ul; r < size / sizeof(double); r++)
+  {
+    if (ConvertToDouble_01((const char *)data + (r * sizeof(double))) != ((double *)expected)[r])
+    {
+      printf("%12s %10s %8s\n", "to double", "single", "FAILED");
+      failures++;
+      break;
+    }
+  }
+  ConvertToFloatArray_01((float *)expected, (const char *)data, size / sizeof(float));
+  for (r = 0ul; r < size / sizeof(float); r++)
+  {
+    if (ConvertToFloat_01((const char *)data + (r * sizeof(float))) != ((float *)expected)[r])
+    {
+      printf("%12s %10s %8s\n", "to float", "single", "FAILED");
+      failures++;
+      break;
+    }
+  }
+
+  free(output);
+  free(expected);
+  free(hexa);
+  free(data);
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+/*
+ * Quantis extractor kernels benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Checks that every extractor kernel supported by the CPU produces the same
+ * output as the scalar reference kernel, then measures their throughput.
+ *
+ * Usage: QuantisExtractorBench [matrix file] [n] [k] [number of blocks]
+ * Without matrix file (or with "-"), a pseudo-random matrix is used.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Quantis/Quantis.h"
+#include "QuantisExtensions/QuantisExtractor.h"
+#include "QuantisExtensions/QuantisExtractor_Kernels.h"
+
+/* Number of blocks compared with the scalar kernel */
+#define CHECKED_BLOCKS 1000u
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t NextRandom(uint64_t *state)
+{
+  /* xorshift64* */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 0x2545F4914F6CDD1DULL;
+}
+
+int main(int argc, char *argv[])
+{
+  const char *matrixFilename = NULL;
+  uint16_t n = 1024u;
+  uint16_t k = 768u;
+  unsigned long blocks = 100000ul;
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  uint64_t *matrix = NULL;
+  uint64_t *input;
+  uint64_t *expected;
+  uint64_t *output;
+  QuantisExtractorTables *tables = NULL;
+  size_t inputWords;
+  size_t outputWords;
+  unsigned long b;
+  size_t i;
+  int kernel;
+  int failures = 0;
+  int32_t result;
+
+  if ((argc > 1) && (strcmp(argv[1], "-") != 0))
+  {
+    matrixFilename = argv[1];
+  }
+  if (argc > 2)
+  {
+    n = (uint16_t)strtoul(argv[2], NULL, 10);
+  }
+  if (argc > 3)
+  {
+    k = (uint16_t)strtoul(argv[3], NULL, 10);
+  }
+  if (argc > 4)
+  {
+    blocks = strtoul(argv[4], NULL, 10);
+  }
+  if ((n == 0u) || (k == 0u) || (n % 64u) || (k % 64u) || (blocks < CHECKED_BLOCKS))
+  {
+    fprintf(stderr, "Usage: %s [matrix file] [n] [k] [number of blocks (>= %u)]\n", argv[0], CHECKED_BLOCKS);
+    return 1;
+  }
+  inputWords = n / 64u;
+  outputWords = k / 64u;
+
+  if (matrixFilename)
+  {
+    result = QuantisExtractorInitializeMatrix(matrixFilename, &matrix, n, k);
+    if (result != QUANTIS_SUCCESS)
+    {
+      fprintf(stderr, "QuantisExtractorInitializeMatrix failed: %d\n", result);
+      return 1;
+    }
+  }
+  else
+  {
+    matrix = (uint64_t *)malloc(inputWords * k * sizeof(uint64_t));
+    if (!matrix)
+    {
+      fprintf(stderr, "Not enough memory\n");
+      return 1;
+    }
+    for (i = 0u; i < inputWords * k; i++)
+    {
+      matrix[i] = NextRandom(&state);
+    }
+  }
+
+  result = QuantisExtractorTablesCreate(matrix, n, k, &tables);
+  if (result != QUANTIS_SUCCESS)
+  {
+    fprintf(stderr, "QuantisExtractorTablesCreate failed: %d\n", result);
+    return 1;
+  }
+
+  input = (uint64_t *)malloc(blocks * inputWords * sizeof(uint64_t));
+  expected = (uint64_t *)malloc(CHECKED_BLOCKS * outputWords * sizeof(uint64_t));
+  output = (uint64_t *)malloc(blocks * outputWords * sizeof(uint64_t));
+  if (!input || !expected || !output)
+  {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+  for (i = 0u; i < blocks * inputWords; i++)
+  {
+    input[i] = NextRandom(&state);
+  }
+  /* Corner cases: all zeros and all ones */
+  memset(&input[0], 0, inputWords * sizeof(uint64_t));
+  memset(&input[inputWords], 0xFF, inputWords * sizeof(uint64_t));
+
+  for (b = 0ul; b < CHECKED_BLOCKS; b++)
+  {
+    QuantisExtractorKernelScalar(&input[b * inputWords], &expected[b * outputWords], matrix, n, k);
+  }
+
+  printf("Extractor %u x %u, %lu blocks (default kernel: %s)\n",
+         (unsigned int)n, (unsigned int)k, blocks,
+         QuantisExtractorKernelGetName(QuantisExtractorKernelGetDefault()));
+  printf("%10s %8s %12s %12s\n", "kernel", "check", "ns/block", "MB/s out");
+
+  for (kernel = 0; kernel < QUANTIS_EXTRACTOR_KERNELS_COUNT; kernel++)
+  {
+    const char *check = "ok";
+    double start;
+    double elapsed;
+
+    if (!QuantisExtractorKernelIsSupported((QuantisExtractorKernel)kernel))
+    {
+      printf("%10s %8s\n", QuantisExtractorKernelGetName((QuantisExtractorKernel)kernel), "n/a");
+      continue;
+    }
+
+    memset(output, 0xA5, blocks * outputWords * sizeof(uint64_t));
+
+    start = GetTime();
+    for (b = 0ul; b < blocks; b++)
+    {
+      QuantisExtractorKernelRun((QuantisExtractorKernel)kernel,
+                                tables,
+                                &input[b * inputWords],
+                                &output[b * outputWords]);
+    }
+    elapsed = GetTime() - start;
+
+    if (memcmp(output, expected, CHECKED_BLOCKS * outputWords * sizeof(uint64_t)) != 0)
+    {
+      check = "FAILED";
+      failures++;
+    }
+
+    printf("%10s %8s %12.1f %12.2f\n",
+           QuantisExtractorKernelGetName((QuantisExtractorKernel)kernel),
+           check,
+           elapsed * 1e9 / (double)blocks,
+           (double)(blocks * (k / 8u)) / elapsed / 1e6);
+  }
+
+  free(output);
+  free(expected);
+  free(input);
+  QuantisExtractorTablesFree(tables);
+  if (matrixFilename)
+  {
+    QuantisExtractorUninitializeMatrix(&matrix);
+  }
+  else
+  {
+    free(matrix);
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+/*
+ * Quantis extractor device read benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Measures QuantisExtractorCtxGetDataFromQuantis against the hardware-less
+ * library, compared with the former way of reading the device (one read of
+ * the whole input, discarded, then reads of 4096 bytes into freshly
+ * allocated buffers).
+ *
+ * Usage: QuantisExtractorDeviceBench [total size in MiB]
+ * A pseudo-random 1024 x 768 matrix is used.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Quantis/Quantis.h"
+#include "QuantisExtensions/QuantisExtractor.h"
+
+#define MATRIX_SIZE_IN 1024u
+#define MATRIX_SIZE_OUT 768u
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t NextRandom(uint64_t *state)
+{
+  /* xorshift64* */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/* Writes a pseudo-random matrix to a temporary file */
+static int CreateMatrixFile(char *filename)
+{
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  uint64_t row[MATRIX_SIZE_IN / 64u];
+  FILE *file;
+  unsigned int i;
+  unsigned int j;
+  int fd = mkstemp(filename);
+
+  if (fd < 0)
+  {
+    return -1;
+  }
+  file = fdopen(fd, "wb");
+  if (!file)
+  {
+    close(fd);
+    return -1;
+  }
+  for (i = 0u; i < MATRIX_SIZE_OUT; i++)
+  {
+    for (j = 0u; j < MATRIX_SIZE_IN / 64u; j++)
+    {
+      row[j] = NextRandom(&state);
+    }
+    fwrite(row, sizeof(row), 1, file);
+  }
+  fclose(file);
+
+  return 0;
+}
+
+/* Former read pattern of QuantisExtractorGetDataFromQuantis (without storage buffer) */
+static int32_t FormerGetDataFromQuantis(QuantisExtractorCtx *ctx,
+                                        uint8_t *outputBuffer,
+                                        uint32_t numberOfBytesRequested)
+{
+  uint32_t numberOfBytesAfterExtraction;
+  uint32_t numberOfBytesBeforeExtraction;
+  uint8_t *inputBufferExtractor;
+  uint8_t *outputBufferExtractor;
+  uint32_t chunkSize = 4096u;
+  uint32_t offset;
+  int32_t result;
+
+  result = QuantisExtractorCtxComputeBufferSize(ctx,
+                                                numberOfBytesRequested,
+                                                &numberOfBytesAfterExtraction,
+                                                &numberOfBytesBeforeExtraction);
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  inputBufferExtractor = (uint8_t *)malloc(numberOfBytesBeforeExtraction);
+  outputBufferExtractor = (uint8_t *)malloc(numberOfBytesAfterExtraction);
+  if (!inputBufferExtractor || !outputBufferExtractor)
+  {
+    free(inputBufferExtractor);
+    free(outputBufferExtractor);
+    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+  }
+
+  result = QuantisRead(QUANTIS_DEVICE_PCI, 0, inputBufferExtractor, numberOfBytesBeforeExtraction);
+  for (offset = 0u; (result >= 0) && (offset < numberOfBytesBeforeExtraction); offset += chunkSize)
+  {
+    if (numberOfBytesBeforeExtraction - offset < chunkSize)
+    {
+      chunkSize = numberOfBytesBeforeExtraction - offset;
+    }
+    result = QuantisRead(QUANTIS_DEVICE_PCI, 0, &inputBufferExtractor[offset], chunkSize);
+  }
+
+  if (result >= 0)
+  {
+    QuantisExtractorCtxGetDataFromBuffer(ctx, inputBufferExtractor, outputBufferExtractor, numberOfBytesAfterExtraction);
+    memcpy(outputBuffer, outputBufferExtractor, numberOfBytesRequested);
+    result = (int32_t)numberOfBytesRequested;
+  }
+
+  free(inputBufferExtractor);
+  free(outputBufferExtractor);
+
+  return result;
+}
+
+int main(int argc, char *argv[])
+{
+  const uint32_t requestSizes[] = {96u, 4096u, 65536u, 1024u * 1024u};
+  char matrixFilename[] = "/tmp/QuantisExtractorMatrixXXXXXX";
+  QuantisExtractorCtx *ctx = NULL;
+  size_t totalSize = 32u * 1024u * 1024u;
+  uint8_t *buffer;
+  unsigned int i;
+  int32_t result;
+
+  if (argc > 1)
+  {
+    totalSize = (size_t)strtoul(argv[1], NULL, 10) * 1024u * 1024u;
+  }
+  if (totalSize == 0u)
+  {
+    fprintf(stderr, "Usage: %s [total size in MiB]\n", argv[0]);
+    return 1;
+  }
+
+  if (CreateMatrixFile(matrixFilename) < 0)
+  {
+    fprintf(stderr, "Unable to create the matrix file\n");
+    return 1;
+  }
+  result = QuantisExtractorCtxCreate(matrixFilename, MATRIX_SIZE_IN, MATRIX_SIZE_OUT, &ctx);
+  unlink(matrixFilename);
+  if (result != QUANTIS_SUCCESS)
+  {
+    fprintf(stderr, "QuantisExtractorCtxCreate failed: %s\n", QuantisExtractorStrError(result));
+    return 1;
+  }
+
+  buffer = (uint8_t *)malloc(requestSizes[sizeof(requestSizes) / sizeof(requestSizes[0]) - 1u]);
+  if (!buffer)
+  {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+
+  printf("Extracting %lu MiB from the hardware-less device\n", (unsigned long)(totalSize / (1024u * 1024u)));
+  printf("%12s %14s %14s %9s\n", "request size", "former MB/s", "current MB/s", "gain");
+
+  for (i = 0u; i < sizeof(requestSizes) / sizeof(requestSizes[0]); i++)
+  {
+    size_t requests = totalSize / requestSizes[i];
+    double rates[2];
+    int pass;
+    size_t r;
+
+    for (pass = 0; pass < 2; pass++)
+    {
+      double start = GetTime();
+      for (r = 0u; r < requests; r++)
+      {
+        result = (pass == 0) ? FormerGetDataFromQuantis(ctx, buffer, requestSizes[i])
+                             : QuantisExtractorCtxGetDataFromQuantis(ctx, QUANTIS_DEVICE_PCI, 0, buffer, requestSizes[i]);
+        if (result < 0)
+        {
+          fprintf(stderr, "Extraction failed: %s\n", QuantisExtractorStrError(result));
+          return 1;
+        }
+      }
+      rates[pass] = (double)(requests * requestSizes[i]) / (GetTime() - start) / 1e6;
+    }
+
+    printf("%12u %14.2f %14.2f %8.2fx\n", requestSizes[i], rates[0], rates[1], rates[1] / rates[0]);
+  }
+
+  free(buffer);
+  QuantisExtractorCtxDestroy(ctx);
+
+  return 0;
+}
@@ -0,0 +1,222 @@
+/*
+ * Quantis parallel extraction benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Measures the scaling of the parallel extraction with the number of
+ * threads, and checks that the output does not depend on it.
+ *
+ * Usage: QuantisExtractorScalingBench [input size in MiB] [max threads]
+ * A pseudo-random 1024 x 768 matrix is used.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Quantis/Quantis.h"
+#include "QuantisExtensions/QuantisExtractor.h"
+
+#define MATRIX_SIZE_IN 1024u
+#define MATRIX_SIZE_OUT 768u
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t NextRandom(uint64_t *state)
+{
+  /* xorshift64* */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/* Writes a pseudo-random matrix to a temporary file */
+static int CreateMatrixFile(char *filename, uint64_t *state)
+{
+  uint64_t row[MATRIX_SIZE_IN / 64u];
+  FILE *file;
+  unsigned int i;
+  unsigned int j;
+  int fd = mkstemp(filename);
+
+  if (fd < 0)
+  {
+    return -1;
+  }
+  file = fdopen(fd, "wb");
+  if (!file)
+  {
+    close(fd);
+    return -1;
+  }
+  for (i = 0u; i < MATRIX_SIZE_OUT; i++)
+  {
+    for (j = 0u; j < MATRIX_SIZE_IN / 64u; j++)
+    {
+      row[j] = NextRandom(state);
+    }
+    fwrite(row, sizeof(row), 1, file);
+  }
+  fclose(file);
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  char matrixFilename[] = "/tmp/QuantisExtractorMatrixXXXXXX";
+  QuantisExtractorCtx *ctx = NULL;
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  uint32_t inputSize = 256u * 1024u * 1024u;
+  uint32_t outputSize;
+  uint32_t maxThreads = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t threads;
+  uint8_t *input;
+  uint8_t *reference;
+  uint8_t *output;
+  double referenceRate = 0.0;
+  uint32_t i;
+  int failures = 0;
+  int32_t result;
+
+  if (argc > 1)
+  {
+    inputSize = (uint32_t)strtoul(argv[1], NULL, 10) * 1024u * 1024u;
+  }
+  if (argc > 2)
+  {
+    maxThreads = (uint32_t)strtoul(argv[2], NULL, 10);
+  }
+  if ((inputSize == 0u) || (inputSize > 3072u * 1024u * 1024u) || (maxThreads == 0u) || (maxThreads > 64u))
+  {
+    fprintf(stderr, "Usage: %s [input size in MiB (<= 3072)] [max threads (<= 64)]\n", argv[0]);
+    return 1;
+  }
+
+  if (CreateMatrixFile(matrixFilename, &state) < 0)
+  {
+    fprintf(stderr, "Unable to create the matrix file\n");
+    return 1;
+  }
+  result = QuantisExtractorCtxCreate(matrixFilename, MATRIX_SIZE_IN, MATRIX_SIZE_OUT, &ctx);
+  unlink(matrixFilename);
+  if (result != QUANTIS_SUCCESS)
+  {
+    fprintf(stderr, "QuantisExtractorCtxCreate failed: %s\n", QuantisExtractorStrError(result));
+    return 1;
+  }
+
+  input = (uint8_t *)malloc(inputSize);
+  result = QuantisExtractorCtxInitializeOutputBuffer(ctx, inputSize, &reference);
+  output = (uint8_t *)malloc(result > 0 ? (size_t)result : 1u);
+  if (!input || (result < 0) || !output)
+  {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+  outputSize = (uint32_t)result;
+  for (i = 0u; i < inputSize / 8u; i++)
+  {
+    ((uint64_t *)input)[i] = NextRandom(&state);
+  }
+
+  printf("Extracting %u MiB (%u processors online)\n",
+         inputSize / (1024u * 1024u), (unsigned int)sysconf(_SC_NPROCESSORS_ONLN));
+  printf("%8s %8s %12s %12s %10s\n", "threads", "check", "GB/s in", "GB/s out", "speedup");
+
+  for (threads = 1u; threads <= maxThreads; threads = (threads < maxThreads && threads * 2u > maxThreads) ? maxThreads : threads * 2u)
+  {
+    uint8_t *destination = (threads == 1u) ? reference : output;
+    const char *check = "ok";
+    double start;
+    double elapsed;
+    double rate;
+
+    QuantisExtractorCtxSetThreads(ctx, threads);
+    memset(destination, 0, outputSize);
+
+    start = GetTime();
+    QuantisExtractorCtxGetDataFromBuffer(ctx, input, destination, outputSize);
+    elapsed = GetTime() - start;
+
+    if ((threads > 1u) && (memcmp(reference, output, outputSize) != 0))
+    {
+      check = "FAILED";
+      failures++;
+    }
+
+    rate = (double)inputSize / elapsed / 1e9;
+    if (threads == 1u)
+    {
+      referenceRate = rate;
+    }
+    printf("%8u %8s %12.3f %12.3f %9.2fx\n",
+           threads, check, rate, (double)outputSize / elapsed / 1e9, rate / referenceRate);
+
+    if (threads == maxThreads)
+    {
+      break;
+    }
+  }
+
+  free(output);
+  QuantisExtractorUnitializeOutputBuffer(&reference);
+  free(input);
+  QuantisExtractorCtxDestroy(ctx);
+
+  return (failures == 0) ? 0 : 1;
+}
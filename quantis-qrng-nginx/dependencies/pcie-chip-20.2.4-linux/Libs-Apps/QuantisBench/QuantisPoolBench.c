@@ -0,0 +1,239 @@
+/*
+ * Quantis random data pool benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Compares small reads served by the device with small reads served by a
+ * QuantisPool, using the hardware-less library.
+ *
+ * Usage: QuantisPoolBench [number of reads] [read size in bytes] [consumers]
+ *
+ * The pool is filled before each measurement. As long as the total size read
+ * fits in the pool (QUANTIS_POOL_DEFAULT_CAPACITY), the measurement shows
+ * the cost of the consumers' fast path. Beyond that, it shows the data rate
+ * of the device.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Quantis/Quantis.h"
+#include "Quantis/Quantis_Pool.h"
+
+typedef struct BenchConsumer
+{
+  QuantisPool *pool;
+  unsigned long reads;
+  size_t readSize;
+  int result;
+} BenchConsumer;
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *Consume(void *arg)
+{
+  BenchConsumer *consumer = (BenchConsumer *)arg;
+  unsigned char buffer[4096];
+  unsigned long i;
+
+  consumer->result = 0;
+  for (i = 0ul; i < consumer->reads; i++)
+  {
+    int result = QuantisPoolRead(consumer->pool, buffer, consumer->readSize);
+    if (result < 0)
+    {
+      consumer->result = result;
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * Fills a new pool, then reads it from several threads.
+ * @return the elapsed time in seconds or a negative value on failure.
+ */
+static double RunPool(QuantisDeviceHandle *deviceHandle,
+                      unsigned int consumersCount,
+                      unsigned long readsPerConsumer,
+                      size_t readSize)
+{
+  BenchConsumer consumers[64];
+  pthread_t threads[64];
+  QuantisPool *pool = NULL;
+  struct timespec delay = {0, 1000000L};
+  unsigned int c;
+  double start;
+  double elapsed;
+  int result;
+
+  result = QuantisPoolCreate(deviceHandle, 0u, 0u, 0u, &pool);
+  if (result < 0)
+  {
+    fprintf(stderr, "QuantisPoolCreate failed: %s\n", QuantisStrError(result));
+    return -1.0;
+  }
+
+  while (QuantisPoolAvailable(pool) < QUANTIS_POOL_DEFAULT_CAPACITY)
+  {
+    nanosleep(&delay, NULL);
+  }
+
+  start = GetTime();
+  for (c = 0u; c < consumersCount; c++)
+  {
+    consumers[c].pool = pool;
+    consumers[c].reads = readsPerConsumer;
+    consumers[c].readSize = readSize;
+    pthread_create(&threads[c], NULL, Consume, &consumers[c]);
+  }
+  for (c = 0u; c < consumersCount; c++)
+  {
+    pthread_join(threads[c], NULL);
+  }
+  elapsed = GetTime() - start;
+
+  QuantisPoolDestroy(pool);
+
+  for (c = 0u; c < consumersCount; c++)
+  {
+    if (consumers[c].result < 0)
+    {
+      fprintf(stderr, "QuantisPoolRead failed: %s\n", QuantisStrError(consumers[c].result));
+      return -1.0;
+    }
+  }
+
+  return elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+  QuantisDeviceHandle *deviceHandle = NULL;
+  unsigned char buffer[4096];
+  unsigned long reads = 16384ul;
+  size_t readSize = 32u;
+  unsigned int consumersCount = 4u;
+  unsigned long i;
+  double start;
+  double elapsed;
+  int result;
+
+  if (argc > 1)
+  {
+    reads = strtoul(argv[1], NULL, 10);
+  }
+  if (argc > 2)
+  {
+    readSize = (size_t)strtoul(argv[2], NULL, 10);
+  }
+  if (argc > 3)
+  {
+    consumersCount = (unsigned int)strtoul(argv[3], NULL, 10);
+  }
+  if ((reads == 0ul) || (readSize == 0u) || (readSize > sizeof(buffer)) ||
+      (consumersCount == 0u) || (consumersCount > 64u))
+  {
+    fprintf(stderr, "Usage: %s [number of reads] [read size in bytes (<= 4096)] [consumers (<= 64)]\n", argv[0]);
+    return 1;
+  }
+
+  result = QuantisOpen(QUANTIS_DEVICE_PCI, 0, &deviceHandle);
+  if (result < 0)
+  {
+    fprintf(stderr, "QuantisOpen failed: %s\n", QuantisStrError(result));
+    return 1;
+  }
+
+  /* Reads served by the device */
+  start = GetTime();
+  for (i = 0ul; i < reads; i++)
+  {
+    result = QuantisReadHandled(deviceHandle, buffer, readSize);
+    if (result < 0)
+    {
+      fprintf(stderr, "QuantisReadHandled failed: %s\n", QuantisStrError(result));
+      QuantisClose(deviceHandle);
+      return 1;
+    }
+  }
+  elapsed = GetTime() - start;
+  printf("device         : %10.1f ns/read %10.2f MB/s\n",
+         elapsed * 1e9 / (double)reads, (double)(reads * readSize) / elapsed / 1e6);
+
+  /* Reads served by the pool, single consumer */
+  elapsed = RunPool(deviceHandle, 1u, reads, readSize);
+  if (elapsed >= 0.0)
+  {
+    printf("pool (1 thread): %10.1f ns/read %10.2f MB/s\n",
+           elapsed * 1e9 / (double)reads, (double)(reads * readSize) / elapsed / 1e6);
+  }
+
+  /* Reads served by the pool, several consumers */
+  reads = reads / consumersCount * consumersCount;
+  elapsed = RunPool(deviceHandle, consumersCount, reads / consumersCount, readSize);
+  if (elapsed >= 0.0)
+  {
+    printf("pool (%u threads): %8.1f ns/read %10.2f MB/s\n",
+           consumersCount,
+           elapsed * 1e9 / (double)reads, (double)(reads * readSize) / elapsed / 1e6);
+  }
+
+  QuantisClose(deviceHandle);
+
+  return 0;
+}
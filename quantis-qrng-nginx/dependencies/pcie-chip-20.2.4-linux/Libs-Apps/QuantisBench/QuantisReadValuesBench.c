@@ -0,0 +1,195 @@
+/*
+ * Quantis batched readers benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Compares reading random values one at a time with the stateless API against
+ * filling arrays with the batched readers, using the hardware-less library.
+ *
+ * Usage: QuantisReadValuesBench [number of values]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Quantis/Quantis.h"
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void PrintResult(const char *name, size_t count, double elapsed)
+{
+  printf("%-28s: %10.1f ns/value %12.2f Mvalues/s\n",
+         name, elapsed * 1e9 / (double)count, (double)count / elapsed / 1e6);
+}
+
+int main(int argc, char *argv[])
+{
+  QuantisDeviceHandle *deviceHandle = NULL;
+  size_t count = 1000000u;
+  double *doubles;
+  int *ints;
+  double sum = 0.0;
+  double start;
+  size_t i;
+  int result = 0;
+
+  if (argc > 1)
+  {
+    count = (size_t)strtoul(argv[1], NULL, 10);
+  }
+  if (count == 0u)
+  {
+    fprintf(stderr, "Usage: %s [number of values]\n", argv[0]);
+    return 1;
+  }
+
+  doubles = (double *)malloc(count * sizeof(double));
+  ints = (int *)malloc(count * sizeof(int));
+  if ((doubles == NULL) || (ints == NULL))
+  {
+    fprintf(stderr, "Not enough memory\n");
+    free(doubles);
+    free(ints);
+    return 1;
+  }
+
+  /* One value per call */
+  start = GetTime();
+  for (i = 0u; (i < count) && (result >= 0); i++)
+  {
+    result = QuantisReadDouble_01(QUANTIS_DEVICE_PCI, 0, &doubles[i]);
+  }
+  PrintResult("QuantisReadDouble_01", count, GetTime() - start);
+
+  start = GetTime();
+  for (i = 0u; (i < count) && (result >= 0); i++)
+  {
+    result = QuantisReadScaledDouble(QUANTIS_DEVICE_PCI, 0, &doubles[i], -1.0, 1.0);
+  }
+  PrintResult("QuantisReadScaledDouble", count, GetTime() - start);
+
+  start = GetTime();
+  for (i = 0u; (i < count) && (result >= 0); i++)
+  {
+    result = QuantisReadInt(QUANTIS_DEVICE_PCI, 0, &ints[i]);
+  }
+  PrintResult("QuantisReadInt", count, GetTime() - start);
+
+  start = GetTime();
+  for (i = 0u; (i < count) && (result >= 0); i++)
+  {
+    result = QuantisReadScaledInt(QUANTIS_DEVICE_PCI, 0, &ints[i], 1, 6);
+  }
+  PrintResult("QuantisReadScaledInt", count, GetTime() - start);
+
+  QuantisCloseCachedHandles();
+
+  /* Arrays */
+  if (result >= 0)
+  {
+    result = QuantisOpen(QUANTIS_DEVICE_PCI, 0, &deviceHandle);
+  }
+
+  if (result >= 0)
+  {
+    start = GetTime();
+    result = QuantisReadDoubles_01(deviceHandle, doubles, count);
+    PrintResult("QuantisReadDoubles_01", count, GetTime() - start);
+  }
+
+  if (result >= 0)
+  {
+    start = GetTime();
+    result = QuantisReadScaledDoubles(deviceHandle, doubles, count, -1.0, 1.0);
+    PrintResult("QuantisReadScaledDoubles", count, GetTime() - start);
+  }
+
+  if (result >= 0)
+  {
+    start = GetTime();
+    result = QuantisReadInts(deviceHandle, ints, count);
+    PrintResult("QuantisReadInts", count, GetTime() - start);
+  }
+
+  if (result >= 0)
+  {
+    start = GetTime();
+    result = QuantisReadScaledInts(deviceHandle, ints, count, 1, 6);
+    PrintResult("QuantisReadScaledInts", count, GetTime() - start);
+  }
+
+  if (result < 0)
+  {
+    fprintf(stderr, "Read failed: %s\n", QuantisStrError(result));
+  }
+  else
+  {
+    /* Sanity check: the mean of uniform values in [-1, 1) is close to 0 */
+    for (i = 0u; i < count; i++)
+    {
+      sum += doubles[i];
+    }
+    printf("mean of the scaled doubles  : %f\n", sum / (double)count);
+  }
+
+  if (deviceHandle != NULL)
+  {
+    QuantisClose(deviceHandle);
+  }
+  free(doubles);
+  free(ints);
+
+  return (result < 0) ? 1 : 0;
+}
@@ -0,0 +1,312 @@
+/*
+ * Quantis USB libusb mock
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Mock of the libusb-1.0 asynchronous transfer API, used to benchmark the
+ * USB stream without a Quantis USB device.
+ *
+ * The simulated device serves bulk transfers one after the other at a
+ * constant data rate, and each transfer has a fixed round-trip latency
+ * (time between submission and the earliest possible completion). With a
+ * single transfer in flight the throughput is therefore
+ * size / (latency + size / rate), while a deep enough queue hides the
+ * latency and reaches the data rate.
+ *
+ * Environment variables:
+ *   QUANTIS_USB_MOCK_RATE     data rate in bytes per second (default 40 MB/s)
+ *   QUANTIS_USB_MOCK_LATENCY  round-trip latency in microseconds (default 500)
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#ifdef __FreeBSD__
+#include <libusb.h>
+#else
+#include <libusb-1.0/libusb.h>
+#endif
+
+#include "QuantisUsbMock.h"
+
+#define QUANTIS_USB_MOCK_DEFAULT_RATE 40000000.0
+#define QUANTIS_USB_MOCK_DEFAULT_LATENCY 500.0
+
+typedef struct QuantisUsbMockRequest
+{
+  struct libusb_transfer *transfer;
+  double due; /* completion time (in seconds) */
+  int cancelled;
+  struct QuantisUsbMockRequest *next;
+} QuantisUsbMockRequest;
+
+static pthread_mutex_t mockMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mockCond = PTHREAD_COND_INITIALIZER;
+static QuantisUsbMockRequest *mockQueue = NULL; /* sorted by due time */
+static double mockRate = 0.0;
+static double mockLatency = 0.0;
+static double mockLastDue = 0.0;
+static unsigned long long mockSubmitted = 0ull;
+
+static double QuantisUsbMockNow()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double QuantisUsbMockGetEnv(const char *name, double defaultValue)
+{
+  const char *value = getenv(name);
+  double result;
+
+  if ((value == NULL) || (*value == '\0'))
+  {
+    return defaultValue;
+  }
+
+  result = strtod(value, NULL);
+  return (result > 0.0) ? result : defaultValue;
+}
+
+/* Must be called with mockMutex held */
+static void QuantisUsbMockInit()
+{
+  if (mockRate == 0.0)
+  {
+    mockRate = QuantisUsbMockGetEnv("QUANTIS_USB_MOCK_RATE", QUANTIS_USB_MOCK_DEFAULT_RATE);
+    mockLatency = QuantisUsbMockGetEnv("QUANTIS_USB_MOCK_LATENCY", QUANTIS_USB_MOCK_DEFAULT_LATENCY) * 1e-6;
+  }
+}
+
+void QuantisUsbMockReset()
+{
+  pthread_mutex_lock(&mockMutex);
+  mockLastDue = 0.0;
+  mockSubmitted = 0ull;
+  pthread_mutex_unlock(&mockMutex);
+}
+
+unsigned long long QuantisUsbMockGetSubmitted()
+{
+  unsigned long long submitted;
+
+  pthread_mutex_lock(&mockMutex);
+  submitted = mockSubmitted;
+  pthread_mutex_unlock(&mockMutex);
+
+  return submitted;
+}
+
+struct libusb_transfer *LIBUSB_CALL libusb_alloc_transfer(int iso_packets)
+{
+  (void)iso_packets;
+  return (struct libusb_transfer *)calloc(1, sizeof(struct libusb_transfer));
+}
+
+void LIBUSB_CALL libusb_free_transfer(struct libusb_transfer *transfer)
+{
+  free(transfer);
+}
+
+int LIBUSB_CALL libusb_submit_transfer(struct libusb_transfer *transfer)
+{
+  QuantisUsbMockRequest *request;
+  QuantisUsbMockRequest **position;
+  double now;
+  double start;
+
+  request = (QuantisUsbMockRequest *)malloc(sizeof(QuantisUsbMockRequest));
+  if (!request)
+  {
+    return LIBUSB_ERROR_NO_MEM;
+  }
+
+  pthread_mutex_lock(&mockMutex);
+  QuantisUsbMockInit();
+
+  /* The device serves transfers in order, at the data rate */
+  now = QuantisUsbMockNow();
+  start = now + mockLatency;
+  if (start < mockLastDue)
+  {
+    start = mockLastDue;
+  }
+  mockLastDue = start + (double)transfer->length / mockRate;
+
+  request->transfer = transfer;
+  request->due = mockLastDue;
+  request->cancelled = 0;
+  request->next = NULL;
+
+  for (position = &mockQueue; *position != NULL; position = &(*position)->next)
+  {
+  }
+  *position = request;
+  mockSubmitted++;
+
+  pthread_cond_broadcast(&mockCond);
+  pthread_mutex_unlock(&mockMutex);
+
+  return LIBUSB_SUCCESS;
+}
+
+int LIBUSB_CALL libusb_cancel_transfer(struct libusb_transfer *transfer)
+{
+  QuantisUsbMockRequest *request;
+  int result = LIBUSB_ERROR_NOT_FOUND;
+
+  pthread_mutex_lock(&mockMutex);
+  for (request = mockQueue; request != NULL; request = request->next)
+  {
+    if ((request->transfer == transfer) && !request->cancelled)
+    {
+      request->cancelled = 1;
+      result = LIBUSB_SUCCESS;
+      break;
+    }
+  }
+  pthread_cond_broadcast(&mockCond);
+  pthread_mutex_unlock(&mockMutex);
+
+  return result;
+}
+
+int LIBUSB_CALL libusb_handle_events_timeout_completed(libusb_context *ctx,
+                                                       struct timeval *tv,
+                                                       int *completed)
+{
+  QuantisUsbMockRequest *request = NULL;
+  QuantisUsbMockRequest *previous;
+  struct libusb_transfer *transfer;
+  double deadline;
+  double wakeUp;
+  double now;
+  struct timespec ts;
+
+  (void)ctx;
+  (void)completed;
+
+  deadline = QuantisUsbMockNow() + (double)tv->tv_sec + (double)tv->tv_usec * 1e-6;
+
+  pthread_mutex_lock(&mockMutex);
+  while (1)
+  {
+    now = QuantisUsbMockNow();
+
+    /* Cancelled requests complete immediately, others once due */
+    previous = NULL;
+    for (request = mockQueue; request != NULL; previous = request, request = request->next)
+    {
+      if (request->cancelled || (request->due <= now))
+      {
+        break;
+      }
+    }
+    if (request)
+    {
+      if (previous)
+      {
+        previous->next = request->next;
+      }
+      else
+      {
+        mockQueue = request->next;
+      }
+      break;
+    }
+
+    if (now >= deadline)
+    {
+      break;
+    }
+
+    wakeUp = deadline;
+    if (mockQueue && (mockQueue->due < wakeUp))
+    {
+      wakeUp = mockQueue->due;
+    }
+
+    /* pthread_cond_timedwait uses CLOCK_REALTIME */
+    clock_gettime(CLOCK_REALTIME, &ts);
+    wakeUp = (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9 + (wakeUp - now);
+    ts.tv_sec = (time_t)wakeUp;
+    ts.tv_nsec = (long)((wakeUp - (double)ts.tv_sec) * 1e9);
+    pthread_cond_timedwait(&mockCond, &mockMutex, &ts);
+  }
+  pthread_mutex_unlock(&mockMutex);
+
+  if (!request)
+  {
+    return LIBUSB_SUCCESS;
+  }
+
+  /* Complete the transfer */
+  transfer = request->transfer;
+  if (request->cancelled)
+  {
+    transfer->status = LIBUSB_TRANSFER_CANCELLED;
+    transfer->actual_length = 0;
+  }
+  else
+  {
+    transfer->status = LIBUSB_TRANSFER_COMPLETED;
+    transfer->actual_length = transfer->length;
+    memset(transfer->buffer, 0x5A, (size_t)transfer->length);
+  }
+  free(request);
+
+  transfer->callback(transfer);
+
+  return LIBUSB_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/*
+ * Quantis USB stream benchmark
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Measures the throughput of the USB stream against the libusb mock, for
+ * several numbers of transfers kept in flight.
+ *
+ * Usage: QuantisUsbStreamBench [size in MiB] [read size in bytes]
+ *
+ * The simulated device is configured with the QUANTIS_USB_MOCK_RATE and
+ * QUANTIS_USB_MOCK_LATENCY environment variables (see QuantisUsbMock.c).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Quantis/Quantis.h"
+#include "Quantis/QuantisUsb_Commands.h"
+#include "Quantis/QuantisUsb_Stream.h"
+#include "QuantisUsbMock.h"
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned int transfersCounts[] = {1u, 2u, 4u, 8u, 16u};
+  size_t totalSize = 16u * 1024u * 1024u;
+  size_t readSize = 4096u;
+  unsigned char *buffer;
+  unsigned int i;
+
+  if (argc > 1)
+  {
+    totalSize = (size_t)strtoul(argv[1], NULL, 10) * 1024u * 1024u;
+  }
+  if (argc > 2)
+  {
+    readSize = (size_t)strtoul(argv[2], NULL, 10);
+  }
+  if ((totalSize == 0u) || (readSize == 0u))
+  {
+    fprintf(stderr, "Usage: %s [size in MiB] [read size in bytes]\n", argv[0]);
+    return 1;
+  }
+
+  buffer = (unsigned char *)malloc(readSize);
+  if (!buffer)
+  {
+    fprintf(stderr, "Not enough memory\n");
+    return 1;
+  }
+
+  printf("Reading %lu MiB by blocks of %lu bytes\n",
+         (unsigned long)(totalSize / (1024u * 1024u)),
+         (unsigned long)readSize);
+  printf("%10s %12s %14s %12s\n", "transfers", "max inflight", "transfers done", "MB/s");
+
+  for (i = 0u; i < sizeof(transfersCounts) / sizeof(transfersCounts[0]); i++)
+  {
+    QuantisUsbStream *stream = NULL;
+    size_t readBytes = 0u;
+    double start;
+    double elapsed;
+    int result;
+
+    QuantisUsbMockReset();
+
+    result = QuantisUsbStreamStart(NULL,
+                                   NULL,
+                                   QUANTIS_USB_ENDPOINT_BULK_IN,
+                                   USB_MAX_BULK_PACKET_SIZE,
+                                   transfersCounts[i],
+                                   QUANTIS_USB_STREAM_BUFFER_SIZE,
+                                   &stream);
+    if (result < 0)
+    {
+      fprintf(stderr, "QuantisUsbStreamStart failed: %d\n", result);
+      free(buffer);
+      return 1;
+    }
+
+    start = GetTime();
+    while (readBytes < totalSize)
+    {
+      size_t size = totalSize - readBytes;
+      if (size > readSize)
+      {
+        size = readSize;
+      }
+
+      result = QuantisUsbStreamRead(stream, buffer, size);
+      if (result < 0)
+      {
+        fprintf(stderr, "QuantisUsbStreamRead failed: %d\n", result);
+        break;
+      }
+      readBytes += (size_t)result;
+    }
+    elapsed = GetTime() - start;
+
+    printf("%10u %12u %14llu %12.2f\n",
+           transfersCounts[i],
+           QuantisUsbStreamGetMaxInFlight(stream),
+           QuantisUsbMockGetSubmitted(),
+           (double)readBytes / elapsed / 1e6);
+
+    QuantisUsbStreamStop(stream);
+  }
+
+  free(buffer);
+
+  return 0;
+}
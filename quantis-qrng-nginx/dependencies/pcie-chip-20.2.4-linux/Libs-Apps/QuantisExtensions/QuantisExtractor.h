@@ -135,7 +135,10 @@ extern "C"
     QUANTIS_EXT_ERROR_STORAGE_BUFFER_DISABLED = -24,
 
     /** less than 1 elementary matrix was provided to QuantisExtCreateExtractorMatrix */
-    QUANTIS_EXT_ERROR_NOT_ENOUGH_INPUT_ELEMENTARY_MATRICES = -25
+    QUANTIS_EXT_ERROR_NOT_ENOUGH_INPUT_ELEMENTARY_MATRICES = -25,
+
+    /** the output of QuantisExtractorGetDataFromFile would be larger than 2 GB */
+    QUANTIS_EXT_ERROR_OUTPUT_TOO_LARGE = -26
 
   } QuantisExtractorError;
 
@@ -185,15 +188,28 @@ extern "C"
 
   /**
    * The function applied the extraction to the input file and stores the processed data into the output filename
+   * The file is processed by windows of 16 MB, trailing bytes which do not fill a block of the extractor are ignored.
    * @param inputFilePath string containing the path of the input file
    * @param outputFilePath string containing the path of the output file 
    * @param extractorMatrix pointer the extractor matrix (uint64_t for multiplication efficiency)
    * @return number of bytes written to file on success, QUANTIS_EXT_ERROR on failure
+   * (QUANTIS_EXT_ERROR_OUTPUT_TOO_LARGE if more than 2 GB would be written)
    */
   DLL_EXPORT int32_t QuantisExtractorGetDataFromFile(char *inputFilePath,
                                                      char *outputFilePath,
                                                      const uint64_t *extractorMatrix);
 
+  /**
+   * Same as QuantisExtractorGetDataFromFile, for files of any size.
+   * @param inputFilePath string containing the path of the input file
+   * @param outputFilePath string containing the path of the output file 
+   * @param extractorMatrix pointer the extractor matrix (uint64_t for multiplication efficiency)
+   * @return number of bytes written to file on success, QUANTIS_EXT_ERROR on failure
+   */
+  DLL_EXPORT int64_t QuantisExtractorGetDataFromFile64(const char *inputFilePath,
+                                                       const char *outputFilePath,
+                                                       const uint64_t *extractorMatrix);
+
   /**
    * The function applies the extraction post processing to the input buffer, with the specified extractor matrix with given parameters
    * and store the processed buffer into outputBuffer
@@ -219,6 +235,21 @@ extern "C"
    */
   DLL_EXPORT uint16_t QuantisExtractorGetMatrixSizeOut();
 
+  /**
+   * Sets the number of threads used to process a buffer (1 by default). The blocks of
+   * a buffer are split into contiguous ranges processed in parallel; the output does
+   * not depend on the number of threads. Small buffers use less threads (each thread
+   * processes at least 1024 blocks).
+   * @param threadsCount the number of threads (at most 64), 0 for the number of online processors
+   */
+  DLL_EXPORT void QuantisExtractorSetThreads(uint32_t threadsCount);
+
+  /**
+   * The function gives the number of threads used to process a buffer
+   * @return the number of threads
+   */
+  DLL_EXPORT uint32_t QuantisExtractorGetThreads();
+
   /**
    * Get the parameters for reading the bytes to perform Troyer-Renner extraction
    * @param numberOfBytesRequested the number of bytes to read (not larger than QUANTIS_MAX_READ_SIZE).
@@ -250,6 +281,10 @@ extern "C"
    * (n and k global variables specifying the parameters of the extractor)
    * The function consists of a matrix multiplication: 
    *    [output] (k x 1) = {extractor} (k x n) * [input] (n x 1)
+   * When the matrix was loaded with QuantisExtractorInitializeMatrix, the fastest kernel supported
+   * by the CPU (AVX-512, AVX2 or plain C) is used, otherwise the matrix is processed bit by bit.
+   * All kernels produce the same output; QUANTIS_EXTRACTOR_KERNEL=scalar|portable|avx2|avx512
+   * in the environment forces a kernel.
    * @param inputBuffer input of the extractor (uint64_t for multiplication efficiency)
    * @param outputBuffer output of the extractor (uint64_t for multiplication efficiency)
    * @param extractorMatrix pointer to the extractor matrix (uint64_t for multiplication efficiency)
@@ -315,34 +350,45 @@ extern "C"
                                                                     uint8_t *outputBuffer,
                                                                     uint32_t inputBufferSize);
 
-  /** Enable the storage buffer and allocate MAX_BUFFER_SIZE bytes for it
+  /** Enable the storage buffer and allocate 65536 bytes for it
+   * The storage buffer keeps the bytes produced by the extractor beyond the requested ones
+   * for the next requests. It is a circular buffer: reading and appending bytes does not
+   * move the bytes it holds.
    * @return QUANTIS_SUCCESS if enabling is successful, QUANTIS_EXT_ERROR otherwise
   */
   DLL_EXPORT int32_t QuantisExtractorStorageBufferEnable();
 
+  /** Enable the storage buffer and allocate the given capacity for it
+   * Bytes held by the storage buffer, if it was already enabled, are dropped.
+   * @param capacity capacity in bytes, rounded up to a power of two (at most 1 GB, 0 for 65536)
+   * @return QUANTIS_SUCCESS if enabling is successful, QUANTIS_EXT_ERROR otherwise
+  */
+  DLL_EXPORT int32_t QuantisExtractorStorageBufferEnableWithCapacity(uint32_t capacity);
+
   /** Disable the storage buffer (if it was previously activated) and free the correspondigly allocated memory
    * @return QUANTIS_SUCCESS if enabling is successful, QUANTIS_EXT_ERROR otherwise
   */
   DLL_EXPORT int32_t QuantisExtractorStorageBufferDisable();
 
-  /** Reset the storage buffer (free and reallocate memory)
+  /** Reset the storage buffer (drop the bytes it holds)
    * @return QUANTIS_SUCCESS if reset is successful, QUANTIS_EXT_ERROR otherwise
   */
   DLL_EXPORT int32_t QuantisExtractorStorageBufferClear();
 
   /** Set the first 'bytesToCopy' bytes of the storage buffer to the 'bytesToCopy' bytes pointed by bufferToCopy
   * Any data previously written in the storage buffer will be overwritten
-  * If the buffer to copy is bigger than MAX_STORAGE_BUFFER_SIZE, extra data will be dropped
+  * If the buffer to copy is bigger than the capacity of the storage buffer, extra data will be dropped
   * @param bufferToCopy pointer to the buffer which should be copied into the storage buffer
   * @param bytesToCopy number of bytes in bufferToCopy to be copied into the storage buffer
-  * @return always QUANTIS_SUCCESS 
+  * @return the number of actually copied bytes (less than bytesToCopy if the storage buffer is too small),
+  * QUANTIS_EXT_ERROR_STORAGE_BUFFER_DISABLED if the storage buffer is disabled
   */
   DLL_EXPORT int32_t QuantisExtractorStorageBufferSet(uint8_t *bufferToCopy,
                                                       uint32_t bytesToCopy);
 
   /** Append 'bytesToAppend' bytes of the bufferToCopy to the storage buffer
    * Existing data in the storage buffer will be preserved
-   * Please note that appendable bytes are limited by MAX_STORAGE_BUFFER_SIZE, i.e., bytes are appended as long as the storage buffer is not full.
+   * Please note that appendable bytes are limited by the capacity of the storage buffer, i.e., bytes are appended as long as the storage buffer is not full.
    * @param bufferToCopy pointer to the buffer which should be copied into the storage buffer
    * @param bytesToCopy number of bytes in bufferToCopy to be copied into the storage buffer
    * @return the number of actually appended bytes .
@@ -363,6 +409,11 @@ extern "C"
   */
   DLL_EXPORT uint32_t QuantisExtractorStorageBufferGetSize();
 
+  /** Return the number of bytes the storage buffer can hold
+   * @return the storage buffer capacity in bytes (0 if disabled)
+  */
+  DLL_EXPORT uint32_t QuantisExtractorStorageBufferGetCapacity();
+
   /** Return the state (enabled/disabled) of the storage buffer
    * @return bufferEnabled (0 = disabled, 1 = enabled)
   */
@@ -498,6 +549,153 @@ extern "C"
                                                      short max,
                                                      const uint64_t *extractorMatrix);
 
+  /**
+   * Fills an array with random double floating precision values between 0.0
+   * (inclusive) and 1.0 (exclusive) from the Quantis device.
+   * The random data of all the values is extracted at once and converted in place.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadDoubles_01(QuantisDeviceType deviceType,
+                                                    unsigned int deviceNumber,
+                                                    double *values,
+                                                    size_t count,
+                                                    const uint64_t *extractorMatrix);
+
+  /**
+   * Fills an array with random single floating precision values between 0.0
+   * (inclusive) and 1.0 (exclusive) from the Quantis device.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadFloats_01(QuantisDeviceType deviceType,
+                                                   unsigned int deviceNumber,
+                                                   float *values,
+                                                   size_t count,
+                                                   const uint64_t *extractorMatrix);
+
+  /**
+   * Fills an array with random numbers from the Quantis device.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadInts(QuantisDeviceType deviceType,
+                                              unsigned int deviceNumber,
+                                              int *values,
+                                              size_t count,
+                                              const uint64_t *extractorMatrix);
+
+  /**
+   * Fills an array with random numbers from the Quantis device.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadShorts(QuantisDeviceType deviceType,
+                                                unsigned int deviceNumber,
+                                                short *values,
+                                                size_t count,
+                                                const uint64_t *extractorMatrix);
+
+  /**
+   * Fills an array with random numbers scaled to be between min (inclusive)
+   * and max (exclusive) from the Quantis device.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadScaledDoubles(QuantisDeviceType deviceType,
+                                                       unsigned int deviceNumber,
+                                                       double *values,
+                                                       size_t count,
+                                                       double min,
+                                                       double max,
+                                                       const uint64_t *extractorMatrix);
+
+  /**
+   * Fills an array with random numbers scaled to be between min (inclusive)
+   * and max (exclusive) from the Quantis device.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadScaledFloats(QuantisDeviceType deviceType,
+                                                      unsigned int deviceNumber,
+                                                      float *values,
+                                                      size_t count,
+                                                      float min,
+                                                      float max,
+                                                      const uint64_t *extractorMatrix);
+
+  /**
+   * Fills an array with random numbers from the Quantis device scaled to be between
+   * min and max (inclusive).
+   * The values are computed with a multiply-shift, the few random values which would
+   * bias the result are replaced by a single extraction for the whole array.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadScaledInts(QuantisDeviceType deviceType,
+                                                    unsigned int deviceNumber,
+                                                    int *values,
+                                                    size_t count,
+                                                    int min,
+                                                    int max,
+                                                    const uint64_t *extractorMatrix);
+
+  /**
+   * Fills an array with random numbers from the Quantis device scaled to be between
+   * min and max (inclusive).
+   * The values are computed with a multiply-shift, the few random values which would
+   * bias the result are replaced by a single extraction for the whole array.
+   * @param deviceType specify the type of Quantis device.
+   * @param deviceNumber the number of the Quantis device.
+   * @param values a pointer to a destination array of at least <em>count</em> values.
+   * @param count the number of values to read.
+   * @param min the minimal value the random numbers can take.
+   * @param max the maximal value the random numbers can take.
+   * @param extractorMatrix pointer to the buffer where the extractor matrix has been stored (initialization should be done with QuantisExtensionsInitExtMatrix)
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorReadScaledShorts(QuantisDeviceType deviceType,
+                                                      unsigned int deviceNumber,
+                                                      short *values,
+                                                      size_t count,
+                                                      short min,
+                                                      short max,
+                                                      const uint64_t *extractorMatrix);
+
   /**
  * Get a pointer to the error message string for the QuantisExtensions library.
  *
@@ -513,6 +711,250 @@ extern "C"
 */
   DLL_EXPORT char *QuantisExtractorStrError(QuantisExtractorError errorNumber);
 
+  /** ----------------------------------------------------------------------------------- */
+  /**                                  EXTRACTOR CONTEXT                                  */
+  /** ----------------------------------------------------------------------------------- */
+
+  /**
+   * Extractor context: owns an extractor matrix, its size and a storage buffer.
+   *
+   * The functions of this library without context share a single global
+   * context, so they can be used with one matrix at a time, from one thread
+   * at a time. Each QuantisExtractorCtx* function does the same as the
+   * function without context of the same name, using the given context
+   * instead; different contexts can be used from different threads at the
+   * same time. A context MUST NOT be used by several threads at once.
+   */
+  typedef struct QuantisExtractorCtx QuantisExtractorCtx;
+
+  /**
+   * Creates an extractor context and loads its matrix from the specified file.
+   * @param matrixFilename the filename of the matrix
+   * @param matrixSizeIn the number of bits which are input to the extractor
+   * @param matrixSizeOut the number of bits which are output to the extractor
+   * @param ctx pointer to the pointer to the created context
+   * @return QUANTIS_SUCCESS if success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  DLL_EXPORT int32_t QuantisExtractorCtxCreate(const char *matrixFilename,
+                                               uint16_t matrixSizeIn,
+                                               uint16_t matrixSizeOut,
+                                               QuantisExtractorCtx **ctx);
+
+  /**
+   * Frees the context, its matrix and its storage buffer.
+   * @param ctx pointer to the context (may be NULL)
+   */
+  DLL_EXPORT void QuantisExtractorCtxDestroy(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorGetDataFromQuantis */
+  DLL_EXPORT int32_t QuantisExtractorCtxGetDataFromQuantis(QuantisExtractorCtx *ctx,
+                                                           QuantisDeviceType deviceType,
+                                                           unsigned int deviceNumber,
+                                                           uint8_t *outputBuffer,
+                                                           uint32_t numberOfBytesRequested);
+
+  /** @see QuantisExtractorGetDataFromFile */
+  DLL_EXPORT int32_t QuantisExtractorCtxGetDataFromFile(QuantisExtractorCtx *ctx,
+                                                        char *inputFilePath,
+                                                        char *outputFilePath);
+
+  /** @see QuantisExtractorGetDataFromFile64 */
+  DLL_EXPORT int64_t QuantisExtractorCtxGetDataFromFile64(QuantisExtractorCtx *ctx,
+                                                          const char *inputFilePath,
+                                                          const char *outputFilePath);
+
+  /** @see QuantisExtractorGetDataFromBuffer */
+  DLL_EXPORT void QuantisExtractorCtxGetDataFromBuffer(QuantisExtractorCtx *ctx,
+                                                       const uint8_t *inputBuffer,
+                                                       uint8_t *outputBuffer,
+                                                       uint32_t numberOfBytesAfterExtraction);
+
+  /** @see QuantisExtractorGetMatrixSizeIn */
+  DLL_EXPORT uint16_t QuantisExtractorCtxGetMatrixSizeIn(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorGetMatrixSizeOut */
+  DLL_EXPORT uint16_t QuantisExtractorCtxGetMatrixSizeOut(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorSetThreads */
+  DLL_EXPORT void QuantisExtractorCtxSetThreads(QuantisExtractorCtx *ctx,
+                                                uint32_t threadsCount);
+
+  /** @see QuantisExtractorGetThreads */
+  DLL_EXPORT uint32_t QuantisExtractorCtxGetThreads(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorComputeBufferSize */
+  DLL_EXPORT int32_t QuantisExtractorCtxComputeBufferSize(QuantisExtractorCtx *ctx,
+                                                          uint32_t numberOfBytesRequested,
+                                                          uint32_t *numberOfBytesAfterExtraction,
+                                                          uint32_t *numberOfBytesBeforeExtraction);
+
+  /** @see QuantisExtractorInitializeOutputBuffer */
+  DLL_EXPORT int32_t QuantisExtractorCtxInitializeOutputBuffer(QuantisExtractorCtx *ctx,
+                                                               uint32_t inputBufferSize,
+                                                               uint8_t **outputBuffer);
+
+  /** @see QuantisExtractorProcessBlock */
+  DLL_EXPORT void QuantisExtractorCtxProcessBlock(QuantisExtractorCtx *ctx,
+                                                  const uint64_t *inputBuffer,
+                                                  uint64_t *outputBuffer);
+
+  /** @see QuantisExtractorStorageBufferEnable */
+  DLL_EXPORT int32_t QuantisExtractorCtxStorageBufferEnable(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorStorageBufferEnableWithCapacity */
+  DLL_EXPORT int32_t QuantisExtractorCtxStorageBufferEnableWithCapacity(QuantisExtractorCtx *ctx,
+                                                                        uint32_t capacity);
+
+  /** @see QuantisExtractorStorageBufferDisable */
+  DLL_EXPORT int32_t QuantisExtractorCtxStorageBufferDisable(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorStorageBufferClear */
+  DLL_EXPORT int32_t QuantisExtractorCtxStorageBufferClear(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorStorageBufferSet */
+  DLL_EXPORT int32_t QuantisExtractorCtxStorageBufferSet(QuantisExtractorCtx *ctx,
+                                                         uint8_t *bufferToCopy,
+                                                         uint32_t bytesToCopy);
+
+  /** @see QuantisExtractorStorageBufferAppend */
+  DLL_EXPORT int32_t QuantisExtractorCtxStorageBufferAppend(QuantisExtractorCtx *ctx,
+                                                            uint8_t *bufferToAppend,
+                                                            uint32_t bytesToAppend);
+
+  /** @see QuantisExtractorStorageBufferRead */
+  DLL_EXPORT int32_t QuantisExtractorCtxStorageBufferRead(QuantisExtractorCtx *ctx,
+                                                          uint8_t *outputBuffer,
+                                                          uint32_t numberOfBytesRequested);
+
+  /** @see QuantisExtractorStorageBufferGetSize */
+  DLL_EXPORT uint32_t QuantisExtractorCtxStorageBufferGetSize(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorStorageBufferGetCapacity */
+  DLL_EXPORT uint32_t QuantisExtractorCtxStorageBufferGetCapacity(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorStorageBufferIsEnabled */
+  DLL_EXPORT uint8_t QuantisExtractorCtxStorageBufferIsEnabled(QuantisExtractorCtx *ctx);
+
+  /** @see QuantisExtractorReadDouble_01 */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadDouble_01(QuantisExtractorCtx *ctx,
+                                                      QuantisDeviceType deviceType,
+                                                      unsigned int deviceNumber,
+                                                      double *value);
+
+  /** @see QuantisExtractorReadFloat_01 */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadFloat_01(QuantisExtractorCtx *ctx,
+                                                     QuantisDeviceType deviceType,
+                                                     unsigned int deviceNumber,
+                                                     float *value);
+
+  /** @see QuantisExtractorReadInt */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadInt(QuantisExtractorCtx *ctx,
+                                                QuantisDeviceType deviceType,
+                                                unsigned int deviceNumber,
+                                                int *value);
+
+  /** @see QuantisExtractorReadShort */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadShort(QuantisExtractorCtx *ctx,
+                                                  QuantisDeviceType deviceType,
+                                                  unsigned int deviceNumber,
+                                                  short *value);
+
+  /** @see QuantisExtractorReadScaledDouble */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledDouble(QuantisExtractorCtx *ctx,
+                                                         QuantisDeviceType deviceType,
+                                                         unsigned int deviceNumber,
+                                                         double *value,
+                                                         double min,
+                                                         double max);
+
+  /** @see QuantisExtractorReadScaledFloat */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledFloat(QuantisExtractorCtx *ctx,
+                                                        QuantisDeviceType deviceType,
+                                                        unsigned int deviceNumber,
+                                                        float *value,
+                                                        float min,
+                                                        float max);
+
+  /** @see QuantisExtractorReadScaledInt */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledInt(QuantisExtractorCtx *ctx,
+                                                      QuantisDeviceType deviceType,
+                                                      unsigned int deviceNumber,
+                                                      int *value,
+                                                      int min,
+                                                      int max);
+
+  /** @see QuantisExtractorReadScaledShort */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledShort(QuantisExtractorCtx *ctx,
+                                                        QuantisDeviceType deviceType,
+                                                        unsigned int deviceNumber,
+                                                        short *value,
+                                                        short min,
+                                                        short max);
+
+  /** @see QuantisExtractorReadDoubles_01 */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadDoubles_01(QuantisExtractorCtx *ctx,
+                                                       QuantisDeviceType deviceType,
+                                                       unsigned int deviceNumber,
+                                                       double *values,
+                                                       size_t count);
+
+  /** @see QuantisExtractorReadFloats_01 */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadFloats_01(QuantisExtractorCtx *ctx,
+                                                      QuantisDeviceType deviceType,
+                                                      unsigned int deviceNumber,
+                                                      float *values,
+                                                      size_t count);
+
+  /** @see QuantisExtractorReadInts */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadInts(QuantisExtractorCtx *ctx,
+                                                 QuantisDeviceType deviceType,
+                                                 unsigned int deviceNumber,
+                                                 int *values,
+                                                 size_t count);
+
+  /** @see QuantisExtractorReadShorts */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadShorts(QuantisExtractorCtx *ctx,
+                                                   QuantisDeviceType deviceType,
+                                                   unsigned int deviceNumber,
+                                                   short *values,
+                                                   size_t count);
+
+  /** @see QuantisExtractorReadScaledDoubles */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledDoubles(QuantisExtractorCtx *ctx,
+                                                          QuantisDeviceType deviceType,
+                                                          unsigned int deviceNumber,
+                                                          double *values,
+                                                          size_t count,
+                                                          double min,
+                                                          double max);
+
+  /** @see QuantisExtractorReadScaledFloats */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledFloats(QuantisExtractorCtx *ctx,
+                                                         QuantisDeviceType deviceType,
+                                                         unsigned int deviceNumber,
+                                                         float *values,
+                                                         size_t count,
+                                                         float min,
+                                                         float max);
+
+  /** @see QuantisExtractorReadScaledInts */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledInts(QuantisExtractorCtx *ctx,
+                                                       QuantisDeviceType deviceType,
+                                                       unsigned int deviceNumber,
+                                                       int *values,
+                                                       size_t count,
+                                                       int min,
+                                                       int max);
+
+  /** @see QuantisExtractorReadScaledShorts */
+  DLL_EXPORT int32_t QuantisExtractorCtxReadScaledShorts(QuantisExtractorCtx *ctx,
+                                                         QuantisDeviceType deviceType,
+                                                         unsigned int deviceNumber,
+                                                         short *values,
+                                                         size_t count,
+                                                         short min,
+                                                         short max);
+
 #ifdef __cplusplus
 }
 #endif
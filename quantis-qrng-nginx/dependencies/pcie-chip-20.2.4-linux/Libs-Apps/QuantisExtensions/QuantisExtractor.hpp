@@ -58,12 +58,6 @@
 #include "../Quantis/Quantis.h"
 #include "QuantisExtractor.h"
 
-#ifdef _WIN32
-// Visual C++ does not implement checked exceptions
-// Disables "C++ exception specification ignored except to indicate a function is not __declspec(nothrow)"
-#pragma warning(disable : 4290)
-#endif
-
 namespace idQ
 {
 class DLL_EXPORT QuantisExtractor
@@ -88,7 +82,7 @@ public:
       */
   void InitializeMatrix(const std::string &matrixFilename,
                         const uint16_t matrixSizeIn = 1024,
-                        const uint16_t matrixSizeOut = 768) throw(std::runtime_error);
+                        const uint16_t matrixSizeOut = 768);
 
   /**
       * Free the memory of the extractor matrix
@@ -108,7 +102,7 @@ public:
   void GetDataFromQuantis(const QuantisDeviceType deviceType,
                           const unsigned int cardNumber,
                           void *buffer,
-                          const size_t bytesNum) throw(std::runtime_error);
+                          const size_t bytesNum);
 
   /**
       * Reads random data from the Quantis device and apply the randomness extraction.
@@ -120,7 +114,7 @@ public:
       */
   std::string GetDataFromQuantis(const QuantisDeviceType deviceType,
                                  const unsigned int cardNumber,
-                                 const size_t bytesNum) throw(std::runtime_error);
+                                 const size_t bytesNum);
 
   /**
       * Reads a random double floating precision value between 0.0 (inclusive)
@@ -131,8 +125,7 @@ public:
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
   double GetDoubleFromQuantis(const QuantisDeviceType deviceType,
-                              const unsigned int cardNumber) const
-      throw(std::runtime_error);
+                              const unsigned int cardNumber) const;
 
   /**
       * Reads a double random number from the Quantis device and scale it to be between 
@@ -147,8 +140,7 @@ public:
   double GetDoubleFromQuantis(const QuantisDeviceType deviceType,
                               const unsigned int cardNumber,
                               double min,
-                              double max) const
-      throw(std::runtime_error);
+                              double max) const;
 
   /**
       * Reads a random float floating precision value between 0.0 (inclusive)
@@ -159,8 +151,7 @@ public:
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
   float GetFloatFromQuantis(const QuantisDeviceType deviceType,
-                            const unsigned int cardNumber) const
-      throw(std::runtime_error);
+                            const unsigned int cardNumber) const;
 
   /**
       * Reads a float random number from the Quantis device and scale it to be between 
@@ -175,8 +166,7 @@ public:
   float GetFloatFromQuantis(const QuantisDeviceType deviceType,
                             const unsigned int cardNumber,
                             float min,
-                            float max) const
-      throw(std::runtime_error);
+                            float max) const;
 
   /**
       * Reads a random integer precision value
@@ -186,8 +176,7 @@ public:
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
   int GetIntFromQuantis(const QuantisDeviceType deviceType,
-                        const unsigned int cardNumber) const
-      throw(std::runtime_error);
+                        const unsigned int cardNumber) const;
 
   /**
       * Reads a integer random number from the Quantis device and scale it to be between 
@@ -202,8 +191,7 @@ public:
   int GetIntFromQuantis(const QuantisDeviceType deviceType,
                         const unsigned int cardNumber,
                         int min,
-                        int max) const
-      throw(std::runtime_error);
+                        int max) const;
 
   /**
       * Reads a random short int precision value
@@ -213,8 +201,7 @@ public:
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
   short GetShortFromQuantis(const QuantisDeviceType deviceType,
-                            const unsigned int cardNumber) const
-      throw(std::runtime_error);
+                            const unsigned int cardNumber) const;
 
   /**
       * Reads a short integer random number from the Quantis device and scale it to be between 
@@ -229,8 +216,7 @@ public:
   short GetShortFromQuantis(const QuantisDeviceType deviceType,
                             const unsigned int cardNumber,
                             short min,
-                            short max) const
-      throw(std::runtime_error);
+                            short max) const;
 
   /**
       * Reads random data from the input file and apply the randomness extraction.
@@ -240,7 +226,7 @@ public:
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
   int32_t GetDataFromFile(const std::string &inputFilename,
-                          const std::string &outputFilename) throw(std::runtime_error);
+                          const std::string &outputFilename);
 
   /**
        * Reads random data from the input buffer and apply the randomness extraction.
@@ -250,7 +236,7 @@ public:
        */
   void GetDataFromBuffer(const void *inputBuffer,
                          void *outputBuffer,
-                         size_t numberOfBytesAfterExtraction) throw(std::runtime_error);
+                         size_t numberOfBytesAfterExtraction);
 
   /**
       * The function initializes an output buffer in order to contain the result of the extraction of an input buffer of inputBufferSize bytes
@@ -260,7 +246,7 @@ public:
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
   uint32_t InitializeOutputBuffer(const uint32_t inputBufferSize,
-                                  uint8_t **outputBuffer) throw(std::runtime_error);
+                                  uint8_t **outputBuffer);
 
   /**
       * Get the number of bits which are input to the extractor
@@ -293,12 +279,12 @@ public:
   /** Enable the storage buffer and allocate MAX_BUFFER_SIZE bytes for it
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
-  void EnableStorageBuffer() throw(std::runtime_error);
+  void EnableStorageBuffer();
 
   /** Disable the storage buffer (if it was previously activated) and free the correspondigly allocated memory
       * @throw runtime_error QUANTIS_EXT_ERROR code on failure 
       */
-  void DisableStorageBuffer() throw(std::runtime_error);
+  void DisableStorageBuffer();
 
   /**
       * Write to file an elementary matrix created by applying ProcessBufferVonNeumann to the buffer produced by ReadUnderSampled
@@ -315,7 +301,7 @@ public:
                               const uint16_t matrixSizeIn,
                               const uint16_t matrixSizeOut,
                               const uint16_t underSamplingPeriod,
-                              const std::string &elementaryMatrixFilename) throw(std::runtime_error);
+                              const std::string &elementaryMatrixFilename);
 
   /** 
       * XOR the bitstreams contained in the number of Elementary Matrices files specified in elementaryMatricesFilename
@@ -326,7 +312,7 @@ public:
       */
   void CreateMatrix(const uint32_t matrixSize,
                     const std::vector<std::string> &elementaryMatricesFilename,
-                    const std::string &extractorMatrixFilename) throw(std::runtime_error);
+                    const std::string &extractorMatrixFilename);
 
   /**
       * Apply the Von Neumann post-processing to the bit sequence which was read from 
@@ -356,7 +342,7 @@ public:
                             const unsigned int deviceNumber,
                             const uint32_t nbrOfBytesRequested,
                             const uint16_t underSamplingPeriod,
-                            std::vector<uint8_t> &sampledBuffer) throw(std::runtime_error);
+                            std::vector<uint8_t> &sampledBuffer);
 
   /**
       * Get an error message string for the QuantisExtensions library.
@@ -50,35 +50,87 @@
 
 #include "../Quantis/Quantis.h"
 #include "QuantisExtractor.h"
+#include "QuantisExtractor_Kernels.h"
 #include "../Quantis/Conversion.h"
 #include <stdio.h>
 #include <math.h>
 #include <malloc.h>
+#include <pthread.h>
+#include <unistd.h>
 
 /* Size of the buffer used for QuantisReadXXX methods */
 #define QUANTIS_EXTENSIONS_READ_XXX_BUFFER_SIZE 8
-/* Max size of the storage buffer */
-#define MAX_STORAGE_BUFFER_SIZE 65535
-
-// global variables
-
-//used to fast the processing
-uint16_t g_n = 0; // extractor: number of input bits
-uint16_t g_k = 0; // extractor: number of output bits
+/* Default capacity of the storage buffer */
+#define DEFAULT_STORAGE_BUFFER_CAPACITY 65536
+/* Max capacity of the storage buffer */
+#define MAX_STORAGE_BUFFER_CAPACITY (1u << 30)
+/* Max number of threads processing a buffer */
+#define MAX_EXTRACTION_THREADS 64
+/* Min number of blocks processed by a thread (smaller buffers are split in less parts) */
+#define MIN_BLOCKS_PER_THREAD 1024
+/* Size of the windows of the input file processed at once */
+#define FILE_WINDOW_SIZE (16 * 1024 * 1024)
+/* Size of the windows extracted at once by the QuantisExtractorReadXXXs methods */
+#define READ_VALUES_WINDOW_SIZE (4 * 1024 * 1024)
+
+struct QuantisExtractorCtx
+{
+  // extractor matrix and its size
+  const uint64_t *matrix;
+  uint8_t ownsMatrix;
+  uint16_t n; // extractor: number of input bits
+  uint16_t k; // extractor: number of output bits
+
+  // tables of the fast kernels (NULL if none, the scalar kernel is used then), computed
+  // for the matrix of generation tablesGeneration. matrixGeneration changes with the
+  // matrix, even at the same address (a new matrix may reuse the memory of a freed one)
+  QuantisExtractorTables *tables;
+  uint32_t matrixGeneration;
+  uint32_t tablesGeneration;
+
+  // storage buffer (bytes produced by the extractor but not requested yet): circular
+  // buffer of storageBufferCapacity bytes (power of two), holding the bytes between
+  // the free running counters storageBufferTail (read) and storageBufferHead (written)
+  uint8_t storageBufferEnabled;
+  uint32_t storageBufferCapacity;
+  uint32_t storageBufferHead;
+  uint32_t storageBufferTail;
+  uint8_t *storageBuffer;
+
+  // number of threads processing a buffer
+  uint32_t threadsCount;
+
+  // buffers of QuantisExtractorCtxGetDataFromQuantis, kept from one call to the next
+  uint8_t *scratchBuffer;
+  size_t scratchBufferSize;
+};
+
+/* Range of blocks processed by a thread */
+typedef struct QuantisExtractorWorker
+{
+  QuantisExtractorCtx *ctx;
+  const uint64_t *inputBuffer;
+  uint64_t *outputBuffer;
+  uint32_t blocksCount;
+  pthread_t thread;
+} QuantisExtractorWorker;
 
-uint8_t g_storageBufferEnabled = 0;
-uint32_t g_storageBufferSize = 0;
-uint8_t *g_storageBuffer = NULL;
+// context of the functions without context: its matrix is the one passed to
+// the last of these functions, its size the one given to QuantisExtractorInitializeMatrix
+static QuantisExtractorCtx g_ctx = {NULL, 0, 0, 0, NULL, 0, 0, 0, 0, 0, 0, NULL, 1, NULL, 0};
 
 float QuantisExtractorGetLibVersion()
 {
   return QUANTIS_EXTRACTOR_LIBRARY_VERSION;
 }
 
-int32_t QuantisExtractorInitializeMatrix(const char *matrixFilename,
-                                         uint64_t **extractorMatrix,
-                                         uint16_t matrixSizeIn,
-                                         uint16_t matrixSizeOut)
+/**
+ * Allocates the extractor matrix and reads it from the specified file.
+ */
+static int32_t QuantisExtractorLoadMatrix(const char *matrixFilename,
+                                          uint64_t **extractorMatrix,
+                                          uint16_t matrixSizeIn,
+                                          uint16_t matrixSizeOut)
 {
   int32_t result;
   FILE *extractorFileHandler;
@@ -97,6 +149,8 @@ int32_t QuantisExtractorInitializeMatrix(const char *matrixFilename,
   extractorFileHandler = fopen(matrixFilename, "rb");
   if (!extractorFileHandler)
   {
+    free(*extractorMatrix);
+    *extractorMatrix = NULL;
     return QUANTIS_EXT_ERROR_MATRIX_FILE_NOT_FOUND;
   }
 
@@ -105,23 +159,123 @@ int32_t QuantisExtractorInitializeMatrix(const char *matrixFilename,
                           sizeof(uint64_t),
                           elementsExtractorMatrix,
                           extractorFileHandler);
-  if (result < 0)
+  fclose(extractorFileHandler);
+
+  if ((uint32_t)result != elementsExtractorMatrix)
   {
-    return QUANTIS_EXT_ERROR_UNABLE_TO_READ_FILE;
+    free(*extractorMatrix);
+    *extractorMatrix = NULL;
+    return QUANTIS_EXT_ERROR_MATRIX_FILE_TOO_SMALL;
   }
-  else
+
+  return QUANTIS_SUCCESS;
+}
+
+/**
+ * Sets the matrix size of the context and precomputes the tables of the fast
+ * kernels for the matrix.
+ */
+static void QuantisExtractorCtxSetMatrix(QuantisExtractorCtx *ctx,
+                                         const uint64_t *extractorMatrix,
+                                         uint16_t matrixSizeIn,
+                                         uint16_t matrixSizeOut)
+{
+  ctx->matrix = extractorMatrix;
+  ctx->n = matrixSizeIn;
+  ctx->k = matrixSizeOut;
+  ctx->matrixGeneration++;
+
+  QuantisExtractorTablesFree(ctx->tables);
+  ctx->tables = NULL;
+  if (QuantisExtractorKernelGetDefault() != QUANTIS_EXTRACTOR_KERNEL_SCALAR)
   {
-    if ((uint32_t)result != elementsExtractorMatrix)
+    if (QuantisExtractorTablesCreate(extractorMatrix, matrixSizeIn, matrixSizeOut, &ctx->tables) != QUANTIS_SUCCESS)
     {
-      return QUANTIS_EXT_ERROR_MATRIX_FILE_TOO_SMALL;
+      ctx->tables = NULL;
     }
   }
+  ctx->tablesGeneration = ctx->matrixGeneration;
+}
 
-  fclose(extractorFileHandler);
+/**
+ * Uses the matrix given to a function of the global context, which keeps its
+ * size. The tables of the previous matrix are not used for another one.
+ */
+static void QuantisExtractorCtxUseMatrix(QuantisExtractorCtx *ctx, const uint64_t *extractorMatrix)
+{
+  if (ctx->matrix != extractorMatrix)
+  {
+    ctx->matrix = extractorMatrix;
+    ctx->matrixGeneration++;
+  }
+}
+
+int32_t QuantisExtractorCtxCreate(const char *matrixFilename,
+                                  uint16_t matrixSizeIn,
+                                  uint16_t matrixSizeOut,
+                                  QuantisExtractorCtx **ctx)
+{
+  QuantisExtractorCtx *_ctx;
+  uint64_t *extractorMatrix = NULL;
+  int32_t result;
+
+  if ((matrixSizeIn <= matrixSizeOut) || (matrixSizeIn % 64) || (matrixSizeOut % 64))
+  {
+    return QUANTIS_EXT_ERROR_WRONG_EXTRACTION_PARAMETERS;
+  }
+
+  _ctx = calloc(1, sizeof(QuantisExtractorCtx));
+  if (_ctx == NULL)
+  {
+    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+  }
+
+  result = QuantisExtractorLoadMatrix(matrixFilename, &extractorMatrix, matrixSizeIn, matrixSizeOut);
+  if (result != QUANTIS_SUCCESS)
+  {
+    free(_ctx);
+    return result;
+  }
+
+  QuantisExtractorCtxSetMatrix(_ctx, extractorMatrix, matrixSizeIn, matrixSizeOut);
+  _ctx->ownsMatrix = 1;
+  _ctx->threadsCount = 1;
+
+  *ctx = _ctx;
+
+  return QUANTIS_SUCCESS;
+}
+
+void QuantisExtractorCtxDestroy(QuantisExtractorCtx *ctx)
+{
+  if (ctx == NULL)
+  {
+    return;
+  }
+
+  QuantisExtractorTablesFree(ctx->tables);
+  if (ctx->ownsMatrix)
+  {
+    free((void *)ctx->matrix);
+  }
+  free(ctx->storageBuffer);
+  free(ctx->scratchBuffer);
+  free(ctx);
+}
+
+int32_t QuantisExtractorInitializeMatrix(const char *matrixFilename,
+                                         uint64_t **extractorMatrix,
+                                         uint16_t matrixSizeIn,
+                                         uint16_t matrixSizeOut)
+{
+  int32_t result = QuantisExtractorLoadMatrix(matrixFilename, extractorMatrix, matrixSizeIn, matrixSizeOut);
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
 
-  //Store the the matrix size in global var to fast the processing
-  g_n = matrixSizeIn;
-  g_k = matrixSizeOut;
+  //Store the the matrix size in the global context to fast the processing
+  QuantisExtractorCtxSetMatrix(&g_ctx, *extractorMatrix, matrixSizeIn, matrixSizeOut);
 
   return QUANTIS_SUCCESS;
 }
@@ -130,15 +284,29 @@ void QuantisExtractorUninitializeMatrix(uint64_t **extractorMatrix)
 {
   if (*extractorMatrix)
   {
+    if (g_ctx.tables && (g_ctx.tables->matrix == *extractorMatrix))
+    {
+      QuantisExtractorTablesFree(g_ctx.tables);
+      g_ctx.tables = NULL;
+    }
+    if (g_ctx.matrix == *extractorMatrix)
+    {
+      g_ctx.matrix = NULL;
+    }
+    // a matrix allocated later at the same address is another one
+    g_ctx.matrixGeneration++;
+    free(g_ctx.scratchBuffer);
+    g_ctx.scratchBuffer = NULL;
+    g_ctx.scratchBufferSize = 0;
     free(*extractorMatrix);
   }
 }
 
-int32_t QuantisExtractorGetDataFromQuantis(QuantisDeviceType deviceType,
-                                           unsigned int deviceNumber,
-                                           uint8_t *outputBuffer,
-                                           uint32_t numberOfBytesRequested,
-                                           const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxGetDataFromQuantis(QuantisExtractorCtx *ctx,
+                                              QuantisDeviceType deviceType,
+                                              unsigned int deviceNumber,
+                                              uint8_t *outputBuffer,
+                                              uint32_t numberOfBytesRequested)
 {
   int32_t result;
 
@@ -156,24 +324,23 @@ int32_t QuantisExtractorGetDataFromQuantis(QuantisDeviceType deviceType,
 
   // read raw output of the Quantis and process it (extraction process is blockwise)
 
-  int32_t localStorageBufferEnabled = QuantisExtractorStorageBufferIsEnabled();
-  int32_t localStorageBufferSize = QuantisExtractorStorageBufferGetSize();
+  int32_t localStorageBufferEnabled = QuantisExtractorCtxStorageBufferIsEnabled(ctx);
+  int32_t localStorageBufferSize = QuantisExtractorCtxStorageBufferGetSize(ctx);
 
   uint32_t chunkSize;
-  uint32_t remaining;
-  uint32_t i;
+  uint32_t offset;
 
   /* check correctness of the extractor parameters (extractorBitsIn and extractorBitsOut 
   should be multiples of 64 and extractorBitsIn > extractorBitsOut) */
-  if (QuantisExtractorGetMatrixSizeIn() <= QuantisExtractorGetMatrixSizeOut())
+  if (QuantisExtractorCtxGetMatrixSizeIn(ctx) <= QuantisExtractorCtxGetMatrixSizeOut(ctx))
   {
     return QUANTIS_EXT_ERROR_WRONG_EXTRACTION_PARAMETERS;
   }
-  if (QuantisExtractorGetMatrixSizeIn() % 64)
+  if (QuantisExtractorCtxGetMatrixSizeIn(ctx) % 64)
   {
     return QUANTIS_EXT_ERROR_WRONG_EXTRACTION_PARAMETERS;
   }
-  if (QuantisExtractorGetMatrixSizeOut() % 64)
+  if (QuantisExtractorCtxGetMatrixSizeOut(ctx) % 64)
   {
     return QUANTIS_EXT_ERROR_WRONG_EXTRACTION_PARAMETERS;
   }
@@ -186,60 +353,55 @@ int32_t QuantisExtractorGetDataFromQuantis(QuantisDeviceType deviceType,
       // read all the bytes written in the storageBuffer
       currentOutputSize = localStorageBufferSize;
 
-      QuantisExtractorStorageBufferRead(&outputBuffer[0], localStorageBufferSize);
+      QuantisExtractorCtxStorageBufferRead(ctx, &outputBuffer[0], localStorageBufferSize);
 
       numberOfBytesRequested = numberOfBytesRequested - currentOutputSize;
     }
     else // there are enough bytes in the storageBuffer in order not to perform a new QuantisRead
     {
-      QuantisExtractorStorageBufferRead(&outputBuffer[0], numberOfBytesRequested);
+      QuantisExtractorCtxStorageBufferRead(ctx, &outputBuffer[0], numberOfBytesRequested);
 
       return numberOfBytesRequested;
     }
   }
 
-  result = QuantisExtractorComputeBufferSize(numberOfBytesRequested,
-                                             &numberOfBytesAfterExtraction,
-                                             &numberOfBytesBeforeExtraction);
+  result = QuantisExtractorCtxComputeBufferSize(ctx,
+                                                numberOfBytesRequested,
+                                                &numberOfBytesAfterExtraction,
+                                                &numberOfBytesBeforeExtraction);
 
   if (result != QUANTIS_SUCCESS)
   {
     return result;
   }
 
-  inputBufferExtractor = malloc(numberOfBytesBeforeExtraction);
-  if (inputBufferExtractor == NULL)
-  {
-    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
-  }
-
-  outputBufferExtractor = malloc(numberOfBytesAfterExtraction);
-  if (outputBufferExtractor == NULL)
+  // both buffers are taken from the scratch buffer of the context, which only grows
+  if (ctx->scratchBufferSize < (size_t)numberOfBytesBeforeExtraction + numberOfBytesAfterExtraction)
   {
-    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+    uint8_t *scratchBuffer = realloc(ctx->scratchBuffer, (size_t)numberOfBytesBeforeExtraction + numberOfBytesAfterExtraction);
+    if (scratchBuffer == NULL)
+    {
+      return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+    }
+    ctx->scratchBuffer = scratchBuffer;
+    ctx->scratchBufferSize = (size_t)numberOfBytesBeforeExtraction + numberOfBytesAfterExtraction;
   }
+  inputBufferExtractor = ctx->scratchBuffer;
+  outputBufferExtractor = &ctx->scratchBuffer[numberOfBytesBeforeExtraction];
 
-  // read "numberOfBytesRequested" bytes from the Quantis device
-  result = QuantisRead(deviceType,
-                       deviceNumber,
-                       inputBufferExtractor,
-                       numberOfBytesBeforeExtraction);
-
-  chunkSize = 4096;
-  remaining = numberOfBytesBeforeExtraction;
-  i = 0;
-
-  while (remaining > 0u)
+  // read "numberOfBytesBeforeExtraction" bytes from the Quantis device (QuantisRead keeps the device open
+  // from one call to the next, chunks are only needed for requests larger than QUANTIS_MAX_READ_SIZE)
+  for (offset = 0u; offset < numberOfBytesBeforeExtraction; offset += chunkSize)
   {
-    /* Chunk size */
-    if (remaining < chunkSize)
+    chunkSize = numberOfBytesBeforeExtraction - offset;
+    if (chunkSize > QUANTIS_MAX_READ_SIZE)
     {
-      chunkSize = remaining;
+      chunkSize = QUANTIS_MAX_READ_SIZE;
     }
 
     result = QuantisRead(deviceType,
                          deviceNumber,
-                         (void *)(&inputBufferExtractor[i++ * chunkSize]),
+                         &inputBufferExtractor[offset],
                          chunkSize);
 
     if (result < 0)
@@ -250,14 +412,12 @@ int32_t QuantisExtractorGetDataFromQuantis(QuantisDeviceType deviceType,
     {
       return QUANTIS_EXT_ERROR_READ_SIZE_DIFFER_FROM_REQUESTED_SIZE;
     }
-
-    remaining -= chunkSize;
   }
 
-  QuantisExtractorGetDataFromBuffer(inputBufferExtractor,
-                                    outputBufferExtractor,
-                                    extractorMatrix,
-                                    numberOfBytesAfterExtraction);
+  QuantisExtractorCtxGetDataFromBuffer(ctx,
+                                       inputBufferExtractor,
+                                       outputBufferExtractor,
+                                       numberOfBytesAfterExtraction);
 
   // copy the number of bytes that were output by the extractor in order to provide all the bytes that the user required
   memcpy(&outputBuffer[currentOutputSize], &outputBufferExtractor[0], numberOfBytesRequested);
@@ -265,132 +425,225 @@ int32_t QuantisExtractorGetDataFromQuantis(QuantisDeviceType deviceType,
 
   if (localStorageBufferEnabled && numberOfBytesAfterExtraction > numberOfBytesRequested)
   {
-    QuantisExtractorStorageBufferAppend(&outputBufferExtractor[numberOfBytesRequested],
-                                        numberOfBytesAfterExtraction - numberOfBytesRequested);
+    QuantisExtractorCtxStorageBufferAppend(ctx,
+                                           &outputBufferExtractor[numberOfBytesRequested],
+                                           numberOfBytesAfterExtraction - numberOfBytesRequested);
   }
 
-  free(inputBufferExtractor);
-  free(outputBufferExtractor);
-
   return currentOutputSize;
 }
 
-int32_t QuantisExtractorGetDataFromFile(char *inputFilePath,
-                                        char *outputFilePath,
-                                        const uint64_t *extractorMatrix)
+/**
+ * Applies the extraction to the input file by windows of FILE_WINDOW_SIZE bytes, so
+ * that the memory used does not depend on the size of the file.
+ * @param maxOutputSize the maximal number of bytes to write, checked before creating the output file
+ * @return number of bytes written to file on success, QUANTIS_EXT_ERROR on failure
+ */
+static int64_t QuantisExtractorCtxProcessFile(QuantisExtractorCtx *ctx,
+                                              const char *inputFilePath,
+                                              const char *outputFilePath,
+                                              uint64_t maxOutputSize)
 {
-  int32_t result;          // variable for checking correctness of a function output
-  FILE *inputFileHandler;  // handler for the input file
-  FILE *outputFileHandler; // handler for the output file
-  uint32_t inputFileSize;  // number of bytes contained in the input file
-
-  uint8_t *inputBuffer;  // buffer containing the input bytes to be processed
-  uint8_t *outputBuffer; // buffer containing the output bytes that were processed
+  int64_t result = 0;             // number of bytes written or QUANTIS_EXT_ERROR code
+  FILE *inputFileHandler = NULL;  // handler for the input file
+  FILE *outputFileHandler = NULL; // handler for the output file
+  uint8_t *inputBuffer = NULL;    // current window of the input file
+  uint8_t *outputBuffer = NULL;   // processed bytes of the current window
 
-  uint32_t numberOfBytesAfterExtraction; // number of bytes that has to be produced by the extractor
+  uint32_t extractorBytesIn = QuantisExtractorCtxGetMatrixSizeIn(ctx) / 8;
+  uint32_t extractorBytesOut = QuantisExtractorCtxGetMatrixSizeOut(ctx) / 8;
+  uint32_t windowBlocks;
+  uint64_t totalBlocks;
+  uint64_t processedBlocks = 0;
+  off_t inputFileSize;
 
-  // ---------------------------------------------------------------------------------//
-  //                      FILE HANDLING AND BUFFER ALLOCATION                         //
-  // ---------------------------------------------------------------------------------//
+  if ((extractorBytesIn == 0) || (extractorBytesOut == 0))
+  {
+    return QUANTIS_EXT_ERROR_WRONG_EXTRACTION_PARAMETERS;
+  }
+  windowBlocks = FILE_WINDOW_SIZE / extractorBytesIn;
 
   inputFileHandler = fopen(inputFilePath, "rb");
-
   if (inputFileHandler == NULL)
   {
     return QUANTIS_EXT_ERROR_UNABLE_TO_OPEN_FILE;
   }
 
-  outputFileHandler = fopen(outputFilePath, "wb");
-
-  if (outputFileHandler == NULL)
+  // Get input file size (trailing bytes which do not fill a block are ignored)
+  if ((fseeko(inputFileHandler, 0, SEEK_END) != 0) ||
+      ((inputFileSize = ftello(inputFileHandler)) < 0) ||
+      (fseeko(inputFileHandler, 0, SEEK_SET) != 0))
   {
     fclose(inputFileHandler);
-    return QUANTIS_EXT_ERROR_UNABLE_TO_OPEN_FILE;
+    return QUANTIS_EXT_ERROR_UNABLE_TO_READ_FILE;
   }
+  totalBlocks = (uint64_t)inputFileSize / extractorBytesIn;
 
-  // Get input file size
-  fseek(inputFileHandler, 0, SEEK_END);
-  inputFileSize = ftell(inputFileHandler);
-  rewind(inputFileHandler);
-
-  // Allocate memory to contain the whole input file
-  inputBuffer = malloc(inputFileSize);
-  if (inputBuffer == NULL)
+  if (totalBlocks < 1)
   {
     fclose(inputFileHandler);
-    fclose(outputFileHandler);
-    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+    return QUANTIS_EXT_ERROR_NOT_ENOUGH_INPUT_BYTES;
   }
-
-  // Copy the input file into the input buffer
-  result = (int32_t)fread(inputBuffer, 1, inputFileSize, inputFileHandler);
-  if (result != (int32_t)inputFileSize)
+  if (totalBlocks * extractorBytesOut > maxOutputSize)
   {
     fclose(inputFileHandler);
-    fclose(outputFileHandler);
-    return QUANTIS_EXT_ERROR_READ_SIZE_DIFFER_FROM_REQUESTED_SIZE;
+    return QUANTIS_EXT_ERROR_OUTPUT_TOO_LARGE;
+  }
+  if (windowBlocks > totalBlocks)
+  {
+    windowBlocks = (uint32_t)totalBlocks;
   }
 
-  // initialize the output buffer and get the number of blocks to process (or a QUANTIS_ERROR code)
-  result = QuantisExtractorInitializeOutputBuffer(inputFileSize, &outputBuffer);
-
-  if (result < 0)
+  outputFileHandler = fopen(outputFilePath, "wb");
+  if (outputFileHandler == NULL)
   {
     fclose(inputFileHandler);
-    fclose(outputFileHandler);
-    return result;
+    return QUANTIS_EXT_ERROR_UNABLE_TO_OPEN_FILE;
   }
-  else
+
+  inputBuffer = malloc((size_t)windowBlocks * extractorBytesIn);
+  outputBuffer = malloc((size_t)windowBlocks * extractorBytesOut);
+  if ((inputBuffer == NULL) || (outputBuffer == NULL))
   {
-    numberOfBytesAfterExtraction = (uint32_t)result;
+    result = QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+    goto cleanup;
   }
 
-  // apply the Troyer-Renner post-processing to the input buffer and store the result into the output buffer
-  QuantisExtractorGetDataFromBuffer(inputBuffer,
-                                    outputBuffer,
-                                    extractorMatrix,
-                                    numberOfBytesAfterExtraction);
+  while (processedBlocks < totalBlocks)
+  {
+    uint32_t blocks = windowBlocks;
+    if (blocks > totalBlocks - processedBlocks)
+    {
+      blocks = (uint32_t)(totalBlocks - processedBlocks);
+    }
 
-  // write the processed bytes to file
-  result = (int32_t)fwrite(outputBuffer, numberOfBytesAfterExtraction, sizeof(uint8_t), outputFileHandler);
+    if (fread(inputBuffer, extractorBytesIn, blocks, inputFileHandler) != blocks)
+    {
+      result = QUANTIS_EXT_ERROR_READ_SIZE_DIFFER_FROM_REQUESTED_SIZE;
+      goto cleanup;
+    }
 
-  if (result < 0)
-  {
-    fclose(inputFileHandler);
-    fclose(outputFileHandler);
-    return QUANTIS_EXT_ERROR_UNABLE_TO_WRITE_FILE;
+    // apply the Troyer-Renner post-processing to the window
+    QuantisExtractorCtxGetDataFromBuffer(ctx,
+                                         inputBuffer,
+                                         outputBuffer,
+                                         blocks * extractorBytesOut);
+
+    // write the processed bytes to file
+    if (fwrite(outputBuffer, extractorBytesOut, blocks, outputFileHandler) != blocks)
+    {
+      result = QUANTIS_EXT_ERROR_UNABLE_TO_WRITE_FILE;
+      goto cleanup;
+    }
+
+    processedBlocks += blocks;
   }
 
-  QuantisExtractorUnitializeOutputBuffer(&outputBuffer);
+  result = (int64_t)(totalBlocks * extractorBytesOut);
 
+cleanup:
+  free(inputBuffer);
+  free(outputBuffer);
   fclose(inputFileHandler);
-  fclose(outputFileHandler);
+  if ((fclose(outputFileHandler) != 0) && (result >= 0))
+  {
+    result = QUANTIS_EXT_ERROR_UNABLE_TO_WRITE_FILE;
+  }
 
-  return numberOfBytesAfterExtraction;
+  return result;
 }
 
-void QuantisExtractorGetDataFromBuffer(const uint8_t *inputBuffer,
-                                       uint8_t *outputBuffer,
-                                       const uint64_t *extractorMatrix,
-                                       uint32_t numberOfBytesAfterExtraction)
+int32_t QuantisExtractorCtxGetDataFromFile(QuantisExtractorCtx *ctx,
+                                           char *inputFilePath,
+                                           char *outputFilePath)
+{
+  return (int32_t)QuantisExtractorCtxProcessFile(ctx, inputFilePath, outputFilePath, INT32_MAX);
+}
+
+int64_t QuantisExtractorCtxGetDataFromFile64(QuantisExtractorCtx *ctx,
+                                             const char *inputFilePath,
+                                             const char *outputFilePath)
+{
+  return QuantisExtractorCtxProcessFile(ctx, inputFilePath, outputFilePath, UINT64_MAX);
+}
 
+/**
+ * Processes a range of consecutive blocks.
+ */
+static void *QuantisExtractorWorkerRun(void *arg)
 {
+  QuantisExtractorWorker *worker = (QuantisExtractorWorker *)arg;
+  uint32_t elementsExtractorInput = QuantisExtractorCtxGetMatrixSizeIn(worker->ctx) / 64;
+  uint32_t elementsExtractorOutput = QuantisExtractorCtxGetMatrixSizeOut(worker->ctx) / 64;
   uint32_t i;
-  uint32_t elementsExtractorInput = QuantisExtractorGetMatrixSizeIn() / 64;
-  uint32_t elementsExtractorOutput = QuantisExtractorGetMatrixSizeOut() / 64;
 
-  uint64_t *inputBuffer64 = (uint64_t *)inputBuffer;
-  uint64_t *outputBuffer64 = (uint64_t *)outputBuffer;
+  for (i = 0; i < worker->blocksCount; i++)
+  {
+    // perform the extraction on the current chunk of the input buffer and store the result in the output buffer
+    QuantisExtractorCtxProcessBlock(worker->ctx,
+                                    &worker->inputBuffer[(size_t)i * elementsExtractorInput],
+                                    &worker->outputBuffer[(size_t)i * elementsExtractorOutput]);
+  }
+
+  return NULL;
+}
+
+void QuantisExtractorCtxGetDataFromBuffer(QuantisExtractorCtx *ctx,
+                                          const uint8_t *inputBuffer,
+                                          uint8_t *outputBuffer,
+                                          uint32_t numberOfBytesAfterExtraction)
 
-  uint32_t numberOfBlocksToProcess = numberOfBytesAfterExtraction / (QuantisExtractorGetMatrixSizeOut() / 8);
+{
+  QuantisExtractorWorker workers[MAX_EXTRACTION_THREADS];
+  uint32_t elementsExtractorInput = QuantisExtractorCtxGetMatrixSizeIn(ctx) / 64;
+  uint32_t elementsExtractorOutput = QuantisExtractorCtxGetMatrixSizeOut(ctx) / 64;
+  uint32_t numberOfBlocksToProcess = numberOfBytesAfterExtraction / (QuantisExtractorCtxGetMatrixSizeOut(ctx) / 8);
+  uint32_t threadsCount = ctx->threadsCount;
+  uint32_t startedThreads;
+  uint32_t firstBlock = 0;
+  uint32_t i;
 
-  // apply post-processing to the read block
-  for (i = 0; i < numberOfBlocksToProcess; i++)
+  // split the blocks in contiguous ranges, each block of the output only depends on the same block of the input
+  if (threadsCount > numberOfBlocksToProcess / MIN_BLOCKS_PER_THREAD)
   {
-    // perform the extraction on the current chunk of the input buffer and store the result in the output buffer
-    QuantisExtractorProcessBlock(&inputBuffer64[i * elementsExtractorInput],
-                                 &outputBuffer64[i * elementsExtractorOutput],
-                                 extractorMatrix);
+    threadsCount = numberOfBlocksToProcess / MIN_BLOCKS_PER_THREAD;
+  }
+  if (threadsCount < 1)
+  {
+    threadsCount = 1;
+  }
+
+  for (i = 0; i < threadsCount; i++)
+  {
+    uint32_t lastBlock = (uint32_t)((uint64_t)numberOfBlocksToProcess * (i + 1) / threadsCount);
+
+    workers[i].ctx = ctx;
+    workers[i].inputBuffer = (const uint64_t *)inputBuffer + (size_t)firstBlock * elementsExtractorInput;
+    workers[i].outputBuffer = (uint64_t *)outputBuffer + (size_t)firstBlock * elementsExtractorOutput;
+    workers[i].blocksCount = lastBlock - firstBlock;
+    firstBlock = lastBlock;
+  }
+
+  // the calling thread processes the first range itself
+  for (startedThreads = 1; startedThreads < threadsCount; startedThreads++)
+  {
+    if (pthread_create(&workers[startedThreads].thread, NULL, QuantisExtractorWorkerRun, &workers[startedThreads]) != 0)
+    {
+      break;
+    }
+  }
+
+  QuantisExtractorWorkerRun(&workers[0]);
+
+  // ranges whose thread could not be started
+  for (i = startedThreads; i < threadsCount; i++)
+  {
+    QuantisExtractorWorkerRun(&workers[i]);
+  }
+
+  for (i = 1; i < startedThreads; i++)
+  {
+    pthread_join(workers[i].thread, NULL);
   }
 }
 
@@ -398,42 +651,65 @@ void QuantisExtractorGetDataFromBuffer(const uint8_t *inputBuffer,
 /**                                LOWER LEVEL FUNCTIONS                                */
 /** ----------------------------------------------------------------------------------- */
 
-uint16_t QuantisExtractorGetMatrixSizeIn()
+uint16_t QuantisExtractorCtxGetMatrixSizeIn(QuantisExtractorCtx *ctx)
 {
-  return (g_n);
+  return (ctx->n);
 }
 
-uint16_t QuantisExtractorGetMatrixSizeOut()
+uint16_t QuantisExtractorCtxGetMatrixSizeOut(QuantisExtractorCtx *ctx)
 {
-  return (g_k);
+  return (ctx->k);
 }
 
-int32_t QuantisExtractorComputeBufferSize(uint32_t numberOfBytesRequested,
-                                          uint32_t *numberOfBytesAfterExtraction,
-                                          uint32_t *numberOfBytesBeforeExtraction)
+void QuantisExtractorCtxSetThreads(QuantisExtractorCtx *ctx,
+                                   uint32_t threadsCount)
+{
+  if (threadsCount == 0)
+  {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    threadsCount = (processors > 0) ? (uint32_t)processors : 1;
+  }
+  if (threadsCount > MAX_EXTRACTION_THREADS)
+  {
+    threadsCount = MAX_EXTRACTION_THREADS;
+  }
+
+  ctx->threadsCount = threadsCount;
+}
+
+uint32_t QuantisExtractorCtxGetThreads(QuantisExtractorCtx *ctx)
+{
+  return ctx->threadsCount;
+}
+
+int32_t QuantisExtractorCtxComputeBufferSize(QuantisExtractorCtx *ctx,
+                                             uint32_t numberOfBytesRequested,
+                                             uint32_t *numberOfBytesAfterExtraction,
+                                             uint32_t *numberOfBytesBeforeExtraction)
 {
   uint32_t numberOfBlocksToProcess;
 
-  if (QuantisExtractorGetMatrixSizeOut() == 0)
+  if (QuantisExtractorCtxGetMatrixSizeOut(ctx) == 0)
   {
     return QUANTIS_EXT_ERROR_WRONG_EXTRACTION_PARAMETERS;
   }
 
-  numberOfBlocksToProcess = (uint32_t)ceil((double)(numberOfBytesRequested * 8) / QuantisExtractorGetMatrixSizeOut());
-  *numberOfBytesAfterExtraction = numberOfBlocksToProcess * (QuantisExtractorGetMatrixSizeOut() / 8);
-  *numberOfBytesBeforeExtraction = numberOfBlocksToProcess * (QuantisExtractorGetMatrixSizeIn() / 64) * 8;
+  numberOfBlocksToProcess = (uint32_t)ceil((double)(numberOfBytesRequested * 8) / QuantisExtractorCtxGetMatrixSizeOut(ctx));
+  *numberOfBytesAfterExtraction = numberOfBlocksToProcess * (QuantisExtractorCtxGetMatrixSizeOut(ctx) / 8);
+  *numberOfBytesBeforeExtraction = numberOfBlocksToProcess * (QuantisExtractorCtxGetMatrixSizeIn(ctx) / 64) * 8;
 
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorInitializeOutputBuffer(uint32_t inputBufferSize,
-                                               uint8_t **outputBuffer)
+int32_t QuantisExtractorCtxInitializeOutputBuffer(QuantisExtractorCtx *ctx,
+                                                  uint32_t inputBufferSize,
+                                                  uint8_t **outputBuffer)
 {
   uint32_t numberOfBlocksToProcess;
   uint32_t numberOfBytesAfterExtraction;
 
-  uint16_t extractorBytesIn = (QuantisExtractorGetMatrixSizeIn() / 8);
-  uint16_t extractorBytesOut = (QuantisExtractorGetMatrixSizeOut() / 8);
+  uint16_t extractorBytesIn = (QuantisExtractorCtxGetMatrixSizeIn(ctx) / 8);
+  uint16_t extractorBytesOut = (QuantisExtractorCtxGetMatrixSizeOut(ctx) / 8);
 
   if ((inputBufferSize / extractorBytesIn < 1))
   {
@@ -464,40 +740,18 @@ void QuantisExtractorUnitializeOutputBuffer(uint8_t **outputBuffer)
   }
 }
 
-void QuantisExtractorProcessBlock(const uint64_t *inputBuffer,
-                                  uint64_t *outputBuffer,
-                                  const uint64_t *extractorMatrix)
+void QuantisExtractorCtxProcessBlock(QuantisExtractorCtx *ctx,
+                                     const uint64_t *inputBuffer,
+                                     uint64_t *outputBuffer)
 {
-  int index = 0;
-  uint32_t i;
-  unsigned int j;
-  unsigned int l;
-
-  // do a matrix-vector multiplication by looping over all rows
-  // the outer loop over all words
-
-  for (i = 0; i < (uint32_t)(g_k / 64); ++i)
+  if (ctx->tables && (ctx->tablesGeneration == ctx->matrixGeneration))
   {
-    outputBuffer[i] = 0;
-
-    // the inner loop over all bits in the word
-    for (j = 0; j < 64; ++j)
-    {
-      uint64_t parity = extractorMatrix[index++] & inputBuffer[0];
-
-      // do it as a vector-vector multiplication using bit operations
-      for (l = 1; l < (uint32_t)(g_n / 64); ++l)
-      {
-        parity ^= extractorMatrix[index++] & inputBuffer[l];
-      }
-
-      // finally count the bit parity
-      parity ^= parity >> 1;
-      parity ^= parity >> 2;
-      parity = (parity & 0x1111111111111111UL) * 0x1111111111111111UL;
-      // and set the j-th output bit of the i-th output word
-      outputBuffer[i] |= ((parity >> 60) & 1) << j;
-    }
+    QuantisExtractorKernelRun(QuantisExtractorKernelGetDefault(), ctx->tables, inputBuffer, outputBuffer);
+  }
+  else
+  {
+    // matrix not loaded with QuantisExtractorInitializeMatrix nor QuantisExtractorCtxCreate
+    QuantisExtractorKernelScalar(inputBuffer, outputBuffer, ctx->matrix, ctx->n, ctx->k);
   }
 }
 
@@ -881,145 +1135,185 @@ uint32_t QuantisExtractorMatrixProcessBufferVonNeumann(uint8_t *inputBuffer,
 /**                              STORAGE BUFFER MANAGEMENT                              */
 /** ----------------------------------------------------------------------------------- */
 
-int32_t QuantisExtractorStorageBufferEnable()
+int32_t QuantisExtractorCtxStorageBufferEnableWithCapacity(QuantisExtractorCtx *ctx,
+                                                           uint32_t capacity)
 {
-  g_storageBufferEnabled = 1;
+  uint32_t roundedCapacity = 1;
+  uint8_t *storageBuffer;
 
-  g_storageBuffer = malloc(MAX_STORAGE_BUFFER_SIZE);
+  if (capacity == 0)
+  {
+    capacity = DEFAULT_STORAGE_BUFFER_CAPACITY;
+  }
+  if (capacity > MAX_STORAGE_BUFFER_CAPACITY)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+  while (roundedCapacity < capacity)
+  {
+    roundedCapacity <<= 1;
+  }
 
-  if (g_storageBuffer == NULL)
+  storageBuffer = malloc(roundedCapacity);
+  if (storageBuffer == NULL)
   {
     return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
   }
-  g_storageBufferSize = 0;
+
+  // enabling again drops the stored bytes
+  free(ctx->storageBuffer);
+  ctx->storageBuffer = storageBuffer;
+  ctx->storageBufferCapacity = roundedCapacity;
+  ctx->storageBufferHead = 0;
+  ctx->storageBufferTail = 0;
+  ctx->storageBufferEnabled = 1;
 
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorStorageBufferDisable()
+int32_t QuantisExtractorCtxStorageBufferEnable(QuantisExtractorCtx *ctx)
+{
+  return QuantisExtractorCtxStorageBufferEnableWithCapacity(ctx, DEFAULT_STORAGE_BUFFER_CAPACITY);
+}
+
+int32_t QuantisExtractorCtxStorageBufferDisable(QuantisExtractorCtx *ctx)
 {
-  if (!g_storageBufferEnabled)
+  if (!ctx->storageBufferEnabled)
   {
     return QUANTIS_EXT_ERROR_STORAGE_BUFFER_DISABLED;
   }
 
-  g_storageBufferEnabled = 0;
-  g_storageBufferSize = 0;
-  free(g_storageBuffer);
+  ctx->storageBufferEnabled = 0;
+  ctx->storageBufferCapacity = 0;
+  ctx->storageBufferHead = 0;
+  ctx->storageBufferTail = 0;
+  free(ctx->storageBuffer);
+  ctx->storageBuffer = NULL;
 
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorStorageBufferClear()
+int32_t QuantisExtractorCtxStorageBufferClear(QuantisExtractorCtx *ctx)
 {
-  if (!g_storageBufferEnabled)
+  if (!ctx->storageBufferEnabled)
   {
     return QUANTIS_EXT_ERROR_STORAGE_BUFFER_DISABLED;
   }
 
-  free(g_storageBuffer);
-
-  g_storageBufferSize = 0;
-  g_storageBuffer = malloc(MAX_STORAGE_BUFFER_SIZE);
-
-  if (g_storageBuffer == NULL)
-  {
-    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
-  }
+  ctx->storageBufferTail = ctx->storageBufferHead;
 
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorStorageBufferSet(uint8_t *bufferToCopy,
-                                         uint32_t bytesToCopy)
+int32_t QuantisExtractorCtxStorageBufferSet(QuantisExtractorCtx *ctx,
+                                            uint8_t *bufferToCopy,
+                                            uint32_t bytesToCopy)
 {
-  if (!g_storageBufferEnabled)
+  if (!ctx->storageBufferEnabled)
   {
     return QUANTIS_EXT_ERROR_STORAGE_BUFFER_DISABLED;
   }
 
-  if (bytesToCopy > MAX_STORAGE_BUFFER_SIZE)
-  {
-    bytesToCopy = MAX_STORAGE_BUFFER_SIZE;
-  }
-
-  memcpy(g_storageBuffer, bufferToCopy, bytesToCopy);
-  g_storageBufferSize = bytesToCopy;
+  ctx->storageBufferHead = 0;
+  ctx->storageBufferTail = 0;
 
-  return QUANTIS_SUCCESS;
+  return QuantisExtractorCtxStorageBufferAppend(ctx, bufferToCopy, bytesToCopy);
 }
 
-int32_t QuantisExtractorStorageBufferAppend(uint8_t *bufferToAppend,
-                                            uint32_t bytesToAppend)
+int32_t QuantisExtractorCtxStorageBufferAppend(QuantisExtractorCtx *ctx,
+                                               uint8_t *bufferToAppend,
+                                               uint32_t bytesToAppend)
 {
-  if (!g_storageBufferEnabled)
+  uint32_t offset;
+  uint32_t firstPart;
+
+  if (!ctx->storageBufferEnabled)
   {
     return QUANTIS_EXT_ERROR_STORAGE_BUFFER_DISABLED;
   }
 
-  if ((g_storageBufferSize + bytesToAppend) > MAX_STORAGE_BUFFER_SIZE)
+  if (bytesToAppend > ctx->storageBufferCapacity - QuantisExtractorCtxStorageBufferGetSize(ctx))
   {
-    bytesToAppend = MAX_STORAGE_BUFFER_SIZE - g_storageBufferSize;
+    bytesToAppend = ctx->storageBufferCapacity - QuantisExtractorCtxStorageBufferGetSize(ctx);
   }
 
-  memcpy(&g_storageBuffer[g_storageBufferSize], bufferToAppend, bytesToAppend);
-  g_storageBufferSize += bytesToAppend;
+  // copy up to the end of the buffer, then from its beginning
+  offset = ctx->storageBufferHead & (ctx->storageBufferCapacity - 1);
+  firstPart = ctx->storageBufferCapacity - offset;
+  if (firstPart > bytesToAppend)
+  {
+    firstPart = bytesToAppend;
+  }
+  memcpy(&ctx->storageBuffer[offset], bufferToAppend, firstPart);
+  memcpy(ctx->storageBuffer, &bufferToAppend[firstPart], bytesToAppend - firstPart);
+  ctx->storageBufferHead += bytesToAppend;
 
   return bytesToAppend;
 }
 
-int32_t QuantisExtractorStorageBufferRead(uint8_t *outputBuffer,
-                                          uint32_t numberOfBytesRequested)
+int32_t QuantisExtractorCtxStorageBufferRead(QuantisExtractorCtx *ctx,
+                                             uint8_t *outputBuffer,
+                                             uint32_t numberOfBytesRequested)
 {
-  if (!g_storageBufferEnabled)
+  uint32_t offset;
+  uint32_t firstPart;
+
+  if (!ctx->storageBufferEnabled)
   {
     return QUANTIS_EXT_ERROR_STORAGE_BUFFER_DISABLED;
   }
 
-  if (g_storageBufferSize < numberOfBytesRequested)
+  if (QuantisExtractorCtxStorageBufferGetSize(ctx) < numberOfBytesRequested)
   {
     return QUANTIS_EXT_ERROR_NOT_ENOUGH_BYTES_IN_STORAGE_BUFFER;
   }
 
-  memcpy(outputBuffer, g_storageBuffer, numberOfBytesRequested);
-  g_storageBufferSize -= numberOfBytesRequested;
-
-  // if there are still some bytes in the storageBuffer, shift them in the first positions of the array
-  if (g_storageBufferSize)
+  // copy up to the end of the buffer, then from its beginning
+  offset = ctx->storageBufferTail & (ctx->storageBufferCapacity - 1);
+  firstPart = ctx->storageBufferCapacity - offset;
+  if (firstPart > numberOfBytesRequested)
   {
-    QuantisExtractorStorageBufferSet(&g_storageBuffer[numberOfBytesRequested], g_storageBufferSize);
+    firstPart = numberOfBytesRequested;
   }
+  memcpy(outputBuffer, &ctx->storageBuffer[offset], firstPart);
+  memcpy(&outputBuffer[firstPart], ctx->storageBuffer, numberOfBytesRequested - firstPart);
+  ctx->storageBufferTail += numberOfBytesRequested;
 
   return QUANTIS_SUCCESS;
 }
 
-uint32_t QuantisExtractorStorageBufferGetSize()
+uint32_t QuantisExtractorCtxStorageBufferGetSize(QuantisExtractorCtx *ctx)
 {
-  return g_storageBufferSize;
+  return ctx->storageBufferHead - ctx->storageBufferTail;
 }
 
-uint8_t QuantisExtractorStorageBufferIsEnabled()
+uint32_t QuantisExtractorCtxStorageBufferGetCapacity(QuantisExtractorCtx *ctx)
+{
+  return ctx->storageBufferCapacity;
+}
+
+uint8_t QuantisExtractorCtxStorageBufferIsEnabled(QuantisExtractorCtx *ctx)
 {
-  return g_storageBufferEnabled;
+  return ctx->storageBufferEnabled;
 }
 
 /** ----------------------------------------------------------------------------------- */
 /**                                       READ OPTIONS                                  */
 /** ----------------------------------------------------------------------------------- */
 
-int32_t QuantisExtractorReadDouble_01(QuantisDeviceType deviceType,
-                                      unsigned int deviceNumber,
-                                      double *value,
-                                      const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadDouble_01(QuantisExtractorCtx *ctx,
+                                         QuantisDeviceType deviceType,
+                                         unsigned int deviceNumber,
+                                         double *value)
 {
   int size = sizeof(*value);
   uint8_t buffer[QUANTIS_EXTENSIONS_READ_XXX_BUFFER_SIZE];
 
-  int32_t result = QuantisExtractorGetDataFromQuantis(deviceType,
-                                                      deviceNumber,
-                                                      buffer,
-                                                      size,
-                                                      extractorMatrix);
+  int32_t result = QuantisExtractorCtxGetDataFromQuantis(ctx,
+                                                         deviceType,
+                                                         deviceNumber,
+                                                         buffer,
+                                                         size);
   if (result < 0)
   {
     return result;
@@ -1034,19 +1328,19 @@ int32_t QuantisExtractorReadDouble_01(QuantisDeviceType deviceType,
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorReadFloat_01(QuantisDeviceType deviceType,
-                                     unsigned int deviceNumber,
-                                     float *value,
-                                     const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadFloat_01(QuantisExtractorCtx *ctx,
+                                        QuantisDeviceType deviceType,
+                                        unsigned int deviceNumber,
+                                        float *value)
 {
   int size = sizeof(*value);
   uint8_t buffer[QUANTIS_EXTENSIONS_READ_XXX_BUFFER_SIZE];
 
-  int32_t result = QuantisExtractorGetDataFromQuantis(deviceType,
-                                                      deviceNumber,
-                                                      buffer,
-                                                      size,
-                                                      extractorMatrix);
+  int32_t result = QuantisExtractorCtxGetDataFromQuantis(ctx,
+                                                         deviceType,
+                                                         deviceNumber,
+                                                         buffer,
+                                                         size);
   if (result < 0)
   {
     return result;
@@ -1061,19 +1355,19 @@ int32_t QuantisExtractorReadFloat_01(QuantisDeviceType deviceType,
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorReadInt(QuantisDeviceType deviceType,
-                                unsigned int deviceNumber,
-                                int *value,
-                                const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadInt(QuantisExtractorCtx *ctx,
+                                   QuantisDeviceType deviceType,
+                                   unsigned int deviceNumber,
+                                   int *value)
 {
   int size = sizeof(*value);
   uint8_t buffer[QUANTIS_EXTENSIONS_READ_XXX_BUFFER_SIZE];
 
-  int32_t result = QuantisExtractorGetDataFromQuantis(deviceType,
-                                                      deviceNumber,
-                                                      buffer,
-                                                      size,
-                                                      extractorMatrix);
+  int32_t result = QuantisExtractorCtxGetDataFromQuantis(ctx,
+                                                         deviceType,
+                                                         deviceNumber,
+                                                         buffer,
+                                                         size);
   if (result < 0)
   {
     return result;
@@ -1088,19 +1382,19 @@ int32_t QuantisExtractorReadInt(QuantisDeviceType deviceType,
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorReadShort(QuantisDeviceType deviceType,
-                                  unsigned int deviceNumber,
-                                  short *value,
-                                  const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadShort(QuantisExtractorCtx *ctx,
+                                     QuantisDeviceType deviceType,
+                                     unsigned int deviceNumber,
+                                     short *value)
 {
   int size = sizeof(*value);
   uint8_t buffer[QUANTIS_EXTENSIONS_READ_XXX_BUFFER_SIZE];
 
-  int32_t result = QuantisExtractorGetDataFromQuantis(deviceType,
-                                                      deviceNumber,
-                                                      buffer,
-                                                      size,
-                                                      extractorMatrix);
+  int32_t result = QuantisExtractorCtxGetDataFromQuantis(ctx,
+                                                         deviceType,
+                                                         deviceNumber,
+                                                         buffer,
+                                                         size);
   if (result < 0)
   {
     return result;
@@ -1115,12 +1409,12 @@ int32_t QuantisExtractorReadShort(QuantisDeviceType deviceType,
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorReadScaledDouble(QuantisDeviceType deviceType,
-                                         unsigned int deviceNumber,
-                                         double *value,
-                                         double min,
-                                         double max,
-                                         const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadScaledDouble(QuantisExtractorCtx *ctx,
+                                            QuantisDeviceType deviceType,
+                                            unsigned int deviceNumber,
+                                            double *value,
+                                            double min,
+                                            double max)
 {
   double tmp;
   int32_t result;
@@ -1130,10 +1424,10 @@ int32_t QuantisExtractorReadScaledDouble(QuantisDeviceType deviceType,
     return QUANTIS_ERROR_INVALID_PARAMETER;
   }
 
-  result = QuantisExtractorReadDouble_01(deviceType,
-                                         deviceNumber,
-                                         &tmp,
-                                         extractorMatrix);
+  result = QuantisExtractorCtxReadDouble_01(ctx,
+                                            deviceType,
+                                            deviceNumber,
+                                            &tmp);
   if (result != QUANTIS_SUCCESS)
   {
     return result;
@@ -1144,12 +1438,12 @@ int32_t QuantisExtractorReadScaledDouble(QuantisDeviceType deviceType,
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorReadScaledFloat(QuantisDeviceType deviceType,
-                                        unsigned int deviceNumber,
-                                        float *value,
-                                        float min,
-                                        float max,
-                                        const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadScaledFloat(QuantisExtractorCtx *ctx,
+                                           QuantisDeviceType deviceType,
+                                           unsigned int deviceNumber,
+                                           float *value,
+                                           float min,
+                                           float max)
 {
   float tmp;
   int32_t result;
@@ -1159,10 +1453,10 @@ int32_t QuantisExtractorReadScaledFloat(QuantisDeviceType deviceType,
     return QUANTIS_ERROR_INVALID_PARAMETER;
   }
 
-  result = QuantisExtractorReadFloat_01(deviceType,
-                                        deviceNumber,
-                                        &tmp,
-                                        extractorMatrix);
+  result = QuantisExtractorCtxReadFloat_01(ctx,
+                                           deviceType,
+                                           deviceNumber,
+                                           &tmp);
   if (result != QUANTIS_SUCCESS)
   {
     return result;
@@ -1173,79 +1467,289 @@ int32_t QuantisExtractorReadScaledFloat(QuantisDeviceType deviceType,
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorReadScaledInt(QuantisDeviceType deviceType,
-                                      unsigned int deviceNumber,
-                                      int *value,
-                                      int min,
-                                      int max,
-                                      const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadScaledInt(QuantisExtractorCtx *ctx,
+                                         QuantisDeviceType deviceType,
+                                         unsigned int deviceNumber,
+                                         int *value,
+                                         int min,
+                                         int max)
 {
   int tmp;
   int32_t result;
 
-  const int BITS = sizeof(tmp) * 8;
-  const unsigned long long RANGE = max - min + 1;
-  const unsigned long long MAX_RANGE = 1ull << BITS;
-  const unsigned long long LIMIT = MAX_RANGE - (MAX_RANGE % RANGE);
-
   if (min > max)
   {
     return QUANTIS_ERROR_INVALID_PARAMETER;
   }
 
-  // Chooses the highest number that is the largest multiple of the output range
-  // (discard values higher the output range)
+  // Discards the random numbers which would bias the output range
   do
   {
-    result = QuantisExtractorReadInt(deviceType,
-                                     deviceNumber,
-                                     &tmp,
-                                     extractorMatrix);
+    result = QuantisExtractorCtxReadInt(ctx,
+                                        deviceType,
+                                        deviceNumber,
+                                        &tmp);
     if (result != QUANTIS_SUCCESS)
     {
       return result;
     }
-  } while ((tmp > 0) && ((unsigned long long)tmp >= LIMIT));
+  } while (ConvertToScaledIntArray(&tmp, 1, min, max) == 0);
 
-  *value = (tmp % RANGE) + min;
+  *value = tmp;
 
   return QUANTIS_SUCCESS;
 }
 
-int32_t QuantisExtractorReadScaledShort(QuantisDeviceType deviceType,
-                                        unsigned int deviceNumber,
-                                        short *value,
-                                        short min,
-                                        short max,
-                                        const uint64_t *extractorMatrix)
+int32_t QuantisExtractorCtxReadScaledShort(QuantisExtractorCtx *ctx,
+                                           QuantisDeviceType deviceType,
+                                           unsigned int deviceNumber,
+                                           short *value,
+                                           short min,
+                                           short max)
 {
   short tmp;
   int32_t result;
-  const int BITS = sizeof(tmp) * 8;
-  const unsigned int RANGE = max - min + 1;
-  const unsigned int MAX_RANGE = 1u << BITS;
-  const unsigned int LIMIT = MAX_RANGE - (MAX_RANGE % RANGE);
 
   if (min > max)
   {
     return QUANTIS_ERROR_INVALID_PARAMETER;
   }
 
-  // Chooses the highest number that is the largest multiple of the output range
-  // (discard values higher the output range)
+  // Discards the random numbers which would bias the output range
   do
   {
-    result = QuantisExtractorReadShort(deviceType,
-                                       deviceNumber,
-                                       &tmp,
-                                       extractorMatrix);
+    result = QuantisExtractorCtxReadShort(ctx,
+                                          deviceType,
+                                          deviceNumber,
+                                          &tmp);
     if (result != QUANTIS_SUCCESS)
     {
       return result;
     }
-  } while ((tmp > 0) && ((unsigned int)tmp >= LIMIT));
+  } while (ConvertToScaledShortArray(&tmp, 1, min, max) == 0);
 
-  *value = (tmp % RANGE) + min;
+  *value = tmp;
+
+  return QUANTIS_SUCCESS;
+}
+
+/**
+ * Fills <em>buffer</em> with <em>count</em> extracted values of <em>valueSize</em> bytes,
+ * by windows of at most READ_VALUES_WINDOW_SIZE bytes.
+ * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+ */
+static int32_t QuantisExtractorCtxReadValues(QuantisExtractorCtx *ctx,
+                                             QuantisDeviceType deviceType,
+                                             unsigned int deviceNumber,
+                                             void *buffer,
+                                             size_t count,
+                                             size_t valueSize)
+{
+  size_t size = count * valueSize;
+  size_t offset;
+  uint32_t windowSize;
+  int32_t result;
+
+  if (((buffer == NULL) && (count > 0)) || (count > (size_t)-1 / valueSize))
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  for (offset = 0; offset < size; offset += windowSize)
+  {
+    windowSize = (size - offset > READ_VALUES_WINDOW_SIZE) ? READ_VALUES_WINDOW_SIZE : (uint32_t)(size - offset);
+
+    result = QuantisExtractorCtxGetDataFromQuantis(ctx,
+                                                   deviceType,
+                                                   deviceNumber,
+                                                   (uint8_t *)buffer + offset,
+                                                   windowSize);
+    if (result < 0)
+    {
+      return result;
+    }
+    else if ((uint32_t)result != windowSize)
+    {
+      return QUANTIS_ERROR_IO;
+    }
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int32_t QuantisExtractorCtxReadDoubles_01(QuantisExtractorCtx *ctx,
+                                          QuantisDeviceType deviceType,
+                                          unsigned int deviceNumber,
+                                          double *values,
+                                          size_t count)
+{
+  int32_t result = QuantisExtractorCtxReadValues(ctx, deviceType, deviceNumber, values, count, sizeof(*values));
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  ConvertToDoubleArray_01(values, (const char *)values, count);
+
+  return QUANTIS_SUCCESS;
+}
+
+int32_t QuantisExtractorCtxReadFloats_01(QuantisExtractorCtx *ctx,
+                                         QuantisDeviceType deviceType,
+                                         unsigned int deviceNumber,
+                                         float *values,
+                                         size_t count)
+{
+  int32_t result = QuantisExtractorCtxReadValues(ctx, deviceType, deviceNumber, values, count, sizeof(*values));
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  ConvertToFloatArray_01(values, (const char *)values, count);
+
+  return QUANTIS_SUCCESS;
+}
+
+int32_t QuantisExtractorCtxReadInts(QuantisExtractorCtx *ctx,
+                                    QuantisDeviceType deviceType,
+                                    unsigned int deviceNumber,
+                                    int *values,
+                                    size_t count)
+{
+  // extracted bytes are random ints, no conversion needed
+  return QuantisExtractorCtxReadValues(ctx, deviceType, deviceNumber, values, count, sizeof(*values));
+}
+
+int32_t QuantisExtractorCtxReadShorts(QuantisExtractorCtx *ctx,
+                                      QuantisDeviceType deviceType,
+                                      unsigned int deviceNumber,
+                                      short *values,
+                                      size_t count)
+{
+  return QuantisExtractorCtxReadValues(ctx, deviceType, deviceNumber, values, count, sizeof(*values));
+}
+
+int32_t QuantisExtractorCtxReadScaledDoubles(QuantisExtractorCtx *ctx,
+                                             QuantisDeviceType deviceType,
+                                             unsigned int deviceNumber,
+                                             double *values,
+                                             size_t count,
+                                             double min,
+                                             double max)
+{
+  const double range = max - min;
+  size_t i;
+  int32_t result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  result = QuantisExtractorCtxReadDoubles_01(ctx, deviceType, deviceNumber, values, count);
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    values[i] = values[i] * range + min;
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int32_t QuantisExtractorCtxReadScaledFloats(QuantisExtractorCtx *ctx,
+                                            QuantisDeviceType deviceType,
+                                            unsigned int deviceNumber,
+                                            float *values,
+                                            size_t count,
+                                            float min,
+                                            float max)
+{
+  const float range = max - min;
+  size_t i;
+  int32_t result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  result = QuantisExtractorCtxReadFloats_01(ctx, deviceType, deviceNumber, values, count);
+  if (result != QUANTIS_SUCCESS)
+  {
+    return result;
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    values[i] = values[i] * range + min;
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int32_t QuantisExtractorCtxReadScaledInts(QuantisExtractorCtx *ctx,
+                                          QuantisDeviceType deviceType,
+                                          unsigned int deviceNumber,
+                                          int *values,
+                                          size_t count,
+                                          int min,
+                                          int max)
+{
+  size_t done = 0;
+  int32_t result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  // Values discarded to avoid a bias are read again, all at once
+  while (done < count)
+  {
+    result = QuantisExtractorCtxReadInts(ctx, deviceType, deviceNumber, values + done, count - done);
+    if (result != QUANTIS_SUCCESS)
+    {
+      return result;
+    }
+
+    done += ConvertToScaledIntArray(values + done, count - done, min, max);
+  }
+
+  return QUANTIS_SUCCESS;
+}
+
+int32_t QuantisExtractorCtxReadScaledShorts(QuantisExtractorCtx *ctx,
+                                            QuantisDeviceType deviceType,
+                                            unsigned int deviceNumber,
+                                            short *values,
+                                            size_t count,
+                                            short min,
+                                            short max)
+{
+  size_t done = 0;
+  int32_t result;
+
+  if (min > max)
+  {
+    return QUANTIS_ERROR_INVALID_PARAMETER;
+  }
+
+  // Values discarded to avoid a bias are read again, all at once
+  while (done < count)
+  {
+    result = QuantisExtractorCtxReadShorts(ctx, deviceType, deviceNumber, values + done, count - done);
+    if (result != QUANTIS_SUCCESS)
+    {
+      return result;
+    }
+
+    done += ConvertToScaledShortArray(values + done, count - done, min, max);
+  }
 
   return QUANTIS_SUCCESS;
 }
@@ -1335,6 +1839,10 @@ char *QuantisExtractorStrError(QuantisExtractorError errorNumber)
     msg = "less than 2 elementary matrices were provided as input, but at least 2 are required to produce an extractor matrix";
     break;
 
+  case QUANTIS_EXT_ERROR_OUTPUT_TOO_LARGE:
+    msg = "the output would be larger than 2 GB, QuantisExtractorGetDataFromFile64 should be used";
+    break;
+
   default:
     sprintf(msg, "Undefined error: %d", (int)errorNumber);
     break;
@@ -1342,3 +1850,307 @@ char *QuantisExtractorStrError(QuantisExtractorError errorNumber)
 
   return (char *)msg;
 }
+
+/** ----------------------------------------------------------------------------------- */
+/**                          FUNCTIONS USING THE GLOBAL CONTEXT                         */
+/** ----------------------------------------------------------------------------------- */
+
+int32_t QuantisExtractorGetDataFromQuantis(QuantisDeviceType deviceType,
+                                           unsigned int deviceNumber,
+                                           uint8_t *outputBuffer,
+                                           uint32_t numberOfBytesRequested,
+                                           const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxGetDataFromQuantis(&g_ctx, deviceType, deviceNumber, outputBuffer, numberOfBytesRequested);
+}
+
+int32_t QuantisExtractorGetDataFromFile(char *inputFilePath,
+                                        char *outputFilePath,
+                                        const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxGetDataFromFile(&g_ctx, inputFilePath, outputFilePath);
+}
+
+int64_t QuantisExtractorGetDataFromFile64(const char *inputFilePath,
+                                          const char *outputFilePath,
+                                          const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxGetDataFromFile64(&g_ctx, inputFilePath, outputFilePath);
+}
+
+void QuantisExtractorGetDataFromBuffer(const uint8_t *inputBuffer,
+                                       uint8_t *outputBuffer,
+                                       const uint64_t *extractorMatrix,
+                                       uint32_t numberOfBytesAfterExtraction)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  QuantisExtractorCtxGetDataFromBuffer(&g_ctx, inputBuffer, outputBuffer, numberOfBytesAfterExtraction);
+}
+
+uint16_t QuantisExtractorGetMatrixSizeIn()
+{
+  return QuantisExtractorCtxGetMatrixSizeIn(&g_ctx);
+}
+
+uint16_t QuantisExtractorGetMatrixSizeOut()
+{
+  return QuantisExtractorCtxGetMatrixSizeOut(&g_ctx);
+}
+
+void QuantisExtractorSetThreads(uint32_t threadsCount)
+{
+  QuantisExtractorCtxSetThreads(&g_ctx, threadsCount);
+}
+
+uint32_t QuantisExtractorGetThreads()
+{
+  return QuantisExtractorCtxGetThreads(&g_ctx);
+}
+
+int32_t QuantisExtractorComputeBufferSize(uint32_t numberOfBytesRequested,
+                                          uint32_t *numberOfBytesAfterExtraction,
+                                          uint32_t *numberOfBytesBeforeExtraction)
+{
+  return QuantisExtractorCtxComputeBufferSize(&g_ctx,
+                                              numberOfBytesRequested,
+                                              numberOfBytesAfterExtraction,
+                                              numberOfBytesBeforeExtraction);
+}
+
+int32_t QuantisExtractorInitializeOutputBuffer(uint32_t inputBufferSize,
+                                               uint8_t **outputBuffer)
+{
+  return QuantisExtractorCtxInitializeOutputBuffer(&g_ctx, inputBufferSize, outputBuffer);
+}
+
+void QuantisExtractorProcessBlock(const uint64_t *inputBuffer,
+                                  uint64_t *outputBuffer,
+                                  const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  QuantisExtractorCtxProcessBlock(&g_ctx, inputBuffer, outputBuffer);
+}
+
+int32_t QuantisExtractorStorageBufferEnable()
+{
+  return QuantisExtractorCtxStorageBufferEnable(&g_ctx);
+}
+
+int32_t QuantisExtractorStorageBufferEnableWithCapacity(uint32_t capacity)
+{
+  return QuantisExtractorCtxStorageBufferEnableWithCapacity(&g_ctx, capacity);
+}
+
+int32_t QuantisExtractorStorageBufferDisable()
+{
+  return QuantisExtractorCtxStorageBufferDisable(&g_ctx);
+}
+
+int32_t QuantisExtractorStorageBufferClear()
+{
+  return QuantisExtractorCtxStorageBufferClear(&g_ctx);
+}
+
+int32_t QuantisExtractorStorageBufferSet(uint8_t *bufferToCopy,
+                                         uint32_t bytesToCopy)
+{
+  return QuantisExtractorCtxStorageBufferSet(&g_ctx, bufferToCopy, bytesToCopy);
+}
+
+int32_t QuantisExtractorStorageBufferAppend(uint8_t *bufferToAppend,
+                                            uint32_t bytesToAppend)
+{
+  return QuantisExtractorCtxStorageBufferAppend(&g_ctx, bufferToAppend, bytesToAppend);
+}
+
+int32_t QuantisExtractorStorageBufferRead(uint8_t *outputBuffer,
+                                          uint32_t numberOfBytesRequested)
+{
+  return QuantisExtractorCtxStorageBufferRead(&g_ctx, outputBuffer, numberOfBytesRequested);
+}
+
+uint32_t QuantisExtractorStorageBufferGetSize()
+{
+  return QuantisExtractorCtxStorageBufferGetSize(&g_ctx);
+}
+
+uint32_t QuantisExtractorStorageBufferGetCapacity()
+{
+  return QuantisExtractorCtxStorageBufferGetCapacity(&g_ctx);
+}
+
+uint8_t QuantisExtractorStorageBufferIsEnabled()
+{
+  return QuantisExtractorCtxStorageBufferIsEnabled(&g_ctx);
+}
+
+int32_t QuantisExtractorReadDouble_01(QuantisDeviceType deviceType,
+                                      unsigned int deviceNumber,
+                                      double *value,
+                                      const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadDouble_01(&g_ctx, deviceType, deviceNumber, value);
+}
+
+int32_t QuantisExtractorReadFloat_01(QuantisDeviceType deviceType,
+                                     unsigned int deviceNumber,
+                                     float *value,
+                                     const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadFloat_01(&g_ctx, deviceType, deviceNumber, value);
+}
+
+int32_t QuantisExtractorReadInt(QuantisDeviceType deviceType,
+                                unsigned int deviceNumber,
+                                int *value,
+                                const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadInt(&g_ctx, deviceType, deviceNumber, value);
+}
+
+int32_t QuantisExtractorReadShort(QuantisDeviceType deviceType,
+                                  unsigned int deviceNumber,
+                                  short *value,
+                                  const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadShort(&g_ctx, deviceType, deviceNumber, value);
+}
+
+int32_t QuantisExtractorReadScaledDouble(QuantisDeviceType deviceType,
+                                         unsigned int deviceNumber,
+                                         double *value,
+                                         double min,
+                                         double max,
+                                         const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledDouble(&g_ctx, deviceType, deviceNumber, value, min, max);
+}
+
+int32_t QuantisExtractorReadScaledFloat(QuantisDeviceType deviceType,
+                                        unsigned int deviceNumber,
+                                        float *value,
+                                        float min,
+                                        float max,
+                                        const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledFloat(&g_ctx, deviceType, deviceNumber, value, min, max);
+}
+
+int32_t QuantisExtractorReadScaledInt(QuantisDeviceType deviceType,
+                                      unsigned int deviceNumber,
+                                      int *value,
+                                      int min,
+                                      int max,
+                                      const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledInt(&g_ctx, deviceType, deviceNumber, value, min, max);
+}
+
+int32_t QuantisExtractorReadScaledShort(QuantisDeviceType deviceType,
+                                        unsigned int deviceNumber,
+                                        short *value,
+                                        short min,
+                                        short max,
+                                        const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledShort(&g_ctx, deviceType, deviceNumber, value, min, max);
+}
+
+int32_t QuantisExtractorReadDoubles_01(QuantisDeviceType deviceType,
+                                       unsigned int deviceNumber,
+                                       double *values,
+                                       size_t count,
+                                       const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadDoubles_01(&g_ctx, deviceType, deviceNumber, values, count);
+}
+
+int32_t QuantisExtractorReadFloats_01(QuantisDeviceType deviceType,
+                                      unsigned int deviceNumber,
+                                      float *values,
+                                      size_t count,
+                                      const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadFloats_01(&g_ctx, deviceType, deviceNumber, values, count);
+}
+
+int32_t QuantisExtractorReadInts(QuantisDeviceType deviceType,
+                                 unsigned int deviceNumber,
+                                 int *values,
+                                 size_t count,
+                                 const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadInts(&g_ctx, deviceType, deviceNumber, values, count);
+}
+
+int32_t QuantisExtractorReadShorts(QuantisDeviceType deviceType,
+                                   unsigned int deviceNumber,
+                                   short *values,
+                                   size_t count,
+                                   const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadShorts(&g_ctx, deviceType, deviceNumber, values, count);
+}
+
+int32_t QuantisExtractorReadScaledDoubles(QuantisDeviceType deviceType,
+                                          unsigned int deviceNumber,
+                                          double *values,
+                                          size_t count,
+                                          double min,
+                                          double max,
+                                          const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledDoubles(&g_ctx, deviceType, deviceNumber, values, count, min, max);
+}
+
+int32_t QuantisExtractorReadScaledFloats(QuantisDeviceType deviceType,
+                                         unsigned int deviceNumber,
+                                         float *values,
+                                         size_t count,
+                                         float min,
+                                         float max,
+                                         const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledFloats(&g_ctx, deviceType, deviceNumber, values, count, min, max);
+}
+
+int32_t QuantisExtractorReadScaledInts(QuantisDeviceType deviceType,
+                                       unsigned int deviceNumber,
+                                       int *values,
+                                       size_t count,
+                                       int min,
+                                       int max,
+                                       const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledInts(&g_ctx, deviceType, deviceNumber, values, count, min, max);
+}
+
+int32_t QuantisExtractorReadScaledShorts(QuantisDeviceType deviceType,
+                                         unsigned int deviceNumber,
+                                         short *values,
+                                         size_t count,
+                                         short min,
+                                         short max,
+                                         const uint64_t *extractorMatrix)
+{
+  QuantisExtractorCtxUseMatrix(&g_ctx, extractorMatrix);
+  return QuantisExtractorCtxReadScaledShorts(&g_ctx, deviceType, deviceNumber, values, count, min, max);
+}
@@ -61,7 +61,7 @@ using namespace std;
  * @throw std::runtime_error if result is negative. The exception message
  * contains details about the error.
  */
-void inline CheckError(const int result, const string &methodName) throw(std::runtime_error)
+void inline CheckError(const int result, const string &methodName)
 {
   // All errors are negative
   if (result < 0)
@@ -90,7 +90,7 @@ float idQ::QuantisExtractor::GetLibVersion()
 
 void idQ::QuantisExtractor::InitializeMatrix(const std::string &matrixFilename,
                                              const uint16_t matrixSizeIn,
-                                             const uint16_t matrixSizeOut) throw(std::runtime_error)
+                                             const uint16_t matrixSizeOut)
 {
 
   if (_matrixInitalized)
@@ -118,7 +118,7 @@ void idQ::QuantisExtractor::UninitializeMatrix()
 void idQ::QuantisExtractor::GetDataFromQuantis(const QuantisDeviceType deviceType,
                                                const unsigned int cardNumber,
                                                void *buffer,
-                                               const size_t bytesNum) throw(std::runtime_error)
+                                               const size_t bytesNum)
 {
   if (bytesNum == 0u)
   {
@@ -148,7 +148,7 @@ void idQ::QuantisExtractor::GetDataFromQuantis(const QuantisDeviceType deviceTyp
 
 std::string idQ::QuantisExtractor::GetDataFromQuantis(const QuantisDeviceType deviceType,
                                                       const unsigned int cardNumber,
-                                                      const size_t bytesNum) throw(std::runtime_error)
+                                                      const size_t bytesNum)
 {
   string buffer;
   buffer.resize(bytesNum);
@@ -170,7 +170,7 @@ std::string idQ::QuantisExtractor::GetDataFromQuantis(const QuantisDeviceType de
 }
 
 int32_t idQ::QuantisExtractor::GetDataFromFile(const std::string &inputFilename,
-                                               const std::string &outputFilename) throw(std::runtime_error)
+                                               const std::string &outputFilename)
 {
   int32_t readBytes;
 
@@ -184,7 +184,7 @@ int32_t idQ::QuantisExtractor::GetDataFromFile(const std::string &inputFilename,
 
 void idQ::QuantisExtractor::GetDataFromBuffer(const void *inputBuffer,
                                               void *outputBuffer,
-                                              size_t numberOfBytesAfterExtraction) throw(std::runtime_error)
+                                              size_t numberOfBytesAfterExtraction)
 {
   ::QuantisExtractorGetDataFromBuffer(static_cast<const uint8_t *>(inputBuffer),
                                       static_cast<uint8_t *>(outputBuffer),
@@ -193,7 +193,7 @@ void idQ::QuantisExtractor::GetDataFromBuffer(const void *inputBuffer,
 }
 
 uint32_t idQ::QuantisExtractor::InitializeOutputBuffer(const uint32_t inputBufferSize,
-                                                       uint8_t **outputBuffer) throw(std::runtime_error)
+                                                       uint8_t **outputBuffer)
 {
   int32_t result;
 
@@ -229,7 +229,7 @@ void idQ::QuantisExtractor::CreateElementaryMatrix(const QuantisDeviceType devic
                                                    const uint16_t matrixSizeIn,
                                                    const uint16_t matrixSizeOut,
                                                    const uint16_t underSamplingPeriod,
-                                                   const std::string &elementaryMatrixFilename) throw(std::runtime_error)
+                                                   const std::string &elementaryMatrixFilename)
 {
   const int32_t res = ::QuantisExtractorMatrixCreateElementary(deviceType,
                                                                deviceNumber,
@@ -242,7 +242,7 @@ void idQ::QuantisExtractor::CreateElementaryMatrix(const QuantisDeviceType devic
 
 void idQ::QuantisExtractor::CreateMatrix(const uint32_t matrixSize,
                                          const std::vector<std::string> &elementaryMatricesFilenames,
-                                         const std::string &extractorMatrixFilename) throw(std::runtime_error)
+                                         const std::string &extractorMatrixFilename)
 {
   uint32_t numberOfElementaryFiles = static_cast<uint32_t>(elementaryMatricesFilenames.size());
   //char *elementaryMatricesToXor[numberOfElementaryFiles];
@@ -284,7 +284,7 @@ uint32_t idQ::QuantisExtractor::ReadUnderSampled(const QuantisDeviceType deviceT
                                                  const unsigned int deviceNumber,
                                                  const uint32_t nbrOfBytesRequested,
                                                  const uint16_t underSamplingPeriod,
-                                                 std::vector<uint8_t> &sampledBuffer) throw(std::runtime_error)
+                                                 std::vector<uint8_t> &sampledBuffer)
 {
   uint32_t result;
 
@@ -299,12 +299,12 @@ uint32_t idQ::QuantisExtractor::ReadUnderSampled(const QuantisDeviceType deviceT
   return static_cast<uint32_t>(result);
 }
 
-void idQ::QuantisExtractor::EnableStorageBuffer() throw(std::runtime_error)
+void idQ::QuantisExtractor::EnableStorageBuffer()
 {
   CheckError(::QuantisExtractorStorageBufferEnable(), "EnableStorageBuffer");
 }
 
-void idQ::QuantisExtractor::DisableStorageBuffer() throw(std::runtime_error)
+void idQ::QuantisExtractor::DisableStorageBuffer()
 {
   CheckError(::QuantisExtractorStorageBufferDisable(), "DisableStorageBuffer");
 }
@@ -316,7 +316,6 @@ std::string idQ::QuantisExtractor::StrError(const QuantisExtractorError errorNum
 
 double idQ::QuantisExtractor::GetDoubleFromQuantis(const QuantisDeviceType deviceType,
                                                    const unsigned int cardNumber) const
-    throw(std::runtime_error)
 {
   double value;
   CheckError(::QuantisExtractorReadDouble_01(deviceType, cardNumber, &value, _matrix), "GetDoubleFromQuantis");
@@ -328,7 +327,6 @@ double idQ::QuantisExtractor::GetDoubleFromQuantis(const QuantisDeviceType devic
                                                    const unsigned int cardNumber,
                                                    double min,
                                                    double max) const
-    throw(std::runtime_error)
 {
   double value;
   CheckError(::QuantisExtractorReadScaledDouble(deviceType, cardNumber, &value, min, max, _matrix), "GetDoubleFromQuantis");
@@ -338,7 +336,6 @@ double idQ::QuantisExtractor::GetDoubleFromQuantis(const QuantisDeviceType devic
 
 float idQ::QuantisExtractor::GetFloatFromQuantis(const QuantisDeviceType deviceType,
                                                  const unsigned int cardNumber) const
-    throw(std::runtime_error)
 {
   float value;
   CheckError(::QuantisExtractorReadFloat_01(deviceType, cardNumber, &value, _matrix), "GetFloatFromQuantis");
@@ -350,7 +347,6 @@ float idQ::QuantisExtractor::GetFloatFromQuantis(const QuantisDeviceType deviceT
                                                  const unsigned int cardNumber,
                                                  float min,
                                                  float max) const
-    throw(std::runtime_error)
 {
   float value;
   CheckError(::QuantisExtractorReadScaledFloat(deviceType, cardNumber, &value, min, max, _matrix), "GetFloatFromQuantis");
@@ -360,7 +356,6 @@ float idQ::QuantisExtractor::GetFloatFromQuantis(const QuantisDeviceType deviceT
 
 int idQ::QuantisExtractor::GetIntFromQuantis(const QuantisDeviceType deviceType,
                                              const unsigned int cardNumber) const
-    throw(std::runtime_error)
 {
   int value;
   CheckError(::QuantisExtractorReadInt(deviceType, cardNumber, &value, _matrix), "GetIntFromQuantis");
@@ -372,7 +367,6 @@ int idQ::QuantisExtractor::GetIntFromQuantis(const QuantisDeviceType deviceType,
                                              const unsigned int cardNumber,
                                              int min,
                                              int max) const
-    throw(std::runtime_error)
 {
   int value;
   CheckError(::QuantisExtractorReadScaledInt(deviceType, cardNumber, &value, min, max, _matrix), "GetIntFromQuantis");
@@ -382,7 +376,6 @@ int idQ::QuantisExtractor::GetIntFromQuantis(const QuantisDeviceType deviceType,
 
 short idQ::QuantisExtractor::GetShortFromQuantis(const QuantisDeviceType deviceType,
                                                  const unsigned int cardNumber) const
-    throw(std::runtime_error)
 {
   short value;
   CheckError(::QuantisExtractorReadShort(deviceType, cardNumber, &value, _matrix), "GetShortFromQuantis");
@@ -394,7 +387,6 @@ short idQ::QuantisExtractor::GetShortFromQuantis(const QuantisDeviceType deviceT
                                                  const unsigned int cardNumber,
                                                  short min,
                                                  short max) const
-    throw(std::runtime_error)
 {
   short value;
   CheckError(::QuantisExtractorReadScaledShort(deviceType, cardNumber, &value, min, max, _matrix), "GetShortFromQuantis");
@@ -0,0 +1,480 @@
+/*
+ * Quantis_Extensions extractor kernels
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#include "../Quantis/Quantis.h"
+#include "QuantisExtractor.h"
+#include "QuantisExtractor_Kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define QUANTIS_EXTRACTOR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/* Number of input bits per table */
+#define QUANTIS_EXTRACTOR_GROUP_BITS 4
+#define QUANTIS_EXTRACTOR_GROUP_ENTRIES (1 << QUANTIS_EXTRACTOR_GROUP_BITS)
+
+/* Alignment of the tables */
+#define QUANTIS_EXTRACTOR_TABLES_ALIGNMENT 64
+
+/**
+ * Returns the entry of the table of group <em>group</em> selected by the
+ * input block.
+ */
+static inline const uint64_t *QuantisExtractorTablesGetEntry(const QuantisExtractorTables *tables,
+                                                             const uint64_t *inputBuffer,
+                                                             uint32_t group)
+{
+  uint32_t value = (uint32_t)(inputBuffer[group >> 4] >> ((group & 15u) * QUANTIS_EXTRACTOR_GROUP_BITS)) &
+                   (QUANTIS_EXTRACTOR_GROUP_ENTRIES - 1u);
+
+  return tables->entries + ((size_t)group * QUANTIS_EXTRACTOR_GROUP_ENTRIES + value) * tables->outputWords;
+}
+
+int32_t QuantisExtractorTablesCreate(const uint64_t *extractorMatrix,
+                                     uint16_t matrixSizeIn,
+                                     uint16_t matrixSizeOut,
+                                     QuantisExtractorTables **tables)
+{
+  QuantisExtractorTables *_tables;
+  void *memory = NULL;
+  uint32_t inputWords = matrixSizeIn / 64u;
+  uint32_t group;
+  uint32_t value;
+  uint32_t row;
+
+  if ((matrixSizeIn == 0u) || (matrixSizeOut == 0u) ||
+      (matrixSizeIn % 64u) || (matrixSizeOut % 64u))
+  {
+    return QUANTIS_EXT_ERROR_WRONG_EXTRACTION_PARAMETERS;
+  }
+
+  _tables = (QuantisExtractorTables *)malloc(sizeof(QuantisExtractorTables));
+  if (_tables == NULL)
+  {
+    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+  }
+
+  _tables->matrix = extractorMatrix;
+  _tables->matrixSizeIn = matrixSizeIn;
+  _tables->matrixSizeOut = matrixSizeOut;
+  _tables->groups = matrixSizeIn / QUANTIS_EXTRACTOR_GROUP_BITS;
+  _tables->outputWords = matrixSizeOut / 64u;
+
+  if (posix_memalign(&memory,
+                     QUANTIS_EXTRACTOR_TABLES_ALIGNMENT,
+                     (size_t)_tables->groups * QUANTIS_EXTRACTOR_GROUP_ENTRIES *
+                         _tables->outputWords * sizeof(uint64_t)) != 0)
+  {
+    free(_tables);
+    return QUANTIS_EXT_ERROR_UNABLE_TO_ALLOCATE_MEMORY;
+  }
+  _tables->entries = (uint64_t *)memory;
+
+  for (group = 0u; group < _tables->groups; group++)
+  {
+    uint64_t *entries = _tables->entries +
+                        (size_t)group * QUANTIS_EXTRACTOR_GROUP_ENTRIES * _tables->outputWords;
+
+    // entry 0 is the null vector
+    memset(entries, 0, _tables->outputWords * sizeof(uint64_t));
+
+    // entry of value = entry of value without its lowest bit XOR the column of that bit
+    for (value = 1u; value < QUANTIS_EXTRACTOR_GROUP_ENTRIES; value++)
+    {
+      uint64_t *entry = entries + (size_t)value * _tables->outputWords;
+      const uint64_t *previous = entries + (size_t)(value & (value - 1u)) * _tables->outputWords;
+      uint32_t column = group * QUANTIS_EXTRACTOR_GROUP_BITS + (uint32_t)__builtin_ctz(value);
+
+      memcpy(entry, previous, _tables->outputWords * sizeof(uint64_t));
+      for (row = 0u; row < matrixSizeOut; row++)
+      {
+        uint64_t bit = (extractorMatrix[(size_t)row * inputWords + column / 64u] >> (column % 64u)) & 1u;
+        entry[row / 64u] ^= bit << (row % 64u);
+      }
+    }
+  }
+
+  *tables = _tables;
+
+  return QUANTIS_SUCCESS;
+}
+
+void QuantisExtractorTablesFree(QuantisExtractorTables *tables)
+{
+  if (tables)
+  {
+    free(tables->entries);
+    free(tables);
+  }
+}
+
+void QuantisExtractorKernelScalar(const uint64_t *inputBuffer,
+                                  uint64_t *outputBuffer,
+                                  const uint64_t *extractorMatrix,
+                                  uint16_t matrixSizeIn,
+                                  uint16_t matrixSizeOut)
+{
+  int index = 0;
+  uint32_t i;
+  unsigned int j;
+  unsigned int l;
+
+  // do a matrix-vector multiplication by looping over all rows
+  // the outer loop over all words
+
+  for (i = 0; i < (uint32_t)(matrixSizeOut / 64); ++i)
+  {
+    outputBuffer[i] = 0;
+
+    // the inner loop over all bits in the word
+    for (j = 0; j < 64; ++j)
+    {
+      uint64_t parity = extractorMatrix[index++] & inputBuffer[0];
+
+      // do it as a vector-vector multiplication using bit operations
+      for (l = 1; l < (uint32_t)(matrixSizeIn / 64); ++l)
+      {
+        parity ^= extractorMatrix[index++] & inputBuffer[l];
+      }
+
+      // finally count the bit parity
+      parity ^= parity >> 1;
+      parity ^= parity >> 2;
+      parity = (parity & 0x1111111111111111UL) * 0x1111111111111111UL;
+      // and set the j-th output bit of the i-th output word
+      outputBuffer[i] |= ((parity >> 60) & 1) << j;
+    }
+  }
+}
+
+/**
+ * Table kernel in plain C. The output is accumulated by slices of 8 words,
+ * small enough to be kept in registers.
+ */
+static void QuantisExtractorKernelPortable(const QuantisExtractorTables *tables,
+                                           const uint64_t *inputBuffer,
+                                           uint64_t *outputBuffer)
+{
+  uint32_t word;
+  uint32_t group;
+  uint32_t i;
+
+  for (word = 0u; word < tables->outputWords; word += 8u)
+  {
+    uint64_t accumulator[8] = {0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u};
+    uint32_t sliceWords = tables->outputWords - word;
+
+    if (sliceWords > 8u)
+    {
+      sliceWords = 8u;
+    }
+
+    if (sliceWords == 8u)
+    {
+      for (group = 0u; group < tables->groups; group++)
+      {
+        const uint64_t *entry = QuantisExtractorTablesGetEntry(tables, inputBuffer, group) + word;
+        for (i = 0u; i < 8u; i++)
+        {
+          accumulator[i] ^= entry[i];
+        }
+      }
+    }
+    else
+    {
+      for (group = 0u; group < tables->groups; group++)
+      {
+        const uint64_t *entry = QuantisExtractorTablesGetEntry(tables, inputBuffer, group) + word;
+        for (i = 0u; i < sliceWords; i++)
+        {
+          accumulator[i] ^= entry[i];
+        }
+      }
+    }
+
+    memcpy(&outputBuffer[word], accumulator, sliceWords * sizeof(uint64_t));
+  }
+}
+
+#ifdef QUANTIS_EXTRACTOR_X86_KERNELS
+
+/**
+ * Table kernel with AVX2. The output is accumulated by slices of 4 registers
+ * (16 words), the last slice being masked.
+ */
+__attribute__((target("avx2"))) static void QuantisExtractorKernelAvx2(const QuantisExtractorTables *tables,
+                                                                        const uint64_t *inputBuffer,
+                                                                        uint64_t *outputBuffer)
+{
+  uint32_t word;
+  uint32_t group;
+  __m256i accumulator[4];
+  __m256i mask[4];
+  int i;
+
+  for (word = 0u; word < tables->outputWords; word += 16u)
+  {
+    uint32_t sliceWords = tables->outputWords - word;
+
+    for (i = 0; i < 4; i++)
+    {
+      accumulator[i] = _mm256_setzero_si256();
+    }
+
+    if (sliceWords >= 16u)
+    {
+      for (group = 0u; group < tables->groups; group++)
+      {
+        const __m256i *entry = (const __m256i *)(QuantisExtractorTablesGetEntry(tables, inputBuffer, group) + word);
+        accumulator[0] = _mm256_xor_si256(accumulator[0], _mm256_loadu_si256(entry));
+        accumulator[1] = _mm256_xor_si256(accumulator[1], _mm256_loadu_si256(entry + 1));
+        accumulator[2] = _mm256_xor_si256(accumulator[2], _mm256_loadu_si256(entry + 2));
+        accumulator[3] = _mm256_xor_si256(accumulator[3], _mm256_loadu_si256(entry + 3));
+      }
+
+      for (i = 0; i < 4; i++)
+      {
+        _mm256_storeu_si256((__m256i *)&outputBuffer[word + 4u * i], accumulator[i]);
+      }
+    }
+    else
+    {
+      // lane j of register i is used if 4 * i + j < sliceWords
+      for (i = 0; i < 4; i++)
+      {
+        mask[i] = _mm256_cmpgt_epi64(_mm256_set1_epi64x((long long)sliceWords),
+                                     _mm256_setr_epi64x(4 * i, 4 * i + 1, 4 * i + 2, 4 * i + 3));
+      }
+
+      for (group = 0u; group < tables->groups; group++)
+      {
+        const long long *entry = (const long long *)(QuantisExtractorTablesGetEntry(tables, inputBuffer, group) + word);
+        accumulator[0] = _mm256_xor_si256(accumulator[0], _mm256_maskload_epi64(entry, mask[0]));
+        accumulator[1] = _mm256_xor_si256(accumulator[1], _mm256_maskload_epi64(entry + 4, mask[1]));
+        accumulator[2] = _mm256_xor_si256(accumulator[2], _mm256_maskload_epi64(entry + 8, mask[2]));
+        accumulator[3] = _mm256_xor_si256(accumulator[3], _mm256_maskload_epi64(entry + 12, mask[3]));
+      }
+
+      for (i = 0; i < 4; i++)
+      {
+        _mm256_maskstore_epi64((long long *)&outputBuffer[word + 4u * i], mask[i], accumulator[i]);
+      }
+    }
+  }
+}
+
+/**
+ * Table kernel with AVX-512. The output is accumulated by slices of 2
+ * registers (16 words), the last slice being masked. Two entries are XORed
+ * into an accumulator at once with a three-way XOR (vpternlogq 0x96).
+ */
+__attribute__((target("avx512f"))) static void QuantisExtractorKernelAvx512(const QuantisExtractorTables *tables,
+                                                                             const uint64_t *inputBuffer,
+                                                                             uint64_t *outputBuffer)
+{
+  uint32_t word;
+  uint32_t group;
+
+  for (word = 0u; word < tables->outputWords; word += 16u)
+  {
+    uint32_t sliceWords = tables->outputWords - word;
+    __mmask8 mask0;
+    __mmask8 mask1;
+    __m512i accumulator0 = _mm512_setzero_si512();
+    __m512i accumulator1 = _mm512_setzero_si512();
+
+    if (sliceWords > 16u)
+    {
+      sliceWords = 16u;
+    }
+    mask0 = (sliceWords >= 8u) ? (__mmask8)0xFF : (__mmask8)((1u << sliceWords) - 1u);
+    mask1 = (sliceWords >= 16u) ? (__mmask8)0xFF
+                                : (__mmask8)((sliceWords > 8u) ? ((1u << (sliceWords - 8u)) - 1u) : 0u);
+
+    // groups is a multiple of 16, hence even
+    for (group = 0u; group < tables->groups; group += 2u)
+    {
+      const uint64_t *entryA = QuantisExtractorTablesGetEntry(tables, inputBuffer, group) + word;
+      const uint64_t *entryB = QuantisExtractorTablesGetEntry(tables, inputBuffer, group + 1u) + word;
+
+      accumulator0 = _mm512_ternarylogic_epi64(accumulator0,
+                                               _mm512_maskz_loadu_epi64(mask0, entryA),
+                                               _mm512_maskz_loadu_epi64(mask0, entryB),
+                                               0x96);
+      accumulator1 = _mm512_ternarylogic_epi64(accumulator1,
+                                               _mm512_maskz_loadu_epi64(mask1, entryA + 8),
+                                               _mm512_maskz_loadu_epi64(mask1, entryB + 8),
+                                               0x96);
+    }
+
+    _mm512_mask_storeu_epi64(&outputBuffer[word], mask0, accumulator0);
+    _mm512_mask_storeu_epi64(&outputBuffer[word + 8u], mask1, accumulator1);
+  }
+}
+
+#endif /* QUANTIS_EXTRACTOR_X86_KERNELS */
+
+int QuantisExtractorKernelIsSupported(QuantisExtractorKernel kernel)
+{
+  switch (kernel)
+  {
+  case QUANTIS_EXTRACTOR_KERNEL_SCALAR:
+  case QUANTIS_EXTRACTOR_KERNEL_PORTABLE:
+    return 1;
+
+#ifdef QUANTIS_EXTRACTOR_X86_KERNELS
+  case QUANTIS_EXTRACTOR_KERNEL_AVX2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+
+  case QUANTIS_EXTRACTOR_KERNEL_AVX512:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") ? 1 : 0;
+#endif
+
+  default:
+    return 0;
+  }
+}
+
+const char *QuantisExtractorKernelGetName(QuantisExtractorKernel kernel)
+{
+  switch (kernel)
+  {
+  case QUANTIS_EXTRACTOR_KERNEL_SCALAR:
+    return "scalar";
+
+  case QUANTIS_EXTRACTOR_KERNEL_PORTABLE:
+    return "portable";
+
+  case QUANTIS_EXTRACTOR_KERNEL_AVX2:
+    return "avx2";
+
+  case QUANTIS_EXTRACTOR_KERNEL_AVX512:
+    return "avx512";
+
+  default:
+    return "unknown";
+  }
+}
+
+QuantisExtractorKernel QuantisExtractorKernelGetDefault()
+{
+  /* Selected once, -1 until then */
+  static int defaultKernel = -1;
+  int kernel = __atomic_load_n(&defaultKernel, __ATOMIC_ACQUIRE);
+
+  if (kernel < 0)
+  {
+    const char *name = getenv("QUANTIS_EXTRACTOR_KERNEL");
+
+    kernel = -1;
+    if (name != NULL)
+    {
+      int i;
+      for (i = 0; i < QUANTIS_EXTRACTOR_KERNELS_COUNT; i++)
+      {
+        if ((strcmp(name, QuantisExtractorKernelGetName((QuantisExtractorKernel)i)) == 0) &&
+            QuantisExtractorKernelIsSupported((QuantisExtractorKernel)i))
+        {
+          kernel = i;
+        }
+      }
+    }
+
+    // fastest supported kernel
+    if (kernel < 0)
+    {
+      kernel = QUANTIS_EXTRACTOR_KERNELS_COUNT - 1;
+      while (!QuantisExtractorKernelIsSupported((QuantisExtractorKernel)kernel))
+      {
+        kernel--;
+      }
+    }
+
+    __atomic_store_n(&defaultKernel, kernel, __ATOMIC_RELEASE);
+  }
+
+  return (QuantisExtractorKernel)kernel;
+}
+
+void QuantisExtractorKernelRun(QuantisExtractorKernel kernel,
+                               const QuantisExtractorTables *tables,
+                               const uint64_t *inputBuffer,
+                               uint64_t *outputBuffer)
+{
+  switch (kernel)
+  {
+#ifdef QUANTIS_EXTRACTOR_X86_KERNELS
+  case QUANTIS_EXTRACTOR_KERNEL_AVX512:
+    QuantisExtractorKernelAvx512(tables, inputBuffer, outputBuffer);
+    break;
+
+  case QUANTIS_EXTRACTOR_KERNEL_AVX2:
+    QuantisExtractorKernelAvx2(tables, inputBuffer, outputBuffer);
+    break;
+#endif
+
+  case QUANTIS_EXTRACTOR_KERNEL_PORTABLE:
+    QuantisExtractorKernelPortable(tables, inputBuffer, outputBuffer);
+    break;
+
+  default:
+    QuantisExtractorKernelScalar(inputBuffer,
+                                 outputBuffer,
+                                 tables->matrix,
+                                 tables->matrixSizeIn,
+                                 tables->matrixSizeOut);
+    break;
+  }
+}
@@ -0,0 +1,185 @@
+/*
+ * Quantis_Extensions extractor kernels
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+#ifndef QUANTIS_EXTRACTOR_KERNELS_H
+#define QUANTIS_EXTRACTOR_KERNELS_H
+
+/*
+ * Internal header: kernels computing one block of the extractor, that is
+ * the product of the k x n extractor matrix by an n bits input block.
+ *
+ * Besides the scalar reference kernel, which works directly on the matrix,
+ * all kernels work on tables precomputed from the matrix (method of the
+ * four Russians): the input block is cut into groups of 4 bits and, for
+ * each group, the table holds the XOR of the matrix columns for each of the
+ * 16 possible values of the group. A block then costs n / 4 XORs of k bits
+ * rows instead of k parities of n bits rows, and these XORs are vectorized.
+ * The tables use 4 times the size of the matrix (384 KB for 1024 x 768).
+ *
+ * All kernels produce exactly the same output.
+ */
+
+#include "QuantisExtractor.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * List of extractor kernels.
+   */
+  typedef enum
+  {
+    /** Reference kernel: one parity per output bit, no table */
+    QUANTIS_EXTRACTOR_KERNEL_SCALAR = 0,
+
+    /** Tables, plain C (vectorized by the compiler if possible) */
+    QUANTIS_EXTRACTOR_KERNEL_PORTABLE = 1,
+
+    /** Tables, AVX2 (256 bits XORs) */
+    QUANTIS_EXTRACTOR_KERNEL_AVX2 = 2,
+
+    /** Tables, AVX-512 (512 bits three-way XORs with vpternlogq) */
+    QUANTIS_EXTRACTOR_KERNEL_AVX512 = 3
+  } QuantisExtractorKernel;
+
+#define QUANTIS_EXTRACTOR_KERNELS_COUNT 4
+
+  /**
+   * Tables precomputed from an extractor matrix.
+   */
+  typedef struct QuantisExtractorTables
+  {
+    /** The matrix the tables were computed from */
+    const uint64_t *matrix;
+
+    /** Number of input bits (n) */
+    uint16_t matrixSizeIn;
+
+    /** Number of output bits (k) */
+    uint16_t matrixSizeOut;
+
+    /** Number of 4 bits groups of an input block (n / 4) */
+    uint32_t groups;
+
+    /** Number of 64 bits words of an output block (k / 64) */
+    uint32_t outputWords;
+
+    /** groups * 16 entries of outputWords words */
+    uint64_t *entries;
+  } QuantisExtractorTables;
+
+  /**
+   * Computes the tables of an extractor matrix.
+   * @param extractorMatrix pointer to the extractor matrix, which MUST remain
+   * allocated as long as the tables are used.
+   * @param matrixSizeIn the number of bits which are input to the extractor
+   * (multiple of 64).
+   * @param matrixSizeOut the number of bits which are output to the extractor
+   * (multiple of 64).
+   * @param tables pointer to the pointer to the created tables.
+   * @return QUANTIS_SUCCESS on success or a QUANTIS_EXT_ERROR code on failure.
+   */
+  int32_t QuantisExtractorTablesCreate(const uint64_t *extractorMatrix,
+                                       uint16_t matrixSizeIn,
+                                       uint16_t matrixSizeOut,
+                                       QuantisExtractorTables **tables);
+
+  /**
+   * Frees tables created with QuantisExtractorTablesCreate.
+   * @param tables pointer to the tables (may be NULL).
+   */
+  void QuantisExtractorTablesFree(QuantisExtractorTables *tables);
+
+  /**
+   * @return 1 when the kernel can run on this CPU, 0 otherwise.
+   */
+  int QuantisExtractorKernelIsSupported(QuantisExtractorKernel kernel);
+
+  /**
+   * Returns the kernel used by QuantisExtractorProcessBlock: the fastest one
+   * supported by the CPU, unless the QUANTIS_EXTRACTOR_KERNEL environment
+   * variable names another supported kernel ("scalar", "portable", "avx2"
+   * or "avx512").
+   */
+  QuantisExtractorKernel QuantisExtractorKernelGetDefault();
+
+  /**
+   * @return the name of the kernel.
+   */
+  const char *QuantisExtractorKernelGetName(QuantisExtractorKernel kernel);
+
+  /**
+   * Processes one block with the given kernel, which MUST be supported.
+   * @param kernel the kernel.
+   * @param tables the tables of the extractor matrix.
+   * @param inputBuffer input of the extractor (n / 64 words).
+   * @param outputBuffer output of the extractor (k / 64 words).
+   */
+  void QuantisExtractorKernelRun(QuantisExtractorKernel kernel,
+                                 const QuantisExtractorTables *tables,
+                                 const uint64_t *inputBuffer,
+                                 uint64_t *outputBuffer);
+
+  /**
+   * Reference kernel, working directly on the extractor matrix.
+   */
+  void QuantisExtractorKernelScalar(const uint64_t *inputBuffer,
+                                    uint64_t *outputBuffer,
+                                    const uint64_t *extractorMatrix,
+                                    uint16_t matrixSizeIn,
+                                    uint16_t matrixSizeOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUANTIS_EXTRACTOR_KERNELS_H */
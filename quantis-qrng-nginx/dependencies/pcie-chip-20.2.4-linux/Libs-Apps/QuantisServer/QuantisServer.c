@@ -0,0 +1,601 @@
+/*
+ * Quantis random data server
+ *
+ * Copyright (C) 2004-2020 ID Quantique SA, Carouge/Geneva, Switzerland
+ * All rights reserved.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY.
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * Alternatively, this software may be distributed under the terms of the
+ * terms of the GNU General Public License version 2 as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * For history of changes, see ChangeLog.txt
+ */
+
+/*
+ * Serves the random data of a Quantis device to remote devices
+ * (QUANTIS_DEVICE_REMOTE), so that a single device feeds several processes
+ * or hosts. Random data is read from the device in large blocks by a
+ * QuantisPool, then shared out between the clients, each of them being
+ * limited to a data rate. A client is a user on the Unix-domain socket and
+ * a host on a TCP socket, its connections share its data rate.
+ *
+ * The server listens on a Unix-domain socket by default. The data is sent
+ * in clear and anyone reaching the socket gets it, so a TCP socket is only
+ * served on the loopback interface unless -N is given.
+ *
+ * Usage: QuantisServer [-a address] [-t pci|usb|aggregate] [-n device number]
+ *                      [-r data rate per client in bytes/s] [-b burst in bytes]
+ *                      [-c maximal number of connections]
+ *                      [-i idle timeout in seconds] [-N]
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* struct ucred */
+#endif
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Quantis/Quantis.h"
+#include "Quantis/Quantis_Pool.h"
+#include "Quantis/Quantis_Remote.h"
+
+/** Default maximal number of connections served at once */
+#define SERVER_DEFAULT_MAX_CLIENTS 64
+
+/** Default time (in seconds) after which an idle connection is closed */
+#define SERVER_DEFAULT_IDLE_TIMEOUT 60
+
+/** Time (in milliseconds) accept() is paused when out of descriptors */
+#define SERVER_ACCEPT_BACKOFF 100
+
+/**
+ * Information on the device, read once at startup since the device handle
+ * belongs to the pool afterwards.
+ */
+typedef struct ServerDevice
+{
+  int modulesMask;
+  int modulesDataRate;
+  int modulesPower;
+  int modulesStatus;
+  int boardVersion;
+  int ais31StartupTestsRequestFlag;
+  char serialNumber[256];
+  char manufacturer[256];
+} ServerDevice;
+
+/**
+ * Token bucket of a client, shared by all its connections.
+ */
+typedef struct ServerBucket
+{
+  char key[128];            /* identity of the client, see GetClientKey */
+  unsigned int connections; /* 0 when the bucket is free */
+  double tokens;            /* bytes which may be sent without waiting */
+  double lastRefill;
+} ServerBucket;
+
+typedef struct ServerClient
+{
+  int fd;
+  ServerBucket *bucket;
+} ServerClient;
+
+static ServerDevice serverDevice;
+static QuantisPool *serverPool = NULL;
+static double serverRate = 0.0;  /* per client, 0 for unlimited */
+static double serverBurst = 0.0;
+static unsigned int serverMaxClients = SERVER_DEFAULT_MAX_CLIENTS;
+static unsigned int serverClientsCount = 0u;
+static unsigned int serverIdleTimeout = SERVER_DEFAULT_IDLE_TIMEOUT;
+static int serverReadError = 0; /* error of the last pool read, 0 once it reads again */
+
+/* One bucket per connection at most */
+static ServerBucket *serverBuckets = NULL;
+static pthread_mutex_t serverBucketsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static double GetTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Sleeps <em>delay</em> seconds.
+ */
+static void Sleep(double delay)
+{
+  struct timespec ts;
+  ts.tv_sec = (time_t)delay;
+  ts.tv_nsec = (long)((delay - (double)ts.tv_sec) * 1e9);
+  while (nanosleep(&ts, &ts) != 0)
+  {
+    /* Interrupted, sleep again */
+  }
+}
+
+/**
+ * Identifies the client of a connection: the user on a Unix-domain socket,
+ * the host on a TCP socket, the connection itself when neither is known.
+ */
+static void GetClientKey(int fd, char *key, size_t size)
+{
+  struct sockaddr_storage address;
+  socklen_t length = sizeof(address);
+  char host[INET6_ADDRSTRLEN];
+
+  if (getpeername(fd, (struct sockaddr *)&address, &length) == 0)
+  {
+    if ((address.ss_family == AF_INET) &&
+        (inet_ntop(AF_INET, &((struct sockaddr_in *)&address)->sin_addr, host, sizeof(host)) != NULL))
+    {
+      snprintf(key, size, "tcp:%s", host);
+      return;
+    }
+    if ((address.ss_family == AF_INET6) &&
+        (inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&address)->sin6_addr, host, sizeof(host)) != NULL))
+    {
+      snprintf(key, size, "tcp:%s", host);
+      return;
+    }
+#ifdef SO_PEERCRED
+    if (address.ss_family == AF_UNIX)
+    {
+      struct ucred credentials;
+      length = sizeof(credentials);
+      if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0)
+      {
+        snprintf(key, size, "uid:%u", (unsigned int)credentials.uid);
+        return;
+      }
+    }
+#endif
+  }
+
+  snprintf(key, size, "fd:%d", fd);
+}
+
+/**
+ * Returns the bucket of a client, shared with its other connections.
+ */
+static ServerBucket *AcquireBucket(const char *key)
+{
+  ServerBucket *bucket = NULL;
+  unsigned int i;
+
+  pthread_mutex_lock(&serverBucketsMutex);
+  for (i = 0u; i < serverMaxClients; i++)
+  {
+    if ((serverBuckets[i].connections > 0u) && (strcmp(serverBuckets[i].key, key) == 0))
+    {
+      bucket = &serverBuckets[i];
+      break;
+    }
+    if ((bucket == NULL) && (serverBuckets[i].connections == 0u))
+    {
+      bucket = &serverBuckets[i];
+    }
+  }
+
+  /* A free bucket is left since there is one per connection */
+  if (bucket->connections == 0u)
+  {
+    snprintf(bucket->key, sizeof(bucket->key), "%s", key);
+    bucket->tokens = serverBurst;
+    bucket->lastRefill = GetTime();
+  }
+  bucket->connections++;
+  pthread_mutex_unlock(&serverBucketsMutex);
+
+  return bucket;
+}
+
+static void ReleaseBucket(ServerBucket *bucket)
+{
+  pthread_mutex_lock(&serverBucketsMutex);
+  bucket->connections--;
+  pthread_mutex_unlock(&serverBucketsMutex);
+}
+
+/**
+ * Waits until the client may be sent <em>size</em> more bytes (token bucket
+ * of serverBurst bytes refilled at serverRate bytes per second).
+ */
+static void Throttle(ServerClient *client, size_t size)
+{
+  ServerBucket *bucket = client->bucket;
+  double delay = 0.0;
+  double now;
+
+  if (serverRate <= 0.0)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&serverBucketsMutex);
+  now = GetTime();
+  bucket->tokens += (now - bucket->lastRefill) * serverRate;
+  if (bucket->tokens > serverBurst)
+  {
+    bucket->tokens = serverBurst;
+  }
+  bucket->lastRefill = now;
+
+  /* The debt is paid back by next refill */
+  bucket->tokens -= (double)size;
+  if (bucket->tokens < 0.0)
+  {
+    delay = -bucket->tokens / serverRate;
+  }
+  pthread_mutex_unlock(&serverBucketsMutex);
+
+  if (delay > 0.0)
+  {
+    Sleep(delay);
+  }
+}
+
+/**
+ * Closes the connection when the client sends no request, or reads no
+ * response, for serverIdleTimeout seconds.
+ */
+static void SetIdleTimeout(int fd)
+{
+  struct timeval tv;
+
+  if (serverIdleTimeout == 0u)
+  {
+    return;
+  }
+
+  tv.tv_sec = (time_t)serverIdleTimeout;
+  tv.tv_usec = 0;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+/**
+ * Sends an integer value.
+ */
+static int SendValue(ServerClient *client, int value)
+{
+  return QuantisRemoteSend(client->fd, value, 0u, NULL, 0u);
+}
+
+/**
+ * Sends a string.
+ */
+static int SendString(ServerClient *client, const char *string)
+{
+  size_t length = strlen(string);
+  return QuantisRemoteSend(client->fd, QUANTIS_SUCCESS, (uint32_t)length, string, length);
+}
+
+static void *ServeClient(void *arg)
+{
+  ServerClient *client = (ServerClient *)arg;
+  unsigned char *buffer = (unsigned char *)malloc(QUANTIS_REMOTE_MAX_READ_SIZE);
+  int32_t command;
+  uint32_t argument;
+  int result = QUANTIS_SUCCESS;
+
+  while ((buffer != NULL) &&
+         (result >= 0) &&
+         (QuantisRemoteReceiveHeader(client->fd, &command, &argument) == QUANTIS_SUCCESS))
+  {
+    switch (command)
+    {
+    case QUANTIS_REMOTE_READ:
+      if ((argument == 0u) || (argument > QUANTIS_REMOTE_MAX_READ_SIZE))
+      {
+        result = SendValue(client, QUANTIS_ERROR_INVALID_READ_SIZE);
+        break;
+      }
+
+      Throttle(client, argument);
+      result = QuantisPoolRead(serverPool, buffer, argument);
+      if (result < 0)
+      {
+        __atomic_store_n(&serverReadError, result, __ATOMIC_SEQ_CST);
+        result = SendValue(client, result);
+      }
+      else
+      {
+        /* The device reads again */
+        if (__atomic_load_n(&serverReadError, __ATOMIC_SEQ_CST) < 0)
+        {
+          __atomic_store_n(&serverReadError, 0, __ATOMIC_SEQ_CST);
+        }
+        result = QuantisRemoteSend(client->fd, result, (uint32_t)result, buffer, (size_t)result);
+      }
+      break;
+
+    case QUANTIS_REMOTE_GET_MODULES_MASK:
+      result = SendValue(client, serverDevice.modulesMask);
+      break;
+
+    case QUANTIS_REMOTE_GET_MODULES_DATA_RATE:
+      result = SendValue(client, serverDevice.modulesDataRate);
+      break;
+
+    case QUANTIS_REMOTE_GET_MODULES_POWER:
+      result = SendValue(client, serverDevice.modulesPower);
+      break;
+
+    case QUANTIS_REMOTE_GET_MODULES_STATUS:
+    {
+      /* Status read at startup, unless the device failed since */
+      int readError = __atomic_load_n(&serverReadError, __ATOMIC_SEQ_CST);
+      result = SendValue(client, (readError < 0) ? readError : serverDevice.modulesStatus);
+      break;
+    }
+
+    case QUANTIS_REMOTE_GET_BOARD_VERSION:
+      result = SendValue(client, serverDevice.boardVersion);
+      break;
+
+    case QUANTIS_REMOTE_GET_SERIAL_NUMBER:
+      result = SendString(client, serverDevice.serialNumber);
+      break;
+
+    case QUANTIS_REMOTE_GET_MANUFACTURER:
+      result = SendString(client, serverDevice.manufacturer);
+      break;
+
+    case QUANTIS_REMOTE_GET_AIS31_STARTUP_TESTS_REQUEST_FLAG:
+      result = SendValue(client, serverDevice.ais31StartupTestsRequestFlag);
+      break;
+
+    default:
+      result = SendValue(client, QUANTIS_ERROR_OPERATION_NOT_SUPPORTED);
+      break;
+    }
+  }
+
+  close(client->fd);
+  ReleaseBucket(client->bucket);
+  free(buffer);
+  free(client);
+  __atomic_sub_fetch(&serverClientsCount, 1u, __ATOMIC_SEQ_CST);
+
+  return NULL;
+}
+
+static int ParseDeviceType(const char *name, QuantisDeviceType *deviceType)
+{
+  if (strcmp(name, "pci") == 0)
+  {
+    *deviceType = QUANTIS_DEVICE_PCI;
+  }
+  else if (strcmp(name, "usb") == 0)
+  {
+    *deviceType = QUANTIS_DEVICE_USB;
+  }
+  else if (strcmp(name, "aggregate") == 0)
+  {
+    *deviceType = QUANTIS_DEVICE_AGGREGATE;
+  }
+  else
+  {
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  const char *address = QUANTIS_REMOTE_DEFAULT_ADDRESS;
+  QuantisDeviceType deviceType = QUANTIS_DEVICE_PCI;
+  unsigned int deviceNumber = 0u;
+  QuantisDeviceHandle *deviceHandle = NULL;
+  int allowNetwork = 0;
+  int listeningFd;
+  int option;
+  int result;
+
+  while ((option = getopt(argc, argv, "a:t:n:r:b:c:i:N")) != -1)
+  {
+    switch (option)
+    {
+    case 'a':
+      address = optarg;
+      break;
+    case 't':
+      if (!ParseDeviceType(optarg, &deviceType))
+      {
+        fprintf(stderr, "Invalid device type: %s\n", optarg);
+        return 1;
+      }
+      break;
+    case 'n':
+      deviceNumber = (unsigned int)strtoul(optarg, NULL, 10);
+      break;
+    case 'r':
+      serverRate = strtod(optarg, NULL);
+      break;
+    case 'b':
+      serverBurst = strtod(optarg, NULL);
+      break;
+    case 'c':
+      serverMaxClients = (unsigned int)strtoul(optarg, NULL, 10);
+      break;
+    case 'i':
+      serverIdleTimeout = (unsigned int)strtoul(optarg, NULL, 10);
+      break;
+    case 'N':
+      allowNetwork = 1;
+      break;
+    default:
+      fprintf(stderr,
+              "Usage: %s [-a address] [-t pci|usb|aggregate] [-n device number]\n"
+              "          [-r data rate per client in bytes/s] [-b burst in bytes]\n"
+              "          [-c maximal number of connections]\n"
+              "          [-i idle timeout in seconds, 0 for none]\n"
+              "          [-N serve a TCP address which is not loopback, in clear]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  if (serverMaxClients == 0u)
+  {
+    fprintf(stderr, "Invalid maximal number of connections\n");
+    return 1;
+  }
+  serverBuckets = (ServerBucket *)calloc(serverMaxClients, sizeof(ServerBucket));
+  if (serverBuckets == NULL)
+  {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  /* A client may at least send a batch request without waiting */
+  if (serverBurst < (double)QUANTIS_REMOTE_BATCH_SIZE)
+  {
+    serverBurst = (double)QUANTIS_REMOTE_BATCH_SIZE;
+  }
+
+  /* Clients closing their connection must not stop the server */
+  signal(SIGPIPE, SIG_IGN);
+
+  result = QuantisOpen(deviceType, deviceNumber, &deviceHandle);
+  if (result < 0)
+  {
+    fprintf(stderr, "QuantisOpen failed: %s\n", QuantisStrError(result));
+    return 1;
+  }
+
+  serverDevice.modulesMask = deviceHandle->ops->GetModulesMask(deviceHandle);
+  serverDevice.modulesDataRate = deviceHandle->ops->GetModulesDataRate(deviceHandle);
+  serverDevice.modulesPower = deviceHandle->ops->GetModulesPower(deviceHandle);
+  serverDevice.modulesStatus = deviceHandle->ops->GetModulesStatus(deviceHandle);
+  serverDevice.boardVersion = deviceHandle->ops->GetBoardVersion(deviceHandle);
+  serverDevice.ais31StartupTestsRequestFlag = QuantisGetAis31StartupTestsRequestFlag(deviceHandle);
+  snprintf(serverDevice.serialNumber, sizeof(serverDevice.serialNumber), "%s",
+           deviceHandle->ops->GetSerialNumber(deviceHandle));
+  snprintf(serverDevice.manufacturer, sizeof(serverDevice.manufacturer), "%s",
+           deviceHandle->ops->GetManufacturer(deviceHandle));
+
+  result = QuantisPoolCreate(deviceHandle, 0u, 0u, 0u, &serverPool);
+  if (result < 0)
+  {
+    fprintf(stderr, "QuantisPoolCreate failed: %s\n", QuantisStrError(result));
+    QuantisClose(deviceHandle);
+    return 1;
+  }
+
+  listeningFd = QuantisRemoteListen(address, allowNetwork);
+  if (listeningFd < 0)
+  {
+    fprintf(stderr, "Unable to listen on %s: %s\n", address, QuantisStrError(listeningFd));
+    if ((listeningFd == QUANTIS_ERROR_INVALID_PARAMETER) && !allowNetwork &&
+        (strncmp(address, "tcp:", 4) == 0))
+    {
+      fprintf(stderr, "Only loopback TCP addresses are served without -N\n");
+    }
+    QuantisPoolDestroy(serverPool);
+    QuantisClose(deviceHandle);
+    return 1;
+  }
+
+  printf("Serving device %u (%s) on %s\n", deviceNumber, serverDevice.serialNumber, address);
+  fflush(stdout);
+
+  while (1)
+  {
+    ServerClient *client;
+    pthread_t thread;
+    char key[128];
+    int fd = accept(listeningFd, NULL, NULL);
+    if (fd < 0)
+    {
+      /* Out of descriptors or memory: retrying at once would spin until
+       * connections are closed */
+      if ((errno == EMFILE) || (errno == ENFILE) || (errno == ENOBUFS) || (errno == ENOMEM))
+      {
+        Sleep(SERVER_ACCEPT_BACKOFF / 1000.0);
+      }
+      continue;
+    }
+
+    if (__atomic_add_fetch(&serverClientsCount, 1u, __ATOMIC_SEQ_CST) > serverMaxClients)
+    {
+      __atomic_sub_fetch(&serverClientsCount, 1u, __ATOMIC_SEQ_CST);
+      close(fd);
+      continue;
+    }
+
+    client = (ServerClient *)malloc(sizeof(ServerClient));
+    if (client == NULL)
+    {
+      __atomic_sub_fetch(&serverClientsCount, 1u, __ATOMIC_SEQ_CST);
+      close(fd);
+      continue;
+    }
+    client->fd = fd;
+    SetIdleTimeout(fd);
+    GetClientKey(fd, key, sizeof(key));
+    client->bucket = AcquireBucket(key);
+
+    if (pthread_create(&thread, NULL, ServeClient, client) != 0)
+    {
+      __atomic_sub_fetch(&serverClientsCount, 1u, __ATOMIC_SEQ_CST);
+      ReleaseBucket(client->bucket);
+      close(fd);
+      free(client);
+      continue;
+    }
+    pthread_detach(thread);
+  }
+
+  return 0;
+}